@@ -44,9 +44,15 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #define ETH_HDR_LEN sizeof(struct net_eth_hdr)
 #endif
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+#define ETH_SEND_MTU MAX(NET_ETH_MTU, CONFIG_NET_TCP_GSO_MAX_SIZE)
+#else
+#define ETH_SEND_MTU NET_ETH_MTU
+#endif
+
 struct eth_context {
 	u8_t recv[NET_ETH_MTU + ETH_HDR_LEN];
-	u8_t send[NET_ETH_MTU + ETH_HDR_LEN];
+	u8_t send[ETH_SEND_MTU + ETH_HDR_LEN];
 	u8_t mac_addr[6];
 	struct net_linkaddr ll_addr;
 	struct net_if *iface;
@@ -175,12 +181,80 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 #define update_gptp(iface, pkt, send)
 #endif /* CONFIG_NET_GPTP */
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+/* The host completes the checksum of each segment, so it expects the
+ * TCP checksum field to only hold the pseudo header sum, with the
+ * length of the whole packet, see tcp_v4_send_check().
+ */
+static void set_pseudo_hdr_chksum(u8_t *ip, struct net_tcp_hdr *tcp_hdr,
+				  size_t tcp_len, bool ipv6)
+{
+	u32_t sum = IPPROTO_TCP + tcp_len;
+	size_t addr_len;
+	u8_t *addr;
+
+	if (ipv6) {
+		addr = (u8_t *)&((struct net_ipv6_hdr *)ip)->src;
+		addr_len = 2 * sizeof(struct in6_addr);
+	} else {
+		addr = (u8_t *)&((struct net_ipv4_hdr *)ip)->src;
+		addr_len = 2 * sizeof(struct in_addr);
+	}
+
+	for (size_t i = 0; i < addr_len; i += 2) {
+		sum += (addr[i] << 8) | addr[i + 1];
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	tcp_hdr->chksum = htons(sum);
+}
+
+static int eth_write_gso(struct eth_context *ctx, struct net_pkt *pkt,
+			 int count)
+{
+	bool ipv6 = net_pkt_family(pkt) == AF_INET6;
+	struct net_tcp_hdr *tcp_hdr;
+	size_t l2_len, csum_start, hdr_len;
+
+	/* The Ethernet header is in its own buffer, see ethernet_send() */
+	l2_len = pkt->buffer->len;
+	csum_start = l2_len + net_pkt_ip_hdr_len(pkt) +
+		net_pkt_ipv6_ext_len(pkt);
+	if (csum_start + NET_TCPH_LEN > (size_t)count) {
+		return -EINVAL;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)(ctx->send + csum_start);
+	hdr_len = csum_start + 4 * (tcp_hdr->offset >> 4);
+
+	if (hdr_len + net_pkt_gso_size(pkt) >= (size_t)count) {
+		return eth_write_data(ctx->dev_fd, ctx->send, count);
+	}
+
+	LOG_DBG("Send pkt %p len %d mss %u", pkt, count,
+		net_pkt_gso_size(pkt));
+
+	set_pseudo_hdr_chksum(ctx->send + l2_len, tcp_hdr, count - csum_start,
+			      ipv6);
+
+	return eth_write_gso_data(ctx->dev_fd, ctx->send, count, hdr_len,
+				  csum_start, net_pkt_gso_size(pkt), ipv6);
+}
+#endif
+
 static int eth_send(struct device *dev, struct net_pkt *pkt)
 {
 	struct eth_context *ctx = dev->driver_data;
 	int count = net_pkt_get_len(pkt);
 	int ret;
 
+	if (count > (int)sizeof(ctx->send)) {
+		return -EMSGSIZE;
+	}
+
 	ret = net_pkt_read(pkt, ctx->send, count);
 	if (ret) {
 		return ret;
@@ -190,7 +264,14 @@ static int eth_send(struct device *dev, struct net_pkt *pkt)
 
 	LOG_DBG("Send pkt %p len %d", pkt, count);
 
-	ret = eth_write_data(ctx->dev_fd, ctx->send, count);
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+	if (net_pkt_gso_size(pkt)) {
+		ret = eth_write_gso(ctx, pkt, count);
+	} else
+#endif
+	{
+		ret = eth_write_data(ctx->dev_fd, ctx->send, count);
+	}
 	if (ret < 0) {
 		LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
 	}
@@ -473,6 +554,9 @@ enum ethernet_hw_caps eth_posix_native_get_capabilities(struct device *dev)
 #endif
 #if defined(CONFIG_NET_LLDP)
 		| ETHERNET_LLDP
+#endif
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+		| ETHERNET_HW_TX_TSO
 #endif
 		;
 }
@@ -23,12 +23,15 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <net/if.h>
+#include <netinet/tcp.h>
 #include <time.h>
 #include "posix_trace.h"
 
 #ifdef __linux
 #include <linux/if_tun.h>
+#include <linux/virtio_net.h>
 #endif
 
 /* Zephyr include files. Be very careful here and only include minimum
@@ -67,6 +70,14 @@ int eth_iface_create(const char *if_name, bool tun_only)
 #ifdef __linux
 	ifr.ifr_flags = (tun_only ? IFF_TUN : IFF_TAP) | IFF_NO_PI;
 
+	/* Every frame is preceded by a virtio_net_hdr so that the kernel
+	 * can segment what we send. The kernel never sends us GSO frames
+	 * as TUNSETOFFLOAD is left alone.
+	 */
+	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_TSO)) {
+		ifr.ifr_flags |= IFF_VNET_HDR;
+	}
+
 	strncpy(ifr.ifr_name, if_name, IFNAMSIZ - 1);
 
 	ret = ioctl(fd, TUNSETIFF, (void *)&ifr);
@@ -165,6 +176,71 @@ int eth_wait_data(int fd)
 	return -EAGAIN;
 }
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+static ssize_t vnet_write(int fd, struct virtio_net_hdr *hdr,
+			  void *buf, size_t buf_len)
+{
+	struct iovec iov[2] = {
+		{ .iov_base = hdr, .iov_len = sizeof(*hdr) },
+		{ .iov_base = buf, .iov_len = buf_len },
+	};
+	ssize_t ret;
+
+	ret = writev(fd, iov, 2);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret < (ssize_t)sizeof(*hdr) ? 0 : ret - sizeof(*hdr);
+}
+
+ssize_t eth_read_data(int fd, void *buf, size_t buf_len)
+{
+	struct virtio_net_hdr hdr;
+	struct iovec iov[2] = {
+		{ .iov_base = &hdr, .iov_len = sizeof(hdr) },
+		{ .iov_base = buf, .iov_len = buf_len },
+	};
+	ssize_t ret;
+
+	ret = readv(fd, iov, 2);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret < (ssize_t)sizeof(hdr) ? 0 : ret - sizeof(hdr);
+}
+
+ssize_t eth_write_data(int fd, void *buf, size_t buf_len)
+{
+	struct virtio_net_hdr hdr;
+
+	(void)memset(&hdr, 0, sizeof(hdr));
+
+	return vnet_write(fd, &hdr, buf, buf_len);
+}
+
+ssize_t eth_write_gso_data(int fd, void *buf, size_t buf_len,
+			   size_t hdr_len, size_t csum_start, u16_t gso_size,
+			   bool ipv6)
+{
+	struct virtio_net_hdr hdr;
+
+	/* The TCP checksum field holds the pseudo header sum, the kernel
+	 * completes it for each segment, see tcp_gso_segment().
+	 */
+	(void)memset(&hdr, 0, sizeof(hdr));
+	hdr.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+	hdr.csum_start = csum_start;
+	hdr.csum_offset = offsetof(struct tcphdr, check);
+	hdr.gso_type = ipv6 ? VIRTIO_NET_HDR_GSO_TCPV6 :
+		VIRTIO_NET_HDR_GSO_TCPV4;
+	hdr.hdr_len = hdr_len;
+	hdr.gso_size = gso_size;
+
+	return vnet_write(fd, &hdr, buf, buf_len);
+}
+#else
 ssize_t eth_read_data(int fd, void *buf, size_t buf_len)
 {
 	return read(fd, buf, buf_len);
@@ -174,6 +250,7 @@ ssize_t eth_write_data(int fd, void *buf, size_t buf_len)
 {
 	return write(fd, buf, buf_len);
 }
+#endif /* CONFIG_ETH_NATIVE_POSIX_TSO */
 
 #if defined(CONFIG_NET_GPTP)
 int eth_clock_gettime(struct net_ptp_time *time)
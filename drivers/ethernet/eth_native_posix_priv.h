@@ -32,6 +32,11 @@ int eth_start_script(const char *if_name);
 int eth_wait_data(int fd);
 ssize_t eth_read_data(int fd, void *buf, size_t buf_len);
 ssize_t eth_write_data(int fd, void *buf, size_t buf_len);
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+ssize_t eth_write_gso_data(int fd, void *buf, size_t buf_len,
+			   size_t hdr_len, size_t csum_start, u16_t gso_size,
+			   bool ipv6);
+#endif
 int eth_if_up(const char *if_name);
 int eth_if_down(const char *if_name);
 
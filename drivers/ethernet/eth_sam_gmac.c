@@ -118,6 +118,9 @@ static struct net_pkt *tx_frame_list_que2[CONFIG_NET_PKT_TX_COUNT + 1];
 
 #define MODULO_INC(val, max) {val = (++val < max) ? val : 0; }
 
+/* Max number of received frames passed up in one net_recv_data_burst() */
+#define RX_BURST_LEN 8
+
 /*
  * Cache helpers
  */
@@ -1198,13 +1201,32 @@ static struct net_pkt *frame_get(struct gmac_queue *queue)
 	return rx_frame;
 }
 
+static void rx_burst_flush(struct net_if *iface, struct net_pkt **burst,
+			   size_t count)
+{
+	int ret;
+	size_t i;
+
+	ret = net_recv_data_burst(iface, burst, count);
+
+	/* Frames not taken are ours to drop */
+	for (i = ret < 0 ? 0 : ret; i < count; i++) {
+		eth_stats_update_errors_rx(iface);
+		net_pkt_unref(burst[i]);
+	}
+}
+
 static void eth_rx(struct gmac_queue *queue)
 {
 	struct eth_sam_dev_data *dev_data =
 		CONTAINER_OF(queue, struct eth_sam_dev_data,
 			     queue_list[queue->que_idx]);
 	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
+	struct net_pkt *burst[RX_BURST_LEN];
+	struct net_if *burst_iface = NULL;
 	struct net_pkt *rx_frame;
+	struct net_if *iface;
+	size_t count = 0;
 #if defined(CONFIG_PTP_CLOCK_SAM_GMAC)
 	struct device *const dev = net_if_get_device(dev_data->iface);
 	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
@@ -1258,15 +1280,25 @@ static void eth_rx(struct gmac_queue *queue)
 		}
 #endif /* CONFIG_PTP_CLOCK_SAM_GMAC */
 
-		if (net_recv_data(get_iface(dev_data, vlan_tag),
-				  rx_frame) < 0) {
-			eth_stats_update_errors_rx(get_iface(dev_data,
-							     vlan_tag));
-			net_pkt_unref(rx_frame);
+		/* Frames are passed up together as long as they belong to
+		 * the same interface.
+		 */
+		iface = get_iface(dev_data, vlan_tag);
+		if (count && (iface != burst_iface ||
+			      count == ARRAY_SIZE(burst))) {
+			rx_burst_flush(burst_iface, burst, count);
+			count = 0;
 		}
 
+		burst_iface = iface;
+		burst[count++] = rx_frame;
+
 		rx_frame = frame_get(queue);
 	}
+
+	if (count) {
+		rx_burst_flush(burst_iface, burst, count);
+	}
 }
 
 #if !defined(CONFIG_ETH_SAM_GMAC_FORCE_QUEUE) && \
@@ -1290,11 +1322,13 @@ static int priority2queue(enum net_priority priority)
 }
 #endif
 
-static int eth_tx(struct device *dev, struct net_pkt *pkt)
+/* Fills in the descriptors of one frame and gives them to the controller,
+ * which is then to be started with GMAC_NCR_TSTART.
+ */
+static int tx_enqueue(struct device *dev, struct net_pkt *pkt,
+		      struct gmac_queue **pkt_queue, u32_t *err_count)
 {
-	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
 	struct eth_sam_dev_data *const dev_data = DEV_DATA(dev);
-	Gmac *gmac = cfg->regs;
 	struct gmac_queue *queue;
 	struct gmac_desc_list *tx_desc_list;
 	struct gmac_desc *tx_desc;
@@ -1304,18 +1338,11 @@ static int eth_tx(struct device *dev, struct net_pkt *pkt)
 	u16_t frag_len;
 	u32_t err_tx_flushed_count_at_entry;
 #if GMAC_MULTIPLE_TX_PACKETS == 1
+	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
+	Gmac *gmac = cfg->regs;
 	unsigned int key;
 #endif
 	u8_t pkt_prio;
-#if GMAC_MULTIPLE_TX_PACKETS == 0
-#if defined(CONFIG_PTP_CLOCK_SAM_GMAC)
-	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
-	struct gptp_hdr *hdr;
-#if defined(CONFIG_NET_VLAN)
-	struct net_eth_hdr *eth_hdr;
-#endif
-#endif
-#endif
 
 	__ASSERT(pkt, "buf pointer is NULL");
 	__ASSERT(pkt->frags, "Frame data missing");
@@ -1339,6 +1366,9 @@ static int eth_tx(struct device *dev, struct net_pkt *pkt)
 	tx_desc_list = &queue->tx_desc_list;
 	err_tx_flushed_count_at_entry = queue->err_tx_flushed_count;
 
+	*pkt_queue = queue;
+	*err_count = err_tx_flushed_count_at_entry;
+
 	frag = pkt->frags;
 
 	/* Keep reference to the descriptor */
@@ -1352,7 +1382,13 @@ static int eth_tx(struct device *dev, struct net_pkt *pkt)
 		dcache_clean((u32_t)frag_data, frag->size);
 
 #if GMAC_MULTIPLE_TX_PACKETS == 1
-		k_sem_take(&queue->tx_desc_sem, K_FOREVER);
+		if (k_sem_take(&queue->tx_desc_sem, K_NO_WAIT) != 0) {
+			/* The ring is full, possibly of frames queued by
+			 * eth_tx_burst() and not started yet.
+			 */
+			gmac->GMAC_NCR |= GMAC_NCR_TSTART;
+			k_sem_take(&queue->tx_desc_sem, K_FOREVER);
+		}
 
 		/* The following section becomes critical and requires IRQ lock
 		 * / unlock protection only due to the possibility of executing
@@ -1442,6 +1478,32 @@ static int eth_tx(struct device *dev, struct net_pkt *pkt)
 	 */
 	__DMB();  /* data memory barrier */
 
+	return 0;
+}
+
+static int eth_tx(struct device *dev, struct net_pkt *pkt)
+{
+	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
+	Gmac *gmac = cfg->regs;
+	struct gmac_queue *queue;
+	u32_t err_tx_flushed_count_at_entry;
+	int ret;
+#if GMAC_MULTIPLE_TX_PACKETS == 0
+#if defined(CONFIG_PTP_CLOCK_SAM_GMAC)
+	struct eth_sam_dev_data *const dev_data = DEV_DATA(dev);
+	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
+	struct gptp_hdr *hdr;
+#if defined(CONFIG_NET_VLAN)
+	struct net_eth_hdr *eth_hdr;
+#endif
+#endif
+#endif
+
+	ret = tx_enqueue(dev, pkt, &queue, &err_tx_flushed_count_at_entry);
+	if (ret < 0) {
+		return ret;
+	}
+
 	/* Start transmission */
 	gmac->GMAC_NCR |= GMAC_NCR_TSTART;
 
@@ -1471,6 +1533,38 @@ static int eth_tx(struct device *dev, struct net_pkt *pkt)
 	return 0;
 }
 
+#if GMAC_MULTIPLE_TX_PACKETS == 1
+/* All the frames are put in the TX rings before transmission is started,
+ * so the controller is kicked once per burst rather than once per frame.
+ */
+static int eth_tx_burst(struct device *dev, struct net_pkt **pkts,
+			size_t count)
+{
+	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
+	u32_t err_tx_flushed_count_at_entry;
+	Gmac *gmac = cfg->regs;
+	struct gmac_queue *queue;
+	int ret = 0;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		ret = tx_enqueue(dev, pkts[i], &queue,
+				 &err_tx_flushed_count_at_entry);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	if (i) {
+		/* Start transmission */
+		gmac->GMAC_NCR |= GMAC_NCR_TSTART;
+		ret = i;
+	}
+
+	return ret;
+}
+#endif
+
 static void queue0_isr(void *arg)
 {
 	struct device *const dev = (struct device *const)arg;
@@ -1926,6 +2020,9 @@ static const struct ethernet_api eth_api = {
 	.set_config = eth_sam_gmac_set_config,
 	.get_config = eth_sam_gmac_get_config,
 	.send = eth_tx,
+#if GMAC_MULTIPLE_TX_PACKETS == 1
+	.send_burst = eth_tx_burst,
+#endif
 
 #if defined(CONFIG_PTP_CLOCK_SAM_GMAC)
 	.get_ptp_clock = eth_sam_gmac_get_ptp_clock,
@@ -453,6 +453,11 @@ struct _thread_base {
 	/* CPU index on which thread was last run */
 	u8_t cpu;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU whose ready queue holds the thread while it is queued */
+	u8_t runq_cpu;
+#endif
+
 	/* Recursive count of irq_lock() calls */
 	u8_t global_lock_count;
 
@@ -508,6 +513,35 @@ struct _thread_userspace_local_data {
 };
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+/** Number of buckets in a scheduling statistics histogram */
+#define K_SCHED_STATS_BUCKETS 16
+
+/**
+ * @ingroup thread_apis
+ * @brief Scheduling statistics of a thread or a priority level
+ *
+ * All times are in hardware cycles, as returned by k_cycle_get_32().
+ * Histogram bucket 0 counts times below 16 cycles, bucket N counts
+ * times from 2^(N + 3) to 2^(N + 4) - 1 cycles, and the last bucket
+ * also counts everything longer.
+ */
+struct k_sched_stats {
+	/** Time from being made ready to running */
+	u32_t wait_hist[K_SCHED_STATS_BUCKETS];
+	/** Time run before switching out */
+	u32_t run_hist[K_SCHED_STATS_BUCKETS];
+	/** Longest time from being made ready to running */
+	u32_t wait_max;
+	/** Longest time run before switching out */
+	u32_t run_max;
+	/** Number of times switched in */
+	u32_t switches;
+	/** Number of times switched out while still ready */
+	u32_t preemptions;
+};
+#endif
+
 /**
  * @ingroup thread_apis
  * Thread Structure
@@ -580,6 +614,13 @@ struct k_thread {
 	/** Context handle returned via z_arch_switch() */
 	void *switch_handle;
 #endif
+#ifdef CONFIG_SCHED_STATS
+	/** scheduling statistics */
+	struct k_sched_stats sched_stats;
+	u32_t sched_ready_stamp;
+	u32_t sched_run_stamp;
+#endif
+
 	/** resource pool */
 	struct k_mem_pool *resource_pool;
 
@@ -1337,6 +1378,54 @@ const char *k_thread_name_get(k_tid_t thread_id);
 __syscall int k_thread_name_copy(k_tid_t thread_id, char *buf,
 				 size_t size);
 
+#ifdef CONFIG_SCHED_STATS
+/**
+ * @brief Get the scheduling statistics of a thread
+ *
+ * Copies the ready-to-running latency and run time histograms, and the
+ * switch and preemption counts, collected for @a thread since it was
+ * created or since the last call to k_sched_stats_reset().
+ *
+ * @param thread Thread to get statistics for
+ * @param stats Destination of the statistics
+ * @retval 0 Success
+ */
+__syscall int k_thread_sched_stats_get(k_tid_t thread,
+				       struct k_sched_stats *stats);
+
+/**
+ * @brief Get the scheduling statistics of a priority level
+ *
+ * Like k_thread_sched_stats_get(), but accumulated over all threads
+ * while they ran at priority @a prio.
+ *
+ * @param prio Priority level, including K_IDLE_PRIO
+ * @param stats Destination of the statistics
+ * @retval 0 Success
+ * @retval -EINVAL Invalid priority level
+ */
+__syscall int k_sched_prio_stats_get(int prio, struct k_sched_stats *stats);
+
+/**
+ * @brief Reset scheduling statistics
+ *
+ * Clears the statistics of every priority level and, with
+ * CONFIG_THREAD_MONITOR, of every thread.
+ */
+void k_sched_stats_reset(void);
+
+/**
+ * @brief Lower bound of a scheduling statistics histogram bucket
+ *
+ * @param bucket Bucket index, less than K_SCHED_STATS_BUCKETS
+ * @return Shortest time counted in @a bucket, in hardware cycles
+ */
+static inline u32_t k_sched_stats_bucket_floor(int bucket)
+{
+	return (bucket == 0) ? 0U : BIT(bucket + 3);
+}
+#endif /* CONFIG_SCHED_STATS */
+
 /**
  * @}
  */
@@ -1557,6 +1646,32 @@ extern void k_timer_init(struct k_timer *timer,
 __syscall void k_timer_start(struct k_timer *timer,
 			     s32_t duration, s32_t period);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Start a timer that may expire late.
+ *
+ * This routine works like k_timer_start(), except that each expiry of
+ * the timer may be delayed by up to @a slack milliseconds.  The kernel
+ * uses the slack to handle expiries of timers, delayed work items and
+ * thread timeouts that fall within it in a single clock interrupt,
+ * saving wakeups from idle.
+ *
+ * Each period is counted from the nominal expiry rather than the one
+ * the slack allowed, so any single expiry of a periodic timer may be
+ * late by up to @a slack milliseconds but the lateness does not add
+ * up from one period to the next.
+ *
+ * @param timer     Address of timer.
+ * @param duration  Initial timer duration (in milliseconds).
+ * @param period    Timer period (in milliseconds).
+ * @param slack     Maximum delay of each expiry (in milliseconds).
+ *
+ * @return N/A
+ */
+__syscall void k_timer_start_slack(struct k_timer *timer, s32_t duration,
+				   s32_t period, s32_t slack);
+#endif
+
 /**
  * @brief Stop a timer.
  *
@@ -2006,6 +2121,29 @@ extern void k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list);
  */
 __syscall void *k_queue_get(struct k_queue *queue, s32_t timeout);
 
+/**
+ * @brief Get several elements from a queue.
+ *
+ * This routine removes up to @a max_items data items from the head of
+ * @a queue under a single lock acquisition and stores their addresses in
+ * @a items, oldest first.  It only waits if the queue is empty, and then
+ * returns as soon as at least one data item is available.  The first
+ * word of each data item is reserved for the kernel's use.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param queue Address of the queue.
+ * @param items Array receiving the addresses of the data items.
+ * @param max_items Size of the @a items array.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items stored in @a items; zero if returned
+ * without waiting, or waiting period timed out.
+ */
+__syscall int k_queue_get_batch(struct k_queue *queue, void **items,
+				int max_items, s32_t timeout);
+
 /**
  * @brief Remove an element from a queue.
  *
@@ -2347,6 +2485,29 @@ struct k_fifo {
 #define k_fifo_get(fifo, timeout) \
 	k_queue_get(&(fifo)->_queue, timeout)
 
+/**
+ * @brief Get several elements from a FIFO queue.
+ *
+ * This routine removes up to @a max_items data items from @a fifo in a
+ * "first in, first out" manner, taking the FIFO's lock only once.  It
+ * only waits if the FIFO is empty.  The first word of each data item is
+ * reserved for the kernel's use.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param fifo Address of the FIFO queue.
+ * @param items Array receiving the addresses of the data items.
+ * @param max_items Size of the @a items array.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items stored in @a items; zero if returned
+ * without waiting, or waiting period timed out.
+ * @req K-FIFO-001
+ */
+#define k_fifo_get_batch(fifo, items, max_items, timeout) \
+	k_queue_get_batch(&(fifo)->_queue, items, max_items, timeout)
+
 /**
  * @brief Query a FIFO queue to see if it has data available.
  *
@@ -2691,6 +2852,33 @@ struct k_work_q {
 	struct k_thread thread;
 };
 
+struct k_work_pool;
+
+struct k_work_pool_worker {
+	struct k_thread thread;
+	struct k_work_pool *pool;
+	struct k_spinlock lock;
+	/* items any worker may run, and items pinned to this one */
+	sys_slist_t shared;
+	sys_slist_t local;
+	_wait_q_t wait_q;
+	bool idle;
+};
+
+struct k_work_pool {
+	struct k_work_pool_worker *workers;
+	k_thread_stack_t *stacks;
+	size_t stack_size;
+	size_t stack_stride;
+	u32_t num_workers;
+	atomic_t next;
+	atomic_t num_idle;
+	/* protects idle workers and the ordered list */
+	struct k_spinlock lock;
+	sys_slist_t ordered;
+	bool ordered_busy;
+};
+
 enum {
 	K_WORK_STATE_PENDING,	/* Work item pending state */
 };
@@ -2709,6 +2897,10 @@ struct k_delayed_work {
 
 extern struct k_work_q k_sys_work_q;
 
+#ifdef CONFIG_SYSTEM_WORK_POOL
+extern struct k_work_pool k_sys_work_pool;
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -3022,6 +3214,55 @@ static inline int k_delayed_work_submit(struct k_delayed_work *work,
 	return k_delayed_work_submit_to_queue(&k_sys_work_q, work, delay);
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Submit a delayed work item to a workqueue, with slack.
+ *
+ * This routine works like k_delayed_work_submit_to_queue(), except that
+ * the work item may be submitted up to @a slack milliseconds after
+ * @a delay has elapsed, so that its countdown can end in the same clock
+ * interrupt as other timeouts.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param work_q Address of workqueue.
+ * @param work Address of delayed work item.
+ * @param delay Delay before submitting the work item (in milliseconds).
+ * @param slack Maximum additional delay (in milliseconds).
+ *
+ * @retval 0 Work item countdown started.
+ * @retval -EINVAL Work item is being processed or has completed its work.
+ * @retval -EADDRINUSE Work item is pending on a different workqueue.
+ */
+extern int k_delayed_work_submit_to_queue_slack(struct k_work_q *work_q,
+						struct k_delayed_work *work,
+						s32_t delay, s32_t slack);
+
+/**
+ * @brief Submit a delayed work item to the system workqueue, with slack.
+ *
+ * This routine works like k_delayed_work_submit(), except that the work
+ * item may be submitted up to @a slack milliseconds after @a delay has
+ * elapsed.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param work Address of delayed work item.
+ * @param delay Delay before submitting the work item (in milliseconds).
+ * @param slack Maximum additional delay (in milliseconds).
+ *
+ * @retval 0 Work item countdown started.
+ * @retval -EINVAL Work item is being processed or has completed its work.
+ * @retval -EADDRINUSE Work item is pending on a different workqueue.
+ */
+static inline int k_delayed_work_submit_slack(struct k_delayed_work *work,
+					      s32_t delay, s32_t slack)
+{
+	return k_delayed_work_submit_to_queue_slack(&k_sys_work_q, work,
+						    delay, slack);
+}
+#endif
+
 /**
  * @brief Get time remaining before a delayed work gets scheduled.
  *
@@ -3039,6 +3280,119 @@ static inline s32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
 	return __ticks_to_ms(z_timeout_remaining(&work->timeout));
 }
 
+#ifdef CONFIG_WORK_POOL
+
+#define Z_WORK_POOL_INITIALIZER(obj, p_workers, p_stacks, p_num_workers, \
+				p_stack_size) \
+	{ \
+	.workers = p_workers, \
+	.stacks = (k_thread_stack_t *)p_stacks, \
+	.stack_size = p_stack_size, \
+	.stack_stride = K_THREAD_STACK_LEN(p_stack_size), \
+	.num_workers = p_num_workers, \
+	.ordered = SYS_SLIST_STATIC_INIT(&obj.ordered), \
+	}
+
+/**
+ * @brief Statically define a work pool.
+ *
+ * A work pool is a workqueue served by several threads.  Each worker
+ * thread has its own queue of work items; idle workers steal items from
+ * busy ones, so one slow handler holds up only the items queued behind
+ * it on its own worker, and only until another worker is free.  The pool
+ * must still be started with k_work_pool_start().
+ *
+ * The pool can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_work_pool <name>; @endcode
+ *
+ * @param name Name of the work pool.
+ * @param num_workers Number of worker threads, usually one per CPU.
+ * @param stack_size Stack size of each worker thread (in bytes).
+ */
+#define K_WORK_POOL_DEFINE(name, num_workers, stack_size) \
+	K_THREAD_STACK_ARRAY_DEFINE(_k_work_pool_stacks_##name, num_workers, \
+				    stack_size); \
+	static struct k_work_pool_worker \
+		_k_work_pool_workers_##name[num_workers]; \
+	struct k_work_pool name = \
+		Z_WORK_POOL_INITIALIZER(name, _k_work_pool_workers_##name, \
+					_k_work_pool_stacks_##name, \
+					num_workers, stack_size)
+
+/**
+ * @brief Start a work pool.
+ *
+ * This routine spawns the worker threads of work pool @a pool, which
+ * run forever.  With CONFIG_SCHED_CPU_MASK on a multiprocessor system,
+ * worker N is pinned to CPU (N % CONFIG_MP_NUM_CPUS).
+ *
+ * @param pool Address of the work pool.
+ * @param prio Priority of the worker threads.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_start(struct k_work_pool *pool, int prio);
+
+/**
+ * @brief Submit a work item to a work pool.
+ *
+ * This routine submits work item @a work to be processed by any worker
+ * of work pool @a pool.  Items submitted by a worker's own handlers are
+ * queued on that worker; others are spread round robin.  Like
+ * k_work_submit_to_queue(), this has no effect on an item that is
+ * already pending.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pool Address of the work pool.
+ * @param work Address of work item.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_submit(struct k_work_pool *pool, struct k_work *work);
+
+/**
+ * @brief Submit a work item to a given worker of a work pool.
+ *
+ * This routine submits work item @a work to be processed by worker
+ * @a worker of work pool @a pool and by no other, e.g. to keep the data
+ * it touches in that worker's CPU cache.  Otherwise this works the same
+ * as k_work_pool_submit().
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pool Address of the work pool.
+ * @param work Address of work item.
+ * @param worker Index of the worker, less than the pool's number of
+ *               workers.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_submit_to_worker(struct k_work_pool *pool,
+					 struct k_work *work, int worker);
+
+/**
+ * @brief Submit an ordered work item to a work pool.
+ *
+ * Work items submitted with this routine to the same work pool are
+ * processed one at a time, in the order they were submitted, by whichever
+ * worker is free.  Use it for handlers that rely on the serial execution
+ * a single threaded workqueue provides.  Otherwise this works the same as
+ * k_work_pool_submit().
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pool Address of the work pool.
+ * @param work Address of work item.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_submit_ordered(struct k_work_pool *pool,
+				       struct k_work *work);
+
+#endif /* CONFIG_WORK_POOL */
+
 /** @} */
 /**
  * @defgroup mutex_apis Mutex APIs
@@ -3469,6 +3823,53 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * This routine sends up to @a num_msgs consecutive messages from @a data
+ * to message queue @a q, taking the queue's lock only once.  Messages go
+ * to waiting receivers first, one each, and the rest are copied into the
+ * queue as long as there is room.  The routine only waits if the queue is
+ * full, and then for room for a single message.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to an array of @a num_msgs messages.
+ * @param num_msgs Number of messages to send.
+ * @param timeout Waiting period to add a message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of messages sent (at least 1), or
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_msgq_put_n(struct k_msgq *q, const void *data,
+			   u32_t num_msgs, s32_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a num_msgs messages from message queue
+ * @a q in a "first in, first out" manner, taking the queue's lock only
+ * once.  Senders waiting for room are let in as space is freed.  The
+ * routine only waits if the queue is empty, and then for a single message.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold @a num_msgs received messages.
+ * @param num_msgs Maximum number of messages to receive.
+ * @param timeout Waiting period to receive a message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of messages received (at least 1), or
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_msgq_get_n(struct k_msgq *q, void *data, u32_t num_msgs,
+			   s32_t timeout);
+
 /**
  * @brief Peek/read a message from a message queue.
  *
@@ -3551,6 +3952,268 @@ static inline u32_t z_impl_k_msgq_num_used_get(struct k_msgq *q)
 
 /** @} */
 
+/**
+ * @defgroup ring_apis Lock-free Ring APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+/* State shared by both ring flavors.  head and tail are free running
+ * record counters (for the MPMC ring: claim counters, see ring.c) and
+ * the record slots are indexed by their low bits, so the capacity must
+ * be a power of two.  The wait queue and lock are touched only when a
+ * reader has to block or a writer has someone to wake.
+ */
+struct z_ring {
+	char *buffer;
+	u32_t rec_size;
+	u32_t mask;
+	atomic_t head;
+	atomic_t tail;
+	atomic_t waiters;
+	_wait_q_t wait_q;
+	struct k_spinlock lock;
+	_POLL_EVENT;
+};
+
+#define Z_RING_INITIALIZER(obj, r_buffer, r_rec_size, r_num_recs) \
+	{ \
+	.buffer = r_buffer, \
+	.rec_size = r_rec_size, \
+	.mask = (r_num_recs) - 1, \
+	.head = ATOMIC_INIT(0), \
+	.tail = ATOMIC_INIT(0), \
+	.waiters = ATOMIC_INIT(0), \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	}
+
+#define Z_RING_CHECK_SIZE(r_name, r_num_recs) \
+	BUILD_ASSERT_MSG((r_num_recs) > 1 && \
+			 ((r_num_recs) & ((r_num_recs) - 1)) == 0, \
+			 #r_name ": number of records must be a power of two")
+
+/* MPMC slots carry a sequence word in front of the record */
+#define Z_MPMC_RING_SLOT_SIZE(rec_size) \
+	(sizeof(atomic_t) + ROUND_UP(rec_size, sizeof(atomic_t)))
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Single producer, single consumer ring
+ *
+ * A bounded FIFO of fixed size records for exactly one writer and one
+ * reader at a time (e.g. an ISR feeding a thread).  Both ends are
+ * lock-free: k_spsc_ring_put() never blocks and costs a copy and two
+ * atomic operations unless the reader is blocked or polling.
+ */
+struct k_spsc_ring {
+	struct z_ring ring;
+};
+
+/**
+ * @brief Multiple producer, multiple consumer ring
+ *
+ * Like struct k_spsc_ring, but any number of threads and ISRs may put
+ * and get concurrently.  Each record slot carries a sequence number,
+ * so neither end ever takes a lock unless a reader has to block.
+ */
+struct k_mpmc_ring {
+	struct z_ring ring;
+};
+
+/**
+ * @brief Size of the buffer needed by an MPMC ring
+ *
+ * @param rec_size Record size (in bytes).
+ * @param num_recs Number of records, a power of two.
+ */
+#define K_MPMC_RING_BUF_SIZE(rec_size, num_recs) \
+	((num_recs) * Z_MPMC_RING_SLOT_SIZE(rec_size))
+
+/**
+ * @brief Statically define and initialize a SPSC ring.
+ *
+ * The ring can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_spsc_ring <name>; @endcode
+ *
+ * @param r_name Name of the ring.
+ * @param r_rec_size Record size (in bytes).
+ * @param r_num_recs Number of records, which must be a power of two.
+ * @param r_align Alignment of the ring's buffer.
+ */
+#define K_SPSC_RING_DEFINE(r_name, r_rec_size, r_num_recs, r_align)	\
+	Z_RING_CHECK_SIZE(r_name, r_num_recs);				\
+	static char __noinit __aligned(r_align)				\
+		_k_spsc_ring_buf_##r_name[(r_num_recs) * (r_rec_size)];	\
+	Z_STRUCT_SECTION_ITERABLE(k_spsc_ring, r_name) = {		\
+		.ring = Z_RING_INITIALIZER(r_name.ring,			\
+					   _k_spsc_ring_buf_##r_name,	\
+					   r_rec_size, r_num_recs)	\
+	}
+
+/**
+ * @brief Statically define and initialize a MPMC ring.
+ *
+ * The ring can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_mpmc_ring <name>; @endcode
+ *
+ * Records are stored at a 4 byte alignment.  Unlike the SPSC ring's,
+ * the buffer is zero initialized, which is its valid empty state.
+ *
+ * @param r_name Name of the ring.
+ * @param r_rec_size Record size (in bytes).
+ * @param r_num_recs Number of records, which must be a power of two.
+ */
+#define K_MPMC_RING_DEFINE(r_name, r_rec_size, r_num_recs)		\
+	Z_RING_CHECK_SIZE(r_name, r_num_recs);				\
+	static char __aligned(sizeof(atomic_t))				\
+		_k_mpmc_ring_buf_##r_name[K_MPMC_RING_BUF_SIZE(r_rec_size, \
+							       r_num_recs)]; \
+	Z_STRUCT_SECTION_ITERABLE(k_mpmc_ring, r_name) = {		\
+		.ring = Z_RING_INITIALIZER(r_name.ring,			\
+					   _k_mpmc_ring_buf_##r_name,	\
+					   r_rec_size, r_num_recs)	\
+	}
+
+/**
+ * @brief Initialize a SPSC ring.
+ *
+ * @param r Address of the ring.
+ * @param buffer Buffer of @a num_recs times @a rec_size bytes.
+ * @param rec_size Record size (in bytes).
+ * @param num_recs Number of records, which must be a power of two.
+ *
+ * @return N/A
+ */
+void k_spsc_ring_init(struct k_spsc_ring *r, void *buffer, size_t rec_size,
+		      u32_t num_recs);
+
+/**
+ * @brief Put a record into a SPSC ring.
+ *
+ * Never blocks.  Only one context may be putting records at a time.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param r Address of the ring.
+ * @param data Pointer to the record.
+ *
+ * @retval 0 Record added.
+ * @retval -ENOMSG The ring is full.
+ */
+__syscall int k_spsc_ring_put(struct k_spsc_ring *r, const void *data);
+
+/**
+ * @brief Get a record from a SPSC ring.
+ *
+ * Only one context may be getting records at a time.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param r Address of the ring.
+ * @param data Address of area to hold the record.
+ * @param timeout Waiting period to receive a record (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Record received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_spsc_ring_get(struct k_spsc_ring *r, void *data,
+			      s32_t timeout);
+
+/**
+ * @brief Get the number of records in a SPSC ring.
+ *
+ * @param r Address of the ring.
+ *
+ * @return Number of records.
+ */
+__syscall u32_t k_spsc_ring_num_used_get(struct k_spsc_ring *r);
+
+static inline u32_t z_impl_k_spsc_ring_num_used_get(struct k_spsc_ring *r)
+{
+	return (u32_t)atomic_get(&r->ring.head) -
+		(u32_t)atomic_get(&r->ring.tail);
+}
+
+/**
+ * @brief Initialize a MPMC ring.
+ *
+ * @param r Address of the ring.
+ * @param buffer Buffer of K_MPMC_RING_BUF_SIZE(@a rec_size, @a num_recs)
+ *               bytes, aligned to 4 bytes.
+ * @param rec_size Record size (in bytes).
+ * @param num_recs Number of records, which must be a power of two.
+ *
+ * @return N/A
+ */
+void k_mpmc_ring_init(struct k_mpmc_ring *r, void *buffer, size_t rec_size,
+		      u32_t num_recs);
+
+/**
+ * @brief Put a record into a MPMC ring.
+ *
+ * Never blocks.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param r Address of the ring.
+ * @param data Pointer to the record.
+ *
+ * @retval 0 Record added.
+ * @retval -ENOMSG The ring is full.
+ */
+__syscall int k_mpmc_ring_put(struct k_mpmc_ring *r, const void *data);
+
+/**
+ * @brief Get a record from a MPMC ring.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param r Address of the ring.
+ * @param data Address of area to hold the record.
+ * @param timeout Waiting period to receive a record (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Record received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_mpmc_ring_get(struct k_mpmc_ring *r, void *data,
+			      s32_t timeout);
+
+/**
+ * @brief Get the number of records in a MPMC ring.
+ *
+ * With concurrent writers this may include records that are still
+ * being copied in and cannot be received yet.
+ *
+ * @param r Address of the ring.
+ *
+ * @return Number of records.
+ */
+__syscall u32_t k_mpmc_ring_num_used_get(struct k_mpmc_ring *r);
+
+static inline u32_t z_impl_k_mpmc_ring_num_used_get(struct k_mpmc_ring *r)
+{
+	return (u32_t)atomic_get(&r->ring.head) -
+		(u32_t)atomic_get(&r->ring.tail);
+}
+
+/** @} */
+
 /**
  * @defgroup mem_pool_apis Memory Pool APIs
  * @ingroup kernel_apis
@@ -3562,11 +4225,18 @@ static inline u32_t z_impl_k_msgq_num_used_get(struct k_msgq *q)
  * to 16M of memory managed by a single pool.  Long term it would be
  * good to move to a variable bit size based on configuration.
  */
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+struct k_mem_block_id {
+	struct k_mem_pool *pool;
+	void *data;
+};
+#else
 struct k_mem_block_id {
 	u32_t pool : 8;
 	u32_t level : 4;
 	u32_t block : 20;
 };
+#endif
 
 struct k_mem_block {
 	void *data;
@@ -3971,10 +4641,22 @@ struct k_mem_slab {
 	char *buffer;
 	char *free_list;
 	u32_t num_used;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* per-CPU magazine index, or -1 */
+	int mag;
+	/* set while threads wait, to flush magazines */
+	atomic_t drain;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 };
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+#define _K_MEM_SLAB_MAG_INIT .mag = -1, .drain = ATOMIC_INIT(0),
+#else
+#define _K_MEM_SLAB_MAG_INIT
+#endif
+
 #define _K_MEM_SLAB_INITIALIZER(obj, slab_buffer, slab_block_size, \
 			       slab_num_blocks) \
 	{ \
@@ -3984,6 +4666,7 @@ struct k_mem_slab {
 	.buffer = slab_buffer, \
 	.free_list = NULL, \
 	.num_used = 0, \
+	_K_MEM_SLAB_MAG_INIT \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -4095,9 +4778,19 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  * @return Number of allocated memory blocks.
  * @req K-MSLAB-002
  */
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+extern u32_t z_mem_slab_num_cached(struct k_mem_slab *slab);
+#else
+static inline u32_t z_mem_slab_num_cached(struct k_mem_slab *slab)
+{
+	ARG_UNUSED(slab);
+	return 0;
+}
+#endif
+
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
-	return slab->num_used;
+	return slab->num_used - z_mem_slab_num_cached(slab);
 }
 
 /**
@@ -4113,7 +4806,7 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /** @} */
@@ -4122,10 +4815,18 @@ static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+struct k_mem_pool {
+	struct sys_heap heap;
+	_wait_q_t wait_q;
+	struct k_spinlock lock;
+};
+#else
 struct k_mem_pool {
 	struct sys_mem_pool_base base;
 	_wait_q_t wait_q;
 };
+#endif
 
 /**
  * INTERNAL_HIDDEN @endcond
@@ -4144,6 +4845,12 @@ struct k_mem_pool {
  * quarters, down to blocks of @a min_size bytes long. The buffer is aligned
  * to a @a align -byte boundary.
  *
+ * With CONFIG_MEM_POOL_HEAP_BACKEND the pool is instead managed by a
+ * sys_heap sized to hold @a n_max blocks of @a max_size bytes, and
+ * allocations of any size are carved from it without rounding up to a
+ * power of four.  @a min_size is ignored and returned blocks are
+ * aligned to 8 bytes.
+ *
  * If the pool is to be accessed outside the module where it is defined, it
  * can be declared via
  *
@@ -4156,6 +4863,17 @@ struct k_mem_pool {
  * @param align Alignment of the pool's buffer (power of 2).
  * @req K-MPOOL-001
  */
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+#define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
+	char __aligned(WB_UP(align))					\
+		_mpool_buf_##name[SYS_HEAP_BUF_SIZE(WB_UP(maxsz), nmax)]; \
+	Z_STRUCT_SECTION_ITERABLE(k_mem_pool, name) = {			\
+		.heap = {						\
+			.init_mem = _mpool_buf_##name,			\
+			.init_bytes = sizeof(_mpool_buf_##name),	\
+		}							\
+	}
+#else
 #define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
 	char __aligned(WB_UP(align)) _mpool_buf_##name[WB_UP(maxsz) * nmax \
 				  + _MPOOL_BITS_SIZE(maxsz, minsz, nmax)]; \
@@ -4171,6 +4889,7 @@ struct k_mem_pool {
 		} \
 	}; \
 	BUILD_ASSERT(WB_UP(maxsz) >= _MPOOL_MINBLK);
+#endif
 
 /**
  * @brief Allocate memory from a memory pool.
@@ -4188,6 +4907,8 @@ struct k_mem_pool {
  *         is set to the starting address of the memory block.
  * @retval -ENOMEM Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL Zero bytes requested from a pool using the heap
+ *         backend (CONFIG_MEM_POOL_HEAP_BACKEND).
  * @req K-MPOOL-002
  */
 extern int k_mem_pool_alloc(struct k_mem_pool *pool, struct k_mem_block *block,
@@ -4314,6 +5035,9 @@ enum _poll_types_bits {
 	/* queue/fifo/lifo data availability */
 	_POLL_TYPE_DATA_AVAILABLE,
 
+	/* SPSC/MPMC ring data availability */
+	_POLL_TYPE_RING_DATA_AVAILABLE,
+
 	_POLL_NUM_TYPES
 };
 
@@ -4366,6 +5090,9 @@ enum _poll_states_bits {
 #define K_POLL_TYPE_SEM_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_SEM_AVAILABLE)
 #define K_POLL_TYPE_DATA_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_DATA_AVAILABLE)
 #define K_POLL_TYPE_FIFO_DATA_AVAILABLE K_POLL_TYPE_DATA_AVAILABLE
+/* for a struct k_spsc_ring or struct k_mpmc_ring object */
+#define K_POLL_TYPE_RING_DATA_AVAILABLE \
+	Z_POLL_TYPE_BIT(_POLL_TYPE_RING_DATA_AVAILABLE)
 
 /* public - polling modes */
 enum k_poll_modes {
@@ -4434,6 +5161,7 @@ struct k_poll_event {
 		struct k_sem *sem;
 		struct k_fifo *fifo;
 		struct k_queue *queue;
+		struct z_ring *ring;
 	};
 };
 
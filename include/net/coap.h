@@ -196,6 +196,15 @@ struct coap_observer {
 	u8_t tkl;
 };
 
+/**
+ * @brief Where an option of a CoAP packet is.
+ */
+struct coap_option_index {
+	u16_t code; /* Option number */
+	u16_t offset; /* Offset of the option value in the packet data */
+	u16_t len; /* Length of the option value */
+};
+
 /**
  * @brief Representation of a CoAP Packet.
  */
@@ -206,6 +215,12 @@ struct coap_packet {
 	u8_t hdr_len; /* CoAP header length */
 	u16_t opt_len; /* Total options length (delta + len + value) */
 	u16_t delta; /* Used for delta calculation in CoAP packet */
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Options of the packet, in ascending order of their numbers */
+	struct coap_option_index opt_index[CONFIG_COAP_OPTION_INDEX_SIZE];
+	u8_t opt_count; /* Number of options in opt_index */
+	bool opt_indexed; /* All the options are in opt_index */
+#endif
 };
 
 struct coap_option {
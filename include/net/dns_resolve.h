@@ -208,6 +208,17 @@ struct dns_resolve_context {
 
 		/** DNS id of this query */
 		u16_t id;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/** Smallest TTL seen so far, CNAME records included */
+		u32_t ttl;
+
+		/** Copy of the query the answer is cached under, as the
+		 * caller's string may not outlive the call. Empty if the
+		 * name is too long to be cached.
+		 */
+		char name[CONFIG_DNS_RESOLVER_CACHE_NAME_LEN + 1];
+#endif
 	} queries[CONFIG_DNS_NUM_CONCUR_QUERIES];
 
 	/** Is this context in use */
@@ -374,6 +385,22 @@ static inline int dns_cancel_addr_info(u16_t dns_id)
 	return dns_resolve_cancel(dns_resolve_get_default(), dns_id);
 }
 
+/**
+ * @brief Forget all the cached DNS answers.
+ *
+ * @details The answers of the resolver are cached for their time to live
+ * if CONFIG_DNS_RESOLVER_CACHE is set. This drops them, for instance
+ * after the DNS servers have been changed, so that the next queries go
+ * to the servers again.
+ */
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+void dns_resolve_cache_flush(void);
+#else
+static inline void dns_resolve_cache_flush(void)
+{
+}
+#endif
+
 /**
  * @}
  */
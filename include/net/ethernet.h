@@ -126,6 +126,9 @@ enum ethernet_hw_caps {
 
 	/** VLAN Tag stripping */
 	ETHERNET_HW_VLAN_TAG_STRIP	= BIT(14),
+
+	/** TCP segmentation offload, see net_pkt_gso_size() */
+	ETHERNET_HW_TX_TSO		= BIT(15),
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -263,6 +266,14 @@ struct ethernet_api {
 
 	/** Send a network packet */
 	int (*send)(struct device *dev, struct net_pkt *pkt);
+
+	/** Send several network packets in one go, optional. Returns the
+	 * number of packets sent from the start of the array, or <0 if
+	 * none was. The packets are left to the caller in both cases, as
+	 * with send().
+	 */
+	int (*send_burst)(struct device *dev, struct net_pkt **pkts,
+			  size_t count);
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -365,6 +365,17 @@ typedef struct float64_value {
 	s64_t val2;
 } float64_value_t;
 
+/**
+ * @brief LwM2M path (obj/obj-instance/resource/resource-instance)
+ */
+struct lwm2m_obj_path {
+	u16_t obj_id;
+	u16_t obj_inst_id;
+	u16_t res_id;
+	u16_t res_inst_id;
+	u8_t  level;  /* 0/1/2/3 = 3 = resource */
+};
+
 /**
  * @brief Create an LwM2M object instance.
  *
@@ -510,6 +521,164 @@ int lwm2m_engine_set_float32(char *pathstr, float32_value_t *value);
  */
 int lwm2m_engine_set_float64(char *pathstr, float64_value_t *value);
 
+/**
+ * @brief Parse a resource path string once for the path based setters
+ *
+ * Resources which are updated often can have their path parsed once and
+ * then be set with lwm2m_engine_set_<type>_by_path(), which skips
+ * parsing the path string on every call.
+ *
+ * @param[in] pathstr LwM2M resource path string (obj/obj-instance/resource)
+ * @param[out] path Parsed LwM2M path
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_parse_path(char *pathstr, struct lwm2m_obj_path *path);
+
+/**
+ * @brief Set resource value (opaque buffer) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] data_ptr Data buffer
+ * @param[in] data_len Length of buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_opaque_by_path(const struct lwm2m_obj_path *path,
+				char *data_ptr, u16_t data_len);
+
+/**
+ * @brief Set resource value (string) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] data_ptr NULL terminated char buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_string_by_path(const struct lwm2m_obj_path *path,
+				char *data_ptr);
+
+/**
+ * @brief Set resource value (u8) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value u8 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_u8_by_path(const struct lwm2m_obj_path *path,
+				u8_t value);
+
+/**
+ * @brief Set resource value (u16) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value u16 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_u16_by_path(const struct lwm2m_obj_path *path,
+				u16_t value);
+
+/**
+ * @brief Set resource value (u32) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value u32 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_u32_by_path(const struct lwm2m_obj_path *path,
+				u32_t value);
+
+/**
+ * @brief Set resource value (u64) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value u64 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_u64_by_path(const struct lwm2m_obj_path *path,
+				u64_t value);
+
+/**
+ * @brief Set resource value (s8) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value s8 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_s8_by_path(const struct lwm2m_obj_path *path,
+				s8_t value);
+
+/**
+ * @brief Set resource value (s16) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value s16 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_s16_by_path(const struct lwm2m_obj_path *path,
+				s16_t value);
+
+/**
+ * @brief Set resource value (s32) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value s32 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_s32_by_path(const struct lwm2m_obj_path *path,
+				s32_t value);
+
+/**
+ * @brief Set resource value (s64) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value s64 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_s64_by_path(const struct lwm2m_obj_path *path,
+				s64_t value);
+
+/**
+ * @brief Set resource value (bool) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value bool value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_bool_by_path(const struct lwm2m_obj_path *path,
+				bool value);
+
+/**
+ * @brief Set resource value (32-bit float structure) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value 32-bit float value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_float32_by_path(const struct lwm2m_obj_path *path,
+				float32_value_t *value);
+
+/**
+ * @brief Set resource value (64-bit float structure) using a parsed path
+ *
+ * @param[in] path LwM2M path parsed by lwm2m_engine_parse_path()
+ * @param[in] value 64-bit float value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_float64_by_path(const struct lwm2m_obj_path *path,
+				float64_value_t *value);
+
 /**
  * @brief Get resource value (opaque buffer)
  *
@@ -267,6 +267,11 @@ struct net_context {
 	/** TLS context information */
 	struct tls_context *tls;
 #endif /* CONFIG_NET_SOCKETS_SOCKOPT_TLS */
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** Registrations of this socket with epoll instances */
+	sys_dlist_t epoll_items;
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -851,6 +856,60 @@ int net_context_sendto(struct net_context *context,
 		       s32_t timeout,
 		       void *user_data);
 
+/**
+ * @brief Send data gathered from several buffers.
+ *
+ * @details This works like net_context_sendto(), or like
+ * net_context_send() when msghdr has no destination address, but the
+ * data is gathered from the iovecs of msghdr straight into the network
+ * packet, so the caller does not need to assemble it in one buffer
+ * first. This is similar as BSD sendmsg() function.
+ *
+ * @param context The network context to use.
+ * @param msghdr Data buffers, and the optional destination address.
+ * @param flags Flags for the send, currently unused.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Timeout for the connection. Possible values
+ * are K_FOREVER, K_NO_WAIT, >0.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_sendmsg(struct net_context *context,
+			const struct msghdr *msghdr,
+			int flags,
+			net_context_send_cb_t cb,
+			s32_t timeout,
+			void *user_data);
+
+/**
+ * @brief Send several messages.
+ *
+ * @details This sends each message of @a msgvec as if by
+ * net_context_sendmsg(), but takes the context lock only once, and
+ * stores the number of bytes sent for each message in its msg_len.
+ * Sending stops at the first message that fails.
+ *
+ * @param context The network context to use.
+ * @param msgvec Messages to send.
+ * @param vlen Number of messages in @a msgvec.
+ * @param flags Flags for the send, currently unused.
+ * @param cb Caller-supplied callback function, called for each message.
+ * @param timeout Timeout for each message. Possible values
+ * are K_FOREVER, K_NO_WAIT, >0.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return number of messages sent, or a negative errno if the first
+ * message could not be sent
+ */
+int net_context_sendmmsg(struct net_context *context,
+			 struct mmsghdr *msgvec,
+			 unsigned int vlen,
+			 int flags,
+			 net_context_send_cb_t cb,
+			 s32_t timeout,
+			 void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
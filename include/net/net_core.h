@@ -86,6 +86,22 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by a network device driver to push up several received
+ * network packets at once, such as all the frames found in its RX ring on
+ * one interrupt. Interface checks are done once, and packets that go to
+ * the same RX queue one after the other are queued in one operation.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of received network packets.
+ * @param count Number of packets in the array.
+ *
+ * @return Number of packets taken, starting from the first one, <0 if
+ * none was. The caller still owns the packets that were not taken.
+ */
+int net_recv_data_burst(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
 /**
  * @brief Send data to network.
  *
@@ -223,6 +239,15 @@ void net_analyze_stack(const char *name, const char *stack, size_t size);
 #define NET_TC_COUNT 1
 #endif /* CONFIG_NET_TC_TX_COUNT && CONFIG_NET_TC_RX_COUNT */
 
+#if defined(CONFIG_NET_RX_RSS_QUEUES)
+#define NET_RX_RSS_QUEUES CONFIG_NET_RX_RSS_QUEUES
+#else
+#define NET_RX_RSS_QUEUES 1
+#endif
+
+/* Each Rx traffic class is spread over NET_RX_RSS_QUEUES queues */
+#define NET_RX_QUEUE_COUNT (NET_TC_RX_COUNT * NET_RX_RSS_QUEUES)
+
 /* @endcond */
 
 /**
@@ -264,6 +264,29 @@ struct sockaddr {
 	char data[NET_SOCKADDR_MAX_SIZE - sizeof(sa_family_t)];
 };
 
+/** Buffer description for scatter/gather I/O. */
+struct iovec {
+	void  *iov_base;
+	size_t iov_len;
+};
+
+/** Message header for sendmsg() and recvmsg(). */
+struct msghdr {
+	void         *msg_name;       /**< Optional socket address */
+	socklen_t     msg_namelen;    /**< Size of the socket address */
+	struct iovec *msg_iov;        /**< Scatter/gather array */
+	size_t        msg_iovlen;     /**< Number of elements in msg_iov */
+	void         *msg_control;    /**< Ancillary data, unused */
+	size_t        msg_controllen; /**< Ancillary data buffer length */
+	int           msg_flags;      /**< Flags on received message */
+};
+
+/** Message header for sendmmsg() and recvmmsg(). */
+struct mmsghdr {
+	struct msghdr msg_hdr;        /**< Message */
+	unsigned int  msg_len;        /**< Number of bytes transferred */
+};
+
 /** @cond INTERNAL_HIDDEN */
 
 struct sockaddr_ptr {
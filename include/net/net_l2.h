@@ -37,6 +37,9 @@ enum net_l2_flags {
 
 	/** Is promiscuous mode supported */
 	NET_L2_PROMISC_MODE			= BIT(2),
+
+	/** TCP packets longer than the MTU are segmented below IP */
+	NET_L2_TCP_GSO				= BIT(3),
 } __packed;
 
 /**
@@ -110,6 +110,12 @@ struct net_pkt {
 	sys_snode_t sent_list;
 #endif
 
+#if defined(CONFIG_NET_TCP_GSO)
+	u16_t gso_size;		/* Segment size the TCP payload is cut at
+				 * below IP, 0 if not to be segmented.
+				 */
+#endif
+
 	u8_t ip_hdr_len;	/* pre-filled in order to avoid func call */
 
 	u8_t overwrite  : 1;	/* Is packet content being overwritten? */
@@ -135,6 +141,10 @@ struct net_pkt {
 				 * Used only if defined(CONFIG_NET_ROUTE)
 				 */
 	u8_t family     : 3;	/* IPv4 vs IPv6 */
+	u8_t chksum_done : 1;	/* L4 checksum of an incoming packet is
+				 * already verified.
+				 * Used only if defined(CONFIG_NET_TCP_GRO)
+				 */
 
 	union {
 		u8_t ipv4_auto_arp_msg : 1; /* Is this pkt IPv4 autoconf ARP
@@ -341,6 +351,42 @@ static inline bool net_pkt_forwarding(struct net_pkt *pkt)
 }
 #endif
 
+static inline bool net_pkt_is_chksum_done(struct net_pkt *pkt)
+{
+	return !!(pkt->chksum_done);
+}
+
+static inline void net_pkt_set_chksum_done(struct net_pkt *pkt,
+					   bool is_chksum_done)
+{
+	pkt->chksum_done = is_chksum_done;
+}
+
+#if defined(CONFIG_NET_TCP_GSO)
+static inline u16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	return pkt->gso_size;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, u16_t size)
+{
+	pkt->gso_size = size;
+}
+#else
+static inline u16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, u16_t size)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(size);
+}
+#endif
+
 #if defined(CONFIG_NET_IPV4)
 static inline u8_t net_pkt_ipv4_ttl(struct net_pkt *pkt)
 {
@@ -1613,6 +1659,22 @@ int net_pkt_update_length(struct net_pkt *pkt, size_t length);
  */
 int net_pkt_pull(struct net_pkt *pkt, size_t length);
 
+/**
+ * @brief Make the start of a packet contiguous
+ *
+ * @details Data of the following buffers is moved into the first one, so
+ *          that it holds at least the first @a length bytes of the packet,
+ *          or all of it if the packet is shorter. Headers in that range can
+ *          then be accessed in place. The packet cursor must be initialized
+ *          again afterwards.
+ *
+ * @param pkt    Network packet
+ * @param length Number of bytes needed in the first buffer
+ *
+ * @return 0 on success, -ENOBUFS if the first buffer is too small.
+ */
+int net_pkt_pullup(struct net_pkt *pkt, size_t length);
+
 /**
  * @brief Get the actual offset in the packet from its cursor
  *
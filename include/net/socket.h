@@ -52,8 +52,38 @@ struct zsock_pollfd {
 /** zsock_poll: Invalid socket (output value only) */
 #define ZSOCK_POLLNVAL 0x20
 
+/** Data stored with a socket registered in an epoll instance */
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	u32_t u32;
+	u64_t u64;
+} zsock_epoll_data_t;
+
+struct zsock_epoll_event {
+	u32_t events;
+	zsock_epoll_data_t data;
+};
+
+/* ZSOCK_EPOLL* values are compatible with Linux */
+/** zsock_epoll: Socket is readable */
+#define ZSOCK_EPOLLIN 0x001
+/** zsock_epoll: Socket is writable */
+#define ZSOCK_EPOLLOUT 0x004
+/** zsock_epoll_ctl: Report readiness only when it changes */
+#define ZSOCK_EPOLLET (1U << 31)
+
+/** zsock_epoll_ctl: Register a socket */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Unregister a socket */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events or data of a registered socket */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
 /** zsock_recv: Read data without removing it from socket input queue */
 #define ZSOCK_MSG_PEEK 0x02
+/** zsock_recvmsg: Datagram was longer than the buffers (in msg_flags) */
+#define ZSOCK_MSG_TRUNC 0x20
 /** zsock_recv/zsock_send: Override operation to non-blocking */
 #define ZSOCK_MSG_DONTWAIT 0x40
 
@@ -119,9 +149,39 @@ struct zsock_pollfd {
  *    - 1 - server
  */
 #define TLS_DTLS_ROLE 6
+/** Socket option to enable resumption of TLS sessions. This option accepts
+ *  and returns an integer:
+ *    - TLS_SESSION_CACHE_DISABLED - full handshake on every connection
+ *    - TLS_SESSION_CACHE_ENABLED - a client keeps the session established
+ *      with a hostname set with TLS_HOSTNAME and offers it when connecting
+ *      to that hostname again with the same TLS_SEC_TAG_LIST and
+ *      TLS_PEER_VERIFY, a server lets its clients resume their sessions,
+ *      by session ID or session ticket
+ *
+ *  Sessions are disabled by default. This requires
+ *  CONFIG_NET_SOCKETS_TLS_SESSION_CACHE.
+ */
+#define TLS_SESSION_CACHE 7
+/** Write-only socket option to drop all the sessions cached by the TLS
+ *  clients. The option value is ignored.
+ */
+#define TLS_SESSION_CACHE_PURGE 8
+/** Socket option to export and import TLS client sessions. Reading it on
+ *  a connected client socket returns the session in a serialized form.
+ *  Setting it on a client socket with a hostname set with TLS_HOSTNAME
+ *  caches the given session for the next connection to that hostname
+ *  with the credentials and peer verification level of the socket,
+ *  for instance one saved before going to sleep. This requires
+ *  CONFIG_NET_SOCKETS_TLS_SESSION_CACHE and mbedTLS 2.19 or newer.
+ */
+#define TLS_SESSION 9
 
 /** @} */
 
+/* Valid values for TLS_SESSION_CACHE option */
+#define TLS_SESSION_CACHE_DISABLED 0
+#define TLS_SESSION_CACHE_ENABLED 1
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -304,6 +364,114 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+/**
+ * @brief Send data gathered from several buffers
+ *
+ * @details
+ * @rst
+ * See `POSIX.1-2017 article
+ * <http://pubs.opengroup.org/onlinepubs/9699919799/functions/sendmsg.html>`__
+ * for normative description. The data is gathered directly into the
+ * network packet. Ancillary data is not supported.
+ * This function is also exposed as ``sendmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
+				int flags);
+
+/**
+ * @brief Receive data into several buffers
+ *
+ * @details
+ * @rst
+ * See `POSIX.1-2017 article
+ * <http://pubs.opengroup.org/onlinepubs/9699919799/functions/recvmsg.html>`__
+ * for normative description. Ancillary data is not supported, and
+ * ``msg_controllen`` is always set to 0. A datagram longer than the
+ * buffers sets ``ZSOCK_MSG_TRUNC`` in ``msg_flags``.
+ * This function is also exposed as ``recvmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall ssize_t zsock_recvmsg(int sock, struct msghdr *msg, int flags);
+
+/**
+ * @brief Send several messages with one call
+ *
+ * @details
+ * @rst
+ * Works like calling :c:func:`zsock_sendmsg` for each entry of
+ * ``msgvec``, storing the number of bytes sent in its ``msg_len``. For
+ * a native UDP socket the context is locked once for the whole batch.
+ * Sending stops at the first message that fails.
+ * This function is also exposed as ``sendmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent, or -1 with errno set if the first
+ * one could not be sent.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive several messages with one call
+ *
+ * @details
+ * @rst
+ * Works like calling :c:func:`zsock_recvmsg` for each entry of
+ * ``msgvec``, storing the number of bytes received in its ``msg_len``.
+ * Only the first message is waited for, as with Linux's
+ * ``MSG_WAITFORONE``; after it, only messages already queued are
+ * returned. There is no timeout argument; use ``ZSOCK_MSG_DONTWAIT``
+ * or poll() instead. For a native UDP socket the queued
+ * datagrams are dequeued in batches.
+ * This function is also exposed as ``recvmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages received, or -1 with errno set if none
+ * was.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive data without copying it
+ *
+ * @details Works like zsock_recvmsg(), except that instead of copying
+ * data into the buffers of @a msg, the iovecs are pointed at the
+ * network buffers holding the data, one per buffer fragment, and
+ * msg_iovlen is set to the number used. The fragments stay valid, and
+ * hold a reference on the packet, until zsock_recvmsg_zc_release() is
+ * called with the returned token, even if the socket is closed.
+ *
+ * For a stream socket, data that does not fit in the iovecs is left
+ * for the next read. For a datagram socket it is discarded and
+ * ZSOCK_MSG_TRUNC is set. Only native TCP and UDP sockets are
+ * supported, and the call is not available from user mode as the
+ * buffers belong to the kernel.
+ *
+ * @param sock Socket
+ * @param msg Message header; msg_iov must have room for at least one
+ * iovec, whose contents are overwritten.
+ * @param flags ZSOCK_MSG_PEEK and ZSOCK_MSG_DONTWAIT are supported.
+ * @param token Filled in with the token to release the data with.
+ *
+ * @return Number of bytes received, or -1 with errno set. No token is
+ * returned when 0 (end of stream) or -1 is returned.
+ */
+ssize_t zsock_recvmsg_zc(int sock, struct msghdr *msg, int flags,
+			 void **token);
+
+/**
+ * @brief Release data received with zsock_recvmsg_zc()
+ *
+ * @param token Token returned by zsock_recvmsg_zc().
+ */
+void zsock_recvmsg_zc_release(void *token);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -334,6 +502,76 @@ __syscall int zsock_fcntl(int sock, int cmd, int flags);
  */
 __syscall int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
 
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * An epoll instance holds a set of registered sockets, and keeps track
+ * of which of them became ready as it happens, so that
+ * :c:func:`zsock_epoll_wait` costs in proportion to the number of ready
+ * sockets rather than to the number of registered ones. The instance
+ * is a file descriptor, released with :c:func:`zsock_close`. Only
+ * native TCP and UDP sockets can be registered.
+ * See the Linux ``epoll(7)`` manual page for a description of the
+ * interface.
+ * This function is also exposed as ``epoll_create()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param size Ignored, but must be greater than zero.
+ *
+ * @return File descriptor of the instance, or -1 with errno set.
+ */
+__syscall int zsock_epoll_create(int size);
+
+/**
+ * @brief Add, modify or remove a socket of an epoll instance
+ *
+ * @details
+ * @rst
+ * ``event->events`` is a combination of ``ZSOCK_EPOLLIN`` and
+ * ``ZSOCK_EPOLLOUT``, optionally with ``ZSOCK_EPOLLET`` to select edge
+ * triggered mode, where a socket is reported once each time it becomes
+ * ready instead of every time it is waited for while ready.
+ * ``event->data`` is returned as is by :c:func:`zsock_epoll_wait`.
+ * Closing a socket removes it from all instances.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd epoll instance
+ * @param op ZSOCK_EPOLL_CTL_ADD, ZSOCK_EPOLL_CTL_MOD or
+ * ZSOCK_EPOLL_CTL_DEL
+ * @param fd Socket
+ * @param event Events and data, ignored (and may be NULL) for
+ * ZSOCK_EPOLL_CTL_DEL
+ *
+ * @return 0, or -1 with errno set.
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int fd,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for sockets of an epoll instance to become ready
+ *
+ * @details
+ * @rst
+ * This function is also exposed as ``epoll_wait()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd epoll instance
+ * @param events Filled in with the ready sockets
+ * @param maxevents Size of @a events, greater than zero
+ * @param timeout Timeout in milliseconds, or -1 to wait forever
+ *
+ * @return Number of entries filled in, 0 on timeout, or -1 with errno
+ * set.
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
 /**
  * @brief Get various socket options
  *
@@ -539,6 +777,8 @@ int zsock_getnameinfo(const struct sockaddr *addr, socklen_t addrlen,
 #if defined(CONFIG_NET_SOCKETS_POSIX_NAMES)
 
 #define pollfd zsock_pollfd
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
 
 #if !defined(CONFIG_NET_SOCKETS_OFFLOAD)
 static inline int socket(int family, int type, int proto)
@@ -603,11 +843,50 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline ssize_t sendmsg(int sock, const struct msghdr *msg, int flags)
+{
+	return zsock_sendmsg(sock, msg, flags);
+}
+
+static inline ssize_t recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg(sock, msg, flags);
+}
+
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
 }
 
+static inline int epoll_create(int size)
+{
+	return zsock_epoll_create(size);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
 static inline int getsockopt(int sock, int level, int optname,
 			     void *optval, socklen_t *optlen)
 {
@@ -700,7 +979,15 @@ static inline int inet_pton(sa_family_t family, const char *src, void *dst)
 #define POLLHUP ZSOCK_POLLHUP
 #define POLLNVAL ZSOCK_POLLNVAL
 
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLET ZSOCK_EPOLLET
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
 #define MSG_PEEK ZSOCK_MSG_PEEK
+#define MSG_TRUNC ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 
 #define SHUT_RD ZSOCK_SHUT_RD
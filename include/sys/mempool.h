@@ -9,8 +9,19 @@
 
 #include <kernel.h>
 #include <sys/mempool_base.h>
+#include <sys/sys_heap.h>
 #include <sys/mutex.h>
 
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+struct sys_mem_pool {
+	struct sys_heap heap;
+	struct sys_mutex mutex;
+};
+
+struct sys_mem_pool_block {
+	struct sys_mem_pool *pool;
+};
+#else
 struct sys_mem_pool {
 	struct sys_mem_pool_base base;
 	struct sys_mutex mutex;
@@ -21,6 +32,7 @@ struct sys_mem_pool_block {
 	u32_t level : 4;
 	u32_t block : 28;
 };
+#endif
 
 /**
  * @brief Statically define system memory pool
@@ -46,6 +58,17 @@ struct sys_mem_pool_block {
  * @param align Alignment of the pool's buffer (power of 2).
  * @param section Destination binary section for pool data
  */
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+#define SYS_MEM_POOL_DEFINE(name, ignored, minsz, maxsz, nmax, align, section) \
+	char __aligned(WB_UP(align)) Z_GENERIC_SECTION(section)		\
+		_mpool_buf_##name[SYS_HEAP_BUF_SIZE(WB_UP(maxsz), nmax)]; \
+	Z_GENERIC_SECTION(section) struct sys_mem_pool name = {		\
+		.heap = {						\
+			.init_mem = _mpool_buf_##name,			\
+			.init_bytes = sizeof(_mpool_buf_##name),	\
+		}							\
+	}
+#else
 #define SYS_MEM_POOL_DEFINE(name, ignored, minsz, maxsz, nmax, align, section) \
 	BUILD_ASSERT(WB_UP(maxsz) >= _MPOOL_MINBLK);			\
 	char __aligned(WB_UP(align)) Z_GENERIC_SECTION(section)		\
@@ -63,6 +86,7 @@ struct sys_mem_pool_block {
 			.flags = SYS_MEM_POOL_USER			\
 		}							\
 	}
+#endif
 
 /**
  * @brief Initialize a memory pool
@@ -74,7 +98,11 @@ struct sys_mem_pool_block {
  */
 static inline void sys_mem_pool_init(struct sys_mem_pool *p)
 {
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+	sys_heap_init(&p->heap, p->heap.init_mem, p->heap.init_bytes);
+#else
 	z_sys_mem_pool_base_init(&p->base);
+#endif
 }
 
 /**
@@ -99,4 +127,16 @@ void *sys_mem_pool_alloc(struct sys_mem_pool *p, size_t size);
  */
 void sys_mem_pool_free(void *ptr);
 
+/**
+ * @brief Return the usable size of a memory pool allocation
+ *
+ * Returns the number of bytes available to the caller in memory
+ * returned by sys_mem_pool_alloc(), which is usually larger than the
+ * size that was requested.
+ *
+ * @param ptr Pointer to previously allocated memory
+ * @return Usable size of the allocation, in bytes
+ */
+size_t sys_mem_pool_usable_size(void *ptr);
+
 #endif
@@ -11,21 +11,31 @@
  * sys_mutex behaves almost exactly like k_mutex, with the added advantage
  * that a sys_mutex instance can reside in user memory.
  *
- * Further enhancements will support locking/unlocking uncontended sys_mutexes
- * with simple atomic ops instead of syscalls, similar to Linux's
- * FUTEX_LOCK_PI and FUTEX_UNLOCK_PI
+ * The mutex word names the owning thread.  When a thread has to wait,
+ * the kernel takes over the lock into a k_mutex on behalf of the current
+ * owner, so the waiter gets the usual priority inheritance, and hands
+ * ownership back through the mutex word on unlock.  This is similar to
+ * Linux's FUTEX_LOCK_PI and FUTEX_UNLOCK_PI.
  */
 
 #ifdef CONFIG_USERSPACE
+#include <kernel.h>
 #include <sys/atomic.h>
 #include <zephyr/types.h>
 
+/* Set in the mutex word once the kernel tracks the mutex, which makes
+ * the owner's unlock go through the kernel to hand it over
+ */
+#define SYS_MUTEX_CONTENDED	BIT(0)
+
 struct sys_mutex {
-	/* Currently unused, but will be used to store state for fast mutexes
-	 * that can be locked/unlocked with atomic ops if there is no
-	 * contention
+	/* Owning thread, possibly with SYS_MUTEX_CONTENDED, or 0 if the
+	 * mutex is free
 	 */
 	atomic_t val;
+
+	/* Recursive lock count, only accessed on behalf of the owner */
+	u32_t lock_count;
 };
 
 #define SYS_MUTEX_DEFINE(name) \
@@ -80,7 +90,6 @@ __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
  */
 static inline int sys_mutex_lock(struct sys_mutex *mutex, s32_t timeout)
 {
-	/* For now, make the syscall unconditionally */
 	return z_sys_mutex_kernel_lock(mutex, timeout);
 }
 
@@ -102,7 +111,6 @@ static inline int sys_mutex_lock(struct sys_mutex *mutex, s32_t timeout)
  */
 static inline int sys_mutex_unlock(struct sys_mutex *mutex)
 {
-	/* For now, make the syscall unconditionally */
 	return z_sys_mutex_kernel_unlock(mutex);
 }
 
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_SEM_H_
+#define ZEPHYR_INCLUDE_SYS_SEM_H_
+
+/*
+ * sys_sem behaves like k_sem, with the added advantage that a sys_sem
+ * instance can reside in user memory.
+ *
+ * With userspace enabled it is built on a k_futex: giving and taking
+ * an uncontended semaphore are atomic ops on the futex word, and the
+ * kernel is only entered to wait for a count or to wake waiters.
+ * Without userspace it is a thin wrapper around k_sem.
+ */
+
+#include <kernel.h>
+#include <zephyr/types.h>
+
+#ifdef CONFIG_USERSPACE
+struct sys_sem {
+	/* Available count, or -1 when it is zero and threads may be
+	 * waiting for it
+	 */
+	struct k_futex futex;
+	int limit;
+};
+
+#define SYS_SEM_DEFINE(name, initial_count, count_limit) \
+	struct sys_sem name = { \
+		.futex = { .val = initial_count }, \
+		.limit = count_limit \
+	}; \
+	BUILD_ASSERT(((count_limit) != 0) && \
+		     ((initial_count) <= (count_limit)))
+#else
+struct sys_sem {
+	struct k_sem kernel_sem;
+};
+
+#define SYS_SEM_DEFINE(name, initial_count, count_limit) \
+	struct sys_sem name = { \
+		.kernel_sem = Z_SEM_INITIALIZER(name.kernel_sem, \
+						initial_count, count_limit) \
+	}; \
+	BUILD_ASSERT(((count_limit) != 0) && \
+		     ((initial_count) <= (count_limit)))
+#endif /* CONFIG_USERSPACE */
+
+/**
+ * @defgroup user_semaphore_apis User mode semaphore APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Initialize a semaphore.
+ *
+ * This routine initializes a semaphore instance, prior to its first use.
+ *
+ * With userspace enabled, the semaphore must have been defined with
+ * SYS_SEM_DEFINE() or otherwise be in memory the kernel scans for
+ * objects at build time, as its futex is a kernel object.
+ *
+ * @param sem Address of the semaphore.
+ * @param initial_count Initial semaphore count.
+ * @param limit Maximum permitted semaphore count.
+ *
+ * @retval 0 Semaphore initialized.
+ * @retval -EINVAL Invalid initial count or limit.
+ */
+int sys_sem_init(struct sys_sem *sem, unsigned int initial_count,
+		 unsigned int limit);
+
+/**
+ * @brief Give a semaphore.
+ *
+ * This routine gives @a sem, unless the semaphore is already at its
+ * maximum permitted count.  It only enters the kernel if threads may
+ * be waiting for the semaphore.
+ *
+ * @param sem Address of the semaphore.
+ *
+ * @retval 0 Semaphore given.
+ * @retval -EAGAIN Semaphore was already at its maximum count.
+ * @retval -EINVAL Semaphore not recognized by the kernel.
+ * @retval -EACCES Caller has no access to the semaphore.
+ */
+int sys_sem_give(struct sys_sem *sem);
+
+/**
+ * @brief Take a semaphore.
+ *
+ * This routine takes @a sem, waiting for it to be given if its count
+ * is zero.  It only enters the kernel to wait.
+ *
+ * @param sem Address of the semaphore.
+ * @param timeout Waiting period to take the semaphore (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Semaphore taken.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL Semaphore not recognized by the kernel.
+ * @retval -EACCES Caller has no access to the semaphore.
+ */
+int sys_sem_take(struct sys_sem *sem, s32_t timeout);
+
+/**
+ * @brief Get a semaphore's count.
+ *
+ * This routine returns the current count of @a sem.
+ *
+ * @param sem Address of the semaphore.
+ *
+ * @return Current semaphore count.
+ */
+unsigned int sys_sem_count_get(struct sys_sem *sem);
+
+/** @} */
+
+#endif /* ZEPHYR_INCLUDE_SYS_SEM_H_ */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_
+#define ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Simple, fast heap implementation.
+ *
+ * A more or less conventional two level segregated fit ("TLSF")
+ * allocator.  Memory is managed in 8 byte units ("chunks" are runs of
+ * such units) with a small header in front of every chunk recording
+ * its size and the size of its left neighbor, so freed memory is
+ * coalesced immediately with both neighbors in constant time.  Free
+ * chunks are kept in lists indexed first by the power of two of their
+ * size and then by a linear subdivision of that power, with a bitmap
+ * at each level.  Allocation is therefore a couple of find-first-set
+ * operations, independent of the size of the heap or of the number of
+ * free chunks, and the memory wasted by rounding a request up to a
+ * list boundary is bounded by 1/Z_HEAP_SL_COUNT of the request (versus
+ * up to 3/4 for the power-of-four buddy allocator used by
+ * sys_mem_pool).
+ *
+ * The heap stores all of its metadata inside the memory it was given
+ * (the sys_heap struct itself just holds a pointer), which makes it
+ * usable from user mode in memory domains that contain only the heap
+ * buffer.
+ *
+ * Note that this heap does no locking of its own.  Callers are
+ * responsible for synchronizing access.
+ */
+
+/* Internal parameters of the TLSF index.  Exposed only so the sizing
+ * macros below can compute the metadata size at build time.
+ */
+#define Z_HEAP_CHUNK_UNIT 8
+#define Z_HEAP_SL_LOG2 3
+#define Z_HEAP_SL_COUNT (1 << Z_HEAP_SL_LOG2)
+
+#define Z_HEAP_LOG2_8(n) ((n) >= 0x80 ? 7 : (n) >= 0x40 ? 6 :		\
+			  (n) >= 0x20 ? 5 : (n) >= 0x10 ? 4 :		\
+			  (n) >= 0x08 ? 3 : (n) >= 0x04 ? 2 :		\
+			  (n) >= 0x02 ? 1 : 0)
+#define Z_HEAP_LOG2_16(n) ((n) >= 0x100 ? 8 + Z_HEAP_LOG2_8((n) >> 8) \
+			   : Z_HEAP_LOG2_8(n))
+#define Z_HEAP_LOG2_32(n) ((n) >= 0x10000 ? 16 + Z_HEAP_LOG2_16((n) >> 16) \
+			   : Z_HEAP_LOG2_16(n))
+
+/* Number of first level buckets for a heap of the given total size */
+#define Z_HEAP_NB_FL(bytes)						\
+	(Z_HEAP_LOG2_32((bytes) / Z_HEAP_CHUNK_UNIT) >= Z_HEAP_SL_LOG2 ? \
+	 Z_HEAP_LOG2_32((bytes) / Z_HEAP_CHUNK_UNIT) - Z_HEAP_SL_LOG2 + 2 : 1)
+
+/* Bytes of metadata (struct z_heap plus buckets) for a heap of the
+ * given total size, and the worst case of that for any heap.
+ */
+#define Z_HEAP_HDR_BYTES(bytes)						\
+	((16 + Z_HEAP_NB_FL(bytes) * 4 * (1 + Z_HEAP_SL_COUNT) +	\
+	  Z_HEAP_CHUNK_UNIT - 1) & ~(Z_HEAP_CHUNK_UNIT - 1))
+#define Z_HEAP_HDR_MAX (16 + 32 * 4 * (1 + Z_HEAP_SL_COUNT))
+
+/**
+ * @brief Buffer size needed for a heap holding @a n blocks of @a sz bytes
+ *
+ * Returns the number of bytes of memory that must be passed to
+ * sys_heap_init() so that @a n simultaneous allocations of @a sz bytes
+ * each are guaranteed to succeed in an otherwise empty heap.  This
+ * accounts for the per-chunk headers, the heap metadata, the end
+ * marker and misalignment of the buffer.
+ *
+ * @param sz Size of each block, in bytes
+ * @param n Number of blocks
+ */
+#define SYS_HEAP_BUF_SIZE(sz, n)					\
+	(Z_HEAP_BUF_PAYLOAD(sz, n) + 2 * Z_HEAP_CHUNK_UNIT +		\
+	 Z_HEAP_HDR_BYTES(Z_HEAP_BUF_PAYLOAD(sz, n) + Z_HEAP_HDR_MAX +	\
+			  2 * Z_HEAP_CHUNK_UNIT))
+
+#define Z_HEAP_BUF_PAYLOAD(sz, n)					\
+	((n) * (Z_HEAP_CHUNK_UNIT +					\
+		(((sz) + Z_HEAP_CHUNK_UNIT - 1) & ~(Z_HEAP_CHUNK_UNIT - 1))))
+
+struct z_heap;
+
+struct sys_heap {
+	struct z_heap *heap;
+	void *init_mem;
+	size_t init_bytes;
+};
+
+/** @brief Initialize sys_heap
+ *
+ * Initializes a sys_heap struct to manage the specified memory.
+ *
+ * @param h Heap to initialize
+ * @param mem Untyped pointer to unused memory
+ * @param bytes Size of region pointed to by @a mem
+ */
+void sys_heap_init(struct sys_heap *h, void *mem, size_t bytes);
+
+/** @brief Allocate memory from a sys_heap
+ *
+ * Returns a pointer to a block of unused memory in the heap.  This
+ * memory will not otherwise be used until it is freed with
+ * sys_heap_free().  If no memory can be allocated, NULL will be
+ * returned.  The returned memory is aligned on an 8 byte boundary.
+ *
+ * @note The sys_heap implementation is not internally synchronized.
+ * No two sys_heap functions should operate on the same heap at the
+ * same time.  All locking must be provided by the user.
+ *
+ * @param h Heap from which to allocate
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can now use
+ */
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes);
+
+/** @brief Free memory into a sys_heap
+ *
+ * De-allocates a pointer to memory previously returned from
+ * sys_heap_alloc such that it can be used for other purposes.  The
+ * caller must not use the memory region after entry to this function.
+ * It is safe to pass NULL, in which case this is a no-op.
+ *
+ * @note The sys_heap implementation is not internally synchronized.
+ * No two sys_heap functions should operate on the same heap at the
+ * same time.  All locking must be provided by the user.
+ *
+ * @param h Heap to which to return the memory
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ */
+void sys_heap_free(struct sys_heap *h, void *mem);
+
+/** @brief Return the usable size of an allocated block
+ *
+ * Returns the number of bytes actually available to the caller in a
+ * block returned by sys_heap_alloc(), which may be slightly larger
+ * than the size originally requested.
+ *
+ * @param h Heap from which the block was allocated
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Usable size of the block, in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem);
+
+/** @brief Validate heap integrity
+ *
+ * Validates the internal integrity of a sys_heap.  Intended for unit
+ * test and validation code, though potentially useful as a user API
+ * for applications with complicated runtime reliability requirements.
+ * Note: this cannot catch every possible error, but if it returns
+ * true then the heap is in a consistent state and can correctly
+ * handle any sys_heap_alloc() request and free any live pointer
+ * returned from a previous allocation.
+ *
+ * @param h Heap to validate
+ * @return true, if the heap is valid, otherwise false
+ */
+bool sys_heap_validate(struct sys_heap *h);
+
+#endif /* ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_ */
@@ -235,8 +235,15 @@ typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
 	sys_dnode_t node;
+	/* Ticks after the previous timeout in the queue, or (with
+	 * CONFIG_TIMEOUT_QUEUE_WHEEL) the absolute expiry tick
+	 */
 	s32_t dticks;
 	_timeout_func_t fn;
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* Ticks the timeout may fire late to share a clock interrupt */
+	s32_t slack;
+#endif
 };
 
 #ifdef __cplusplus
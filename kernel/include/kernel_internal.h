@@ -223,6 +223,36 @@ extern size_t z_arch_user_string_nlen(const char *s, size_t maxsize, int *err);
  * z_cstart() if userspace is enabled.
  */
 extern void z_app_shmem_bss_zero(void);
+
+struct sys_mutex;
+
+/**
+ * @brief Lock a sys_mutex through the k_mutex backing it
+ *
+ * Kernel side of sys_mutex_lock(). The mutex word is updated under the
+ * same lock as the k_mutex, so this can never interleave with
+ * z_mutex_unlock_for_sys() on another CPU.
+ *
+ * @param mutex k_mutex the kernel keeps for @a sys_mutex
+ * @param sys_mutex Validated sys_mutex in user memory
+ * @param timeout Waiting period, or K_NO_WAIT or K_FOREVER
+ * @return 0 on success, -EBUSY, -EAGAIN or -EINVAL otherwise
+ */
+extern int z_mutex_lock_for_sys(struct k_mutex *mutex,
+				struct sys_mutex *sys_mutex, s32_t timeout);
+
+/**
+ * @brief Unlock a sys_mutex through the k_mutex backing it
+ *
+ * Kernel side of sys_mutex_unlock(), handing the mutex word over to
+ * the highest priority waiter if there is one.
+ *
+ * @param mutex k_mutex the kernel keeps for @a sys_mutex
+ * @param sys_mutex Validated sys_mutex in user memory
+ * @return 0 on success, -EINVAL or -EPERM otherwise
+ */
+extern int z_mutex_unlock_for_sys(struct k_mutex *mutex,
+				  struct sys_mutex *sys_mutex);
 #endif /* CONFIG_USERSPACE */
 
 /**
@@ -86,6 +86,14 @@ struct _ready_q {
 
 typedef struct _ready_q _ready_q_t;
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+/* A CPU-local stack of free blocks of one memory slab */
+struct z_mem_slab_mag {
+	u32_t count;
+	void *blocks[CONFIG_MEM_SLAB_CPU_CACHE_SIZE];
+};
+#endif
+
 struct _cpu {
 	/* nested interrupt count */
 	u32_t nested;
@@ -110,6 +118,21 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* threads queued to run on this CPU, and how many there are */
+	struct _priq_mq runq;
+	u32_t runq_count;
+#endif
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* free block magazines, indexed by k_mem_slab::mag */
+	struct z_mem_slab_mag slab_mags[CONFIG_MEM_SLAB_CPU_CACHE_SLABS];
+	/* held by this CPU's magazine fast paths, and by other CPUs
+	 * reclaiming its magazines
+	 */
+	struct k_spinlock slab_mag_lock;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -59,6 +59,24 @@ void z_time_slice(int ticks);
 void z_sched_abort(struct k_thread *thread);
 void z_sched_ipi(void);
 
+#ifdef CONFIG_SCHED_STATS
+void z_sched_stats_ready(struct k_thread *thread);
+void z_sched_stats_switch(struct k_thread *old_thread,
+			  struct k_thread *new_thread);
+#else
+static inline void z_sched_stats_ready(struct k_thread *thread)
+{
+	ARG_UNUSED(thread);
+}
+
+static inline void z_sched_stats_switch(struct k_thread *old_thread,
+					struct k_thread *new_thread)
+{
+	ARG_UNUSED(old_thread);
+	ARG_UNUSED(new_thread);
+}
+#endif
+
 static inline void z_pend_curr_unlocked(_wait_q_t *wait_q, s32_t timeout)
 {
 	(void) z_pend_curr_irqlock(z_arch_irq_lock(), wait_q, timeout);
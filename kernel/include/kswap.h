@@ -75,6 +75,7 @@ static ALWAYS_INLINE unsigned int do_swap(unsigned int key,
 			z_smp_release_global_lock(new_thread);
 		}
 #endif
+		z_sched_stats_switch(old_thread, new_thread);
 		_current = new_thread;
 		z_arch_switch(new_thread->switch_handle,
 			     &old_thread->switch_handle);
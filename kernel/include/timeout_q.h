@@ -27,7 +27,18 @@ static inline void z_init_timeout(struct _timeout *t, _timeout_func_t fn)
 	sys_dnode_init(&t->node);
 }
 
-void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks);
+/* The timeout may fire up to slack ticks late, so that it can share a
+ * clock interrupt with others.  Slack is ignored without
+ * CONFIG_TIMEOUT_SLACK.
+ */
+void z_add_timeout_slack(struct _timeout *to, _timeout_func_t fn,
+			 s32_t ticks, s32_t slack);
+
+static inline void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
+				 s32_t ticks)
+{
+	z_add_timeout_slack(to, fn, ticks, 0);
+}
 
 int z_abort_timeout(struct _timeout *to);
 
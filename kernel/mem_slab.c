@@ -48,6 +48,199 @@ static void create_free_list(struct k_mem_slab *slab)
 	}
 }
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+
+/* Per-CPU magazines.  Each cached slab owns one z_mem_slab_mag in
+ * every CPU's struct _cpu.  The fast paths below only ever touch the
+ * current CPU's magazines, under that CPU's slab_mag_lock, which is
+ * uncontended unless another CPU is reclaiming them.  Everything that
+ * moves blocks between a magazine and the shared free list happens
+ * under the slab lock, in batches: refills and flushes of the local
+ * magazine, and reclaiming every CPU's magazine when the free list
+ * runs dry.
+ *
+ * Blocks in magazines are counted in num_used, the difference is
+ * made up by z_mem_slab_num_cached().
+ */
+
+#define MAG_SIZE CONFIG_MEM_SLAB_CPU_CACHE_SIZE
+#define MAG_BATCH (MAG_SIZE / 2)
+
+static atomic_t next_mag;
+
+static void mag_assign(struct k_mem_slab *slab)
+{
+	int mag = atomic_inc(&next_mag);
+
+	slab->mag = mag < CONFIG_MEM_SLAB_CPU_CACHE_SLABS ? mag : -1;
+	atomic_clear(&slab->drain);
+}
+
+static inline struct z_mem_slab_mag *cpu_mag(struct k_mem_slab *slab)
+{
+	return &_current_cpu->slab_mags[slab->mag];
+}
+
+static bool mag_alloc(struct k_mem_slab *slab, void **mem)
+{
+	struct z_mem_slab_mag *mag;
+	struct _cpu *cpu;
+	k_spinlock_key_t mkey;
+	unsigned int key;
+	bool ret = false;
+
+	if (slab->mag < 0) {
+		return false;
+	}
+
+	/* Pin ourselves to this CPU before picking its lock */
+	key = z_arch_irq_lock();
+	cpu = _current_cpu;
+	mkey = k_spin_lock(&cpu->slab_mag_lock);
+
+	/* Checked under the magazine lock, see mag_reclaim() */
+	mag = &cpu->slab_mags[slab->mag];
+	if (atomic_get(&slab->drain) == 0 && mag->count > 0U) {
+		*mem = mag->blocks[--mag->count];
+		ret = true;
+	}
+
+	k_spin_unlock(&cpu->slab_mag_lock, mkey);
+	z_arch_irq_unlock(key);
+
+	return ret;
+}
+
+static bool mag_free(struct k_mem_slab *slab, void *mem)
+{
+	struct z_mem_slab_mag *mag;
+	struct _cpu *cpu;
+	k_spinlock_key_t mkey;
+	unsigned int key;
+	bool ret = false;
+
+	if (slab->mag < 0) {
+		return false;
+	}
+
+	key = z_arch_irq_lock();
+	cpu = _current_cpu;
+	mkey = k_spin_lock(&cpu->slab_mag_lock);
+
+	mag = &cpu->slab_mags[slab->mag];
+	if (atomic_get(&slab->drain) == 0 && mag->count < MAG_SIZE) {
+		mag->blocks[mag->count++] = mem;
+		ret = true;
+	}
+
+	k_spin_unlock(&cpu->slab_mag_lock, mkey);
+	z_arch_irq_unlock(key);
+
+	return ret;
+}
+
+/* Called with lock held: moves up to MAG_BATCH blocks from the free
+ * list into this CPU's magazine.
+ */
+static void mag_refill(struct k_mem_slab *slab)
+{
+	struct z_mem_slab_mag *mag = cpu_mag(slab);
+
+	while (mag->count < MAG_BATCH && slab->free_list != NULL) {
+		mag->blocks[mag->count++] = slab->free_list;
+		slab->free_list = *(char **)(slab->free_list);
+		slab->num_used++;
+	}
+}
+
+/* Called with lock held: returns up to n blocks from a magazine,
+ * handing them directly to waiting threads first.  Returns true if a
+ * thread was readied.
+ */
+static bool mag_return(struct k_mem_slab *slab, struct z_mem_slab_mag *mag,
+		       u32_t n)
+{
+	bool readied = false;
+
+	while (n-- > 0U && mag->count > 0U) {
+		char *block = mag->blocks[--mag->count];
+		struct k_thread *thread = z_unpend_first_thread(&slab->wait_q);
+
+		if (thread != NULL) {
+			z_set_thread_return_value_with_data(thread, 0, block);
+			z_ready_thread(thread);
+			readied = true;
+		} else {
+			*(char **)block = slab->free_list;
+			slab->free_list = block;
+			slab->num_used--;
+		}
+	}
+
+	return readied;
+}
+
+/* Called with lock held: once nobody waits, magazines may fill again */
+static void mag_undrain(struct k_mem_slab *slab)
+{
+	if (atomic_get(&slab->drain) != 0 &&
+	    z_waitq_head(&slab->wait_q) == NULL) {
+		atomic_clear(&slab->drain);
+	}
+}
+
+/* Called with lock held: returns up to n blocks from this CPU's
+ * magazine.  Returns true if a thread was readied.
+ */
+static bool mag_flush(struct k_mem_slab *slab, u32_t n)
+{
+	bool readied = mag_return(slab, cpu_mag(slab), n);
+
+	mag_undrain(slab);
+
+	return readied;
+}
+
+/* Called with lock held when the free list is empty: empties every
+ * CPU's magazine, so no block can be stranded on a CPU that does not
+ * touch the slab again.  Each magazine is taken under its CPU's lock,
+ * which that CPU's fast paths hold while they check the drain flag,
+ * so once drain is set no block can go into a magazine after it has
+ * been emptied here.  Returns true if a thread was readied.
+ */
+static bool mag_reclaim(struct k_mem_slab *slab)
+{
+	bool readied = false;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+		k_spinlock_key_t key = k_spin_lock(&cpu->slab_mag_lock);
+
+		readied |= mag_return(slab, &cpu->slab_mags[slab->mag],
+				      MAG_SIZE);
+		k_spin_unlock(&cpu->slab_mag_lock, key);
+	}
+
+	return readied;
+}
+
+u32_t z_mem_slab_num_cached(struct k_mem_slab *slab)
+{
+	u32_t n = 0U;
+
+	if (slab->mag < 0) {
+		return 0;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		n += _kernel.cpus[i].slab_mags[slab->mag].count;
+	}
+
+	return n;
+}
+
+#endif /* CONFIG_MEM_SLAB_CPU_CACHE */
+
 /**
  * @brief Complete initialization of statically defined memory slabs.
  *
@@ -61,6 +254,9 @@ static int init_mem_slab_module(struct device *dev)
 
 	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
 		create_free_list(slab);
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		mag_assign(slab);
+#endif
 		SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 		z_object_init(slab);
 	}
@@ -77,6 +273,12 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->block_size = block_size;
 	slab->buffer = buffer;
 	slab->num_used = 0U;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* Runtime slabs may be re-initialized while blocks are still
+	 * cached, so they never get magazines
+	 */
+	slab->mag = -1;
+#endif
 	create_free_list(slab);
 	z_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
@@ -86,15 +288,51 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (mag_alloc(slab, mem)) {
+		return 0;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool need_sched = false;
 	int result;
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (slab->mag >= 0 && atomic_get(&slab->drain) != 0) {
+		/* Others are waiting: give back what we have cached */
+		need_sched = mag_flush(slab, MAG_SIZE);
+	}
+
+	if (slab->mag >= 0 && slab->free_list == NULL) {
+		/* Free blocks may be cached on other CPUs.  If we are
+		 * going to wait, stop them caching more first.
+		 */
+		if (timeout != K_NO_WAIT) {
+			atomic_set(&slab->drain, 1);
+		}
+		need_sched |= mag_reclaim(slab);
+
+		/* If we are about to pend, frees must keep coming to
+		 * the wait queue rather than a magazine
+		 */
+		if (slab->free_list != NULL || timeout == K_NO_WAIT) {
+			mag_undrain(slab);
+		}
+	}
+#endif
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
 		slab->free_list = *(char **)(slab->free_list);
 		slab->num_used++;
 		result = 0;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		if (slab->mag >= 0 && atomic_get(&slab->drain) == 0) {
+			mag_refill(slab);
+		}
+#endif
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
 		*mem = NULL;
@@ -108,24 +346,51 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 		return result;
 	}
 
-	k_spin_unlock(&lock, key);
+	if (need_sched) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
 
 	return result;
 }
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (mag_free(slab, *mem)) {
+		return;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
+	bool need_sched = false;
 
 	if (pending_thread != NULL) {
 		z_set_thread_return_value_with_data(pending_thread, 0, *mem);
 		z_ready_thread(pending_thread);
-		z_reschedule(&lock, key);
+		need_sched = true;
 	} else {
 		**(char ***)mem = slab->free_list;
 		slab->free_list = *(char **)mem;
 		slab->num_used--;
+	}
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* Either the magazine is full, or there are waiters and
+	 * everything cached here should go to them
+	 */
+	if (slab->mag >= 0) {
+		need_sched |= mag_flush(slab,
+					atomic_get(&slab->drain) != 0 ?
+					MAG_SIZE : MAG_BATCH);
+	}
+#endif
+
+	if (need_sched) {
+		z_reschedule(&lock, key);
+	} else {
 		k_spin_unlock(&lock, key);
 	}
 }
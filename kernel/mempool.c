@@ -13,6 +13,62 @@
 #include <sys/math_extras.h>
 #include <stdbool.h>
 
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+
+/* sys_heap backend: allocation and free are constant time, so unlike
+ * the buddy allocator below there is no need to relax the lock in the
+ * middle of an operation, and the per-pool spinlock can also cover
+ * the wait queue.
+ */
+
+static void k_mem_pool_init(struct k_mem_pool *p)
+{
+	z_waitq_init(&p->wait_q);
+	sys_heap_init(&p->heap, p->heap.init_mem, p->heap.init_bytes);
+}
+
+static int pool_block_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+			    size_t size)
+{
+	k_spinlock_key_t key;
+
+	/* sys_heap has nothing to return for zero bytes, and waiting
+	 * for a free would not change that
+	 */
+	if (size == 0) {
+		block->data = NULL;
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&p->lock);
+	block->data = sys_heap_alloc(&p->heap, size);
+	k_spin_unlock(&p->lock, key);
+
+	block->id.pool = p;
+	block->id.data = block->data;
+
+	return block->data != NULL ? 0 : -ENOMEM;
+}
+
+void k_mem_pool_free_id(struct k_mem_block_id *id)
+{
+	struct k_mem_pool *p = id->pool;
+	k_spinlock_key_t key = k_spin_lock(&p->lock);
+
+	sys_heap_free(&p->heap, id->data);
+
+	/* Wake up anyone blocked on this pool and let them repeat
+	 * their allocation attempts
+	 */
+	if (z_unpend_all(&p->wait_q) != 0) {
+		z_reschedule(&p->lock, key);
+	} else {
+		k_spin_unlock(&p->lock, key);
+	}
+}
+
+#else
+
 static struct k_spinlock lock;
 
 static struct k_mem_pool *get_pool(int id)
@@ -33,6 +89,66 @@ static void k_mem_pool_init(struct k_mem_pool *p)
 	z_sys_mem_pool_base_init(&p->base);
 }
 
+static int pool_block_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+			    size_t size)
+{
+	int ret;
+	u32_t level_num, block_num;
+
+	/* There is a "managed race" in alloc that can fail
+	 * (albeit in a well-defined way, see comments there)
+	 * with -EAGAIN when simultaneous allocations happen.
+	 * Retry exactly once before sleeping to resolve it.
+	 * If we're so contended that it fails twice, then we
+	 * clearly want to block.
+	 */
+	for (int i = 0; i < 2; i++) {
+		ret = z_sys_mem_pool_block_alloc(&p->base, size,
+						&level_num, &block_num,
+						&block->data);
+		if (ret != -EAGAIN) {
+			break;
+		}
+	}
+
+	if (ret == -EAGAIN) {
+		ret = -ENOMEM;
+	}
+
+	block->id.pool = pool_id(p);
+	block->id.level = level_num;
+	block->id.block = block_num;
+
+	return ret;
+}
+
+void k_mem_pool_free_id(struct k_mem_block_id *id)
+{
+	int need_sched = 0;
+	struct k_mem_pool *p = get_pool(id->pool);
+
+	z_sys_mem_pool_block_free(&p->base, id->level, id->block);
+
+	/* Wake up anyone blocked on this pool and let them repeat
+	 * their allocation attempts
+	 *
+	 * (Note that this spinlock only exists because z_unpend_all()
+	 * is unsynchronized.  Maybe we want to put the lock into the
+	 * wait_q instead and make the API safe?)
+	 */
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	need_sched = z_unpend_all(&p->wait_q);
+
+	if (need_sched != 0) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+}
+
+#endif /* CONFIG_MEM_POOL_HEAP_BACKEND */
+
 int init_static_pools(struct device *unused)
 {
 	ARG_UNUSED(unused);
@@ -59,31 +175,7 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 	}
 
 	while (true) {
-		u32_t level_num, block_num;
-
-		/* There is a "managed race" in alloc that can fail
-		 * (albeit in a well-defined way, see comments there)
-		 * with -EAGAIN when simultaneous allocations happen.
-		 * Retry exactly once before sleeping to resolve it.
-		 * If we're so contended that it fails twice, then we
-		 * clearly want to block.
-		 */
-		for (int i = 0; i < 2; i++) {
-			ret = z_sys_mem_pool_block_alloc(&p->base, size,
-							&level_num, &block_num,
-							&block->data);
-			if (ret != -EAGAIN) {
-				break;
-			}
-		}
-
-		if (ret == -EAGAIN) {
-			ret = -ENOMEM;
-		}
-
-		block->id.pool = pool_id(p);
-		block->id.level = level_num;
-		block->id.block = block_num;
+		ret = pool_block_alloc(p, block, size);
 
 		if (ret == 0 || timeout == K_NO_WAIT ||
 		    ret != -ENOMEM) {
@@ -103,31 +195,6 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 	return -EAGAIN;
 }
 
-void k_mem_pool_free_id(struct k_mem_block_id *id)
-{
-	int need_sched = 0;
-	struct k_mem_pool *p = get_pool(id->pool);
-
-	z_sys_mem_pool_block_free(&p->base, id->level, id->block);
-
-	/* Wake up anyone blocked on this pool and let them repeat
-	 * their allocation attempts
-	 *
-	 * (Note that this spinlock only exists because z_unpend_all()
-	 * is unsynchronized.  Maybe we want to put the lock into the
-	 * wait_q instead and make the API safe?)
-	 */
-	k_spinlock_key_t key = k_spin_lock(&lock);
-
-	need_sched = z_unpend_all(&p->wait_q);
-
-	if (need_sched != 0) {
-		z_reschedule(&lock, key);
-	} else {
-		k_spin_unlock(&lock, key);
-	}
-}
-
 void k_mem_pool_free(struct k_mem_block *block)
 {
 	k_mem_pool_free_id(&block->id);
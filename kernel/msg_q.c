@@ -247,6 +247,182 @@ Z_SYSCALL_HANDLER(k_msgq_get, msgq_p, data, timeout)
 }
 #endif
 
+/* Copy n messages into the ring buffer at write_ptr, in at most two
+ * pieces.  The caller has checked there is room.
+ */
+static void msgq_copy_in(struct k_msgq *msgq, const char *data, u32_t n)
+{
+	size_t len = n * msgq->msg_size;
+	size_t first = MIN(len, (size_t)(msgq->buffer_end - msgq->write_ptr));
+
+	(void)memcpy(msgq->write_ptr, data, first);
+	(void)memcpy(msgq->buffer_start, data + first, len - first);
+	msgq->write_ptr += first;
+	if (msgq->write_ptr == msgq->buffer_end) {
+		msgq->write_ptr = msgq->buffer_start + (len - first);
+	}
+	msgq->used_msgs += n;
+}
+
+/* Copy n messages out of the ring buffer at read_ptr, the mirror image
+ * of msgq_copy_in().  The caller has checked they are there.
+ */
+static void msgq_copy_out(struct k_msgq *msgq, char *data, u32_t n)
+{
+	size_t len = n * msgq->msg_size;
+	size_t first = MIN(len, (size_t)(msgq->buffer_end - msgq->read_ptr));
+
+	(void)memcpy(data, msgq->read_ptr, first);
+	(void)memcpy(data + first, msgq->buffer_start, len - first);
+	msgq->read_ptr += first;
+	if (msgq->read_ptr == msgq->buffer_end) {
+		msgq->read_ptr = msgq->buffer_start + (len - first);
+	}
+	msgq->used_msgs -= n;
+}
+
+int z_impl_k_msgq_put_n(struct k_msgq *msgq, const void *data,
+			u32_t num_msgs, s32_t timeout)
+{
+	__ASSERT(!z_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	const char *src = data;
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool woken = false;
+	u32_t n = 0U;
+	u32_t count;
+	int ret;
+
+	if (num_msgs == 0U) {
+		return 0;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->used_msgs == msgq->max_msgs) {
+		if (timeout == K_NO_WAIT) {
+			k_spin_unlock(&msgq->lock, key);
+			return -ENOMSG;
+		}
+
+		/* wait for a receiver to take the first message, as
+		 * k_msgq_put() would
+		 */
+		_current->base.swap_data = (void *)src;
+		ret = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+		return (ret == 0) ? 1 : ret;
+	}
+
+	/* Threads only pend on a non-full queue if they are receivers,
+	 * and only when it is empty: give each one a message, in order,
+	 * before buffering the rest.
+	 */
+	while (n < num_msgs) {
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread == NULL) {
+			break;
+		}
+		(void)memcpy(pending_thread->base.swap_data,
+			     src + n * msgq->msg_size, msgq->msg_size);
+		z_set_thread_return_value(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		woken = true;
+		n++;
+	}
+
+	count = MIN(num_msgs - n, msgq->max_msgs - msgq->used_msgs);
+	msgq_copy_in(msgq, src + n * msgq->msg_size, count);
+	n += count;
+
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return n;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_put_n, msgq_p, data, num_msgs, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_READ(data, num_msgs, q->msg_size));
+
+	return z_impl_k_msgq_put_n(q, (const void *)data, num_msgs, timeout);
+}
+#endif
+
+int z_impl_k_msgq_get_n(struct k_msgq *msgq, void *data, u32_t num_msgs,
+			s32_t timeout)
+{
+	__ASSERT(!z_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool woken = false;
+	u32_t count;
+	int ret;
+
+	if (num_msgs == 0U) {
+		return 0;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->used_msgs == 0U) {
+		if (timeout == K_NO_WAIT) {
+			k_spin_unlock(&msgq->lock, key);
+			return -ENOMSG;
+		}
+
+		/* wait for a sender to hand over a single message */
+		_current->base.swap_data = data;
+		ret = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+		return (ret == 0) ? 1 : ret;
+	}
+
+	count = MIN(num_msgs, msgq->used_msgs);
+	msgq_copy_out(msgq, data, count);
+
+	/* Threads only pend on a non-empty queue if they are senders:
+	 * let as many in as there is now room for, in order.
+	 */
+	while (msgq->used_msgs < msgq->max_msgs) {
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread == NULL) {
+			break;
+		}
+		msgq_copy_in(msgq, pending_thread->base.swap_data, 1);
+		z_set_thread_return_value(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		woken = true;
+	}
+
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_get_n, msgq_p, data, num_msgs, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(data, num_msgs, q->msg_size));
+
+	return z_impl_k_msgq_get_n(q, (void *)data, num_msgs, timeout);
+}
+#endif
+
 int z_impl_k_msgq_peek(struct k_msgq *msgq, void *data)
 {
 	k_spinlock_key_t key;
@@ -37,6 +37,8 @@
 #include <init.h>
 #include <syscall_handler.h>
 #include <debug/tracing.h>
+#include <kernel_internal.h>
+#include <sys/mutex.h>
 
 /* We use a global spinlock here because some of the synchronization
  * is protecting things like owner thread priorities which aren't
@@ -261,3 +263,184 @@ Z_SYSCALL_HANDLER(k_mutex_unlock, mutex)
 	return 0;
 }
 #endif
+
+#ifdef CONFIG_USERSPACE
+/* sys_mutex support.  The mutex word in user memory names the owning
+ * thread, plus SYS_MUTEX_CONTENDED while the kernel tracks the mutex.
+ * The kernel tracks it in the k_mutex backing the sys_mutex: that
+ * k_mutex is owned by the same thread exactly when the bit is set, so
+ * waiters can pend on it and boost the owner.  The word and the
+ * k_mutex only ever change together under lock.
+ */
+
+static struct k_thread *sys_mutex_owner(atomic_val_t val)
+{
+	struct k_thread *owner;
+	struct _k_object *obj;
+
+	owner = (struct k_thread *)(val & ~SYS_MUTEX_CONTENDED);
+
+	/* The mutex word lives in user memory, so don't trust it */
+	obj = z_object_find(owner);
+	if (obj == NULL || obj->type != K_OBJ_THREAD ||
+	    (obj->flags & K_OBJ_FLAG_INITIALIZED) == 0U) {
+		return NULL;
+	}
+
+	return owner;
+}
+
+int z_mutex_lock_for_sys(struct k_mutex *mutex, struct sys_mutex *sys_mutex,
+			 s32_t timeout)
+{
+	atomic_val_t self = (atomic_val_t)_current;
+	struct k_thread *owner = NULL;
+	struct k_thread *waiter;
+	atomic_val_t val;
+	k_spinlock_key_t key;
+	int new_prio;
+	int ret = 0;
+
+	z_sched_lock();
+	key = k_spin_lock(&lock);
+
+	while (true) {
+		val = atomic_get(&sys_mutex->val);
+		if (val == 0) {
+			if (atomic_cas(&sys_mutex->val, 0, self)) {
+				sys_mutex->lock_count = 1U;
+				goto out;
+			}
+			continue;
+		}
+
+		if ((val & ~SYS_MUTEX_CONTENDED) == self) {
+			sys_mutex->lock_count++;
+			goto out;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			ret = -EBUSY;
+			goto out;
+		}
+
+		owner = sys_mutex_owner(val);
+		if (owner == NULL) {
+			ret = -EINVAL;
+			goto out;
+		}
+
+		if ((val & SYS_MUTEX_CONTENDED) != 0 ||
+		    atomic_cas(&sys_mutex->val, val,
+			       val | SYS_MUTEX_CONTENDED)) {
+			break;
+		}
+	}
+
+	/* First waiter: the owner took the mutex in user space, so start
+	 * tracking it on the owner's behalf
+	 */
+	if (mutex->lock_count == 0U) {
+		mutex->owner = owner;
+		mutex->owner_orig_prio = owner->base.prio;
+		mutex->lock_count = 1U;
+	}
+
+	new_prio = new_prio_for_inheritance(_current->base.prio,
+					    mutex->owner->base.prio);
+	if (z_is_prio_higher(new_prio, mutex->owner->base.prio)) {
+		adjust_owner_prio(mutex, new_prio);
+	}
+
+	/* On success the unlocking thread has handed us the mutex word */
+	if (z_pend_curr(&lock, key, &mutex->wait_q, timeout) == 0) {
+		k_sched_unlock();
+		return 0;
+	}
+
+	/* timed out */
+	key = k_spin_lock(&lock);
+	if (mutex->lock_count != 0U) {
+		waiter = z_waitq_head(&mutex->wait_q);
+		new_prio = mutex->owner_orig_prio;
+		new_prio = (waiter != NULL) ?
+			new_prio_for_inheritance(waiter->base.prio, new_prio) :
+			new_prio;
+		adjust_owner_prio(mutex, new_prio);
+	}
+	ret = -EAGAIN;
+
+out:
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+	return ret;
+}
+
+int z_mutex_unlock_for_sys(struct k_mutex *mutex, struct sys_mutex *sys_mutex)
+{
+	atomic_val_t self = (atomic_val_t)_current;
+	struct k_thread *new_owner;
+	atomic_val_t val;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&lock);
+
+	val = atomic_get(&sys_mutex->val);
+	if (val == 0) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	if ((val & ~SYS_MUTEX_CONTENDED) != self) {
+		ret = -EPERM;
+		goto out;
+	}
+
+	if (sys_mutex->lock_count > 1U) {
+		sys_mutex->lock_count--;
+		goto out;
+	}
+
+	if (mutex->lock_count == 0U) {
+		/* Nobody waited for it */
+		atomic_set(&sys_mutex->val, 0);
+		goto out;
+	}
+
+	adjust_owner_prio(mutex, mutex->owner_orig_prio);
+
+	new_owner = z_unpend_first_thread(&mutex->wait_q);
+	if (new_owner == NULL) {
+		/* The waiters timed out */
+		mutex->owner = NULL;
+		mutex->lock_count = 0U;
+		atomic_set(&sys_mutex->val, 0);
+		goto out;
+	}
+
+	sys_mutex->lock_count = 1U;
+	if (z_waitq_head(&mutex->wait_q) != NULL) {
+		/* new owner is already of higher or equal prio than the
+		 * remaining waiters since the wait queue is priority-based
+		 */
+		mutex->owner = new_owner;
+		mutex->owner_orig_prio = new_owner->base.prio;
+		atomic_set(&sys_mutex->val,
+			   (atomic_val_t)new_owner | SYS_MUTEX_CONTENDED);
+	} else {
+		mutex->owner = NULL;
+		mutex->lock_count = 0U;
+		atomic_set(&sys_mutex->val, (atomic_val_t)new_owner);
+	}
+
+	z_set_thread_return_value(new_owner, 0);
+	z_ready_thread(new_owner);
+	z_reschedule(&lock, key);
+	return 0;
+
+out:
+	k_spin_unlock(&lock, key);
+	return ret;
+}
+#endif /* CONFIG_USERSPACE */
@@ -68,6 +68,13 @@ static inline bool is_condition_met(struct k_poll_event *event, u32_t *state)
 			return true;
 		}
 		break;
+	case K_POLL_TYPE_RING_DATA_AVAILABLE:
+		if (atomic_get(&event->ring->head) !=
+		    atomic_get(&event->ring->tail)) {
+			*state = K_POLL_STATE_DATA_AVAILABLE;
+			return true;
+		}
+		break;
 	case K_POLL_TYPE_SIGNAL:
 		if (event->signal->signaled != 0U) {
 			*state = K_POLL_STATE_SIGNALED;
@@ -121,6 +128,10 @@ static inline int register_event(struct k_poll_event *event,
 		__ASSERT(event->queue != NULL, "invalid queue\n");
 		add_event(&event->queue->poll_events, event, poller);
 		break;
+	case K_POLL_TYPE_RING_DATA_AVAILABLE:
+		__ASSERT(event->ring != NULL, "invalid ring\n");
+		add_event(&event->ring->poll_events, event, poller);
+		break;
 	case K_POLL_TYPE_SIGNAL:
 		__ASSERT(event->signal != NULL, "invalid poll signal\n");
 		add_event(&event->signal->poll_events, event, poller);
@@ -154,6 +165,10 @@ static inline void clear_event_registration(struct k_poll_event *event)
 		__ASSERT(event->queue != NULL, "invalid queue\n");
 		remove = true;
 		break;
+	case K_POLL_TYPE_RING_DATA_AVAILABLE:
+		__ASSERT(event->ring != NULL, "invalid ring\n");
+		remove = true;
+		break;
 	case K_POLL_TYPE_SIGNAL:
 		__ASSERT(event->signal != NULL, "invalid poll signal\n");
 		remove = true;
@@ -315,6 +330,16 @@ Z_SYSCALL_HANDLER(k_poll, events, num_events, timeout)
 		case K_POLL_TYPE_DATA_AVAILABLE:
 			Z_OOPS(Z_SYSCALL_OBJ(e->queue, K_OBJ_QUEUE));
 			break;
+		case K_POLL_TYPE_RING_DATA_AVAILABLE: {
+			struct _k_object *ko = z_object_find(e->ring);
+			enum k_objects otype = K_OBJ_SPSC_RING;
+
+			if (ko != NULL && ko->type == K_OBJ_MPMC_RING) {
+				otype = K_OBJ_MPMC_RING;
+			}
+			Z_OOPS(Z_SYSCALL_OBJ(e->ring, otype));
+			break;
+		}
 		default:
 			ret = -EINVAL;
 			goto out_free;
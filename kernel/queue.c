@@ -344,6 +344,55 @@ void *z_impl_k_queue_get(struct k_queue *queue, s32_t timeout)
 #endif /* CONFIG_POLL */
 }
 
+/* Moves up to max_items already queued items to the items array */
+static int queue_get_locked(struct k_queue *queue, void **items, int max_items)
+{
+	int n = 0;
+
+	while ((n < max_items) && !sys_sflist_is_empty(&queue->data_q)) {
+		sys_sfnode_t *node;
+
+		node = sys_sflist_get_not_empty(&queue->data_q);
+		items[n] = z_queue_node_peek(node, true);
+		n++;
+	}
+
+	return n;
+}
+
+int z_impl_k_queue_get_batch(struct k_queue *queue, void **items,
+			     int max_items, s32_t timeout)
+{
+	k_spinlock_key_t key;
+	int n;
+
+	if (max_items <= 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&queue->lock);
+	n = queue_get_locked(queue, items, max_items);
+	k_spin_unlock(&queue->lock, key);
+
+	if ((n != 0) || (timeout == K_NO_WAIT)) {
+		return n;
+	}
+
+	/* Empty: wait for the first item like k_queue_get() does, then
+	 * pick up whatever else arrived with it.
+	 */
+	items[0] = z_impl_k_queue_get(queue, timeout);
+	if (items[0] == NULL) {
+		return 0;
+	}
+
+	key = k_spin_lock(&queue->lock);
+	n = 1 + queue_get_locked(queue, items + 1, max_items - 1);
+	k_spin_unlock(&queue->lock, key);
+
+	return n;
+}
+
 #ifdef CONFIG_USERSPACE
 Z_SYSCALL_HANDLER(k_queue_get, queue, timeout_p)
 {
@@ -354,6 +403,18 @@ Z_SYSCALL_HANDLER(k_queue_get, queue, timeout_p)
 	return (u32_t)z_impl_k_queue_get((struct k_queue *)queue, timeout);
 }
 
+Z_SYSCALL_HANDLER(k_queue_get_batch, queue, items, max_items, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(queue, K_OBJ_QUEUE));
+	if ((int)max_items > 0) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(items, max_items,
+						    sizeof(void *)));
+	}
+
+	return z_impl_k_queue_get_batch((struct k_queue *)queue,
+					(void **)items, max_items, timeout);
+}
+
 Z_SYSCALL_HANDLER1_SIMPLE(k_queue_is_empty, K_OBJ_QUEUE, struct k_queue *);
 Z_SYSCALL_HANDLER1_SIMPLE(k_queue_peek_head, K_OBJ_QUEUE, struct k_queue *);
 Z_SYSCALL_HANDLER1_SIMPLE(k_queue_peek_tail, K_OBJ_QUEUE, struct k_queue *);
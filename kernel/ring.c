@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock-free SPSC and MPMC rings.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <string.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <syscall_handler.h>
+#include <kernel_internal.h>
+
+/* Both rings share the blocking machinery below, which is entered
+ * only when a reader finds the ring empty and wants to wait, or when
+ * a writer sees a non-zero waiters count (or, with CONFIG_POLL, a
+ * registered poller).  The reader increments waiters before it
+ * re-checks the ring under the lock, and the writer reads waiters
+ * only after publishing its record; with both accesses sequentially
+ * consistent at least one side sees the other, so a wakeup can't be
+ * lost.  Records are handed straight to the woken reader, as
+ * k_msgq does.
+ */
+
+/* Returned to a woken reader whose record was taken by another
+ * (non-blocking) reader in the meantime.  MPMC only; the reader just
+ * goes back to sleep.
+ */
+#define RING_RETRY 1
+
+typedef int (*ring_get_fn)(struct z_ring *ring, void *data);
+
+static void ring_init(struct z_ring *ring, void *buffer, size_t rec_size,
+		      u32_t num_recs)
+{
+	__ASSERT(num_recs > 1 && (num_recs & (num_recs - 1)) == 0,
+		 "number of records must be a power of two");
+
+	ring->buffer = buffer;
+	ring->rec_size = rec_size;
+	ring->mask = num_recs - 1;
+	atomic_clear(&ring->head);
+	atomic_clear(&ring->tail);
+	atomic_clear(&ring->waiters);
+	z_waitq_init(&ring->wait_q);
+	ring->lock = (struct k_spinlock) {};
+#ifdef CONFIG_POLL
+	sys_dlist_init(&ring->poll_events);
+#endif
+}
+
+static inline bool has_waiters(struct z_ring *ring)
+{
+#ifdef CONFIG_POLL
+	if (!sys_dlist_is_empty(&ring->poll_events)) {
+		return true;
+	}
+#endif
+	return atomic_get(&ring->waiters) != 0;
+}
+
+/* Writer side slow path: hand the oldest record to a blocked reader,
+ * or else tell a poller there is data.
+ */
+static void ring_wake(struct z_ring *ring, ring_get_fn get)
+{
+	k_spinlock_key_t key = k_spin_lock(&ring->lock);
+	struct k_thread *thread = z_unpend_first_thread(&ring->wait_q);
+
+	if (thread != NULL) {
+		int ret = get(ring, thread->base.swap_data);
+
+		z_set_thread_return_value(thread, ret == 0 ? 0 : RING_RETRY);
+		z_ready_thread(thread);
+	} else {
+#ifdef CONFIG_POLL
+		z_handle_obj_poll_events(&ring->poll_events,
+					 K_POLL_STATE_DATA_AVAILABLE);
+#endif
+	}
+
+	z_reschedule(&ring->lock, key);
+}
+
+/* Reader side slow path */
+static int ring_wait(struct z_ring *ring, ring_get_fn get, void *data,
+		     s32_t timeout)
+{
+	k_spinlock_key_t key;
+	s64_t end = 0;
+	int ret;
+
+	if (timeout != K_FOREVER) {
+		end = k_uptime_get() + timeout;
+	}
+
+	while (true) {
+		key = k_spin_lock(&ring->lock);
+
+		(void)atomic_inc(&ring->waiters);
+		ret = get(ring, data);
+		if (ret == 0) {
+			(void)atomic_dec(&ring->waiters);
+			k_spin_unlock(&ring->lock, key);
+			return 0;
+		}
+
+		_current->base.swap_data = data;
+		ret = z_pend_curr(&ring->lock, key, &ring->wait_q, timeout);
+		(void)atomic_dec(&ring->waiters);
+
+		if (ret != RING_RETRY) {
+			return ret;
+		}
+
+		/* Lost the record, wait only for what is left of the
+		 * caller's timeout
+		 */
+		if (timeout != K_FOREVER) {
+			timeout = end - k_uptime_get();
+			if (timeout <= 0) {
+				return get(ring, data) == 0 ? 0 : -EAGAIN;
+			}
+		}
+	}
+}
+
+static int ring_get(struct z_ring *ring, ring_get_fn get, void *data,
+		    s32_t timeout)
+{
+	__ASSERT(!z_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	if (get(ring, data) == 0) {
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		return -ENOMSG;
+	}
+
+	return ring_wait(ring, get, data, timeout);
+}
+
+/* SPSC: head is written only by the producer and tail only by the
+ * consumer (or by a producer handing a record to the blocked
+ * consumer, which is then not running).
+ */
+
+static int spsc_get(struct z_ring *ring, void *data)
+{
+	u32_t tail = atomic_get(&ring->tail);
+
+	if ((u32_t)atomic_get(&ring->head) == tail) {
+		return -ENOMSG;
+	}
+
+	(void)memcpy(data, ring->buffer + (tail & ring->mask) * ring->rec_size,
+		     ring->rec_size);
+	(void)atomic_set(&ring->tail, tail + 1);
+
+	return 0;
+}
+
+void k_spsc_ring_init(struct k_spsc_ring *r, void *buffer, size_t rec_size,
+		      u32_t num_recs)
+{
+	ring_init(&r->ring, buffer, rec_size, num_recs);
+	z_object_init(r);
+}
+
+int z_impl_k_spsc_ring_put(struct k_spsc_ring *r, const void *data)
+{
+	struct z_ring *ring = &r->ring;
+	u32_t head = atomic_get(&ring->head);
+
+	if (head - (u32_t)atomic_get(&ring->tail) > ring->mask) {
+		return -ENOMSG;
+	}
+
+	(void)memcpy(ring->buffer + (head & ring->mask) * ring->rec_size,
+		     data, ring->rec_size);
+	(void)atomic_set(&ring->head, head + 1);
+
+	if (has_waiters(ring)) {
+		ring_wake(ring, spsc_get);
+	}
+
+	return 0;
+}
+
+int z_impl_k_spsc_ring_get(struct k_spsc_ring *r, void *data, s32_t timeout)
+{
+	return ring_get(&r->ring, spsc_get, data, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_spsc_ring_put, r_p, data)
+{
+	struct k_spsc_ring *r = (struct k_spsc_ring *)r_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(r, K_OBJ_SPSC_RING));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(data, r->ring.rec_size));
+
+	return z_impl_k_spsc_ring_put(r, (const void *)data);
+}
+
+Z_SYSCALL_HANDLER(k_spsc_ring_get, r_p, data, timeout)
+{
+	struct k_spsc_ring *r = (struct k_spsc_ring *)r_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(r, K_OBJ_SPSC_RING));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, r->ring.rec_size));
+
+	return z_impl_k_spsc_ring_get(r, (void *)data, timeout);
+}
+
+Z_SYSCALL_HANDLER1_SIMPLE(k_spsc_ring_num_used_get, K_OBJ_SPSC_RING,
+			  struct k_spsc_ring *);
+#endif
+
+/* MPMC: a bounded queue in the style of Dmitry Vyukov's.  Each slot
+ * starts with a sequence word that says whose turn it is: a writer
+ * may fill the slot for position pos when seq == pos, a reader may
+ * drain it when seq == pos + 1.  head and tail are claimed with a
+ * compare-and-swap, the record is copied, and then the sequence word
+ * is advanced to publish it (to pos + 1) or free it (to pos + number
+ * of slots).
+ *
+ * The sequence word is stored minus the slot index, so that an all
+ * zero buffer is a valid empty ring and statically defined rings need
+ * no boot time initialization.
+ */
+
+static inline atomic_t *mpmc_seq(struct z_ring *ring, u32_t pos)
+{
+	u32_t idx = pos & ring->mask;
+
+	return (atomic_t *)(ring->buffer +
+			    idx * Z_MPMC_RING_SLOT_SIZE(ring->rec_size));
+}
+
+/* Zero when the slot for pos holds sequence number "want", negative
+ * if it is behind (the ring is full or empty) and positive if another
+ * context has already claimed pos.
+ */
+static inline s32_t mpmc_turn(struct z_ring *ring, atomic_t *seq, u32_t pos,
+			      u32_t want)
+{
+	return (s32_t)((u32_t)atomic_get(seq) + (pos & ring->mask) - want);
+}
+
+static inline void mpmc_set_seq(struct z_ring *ring, atomic_t *seq,
+				u32_t pos, u32_t val)
+{
+	(void)atomic_set(seq, val - (pos & ring->mask));
+}
+
+static int mpmc_get(struct z_ring *ring, void *data)
+{
+	u32_t pos = atomic_get(&ring->tail);
+	atomic_t *seq;
+
+	for (;;) {
+		s32_t turn;
+
+		seq = mpmc_seq(ring, pos);
+		turn = mpmc_turn(ring, seq, pos, pos + 1);
+
+		if (turn == 0) {
+			if (atomic_cas(&ring->tail, pos, pos + 1)) {
+				break;
+			}
+			pos = atomic_get(&ring->tail);
+		} else if (turn < 0) {
+			return -ENOMSG;
+		} else {
+			pos = atomic_get(&ring->tail);
+		}
+	}
+
+	(void)memcpy(data, seq + 1, ring->rec_size);
+	mpmc_set_seq(ring, seq, pos, pos + ring->mask + 1);
+
+	return 0;
+}
+
+void k_mpmc_ring_init(struct k_mpmc_ring *r, void *buffer, size_t rec_size,
+		      u32_t num_recs)
+{
+	ring_init(&r->ring, buffer, rec_size, num_recs);
+
+	for (u32_t i = 0; i < num_recs; i++) {
+		atomic_clear(mpmc_seq(&r->ring, i));
+	}
+
+	z_object_init(r);
+}
+
+int z_impl_k_mpmc_ring_put(struct k_mpmc_ring *r, const void *data)
+{
+	struct z_ring *ring = &r->ring;
+	u32_t pos = atomic_get(&ring->head);
+	atomic_t *seq;
+
+	for (;;) {
+		s32_t turn;
+
+		seq = mpmc_seq(ring, pos);
+		turn = mpmc_turn(ring, seq, pos, pos);
+
+		if (turn == 0) {
+			if (atomic_cas(&ring->head, pos, pos + 1)) {
+				break;
+			}
+			pos = atomic_get(&ring->head);
+		} else if (turn < 0) {
+			return -ENOMSG;
+		} else {
+			pos = atomic_get(&ring->head);
+		}
+	}
+
+	(void)memcpy(seq + 1, data, ring->rec_size);
+	mpmc_set_seq(ring, seq, pos, pos + 1);
+
+	if (has_waiters(ring)) {
+		ring_wake(ring, mpmc_get);
+	}
+
+	return 0;
+}
+
+int z_impl_k_mpmc_ring_get(struct k_mpmc_ring *r, void *data, s32_t timeout)
+{
+	return ring_get(&r->ring, mpmc_get, data, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_mpmc_ring_put, r_p, data)
+{
+	struct k_mpmc_ring *r = (struct k_mpmc_ring *)r_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(r, K_OBJ_MPMC_RING));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(data, r->ring.rec_size));
+
+	return z_impl_k_mpmc_ring_put(r, (const void *)data);
+}
+
+Z_SYSCALL_HANDLER(k_mpmc_ring_get, r_p, data, timeout)
+{
+	struct k_mpmc_ring *r = (struct k_mpmc_ring *)r_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(r, K_OBJ_MPMC_RING));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, r->ring.rec_size));
+
+	return z_impl_k_mpmc_ring_get(r, (void *)data, timeout);
+}
+
+Z_SYSCALL_HANDLER1_SIMPLE(k_mpmc_ring_num_used_get, K_OBJ_MPMC_RING,
+			  struct k_mpmc_ring *);
+#endif
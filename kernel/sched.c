@@ -176,6 +176,213 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Per-CPU ready queues.  Every queued thread lives in the MULTIQ of
+ * exactly one CPU (recorded in base.runq_cpu), which is normally the
+ * only CPU that looks at it.  All of this is still serialized by
+ * sched_spinlock.
+ */
+
+static inline bool cpu_allowed(struct k_thread *th, int id)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (th->base.cpu_mask & BIT(id)) != 0;
+#else
+	return true;
+#endif
+}
+
+/* Best thread in a CPU queue that may run on CPU "id".  Without CPU
+ * masks that is just the head of the highest non-empty priority.
+ */
+static struct k_thread *runq_first_allowed(struct _priq_mq *pq, int id)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	u32_t bits = pq->bitmask;
+	struct k_thread *t;
+
+	while (bits != 0U) {
+		int prio = __builtin_ctz(bits);
+
+		SYS_DLIST_FOR_EACH_CONTAINER(&pq->queues[prio], t,
+					     base.qnode_dlist) {
+			if (cpu_allowed(t, id)) {
+				return t;
+			}
+		}
+		bits &= bits - 1;
+	}
+	return NULL;
+#else
+	ARG_UNUSED(id);
+	return z_priq_mq_best(pq);
+#endif
+}
+
+/* Picks the queue for a thread being made ready: an allowed CPU that
+ * is idle with nothing queued can run it right away.  Failing that, a
+ * CPU whose _current it outranks, so it preempts there instead of
+ * waiting behind lower priority work: the readying CPU if possible,
+ * else the one running the lowest priority thread.  Otherwise the
+ * allowed CPU with the shortest queue.  The search starts from the
+ * CPU the thread last ran on, so ties keep its cache warm.
+ */
+static int runq_place(struct k_thread *th)
+{
+	int self = _current_cpu->id;
+	int first = th->base.cpu % CONFIG_MP_NUM_CPUS;
+	int best = first;
+	int victim = -1;
+	u32_t least = UINT32_MAX;
+
+	for (int n = 0; n < CONFIG_MP_NUM_CPUS; n++) {
+		int id = (first + n) % CONFIG_MP_NUM_CPUS;
+		struct _cpu *cpu = &_kernel.cpus[id];
+
+		if (!cpu_allowed(th, id)) {
+			continue;
+		}
+
+		if (cpu->runq_count == 0U && cpu->current != NULL &&
+		    is_idle(cpu->current)) {
+			return id;
+		}
+
+		if (cpu->current != NULL && victim != self &&
+		    z_is_t1_higher_prio_than_t2(th, cpu->current) &&
+		    (id == self || victim < 0 ||
+		     z_is_t1_higher_prio_than_t2(_kernel.cpus[victim].current,
+						 cpu->current))) {
+			victim = id;
+		}
+
+		if (cpu->runq_count < least) {
+			least = cpu->runq_count;
+			best = id;
+		}
+	}
+
+	if (victim >= 0) {
+		return victim;
+	}
+
+	/* An empty mask leaves it on its last CPU, where
+	 * runq_first_allowed() will never pick it, just as the single
+	 * queue implementation would never run it.
+	 */
+	return best;
+}
+
+static void runq_add(struct k_thread *th)
+{
+	int id = runq_place(th);
+	struct _cpu *cpu = &_kernel.cpus[id];
+
+	th->base.runq_cpu = id;
+	z_priq_mq_add(&cpu->runq, th);
+	cpu->runq_count++;
+
+	/* The other CPU only looks at its queue when it reschedules */
+#ifdef CONFIG_SCHED_IPI_SUPPORTED
+	if (id != _current_cpu->id) {
+		z_arch_sched_ipi();
+	}
+#endif
+}
+
+static void runq_remove(struct k_thread *th)
+{
+	struct _cpu *cpu = &_kernel.cpus[th->base.runq_cpu];
+
+	z_priq_mq_remove(&cpu->runq, th);
+	cpu->runq_count--;
+}
+
+/* Priority index of the best thread queued on a CPU, lower is
+ * better, or 32 when its queue is empty.  The MULTIQ bitmask is kept
+ * up to date by every add and remove, so it doubles as the summary
+ * siblings compare against without walking each other's lists.
+ */
+static inline int runq_top(struct _cpu *cpu)
+{
+	u32_t bits = cpu->runq.bitmask;
+
+	return bits == 0U ? 32 : __builtin_ctz(bits);
+}
+
+/* Work stealing: the highest priority thread we are allowed to run
+ * from the sibling queues whose summary is better than "limit",
+ * preferring the longest queue among equals.  Only those queues are
+ * walked.  This only peeks; next_up() removes the thread if it
+ * chooses it.
+ */
+static struct k_thread *runq_steal(struct _cpu *self, int limit)
+{
+	struct k_thread *ret = NULL;
+	u32_t most = 0U;
+
+	for (int id = 0; id < CONFIG_MP_NUM_CPUS; id++) {
+		struct _cpu *cpu = &_kernel.cpus[id];
+		struct k_thread *th;
+
+		if (cpu == self || runq_top(cpu) >= limit) {
+			continue;
+		}
+
+		th = runq_first_allowed(&cpu->runq, self->id);
+		if (th == NULL) {
+			continue;
+		}
+
+		if (ret == NULL || z_is_t1_higher_prio_than_t2(th, ret) ||
+		    (!z_is_t1_higher_prio_than_t2(ret, th) &&
+		     cpu->runq_count > most)) {
+			ret = th;
+			most = cpu->runq_count;
+		}
+	}
+
+	return ret;
+}
+
+/* The local head wins unless a sibling queue holds a thread of
+ * strictly higher priority, which would otherwise wait behind our
+ * lower priority work.  Siblings are only searched when our queue is
+ * empty or one of them advertises such a priority.
+ */
+static struct k_thread *runq_best(void)
+{
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *th = runq_first_allowed(&cpu->runq, cpu->id);
+	struct k_thread *remote;
+
+	remote = runq_steal(cpu, th == NULL ? 32 :
+			    th->base.prio - K_HIGHEST_THREAD_PRIO);
+
+	if (th == NULL ||
+	    (remote != NULL && z_is_t1_higher_prio_than_t2(remote, th))) {
+		return remote;
+	}
+
+	return th;
+}
+#else
+static ALWAYS_INLINE void runq_add(struct k_thread *th)
+{
+	_priq_run_add(&_kernel.ready_q.runq, th);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *th)
+{
+	_priq_run_remove(&_kernel.ready_q.runq, th);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 #ifndef CONFIG_SMP
@@ -185,7 +392,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	 * responsible for putting it back in z_swap and ISR return!),
 	 * which makes this choice simple.
 	 */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best();
 
 	return th ? th : _current_cpu->idle_thread;
 #else
@@ -203,7 +410,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	int active = !z_is_thread_prevented_from_running(_current);
 
 	/* Choose the best thread that is not current */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best();
 	if (th == NULL) {
 		th = _current_cpu->idle_thread;
 	}
@@ -221,13 +428,13 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 
 	/* Put _current back into the queue */
 	if (th != _current && active && !is_idle(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(th)) {
-		_priq_run_remove(&_kernel.ready_q.runq, th);
+		runq_remove(th);
 	}
 	z_mark_thread_as_not_queued(th);
 
@@ -330,8 +537,10 @@ static void update_cache(int preempt_ok)
 
 void z_add_thread_to_ready_q(struct k_thread *thread)
 {
+	z_sched_stats_ready(thread);
+
 	LOCKED(&sched_spinlock) {
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
 	}
@@ -340,8 +549,11 @@ void z_add_thread_to_ready_q(struct k_thread *thread)
 void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		/* Under SMP, _current is not in the queue */
+		if (z_is_thread_queued(thread)) {
+			runq_remove(thread);
+		}
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(thread == _current);
 	}
@@ -351,7 +563,7 @@ void z_remove_thread_from_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		update_cache(thread == _current);
@@ -485,9 +697,9 @@ void z_thread_priority_set(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -582,6 +794,9 @@ static inline void set_current(struct k_thread *new_thread)
 #ifdef CONFIG_TRACING
 	sys_trace_thread_switched_out();
 #endif
+	if (new_thread != _current) {
+		z_sched_stats_switch(_current, new_thread);
+	}
 	_current = new_thread;
 #ifdef CONFIG_TRACING
 	sys_trace_thread_switched_in();
@@ -818,6 +1033,16 @@ void z_sched_init(void)
 	}
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int id = 0; id < CONFIG_MP_NUM_CPUS; id++) {
+		struct _priq_mq *pq = &_kernel.cpus[id].runq;
+
+		for (int i = 0; i < ARRAY_SIZE(pq->queues); i++) {
+			sys_dlist_init(&pq->queues[i]);
+		}
+	}
+#endif
+
 #ifdef CONFIG_TIMESLICING
 	k_sched_time_slice_set(CONFIG_TIMESLICE_SIZE,
 		CONFIG_TIMESLICE_PRIORITY);
@@ -873,8 +1098,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		th->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(th)) {
-			_priq_run_remove(&_kernel.ready_q.runq, th);
-			_priq_run_add(&_kernel.ready_q.runq, th);
+			runq_remove(th);
+			runq_add(th);
 		}
 	}
 }
@@ -903,10 +1128,8 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
-				_priq_run_add(&_kernel.ready_q.runq,
-					      _current);
+				runq_remove(_current);
+				runq_add(_current);
 			}
 			update_cache(1);
 		}
@@ -1058,7 +1281,7 @@ void z_sched_abort(struct k_thread *thread)
 		LOCKED(&sched_spinlock) {
 			if (z_is_thread_queued(thread)) {
 				thread->base.thread_state |= _THREAD_DEAD;
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 		}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Scheduling latency statistics
+ *
+ * Every context switch is timestamped with the cycle counter.  The
+ * outgoing thread gets the length of the slice it just ran recorded,
+ * and if it is still ready (preempted, or yielding) the time it starts
+ * waiting to run again.  The incoming thread gets the time it waited
+ * since it was made ready recorded.  Histograms have power of two
+ * buckets, so recording is a subtraction and a find-last-set.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <spinlock.h>
+#include <syscall_handler.h>
+#include <string.h>
+
+#define NUM_PRIOS (K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO + 1)
+
+static struct k_spinlock lock;
+static struct k_sched_stats prio_stats[NUM_PRIOS];
+
+static inline struct k_sched_stats *stats_of_prio(int prio)
+{
+	__ASSERT_NO_MSG(prio >= K_HIGHEST_THREAD_PRIO &&
+			prio <= K_LOWEST_THREAD_PRIO);
+
+	return &prio_stats[prio - K_HIGHEST_THREAD_PRIO];
+}
+
+static inline void record(u32_t *hist, u32_t *max, u32_t cycles)
+{
+	u32_t bucket = find_msb_set(cycles >> 4);
+
+	hist[MIN(bucket, K_SCHED_STATS_BUCKETS - 1)]++;
+	if (cycles > *max) {
+		*max = cycles;
+	}
+}
+
+static inline bool is_dummy(struct k_thread *thread)
+{
+	return (thread->base.thread_state & _THREAD_DUMMY) != 0U;
+}
+
+static inline bool is_idle(struct k_thread *thread)
+{
+#ifdef CONFIG_SMP
+	return thread->base.is_idle;
+#else
+	extern k_tid_t const _idle_thread;
+
+	return thread == _idle_thread;
+#endif
+}
+
+void z_sched_stats_ready(struct k_thread *thread)
+{
+	thread->sched_ready_stamp = k_cycle_get_32();
+}
+
+void z_sched_stats_switch(struct k_thread *old_thread,
+			  struct k_thread *new_thread)
+{
+	u32_t now = k_cycle_get_32();
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct k_sched_stats *ps;
+	u32_t cycles;
+
+	if (!is_dummy(old_thread)) {
+		ps = stats_of_prio(old_thread->base.prio);
+		cycles = now - old_thread->sched_run_stamp;
+		record(old_thread->sched_stats.run_hist,
+		       &old_thread->sched_stats.run_max, cycles);
+		record(ps->run_hist, &ps->run_max, cycles);
+
+		if (z_is_thread_ready(old_thread)) {
+			old_thread->sched_stats.preemptions++;
+			ps->preemptions++;
+			old_thread->sched_ready_stamp = now;
+		}
+	}
+
+	/* Idle threads, and threads that were never made ready through
+	 * z_sched_stats_ready() (e.g. the first switch to main), have no
+	 * wait to record.  The stamp is consumed so it is never reused.
+	 */
+	ps = stats_of_prio(new_thread->base.prio);
+	if (new_thread->sched_ready_stamp != 0U && !is_idle(new_thread)) {
+		cycles = now - new_thread->sched_ready_stamp;
+		record(new_thread->sched_stats.wait_hist,
+		       &new_thread->sched_stats.wait_max, cycles);
+		record(ps->wait_hist, &ps->wait_max, cycles);
+	}
+	new_thread->sched_ready_stamp = 0U;
+	new_thread->sched_stats.switches++;
+	ps->switches++;
+	new_thread->sched_run_stamp = now;
+
+	k_spin_unlock(&lock, key);
+}
+
+int z_impl_k_thread_sched_stats_get(k_tid_t thread,
+				    struct k_sched_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*stats = thread->sched_stats;
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int z_impl_k_sched_prio_stats_get(int prio, struct k_sched_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	if (prio < K_HIGHEST_THREAD_PRIO || prio > K_LOWEST_THREAD_PRIO) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	*stats = *stats_of_prio(prio);
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+void k_sched_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	(void)memset(prio_stats, 0, sizeof(prio_stats));
+#ifdef CONFIG_THREAD_MONITOR
+	for (struct k_thread *thread = _kernel.threads; thread != NULL;
+	     thread = thread->next_thread) {
+		(void)memset(&thread->sched_stats, 0,
+			     sizeof(thread->sched_stats));
+	}
+#endif
+
+	k_spin_unlock(&lock, key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_sched_stats_get, thread, stats)
+{
+	struct k_sched_stats kstats;
+	int ret;
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+
+	ret = z_impl_k_thread_sched_stats_get((k_tid_t)thread, &kstats);
+	Z_OOPS(z_user_to_copy((void *)stats, &kstats, sizeof(kstats)));
+
+	return ret;
+}
+
+Z_SYSCALL_HANDLER(k_sched_prio_stats_get, prio, stats)
+{
+	struct k_sched_stats kstats;
+	int ret;
+
+	ret = z_impl_k_sched_prio_stats_get((int)prio, &kstats);
+	if (ret == 0) {
+		Z_OOPS(z_user_to_copy((void *)stats, &kstats,
+				      sizeof(kstats)));
+	}
+
+	return ret;
+}
+#endif /* CONFIG_USERSPACE */
@@ -32,3 +32,20 @@ static int k_sys_work_q_init(struct device *dev)
 }
 
 SYS_INIT(k_sys_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#ifdef CONFIG_SYSTEM_WORK_POOL
+K_WORK_POOL_DEFINE(k_sys_work_pool, CONFIG_SYSTEM_WORK_POOL_WORKERS,
+		   CONFIG_SYSTEM_WORK_POOL_STACK_SIZE);
+
+static int k_sys_work_pool_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_pool_start(&k_sys_work_pool, CONFIG_SYSTEM_WORK_POOL_PRIORITY);
+
+	return 0;
+}
+
+SYS_INIT(k_sys_work_pool_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_SYSTEM_WORK_POOL */
@@ -458,6 +458,10 @@ void z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_SCHED_CPU_MASK
 	new_thread->base.cpu_mask = -1;
 #endif
+#ifdef CONFIG_SCHED_STATS
+	(void)memset(&new_thread->sched_stats, 0,
+		     sizeof(new_thread->sched_stats));
+#endif
 #ifdef CONFIG_ARCH_HAS_CUSTOM_SWAP_TO_MAIN
 	/* _current may be null if the dummy thread is not used */
 	if (!_current) {
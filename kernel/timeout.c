@@ -17,8 +17,6 @@
 
 static u64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -27,6 +25,14 @@ static struct k_spinlock timeout_lock;
 /* Cycles left to process in the currently-executing z_clock_announce() */
 static int announce_remaining;
 
+/* Tick (truncated to 32 bits) by which the timer driver will announce
+ * at the latest, as of the last next_timeout(), if it was asked to at
+ * all.  A new timeout whose deadline is not earlier does not need the
+ * driver reprogrammed, so arming it needn't look at the queue.
+ */
+static u32_t armed_tick;
+static bool armed;
+
 #if defined(CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME)
 int z_clock_hw_cycles_per_sec = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
 
@@ -38,6 +44,267 @@ Z_SYSCALL_HANDLER(z_clock_hw_cycles_per_sec_runtime_get)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+static s32_t elapsed(void)
+{
+	return announce_remaining == 0 ? z_clock_elapsed() : 0;
+}
+
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+/* Hierarchical timing wheel.  Each pending timeout stores its
+ * absolute expiry tick (truncated to 32 bits) in dticks and sits in
+ * one slot of one of WHEEL_LEVELS wheels of WHEEL_SLOTS slots.  A
+ * slot of level L spans 64^L ticks, and a timeout goes in the finest
+ * level whose range covers its distance from curr_tick, at the slot
+ * its expiry hashes to.  When time reaches the start of a slot on a
+ * level above zero, that slot's timeouts are re-filed ("cascaded")
+ * into finer levels; level zero slots are exact ticks and simply
+ * expire.
+ *
+ * A per-level bitmap marks the slots that may be non-empty.  Bits
+ * are cleared lazily: z_abort_timeout() just unlinks the node, and
+ * the stale bit is dropped the next time wheel_next() finds the slot
+ * empty.  A clear bit always means an empty slot, so its list head
+ * is (re)initialized when the first timeout goes into it, which also
+ * spares us a boot-time init of the whole array.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_LEVELS 4
+
+/* Ticks spanned by one slot of the given level, and by all levels */
+#define LVL_TICKS(l) (1U << (WHEEL_BITS * (l)))
+#define WHEEL_RANGE LVL_TICKS(WHEEL_LEVELS)
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static u64_t wheel_bits[WHEEL_LEVELS];
+
+static inline int slot_of(u32_t tick, int lvl)
+{
+	return (tick >> (WHEEL_BITS * lvl)) & (WHEEL_SLOTS - 1);
+}
+
+/* Distance (0 to WHEEL_SLOTS - 1) from slot s to the first marked
+ * slot at or after it on the level, wrapping around, or -1 if none.
+ */
+static int slot_scan(int lvl, int s)
+{
+	u64_t m = wheel_bits[lvl];
+	u32_t lo;
+
+	if (m == 0U) {
+		return -1;
+	}
+
+	if (s != 0) {
+		m = (m >> s) | (m << (WHEEL_SLOTS - s));
+	}
+
+	lo = (u32_t)m;
+	return lo != 0U ? find_lsb_set(lo) - 1
+		: find_lsb_set((u32_t)(m >> 32)) + 31;
+}
+
+static void wheel_insert(struct _timeout *to)
+{
+	u32_t now = (u32_t)curr_tick;
+	u32_t expiry = (u32_t)to->dticks;
+	u32_t delta = expiry - now;
+	int lvl, s;
+
+	for (lvl = 0; lvl < WHEEL_LEVELS - 1; lvl++) {
+		if (delta < LVL_TICKS(lvl + 1)) {
+			break;
+		}
+	}
+
+	/* Out of range: park it in the furthest slot.  It gets filed
+	 * again, with its real expiry, when that slot is cascaded.
+	 */
+	if (delta >= WHEEL_RANGE) {
+		expiry = now + WHEEL_RANGE - 1;
+	}
+
+	s = slot_of(expiry, lvl);
+	if ((wheel_bits[lvl] & ((u64_t)1 << s)) == 0U) {
+		sys_dlist_init(&wheel[lvl][s]);
+		wheel_bits[lvl] |= (u64_t)1 << s;
+	}
+	sys_dlist_append(&wheel[lvl][s], &to->node);
+}
+
+/* Ticks from curr_tick to the next tick at which the wheel has work
+ * to do, either an expiry or a cascade, or -1 if it is empty.  For
+ * levels above zero this is the start of the slot, so it is only a
+ * lower bound on the next expiry.
+ */
+static s32_t level_next(int lvl)
+{
+	u32_t now = (u32_t)curr_tick;
+	int cur = slot_of(now, lvl);
+	int k, s;
+
+	while ((k = slot_scan(lvl, (cur + 1) & (WHEEL_SLOTS - 1))) >= 0) {
+		s = (cur + 1 + k) & (WHEEL_SLOTS - 1);
+		if (!sys_dlist_is_empty(&wheel[lvl][s])) {
+			break;
+		}
+		wheel_bits[lvl] &= ~((u64_t)1 << s);
+	}
+
+	if (k < 0) {
+		return -1;
+	}
+
+	return (s32_t)((((now >> (WHEEL_BITS * lvl)) + k + 1)
+			<< (WHEEL_BITS * lvl)) - now);
+}
+
+static s32_t next_expiry(void)
+{
+	s32_t ret = -1;
+
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		s32_t dt = level_next(lvl);
+
+		if (dt >= 0 && (ret < 0 || dt < ret)) {
+			ret = dt;
+		}
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Ticks from curr_tick by which the clock must next be announced:
+ * the earliest expiry plus slack of the level zero timeouts, but no
+ * later than the next cascade, whose timeouts we can't see yet.  -1
+ * if the wheel is empty.
+ */
+static s32_t first_deadline(void)
+{
+	int cur = slot_of((u32_t)curr_tick, 0);
+	s32_t ret = -1;
+
+	for (int lvl = 1; lvl < WHEEL_LEVELS; lvl++) {
+		s32_t dt = level_next(lvl);
+
+		if (dt >= 0 && (ret < 0 || dt < ret)) {
+			ret = dt;
+		}
+	}
+
+	/* Level zero slots are exact ticks, only visit the marked ones */
+	for (s32_t dt = 1; dt < WHEEL_SLOTS && (ret < 0 || dt <= ret); dt++) {
+		int k = slot_scan(0, (cur + dt) & (WHEEL_SLOTS - 1));
+		struct _timeout *t;
+		int s;
+
+		if (k < 0 || dt + k >= WHEEL_SLOTS ||
+		    (ret >= 0 && dt + k > ret)) {
+			break;
+		}
+		dt += k;
+		s = (cur + dt) & (WHEEL_SLOTS - 1);
+
+		SYS_DLIST_FOR_EACH_CONTAINER(&wheel[0][s], t, node) {
+			s32_t d = dt + MIN(t->slack, INT_MAX - dt);
+
+			if (ret < 0 || d < ret) {
+				ret = d;
+			}
+		}
+	}
+
+	return ret;
+}
+#else
+#define first_deadline() next_expiry()
+#endif
+
+/* Runs the wheel at tick curr_tick: cascades every level whose slot
+ * boundary this is, coarsest first so entries can trickle all the way
+ * down, then expires level zero.  Called and returns with the lock
+ * held, but drops it around each callback.
+ */
+static k_spinlock_key_t wheel_process(k_spinlock_key_t key)
+{
+	u32_t now = (u32_t)curr_tick;
+	sys_dnode_t *node;
+	int s;
+
+	for (int lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+		s = slot_of(now, lvl);
+		if ((now & (LVL_TICKS(lvl) - 1)) != 0U ||
+		    (wheel_bits[lvl] & ((u64_t)1 << s)) == 0U) {
+			continue;
+		}
+
+		/* No entry can hash back to this same slot */
+		while ((node = sys_dlist_get(&wheel[lvl][s])) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+		wheel_bits[lvl] &= ~((u64_t)1 << s);
+	}
+
+	s = slot_of(now, 0);
+	if ((wheel_bits[0] & ((u64_t)1 << s)) == 0U) {
+		return key;
+	}
+
+	/* Callbacks may add timeouts, but never for the current tick */
+	while ((node = sys_dlist_get(&wheel[0][s])) != NULL) {
+		struct _timeout *t = CONTAINER_OF(node, struct _timeout, node);
+
+		k_spin_unlock(&timeout_lock, key);
+		t->fn(t);
+		key = k_spin_lock(&timeout_lock);
+	}
+	wheel_bits[0] &= ~((u64_t)1 << s);
+
+	return key;
+}
+
+/* Must be called with the lock held */
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	to->dticks = (s32_t)((u32_t)curr_tick + (u32_t)(ticks + elapsed()));
+	wheel_insert(to);
+}
+
+int z_abort_timeout(struct _timeout *to)
+{
+	int ret = -EINVAL;
+
+	LOCKED(&timeout_lock) {
+		if (sys_dnode_is_linked(&to->node)) {
+			sys_dlist_remove(&to->node);
+			ret = 0;
+		}
+	}
+
+	return ret;
+}
+
+s32_t z_timeout_remaining(struct _timeout *timeout)
+{
+	s32_t ticks = 0;
+
+	if (z_is_inactive_timeout(timeout)) {
+		return 0;
+	}
+
+	LOCKED(&timeout_lock) {
+		ticks = (s32_t)((u32_t)timeout->dticks - (u32_t)curr_tick);
+	}
+
+	return ticks - elapsed();
+}
+
+#else /* CONFIG_TIMEOUT_QUEUE_DLIST */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -61,52 +328,59 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
-static s32_t elapsed(void)
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Ticks from curr_tick by which the clock must next be announced:
+ * the earliest expiry plus slack of all timeouts, which can only come
+ * from those expiring before it.  -1 if the list is empty.
+ */
+static s32_t first_deadline(void)
 {
-	return announce_remaining == 0 ? z_clock_elapsed() : 0;
-}
+	s32_t ticks = 0;
+	s32_t ret = -1;
 
-static s32_t next_timeout(void)
-{
-	struct _timeout *to = first();
-	s32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - elapsed());
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (ret >= 0 && ticks > ret) {
+			break;
+		}
 
-#ifdef CONFIG_TIMESLICING
-	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
-		ret = _current_cpu->slice_ticks;
+		s32_t d = ticks + MIN(t->slack, INT_MAX - ticks);
+
+		if (ret < 0 || d < ret) {
+			ret = d;
+		}
 	}
-#endif
+
 	return ret;
 }
-
-void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
+#else
+static s32_t first_deadline(void)
 {
-	__ASSERT(!sys_dnode_is_linked(&to->node), "");
-	to->fn = fn;
-	ticks = MAX(1, ticks);
+	struct _timeout *to = first();
 
-	LOCKED(&timeout_lock) {
-		struct _timeout *t;
+	return to == NULL ? -1 : to->dticks;
+}
+#endif
 
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			__ASSERT(t->dticks >= 0, "");
+/* Must be called with the lock held */
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	struct _timeout *t;
 
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
+	to->dticks = ticks + elapsed();
+	for (t = first(); t != NULL; t = next(t)) {
+		__ASSERT(t->dticks >= 0, "");
 
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
 		}
+		to->dticks -= t->dticks;
+	}
 
-		if (to == first()) {
-			z_clock_set_timeout(next_timeout(), false);
-		}
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
 	}
 }
 
@@ -144,6 +418,55 @@ s32_t z_timeout_remaining(struct _timeout *timeout)
 	return ticks - elapsed();
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
+static s32_t next_timeout(void)
+{
+	s32_t next = first_deadline();
+	s32_t ret = next < 0 ? MAX_WAIT : MAX(0, next - elapsed());
+
+	/* The driver is programmed no later than this, either here or
+	 * because nothing queued since its last programming was earlier
+	 */
+	armed = next >= 0;
+	armed_tick = (u32_t)curr_tick + (u32_t)next;
+
+#ifdef CONFIG_TIMESLICING
+	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
+		ret = _current_cpu->slice_ticks;
+	}
+#endif
+	return ret;
+}
+
+void z_add_timeout_slack(struct _timeout *to, _timeout_func_t fn,
+			 s32_t ticks, s32_t slack)
+{
+	__ASSERT(!sys_dnode_is_linked(&to->node), "");
+	to->fn = fn;
+	ticks = MAX(1, ticks);
+#ifdef CONFIG_TIMEOUT_SLACK
+	to->slack = MAX(0, slack);
+#else
+	ARG_UNUSED(slack);
+#endif
+
+	LOCKED(&timeout_lock) {
+		s32_t deadline = ticks + elapsed();
+
+#ifdef CONFIG_TIMEOUT_SLACK
+		deadline += MIN(to->slack, INT_MAX - deadline);
+#endif
+		insert_timeout(to, ticks);
+
+		/* Only reprogram when this one has to fire first */
+		if (!armed ||
+		    deadline < (s32_t)(armed_tick - (u32_t)curr_tick)) {
+			z_clock_set_timeout(next_timeout(), false);
+		}
+	}
+}
+
 s32_t z_get_next_timeout_expiry(void)
 {
 	s32_t ret = K_FOREVER;
@@ -183,6 +506,14 @@ void z_clock_announce(s32_t ticks)
 
 	announce_remaining = ticks;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	for (s32_t dt = next_expiry();
+	     dt >= 0 && dt <= announce_remaining; dt = next_expiry()) {
+		curr_tick += dt;
+		announce_remaining -= dt;
+		key = wheel_process(key);
+	}
+#else
 	while (first() != NULL && first()->dticks <= announce_remaining) {
 		struct _timeout *t = first();
 		int dt = t->dticks;
@@ -200,6 +531,7 @@ void z_clock_announce(s32_t ticks)
 	if (first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
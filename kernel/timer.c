@@ -52,8 +52,14 @@ void z_timer_expiration_handler(struct _timeout *t)
 	 * since we're already aligned to a tick boundary
 	 */
 	if (timer->period > 0) {
+#ifdef CONFIG_TIMEOUT_SLACK
+		z_add_timeout_slack(&timer->timeout,
+				    z_timer_expiration_handler,
+				    timer->period, timer->timeout.slack);
+#else
 		z_add_timeout(&timer->timeout, z_timer_expiration_handler,
 			     timer->period);
+#endif
 	}
 
 	/* update timer's status */
@@ -104,7 +110,8 @@ void k_timer_init(struct k_timer *timer,
 }
 
 
-void z_impl_k_timer_start(struct k_timer *timer, s32_t duration, s32_t period)
+static void timer_start(struct k_timer *timer, s32_t duration, s32_t period,
+			s32_t slack)
 {
 	__ASSERT(duration >= 0 && period >= 0 &&
 		 (duration != 0 || period != 0), "invalid parameters\n");
@@ -117,8 +124,13 @@ void z_impl_k_timer_start(struct k_timer *timer, s32_t duration, s32_t period)
 	(void)z_abort_timeout(&timer->timeout);
 	timer->period = period_in_ticks;
 	timer->status = 0U;
-	z_add_timeout(&timer->timeout, z_timer_expiration_handler,
-		     duration_in_ticks);
+	z_add_timeout_slack(&timer->timeout, z_timer_expiration_handler,
+			    duration_in_ticks, slack);
+}
+
+void z_impl_k_timer_start(struct k_timer *timer, s32_t duration, s32_t period)
+{
+	timer_start(timer, duration, period, 0);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -137,6 +149,34 @@ Z_SYSCALL_HANDLER(k_timer_start, timer, duration_p, period_p)
 }
 #endif
 
+#ifdef CONFIG_TIMEOUT_SLACK
+void z_impl_k_timer_start_slack(struct k_timer *timer, s32_t duration,
+				s32_t period, s32_t slack)
+{
+	__ASSERT(slack >= 0, "invalid slack\n");
+
+	timer_start(timer, duration, period, z_ms_to_ticks(slack));
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_timer_start_slack, timer, duration_p, period_p, slack_p)
+{
+	s32_t duration, period, slack;
+
+	duration = (s32_t)duration_p;
+	period = (s32_t)period_p;
+	slack = (s32_t)slack_p;
+
+	Z_OOPS(Z_SYSCALL_VERIFY(duration >= 0 && period >= 0 &&
+				(duration != 0 || period != 0) && slack >= 0));
+	Z_OOPS(Z_SYSCALL_OBJ(timer, K_OBJ_TIMER));
+	z_impl_k_timer_start_slack((struct k_timer *)timer, duration, period,
+				   slack);
+	return 0;
+}
+#endif
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 void z_impl_k_timer_stop(struct k_timer *timer)
 {
 	int inactive = z_abort_timeout(&timer->timeout) != 0;
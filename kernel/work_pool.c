@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Multi-threaded work pools
+ *
+ * Each worker owns two lists behind its own spinlock: "local" items
+ * that were submitted with an affinity to it, and "shared" items that
+ * any worker may take.  A worker drains its local list, then the
+ * pool's ordered list (if no other ordered item is running), then its
+ * shared list, and finally steals from the shared lists of its
+ * siblings.  Stealing takes the oldest item, so work submitted to a
+ * busy worker doesn't wait behind newer work.  The pool lock is
+ * touched only to run ordered items and to put workers to sleep or
+ * wake them.
+ *
+ * A submitter publishes the item before reading num_idle, and a
+ * worker bumps num_idle before its last look at the lists, so a
+ * submitter that skips the pool lock can't strand an item next to a
+ * sleeping worker.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <spinlock.h>
+
+#define WORK_POOL_THREAD_NAME	"workpool"
+
+/* k_work keeps its first word free for whatever queue it's on */
+static inline sys_snode_t *work_node(struct k_work *work)
+{
+	return (sys_snode_t *)work;
+}
+
+static inline struct k_work *node_work(sys_snode_t *node)
+{
+	return (struct k_work *)node;
+}
+
+static struct k_work *list_get(struct k_work_pool_worker *w,
+			       sys_slist_t *list)
+{
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	if (sys_slist_is_empty(list)) {
+		return NULL;
+	}
+
+	key = k_spin_lock(&w->lock);
+	node = sys_slist_get(list);
+	k_spin_unlock(&w->lock, key);
+
+	return node_work(node);
+}
+
+/* Must be called with the pool lock held */
+static struct k_work *ordered_get(struct k_work_pool *pool)
+{
+	sys_snode_t *node;
+
+	if (pool->ordered_busy) {
+		return NULL;
+	}
+
+	node = sys_slist_get(&pool->ordered);
+	if (node != NULL) {
+		pool->ordered_busy = true;
+	}
+
+	return node_work(node);
+}
+
+static struct k_work *steal(struct k_work_pool_worker *w)
+{
+	struct k_work_pool *pool = w->pool;
+	u32_t me = w - pool->workers;
+	struct k_work *work;
+
+	for (u32_t i = 1; i < pool->num_workers; i++) {
+		struct k_work_pool_worker *victim =
+			&pool->workers[(me + i) % pool->num_workers];
+
+		work = list_get(victim, &victim->shared);
+		if (work != NULL) {
+			return work;
+		}
+	}
+
+	return NULL;
+}
+
+/* Everything but the ordered list, which needs the pool lock */
+static struct k_work *next_unordered(struct k_work_pool_worker *w)
+{
+	struct k_work *work;
+
+	work = list_get(w, &w->local);
+	if (work == NULL) {
+		work = list_get(w, &w->shared);
+	}
+	if (work == NULL) {
+		work = steal(w);
+	}
+
+	return work;
+}
+
+static struct k_work *next_work(struct k_work_pool_worker *w, bool *ordered)
+{
+	struct k_work_pool *pool = w->pool;
+	struct k_work *work;
+	k_spinlock_key_t key;
+
+	*ordered = false;
+
+	work = list_get(w, &w->local);
+	if (work != NULL) {
+		return work;
+	}
+
+	if (!sys_slist_is_empty(&pool->ordered)) {
+		key = k_spin_lock(&pool->lock);
+		work = ordered_get(pool);
+		k_spin_unlock(&pool->lock, key);
+		if (work != NULL) {
+			*ordered = true;
+			return work;
+		}
+	}
+
+	work = next_unordered(w);
+	if (work != NULL) {
+		return work;
+	}
+
+	/* Nothing found: announce we're idle, then look once more
+	 * under the pool lock before going to sleep.
+	 */
+	key = k_spin_lock(&pool->lock);
+	w->idle = true;
+	(void)atomic_inc(&pool->num_idle);
+
+	work = ordered_get(pool);
+	if (work != NULL) {
+		*ordered = true;
+	} else {
+		work = next_unordered(w);
+	}
+
+	if (work != NULL) {
+		w->idle = false;
+		(void)atomic_dec(&pool->num_idle);
+		k_spin_unlock(&pool->lock, key);
+		return work;
+	}
+
+	/* Whoever wakes us clears idle and num_idle */
+	(void)z_pend_curr(&pool->lock, key, &w->wait_q, K_FOREVER);
+
+	return NULL;
+}
+
+static void worker_main(void *worker_ptr, void *p2, void *p3)
+{
+	struct k_work_pool_worker *w = worker_ptr;
+	struct k_work_pool *pool = w->pool;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct k_work *work;
+		bool ordered;
+
+		work = next_work(w, &ordered);
+		if (work == NULL) {
+			continue;
+		}
+
+		/* Reset pending state so it can be resubmitted by handler */
+		if (atomic_test_and_clear_bit(work->flags,
+					      K_WORK_STATE_PENDING)) {
+			work->handler(work);
+		}
+
+		if (ordered) {
+			k_spinlock_key_t key = k_spin_lock(&pool->lock);
+
+			pool->ordered_busy = false;
+			k_spin_unlock(&pool->lock, key);
+		}
+
+		/* Make sure we don't hog up the CPU if the queues never
+		 * (or very rarely) get empty.
+		 */
+		k_yield();
+	}
+}
+
+/* Must be called with the pool lock held */
+static bool wake_locked(struct k_work_pool_worker *w)
+{
+	struct k_thread *thread;
+
+	/* A worker stays idle from setting the flag until it has pended,
+	 * all under the pool lock, so an idle worker is always on its
+	 * wait queue here.
+	 */
+	if (!w->idle) {
+		return false;
+	}
+
+	thread = z_unpend_first_thread(&w->wait_q);
+	__ASSERT_NO_MSG(thread != NULL);
+
+	w->idle = false;
+	(void)atomic_dec(&w->pool->num_idle);
+	z_ready_thread(thread);
+
+	return true;
+}
+
+/* Wakes target if it is asleep, or else (unless the item is pinned to
+ * target) any sleeping worker, which will steal the item.
+ */
+static void wake(struct k_work_pool *pool, struct k_work_pool_worker *target,
+		 bool pinned)
+{
+	k_spinlock_key_t key;
+	bool woken = false;
+
+	if (atomic_get(&pool->num_idle) == 0) {
+		return;
+	}
+
+	key = k_spin_lock(&pool->lock);
+
+	if (target != NULL) {
+		woken = wake_locked(target);
+	}
+
+	for (u32_t i = 0; !woken && !pinned && i < pool->num_workers; i++) {
+		woken = wake_locked(&pool->workers[i]);
+	}
+
+	if (woken) {
+		z_reschedule(&pool->lock, key);
+	} else {
+		k_spin_unlock(&pool->lock, key);
+	}
+}
+
+static void list_put(struct k_work_pool_worker *w, sys_slist_t *list,
+		     struct k_work *work)
+{
+	k_spinlock_key_t key = k_spin_lock(&w->lock);
+
+	sys_slist_append(list, work_node(work));
+	k_spin_unlock(&w->lock, key);
+}
+
+static struct k_work_pool_worker *current_worker(struct k_work_pool *pool)
+{
+	for (u32_t i = 0; i < pool->num_workers; i++) {
+		if (_current == &pool->workers[i].thread) {
+			return &pool->workers[i];
+		}
+	}
+
+	return NULL;
+}
+
+void k_work_pool_submit(struct k_work_pool *pool, struct k_work *work)
+{
+	struct k_work_pool_worker *w = NULL;
+
+	if (atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return;
+	}
+
+	if (!z_is_in_isr()) {
+		w = current_worker(pool);
+	}
+	if (w == NULL) {
+		u32_t n = (u32_t)atomic_inc(&pool->next);
+
+		w = &pool->workers[n % pool->num_workers];
+	}
+
+	list_put(w, &w->shared, work);
+	wake(pool, w, false);
+}
+
+void k_work_pool_submit_to_worker(struct k_work_pool *pool,
+				  struct k_work *work, int worker)
+{
+	struct k_work_pool_worker *w = &pool->workers[worker];
+
+	__ASSERT(worker >= 0 && worker < pool->num_workers,
+		 "invalid worker %d", worker);
+
+	if (atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return;
+	}
+
+	list_put(w, &w->local, work);
+	wake(pool, w, true);
+}
+
+void k_work_pool_submit_ordered(struct k_work_pool *pool,
+				struct k_work *work)
+{
+	k_spinlock_key_t key;
+	bool busy;
+
+	if (atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return;
+	}
+
+	key = k_spin_lock(&pool->lock);
+	sys_slist_append(&pool->ordered, work_node(work));
+	busy = pool->ordered_busy;
+	k_spin_unlock(&pool->lock, key);
+
+	/* The worker running the current ordered item picks this one
+	 * up when it's done.
+	 */
+	if (!busy) {
+		wake(pool, NULL, false);
+	}
+}
+
+void k_work_pool_start(struct k_work_pool *pool, int prio)
+{
+	for (u32_t i = 0; i < pool->num_workers; i++) {
+		struct k_work_pool_worker *w = &pool->workers[i];
+		k_thread_stack_t *stack = (k_thread_stack_t *)
+			((char *)pool->stacks + i * pool->stack_stride);
+
+		w->pool = pool;
+		sys_slist_init(&w->shared);
+		sys_slist_init(&w->local);
+		z_waitq_init(&w->wait_q);
+		w->idle = false;
+
+		(void)k_thread_create(&w->thread, stack, pool->stack_size,
+				      worker_main, w, NULL, NULL, prio, 0,
+				      K_FOREVER);
+#if defined(CONFIG_SCHED_CPU_MASK) && (CONFIG_MP_NUM_CPUS > 1)
+		(void)k_thread_cpu_mask_clear(&w->thread);
+		(void)k_thread_cpu_mask_enable(&w->thread,
+					       i % CONFIG_MP_NUM_CPUS);
+#endif
+		k_thread_name_set(&w->thread, WORK_POOL_THREAD_NAME);
+	}
+
+	for (u32_t i = 0; i < pool->num_workers; i++) {
+		k_thread_start(&pool->workers[i].thread);
+	}
+}
@@ -73,9 +73,9 @@ static int work_cancel(struct k_delayed_work *work)
 	return 0;
 }
 
-int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
-				   struct k_delayed_work *work,
-				   s32_t delay)
+static int delayed_work_submit(struct k_work_q *work_q,
+			       struct k_delayed_work *work,
+			       s32_t delay, s32_t slack)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	int err = 0;
@@ -107,14 +107,32 @@ int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
 	}
 
 	/* Add timeout */
-	z_add_timeout(&work->timeout, work_timeout,
-		     _TICK_ALIGN + z_ms_to_ticks(delay));
+	z_add_timeout_slack(&work->timeout, work_timeout,
+			    _TICK_ALIGN + z_ms_to_ticks(delay), slack);
 
 done:
 	k_spin_unlock(&lock, key);
 	return err;
 }
 
+int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
+				   struct k_delayed_work *work,
+				   s32_t delay)
+{
+	return delayed_work_submit(work_q, work, delay, 0);
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+int k_delayed_work_submit_to_queue_slack(struct k_work_q *work_q,
+					 struct k_delayed_work *work,
+					 s32_t delay, s32_t slack)
+{
+	__ASSERT(slack >= 0, "invalid slack");
+
+	return delayed_work_submit(work_q, work, delay, z_ms_to_ticks(slack));
+}
+#endif
+
 int k_delayed_work_cancel(struct k_delayed_work *work)
 {
 	if (!work->work_q) {
@@ -87,9 +87,7 @@ void *calloc(size_t nmemb, size_t size)
 
 void *realloc(void *ptr, size_t requested_size)
 {
-	struct sys_mem_pool_block *blk;
-	size_t struct_blk_size = WB_UP(sizeof(struct sys_mem_pool_block));
-	size_t block_size, total_requested_size;
+	size_t block_size;
 	void *new_ptr;
 
 	if (ptr == NULL) {
@@ -101,21 +99,10 @@ void *realloc(void *ptr, size_t requested_size)
 		return NULL;
 	}
 
-	/* Stored right before the pointer passed to the user */
-	blk = (struct sys_mem_pool_block *)((char *)ptr - struct_blk_size);
+	/* Most likely a bit larger than the original allocation */
+	block_size = sys_mem_pool_usable_size(ptr);
 
-	/* Determine size of previously allocated block by its level.
-	 * Most likely a bit larger than the original allocation
-	 */
-	block_size = blk->pool->base.max_sz;
-	for (int i = 1; i <= blk->level; i++) {
-		block_size = WB_DN(block_size / 4);
-	}
-
-	/* We really need this much memory */
-	total_requested_size = requested_size + struct_blk_size;
-
-	if (block_size >= total_requested_size) {
+	if (block_size >= requested_size) {
 		/* Existing block large enough, nothing to do */
 		return ptr;
 	}
@@ -125,7 +112,7 @@ void *realloc(void *ptr, size_t requested_size)
 		return NULL;
 	}
 
-	memcpy(new_ptr, ptr, block_size - struct_blk_size);
+	memcpy(new_ptr, ptr, block_size);
 	free(ptr);
 
 	return new_ptr;
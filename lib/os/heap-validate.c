@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <sys/sys_heap.h>
+#include <kernel.h>
+#include "heap.h"
+
+/* White-box sys_heap validation code.  Uses internal data structures.
+ * Not expected to be useful in production apps.  This checks every
+ * header field of every chunk and returns true if the totality of the
+ * data structure is a valid heap.  It doesn't necessarily tell you
+ * that it is the CORRECT heap given the history of alloc/free calls
+ * that it can't inspect.  In a pathological case, you can imagine
+ * something scribbling a copy of a previously-valid heap on top of a
+ * running one and corrupting it. YMMV.
+ */
+
+static bool in_bounds(struct z_heap *h, chunkid_t c)
+{
+	return (c >= chunk_size(h, 0))
+		&& (c < h->len)
+		&& (chunk_size(h, c) < h->len);
+}
+
+static bool valid_chunk(struct z_heap *h, chunkid_t c)
+{
+	return (chunk_size(h, c) >= MIN_CHUNK_SIZE
+		&& (c + chunk_size(h, c) <= h->len)
+		&& in_bounds(h, c)
+		&& (right_chunk(h, left_chunk(h, c)) == c)
+		&& (left_chunk(h, right_chunk(h, c)) == c)
+		&& (chunk_used(h, c) || in_bounds(h, prev_free_chunk(h, c)))
+		&& (chunk_used(h, c) || in_bounds(h, next_free_chunk(h, c))));
+}
+
+/* Validate multiple state dimensions for the bucket "next" pointer
+ * and see that they match.  Probably should unify the design a
+ * bit...
+ */
+static inline void check_nexts(struct z_heap *h, int fl, int sl)
+{
+	struct z_heap_bucket *b = &h->buckets[fl];
+
+	bool emptybit = (b->sl_bitmap & BIT(sl)) == 0U;
+	bool emptylist = b->next[sl] == 0U;
+
+	CHECK(emptybit == emptylist);
+	ARG_UNUSED(emptybit);
+	ARG_UNUSED(emptylist);
+}
+
+bool sys_heap_validate(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c;
+	u32_t nfree_chunks = 0U, nfree_listed = 0U;
+
+	/* Walk the heap front to back.  Every chunk must be valid and
+	 * no two free chunks may ever be adjacent (they would have
+	 * been coalesced).
+	 */
+	for (c = chunk_size(h, 0); c < h->len; c = right_chunk(h, c)) {
+		if (!valid_chunk(h, c)) {
+			return false;
+		}
+		if (!chunk_used(h, c)) {
+			if (!chunk_used(h, right_chunk(h, c))) {
+				return false;
+			}
+			nfree_chunks++;
+		}
+	}
+	if (c != h->len || !chunk_used(h, c)) {
+		return false;  /* Should have exactly consumed the buffer */
+	}
+
+	/* Check the free lists: entry count, bitmap consistency,
+	 * and that every free chunk is in the list its size maps to.
+	 */
+	for (int fl = 0; fl < nb_fl(h); fl++) {
+		struct z_heap_bucket *b = &h->buckets[fl];
+		bool fl_empty = (h->fl_bitmap & BIT(fl)) == 0U;
+
+		if (fl_empty != (b->sl_bitmap == 0U)) {
+			return false;
+		}
+
+		for (int sl = 0; sl < SL_COUNT; sl++) {
+			chunkid_t first = b->next[sl];
+
+			check_nexts(h, fl, sl);
+			if (((b->sl_bitmap & BIT(sl)) == 0U) != (first == 0U)) {
+				return false;
+			}
+			if (first == 0U) {
+				continue;
+			}
+
+			c = first;
+			do {
+				int cfl, csl;
+
+				if (!valid_chunk(h, c) || chunk_used(h, c)) {
+					return false;
+				}
+				if (prev_free_chunk(h, next_free_chunk(h, c))
+				    != c) {
+					return false;
+				}
+				bucket_idx(chunk_size(h, c), &cfl, &csl);
+				if (cfl != fl || csl != sl) {
+					return false;
+				}
+				if (++nfree_listed > nfree_chunks) {
+					return false;
+				}
+				c = next_free_chunk(h, c);
+			} while (c != first);
+		}
+	}
+
+	for (int fl = nb_fl(h); fl < 32; fl++) {
+		if ((h->fl_bitmap & BIT(fl)) != 0U) {
+			return false;
+		}
+	}
+
+	return nfree_listed == nfree_chunks;
+}
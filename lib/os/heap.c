@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <sys/sys_heap.h>
+#include <kernel.h>
+#include <string.h>
+#include "heap.h"
+
+BUILD_ASSERT(sizeof(struct z_heap) == 16);
+BUILD_ASSERT(sizeof(struct z_heap_bucket) == 4 * (1 + SL_COUNT));
+
+static void *chunk_mem(struct z_heap *h, chunkid_t c)
+{
+	return &chunk_buf(h)[c + 1];
+}
+
+static chunkid_t mem_to_chunkid(struct z_heap *h, void *p)
+{
+	return ((chunk_unit_t *)p - chunk_buf(h)) - 1;
+}
+
+static void free_list_remove(struct z_heap *h, chunkid_t c)
+{
+	int fl, sl;
+	struct z_heap_bucket *b;
+
+	bucket_idx(chunk_size(h, c), &fl, &sl);
+	b = &h->buckets[fl];
+
+	CHECK(!chunk_used(h, c));
+	CHECK(b->next[sl] != 0);
+
+	if (next_free_chunk(h, c) == c) {
+		/* this is the last chunk */
+		b->next[sl] = 0;
+		b->sl_bitmap &= ~BIT(sl);
+		if (b->sl_bitmap == 0U) {
+			h->fl_bitmap &= ~BIT(fl);
+		}
+	} else {
+		chunkid_t first = prev_free_chunk(h, c),
+			  second = next_free_chunk(h, c);
+
+		b->next[sl] = second;
+		chunk_set(h, first, FREE_NEXT, second);
+		chunk_set(h, second, FREE_PREV, first);
+	}
+}
+
+static void free_list_add(struct z_heap *h, chunkid_t c)
+{
+	int fl, sl;
+	struct z_heap_bucket *b;
+
+	bucket_idx(chunk_size(h, c), &fl, &sl);
+	b = &h->buckets[fl];
+
+	if (b->next[sl] == 0U) {
+		CHECK((b->sl_bitmap & BIT(sl)) == 0U);
+
+		/* Empty list, first item */
+		b->sl_bitmap |= BIT(sl);
+		h->fl_bitmap |= BIT(fl);
+		chunk_set(h, c, FREE_PREV, c);
+		chunk_set(h, c, FREE_NEXT, c);
+	} else {
+		/* Insert before (!) the "next" pointer */
+		chunkid_t second = b->next[sl];
+		chunkid_t first = prev_free_chunk(h, second);
+
+		chunk_set(h, c, FREE_PREV, first);
+		chunk_set(h, c, FREE_NEXT, second);
+		chunk_set(h, first, FREE_NEXT, c);
+		chunk_set(h, second, FREE_PREV, c);
+	}
+
+	/* Newly freed chunks are the most likely to be cache-hot, so
+	 * make this the one handed out next
+	 */
+	b->next[sl] = c;
+}
+
+/* Splits chunk "lc" into a left chunk and a right chunk at "rc".
+ * The right chunk is free and is put in its free list.
+ */
+static void split_chunks(struct z_heap *h, chunkid_t lc, chunkid_t rc)
+{
+	CHECK(rc > lc);
+	CHECK(rc - lc < chunk_size(h, lc));
+
+	chunkid_t sz0 = chunk_size(h, lc);
+	chunkid_t lsz = rc - lc;
+	chunkid_t rsz = sz0 - lsz;
+
+	set_chunk_size(h, lc, lsz);
+	chunk_set(h, rc, SIZE_AND_USED, rsz << 1);
+	set_left_chunk_size(h, rc, lsz);
+	set_left_chunk_size(h, right_chunk(h, rc), rsz);
+
+	free_list_add(h, rc);
+}
+
+/* Does not modify free list */
+static void merge_chunks(struct z_heap *h, chunkid_t lc, chunkid_t rc)
+{
+	chunkid_t newsz = chunk_size(h, lc) + chunk_size(h, rc);
+
+	set_chunk_size(h, lc, newsz);
+	set_left_chunk_size(h, right_chunk(h, rc), newsz);
+}
+
+void sys_heap_free(struct sys_heap *heap, void *mem)
+{
+	if (mem == NULL) {
+		return; /* ISO C free() semantics */
+	}
+
+	struct z_heap *h = heap->heap;
+	chunkid_t c = mem_to_chunkid(h, mem);
+
+	/*
+	 * This should catch many double-free cases.
+	 * This is cheap enough so let's do it all the time.
+	 */
+	__ASSERT(chunk_used(h, c),
+		 "unexpected heap state (double-free?) for memory at %p", mem);
+
+	/*
+	 * It is easy to catch many common memory overflow cases with
+	 * a quick check on this and next chunk header fields that are
+	 * immediately before and after the freed memory.
+	 */
+	__ASSERT(left_chunk(h, right_chunk(h, c)) == c,
+		 "corrupted heap bounds (buffer overflow?) for memory at %p",
+		 mem);
+
+	set_chunk_used(h, c, false);
+
+	/* Merge with free right chunk? */
+	if (!chunk_used(h, right_chunk(h, c))) {
+		chunkid_t rc = right_chunk(h, c);
+
+		free_list_remove(h, rc);
+		merge_chunks(h, c, rc);
+	}
+
+	/* Merge with free left chunk? */
+	if (!chunk_used(h, left_chunk(h, c))) {
+		chunkid_t lc = left_chunk(h, c);
+
+		free_list_remove(h, lc);
+		merge_chunks(h, lc, c);
+		c = lc;
+	}
+
+	free_list_add(h, c);
+}
+
+/* Returns the head of a free list whose chunks are all guaranteed to
+ * hold sz units, or zero.  The request is rounded up to the next list
+ * boundary ("good fit") so that no list walking is ever needed.  Only
+ * when that fails do we fall back to the first chunk of the list the
+ * request itself maps to, which may or may not be large enough; this
+ * keeps the last few exact-size allocations of a nearly full heap
+ * from failing spuriously.
+ */
+static chunkid_t find_free_chunk(struct z_heap *h, chunkid_t sz)
+{
+	int fl, sl;
+	chunkid_t rsz = sz;
+	chunkid_t c;
+
+	if (sz >= SL_COUNT) {
+		rsz += BIT(find_msb_set(sz) - 1 - SL_LOG2) - 1;
+	}
+
+	bucket_idx(rsz, &fl, &sl);
+
+	if (fl < nb_fl(h)) {
+		u32_t slmap = h->buckets[fl].sl_bitmap & (~0U << sl);
+
+		if (slmap == 0U && fl < 31) {
+			u32_t flmap = h->fl_bitmap & (~0U << (fl + 1));
+
+			if (flmap != 0U) {
+				fl = find_lsb_set(flmap) - 1;
+				slmap = h->buckets[fl].sl_bitmap;
+			}
+		}
+
+		if (slmap != 0U) {
+			return h->buckets[fl].next[find_lsb_set(slmap) - 1];
+		}
+	}
+
+	bucket_idx(sz, &fl, &sl);
+	c = h->buckets[fl].next[sl];
+	if (c != 0U && chunk_size(h, c) >= sz) {
+		return c;
+	}
+
+	return 0;
+}
+
+void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c;
+	size_t sz;
+
+	if (bytes == 0U || bytes >= (size_t)h->len * CHUNK_UNIT) {
+		return NULL;
+	}
+
+	sz = bytes_to_chunksz(bytes);
+	c = find_free_chunk(h, sz);
+	if (c == 0U) {
+		return NULL;
+	}
+
+	free_list_remove(h, c);
+
+	/* Split off remainder if it's usefully large */
+	if (chunk_size(h, c) >= sz + MIN_CHUNK_SIZE) {
+		split_chunks(h, c, c + sz);
+	}
+
+	set_chunk_used(h, c, true);
+	return chunk_mem(h, c);
+}
+
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c = mem_to_chunkid(h, mem);
+
+	return (chunk_size(h, c) - 1) * CHUNK_UNIT;
+}
+
+void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
+{
+	/* Must fit in a 31 bit count of CHUNK_UNIT */
+	__ASSERT(bytes / CHUNK_UNIT <= 0x7fffffffU, "heap size is too big");
+
+	/* Reserve the final marker chunk's header */
+	__ASSERT(bytes > CHUNK_UNIT, "heap size is too small");
+	bytes -= CHUNK_UNIT;
+
+	/* Round the start up, the end down */
+	uintptr_t addr = ROUND_UP(mem, CHUNK_UNIT);
+	uintptr_t end = ROUND_DOWN((u8_t *)mem + bytes, CHUNK_UNIT);
+	chunkid_t buf_sz = (end - addr) / CHUNK_UNIT;
+
+	CHECK(end > addr);
+	__ASSERT(buf_sz > MIN_CHUNK_SIZE, "heap size is too small");
+
+	struct z_heap *h = (struct z_heap *)addr;
+
+	heap->heap = h;
+	h->len = buf_sz;
+	h->fl_bitmap = 0U;
+
+	size_t chunk0_size = chunksz(sizeof(struct z_heap) +
+				     nb_fl(h) * sizeof(struct z_heap_bucket));
+
+	__ASSERT(chunk0_size + MIN_CHUNK_SIZE < buf_sz,
+		 "heap size is too small");
+
+	(void)memset(h->buckets, 0, nb_fl(h) * sizeof(struct z_heap_bucket));
+
+	/* chunk containing our struct z_heap */
+	chunk_set(h, 0, SIZE_AND_USED, chunk0_size << 1);
+	set_left_chunk_size(h, 0, 0);
+	set_chunk_used(h, 0, true);
+
+	/* chunk containing the free heap */
+	chunk_set(h, chunk0_size, SIZE_AND_USED,
+		  (buf_sz - chunk0_size) << 1);
+	set_left_chunk_size(h, chunk0_size, chunk0_size);
+
+	/* the end marker chunk */
+	chunk_set(h, buf_sz, SIZE_AND_USED, (1 << 1) | 1U);
+	set_left_chunk_size(h, buf_sz, buf_sz - chunk0_size);
+
+	free_list_add(h, chunk0_size);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_LIB_OS_HEAP_H_
+#define ZEPHYR_INCLUDE_LIB_OS_HEAP_H_
+
+/*
+ * Internal heap APIs
+ */
+
+/* Heap memory is viewed as an array of CHUNK_UNIT byte units.  Every
+ * chunk starts with a one-unit header holding two 32 bit fields: the
+ * size of the chunk to its left (so we can walk backwards to coalesce)
+ * and its own size shifted up by one, with the bottom bit used as the
+ * "used" flag.  Free chunks additionally store the indices of their
+ * neighbors in their free list in the first unit of the body, which
+ * is why the smallest chunk is two units.
+ *
+ * Chunk zero holds struct z_heap itself (its first 8 bytes overlap
+ * the chunk header) and is permanently marked used, as is a one-unit
+ * marker chunk at the very end of the heap.  Together they guarantee
+ * that every chunk handed out has a used neighbor at each end of the
+ * heap, so coalescing never needs to check bounds.
+ */
+
+#ifdef CONFIG_SYS_HEAP_VALIDATE
+#define CHECK(x) __ASSERT(x, "")
+#else
+#define CHECK(x) /**/
+#endif
+
+#define CHUNK_UNIT Z_HEAP_CHUNK_UNIT
+#define SL_LOG2 Z_HEAP_SL_LOG2
+#define SL_COUNT Z_HEAP_SL_COUNT
+
+typedef u32_t chunkid_t;
+
+typedef struct { char bytes[CHUNK_UNIT]; } chunk_unit_t;
+
+enum chunk_fields { LEFT_SIZE, SIZE_AND_USED, FREE_PREV, FREE_NEXT };
+
+/* Header plus two free list links */
+#define MIN_CHUNK_SIZE 2
+
+struct z_heap_bucket {
+	u32_t sl_bitmap;
+	chunkid_t next[SL_COUNT];
+};
+
+struct z_heap {
+	u64_t chunk0_hdr_area;  /* matches the layout of chunk 0's header */
+	u32_t len;
+	u32_t fl_bitmap;
+	struct z_heap_bucket buckets[0];
+};
+
+static inline chunk_unit_t *chunk_buf(struct z_heap *h)
+{
+	/* the struct z_heap matches with the first chunk */
+	return (chunk_unit_t *)h;
+}
+
+static inline u32_t *chunk_field_ptr(struct z_heap *h, chunkid_t c,
+				     enum chunk_fields f)
+{
+	return &((u32_t *)&chunk_buf(h)[c])[f];
+}
+
+static inline chunkid_t chunk_field(struct z_heap *h, chunkid_t c,
+				    enum chunk_fields f)
+{
+	return *chunk_field_ptr(h, c, f);
+}
+
+static inline void chunk_set(struct z_heap *h, chunkid_t c,
+			     enum chunk_fields f, chunkid_t val)
+{
+	*chunk_field_ptr(h, c, f) = val;
+}
+
+static inline chunkid_t chunk_size(struct z_heap *h, chunkid_t c)
+{
+	return chunk_field(h, c, SIZE_AND_USED) >> 1;
+}
+
+static inline bool chunk_used(struct z_heap *h, chunkid_t c)
+{
+	return (chunk_field(h, c, SIZE_AND_USED) & 1U) != 0U;
+}
+
+static inline void set_chunk_used(struct z_heap *h, chunkid_t c, bool used)
+{
+	chunkid_t val = chunk_field(h, c, SIZE_AND_USED);
+
+	chunk_set(h, c, SIZE_AND_USED, used ? (val | 1U) : (val & ~1U));
+}
+
+/* Note: the used bit is preserved */
+static inline void set_chunk_size(struct z_heap *h, chunkid_t c,
+				  chunkid_t size)
+{
+	chunkid_t used = chunk_field(h, c, SIZE_AND_USED) & 1U;
+
+	chunk_set(h, c, SIZE_AND_USED, (size << 1) | used);
+}
+
+static inline void set_left_chunk_size(struct z_heap *h, chunkid_t c,
+				       chunkid_t size)
+{
+	chunk_set(h, c, LEFT_SIZE, size);
+}
+
+static inline chunkid_t left_chunk(struct z_heap *h, chunkid_t c)
+{
+	return c - chunk_field(h, c, LEFT_SIZE);
+}
+
+static inline chunkid_t right_chunk(struct z_heap *h, chunkid_t c)
+{
+	return c + chunk_size(h, c);
+}
+
+static inline chunkid_t prev_free_chunk(struct z_heap *h, chunkid_t c)
+{
+	return chunk_field(h, c, FREE_PREV);
+}
+
+static inline chunkid_t next_free_chunk(struct z_heap *h, chunkid_t c)
+{
+	return chunk_field(h, c, FREE_NEXT);
+}
+
+/* Converts a size in bytes (of a whole region or of a request plus
+ * its header) to a count of chunk units, rounding up.
+ */
+static inline size_t chunksz(size_t bytes)
+{
+	return (bytes + CHUNK_UNIT - 1) / CHUNK_UNIT;
+}
+
+static inline size_t bytes_to_chunksz(size_t bytes)
+{
+	return 1 + chunksz(bytes);
+}
+
+/* Maps a chunk size to its first and second level list indices */
+static inline void bucket_idx(chunkid_t sz, int *fl, int *sl)
+{
+	if (sz < SL_COUNT) {
+		*fl = 0;
+		*sl = sz;
+	} else {
+		int m = find_msb_set(sz) - 1;
+
+		*fl = m - SL_LOG2 + 1;
+		*sl = (sz >> (m - SL_LOG2)) - SL_COUNT;
+	}
+}
+
+static inline int nb_fl(struct z_heap *h)
+{
+	int fl, sl;
+
+	bucket_idx(h->len, &fl, &sl);
+	return fl + 1;
+}
+
+#endif /* ZEPHYR_INCLUDE_LIB_OS_HEAP_H_ */
@@ -311,6 +311,56 @@ void z_sys_mem_pool_block_free(struct sys_mem_pool_base *p, u32_t level,
  * Functions specific to user-mode blocks
  */
 
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+
+void *sys_mem_pool_alloc(struct sys_mem_pool *p, size_t size)
+{
+	struct sys_mem_pool_block *blk;
+	char *ret;
+
+	sys_mutex_lock(&p->mutex, K_FOREVER);
+
+	size += WB_UP(sizeof(struct sys_mem_pool_block));
+	ret = sys_heap_alloc(&p->heap, size);
+	if (ret != NULL) {
+		blk = (struct sys_mem_pool_block *)ret;
+		blk->pool = p;
+		ret += WB_UP(sizeof(struct sys_mem_pool_block));
+	}
+
+	sys_mutex_unlock(&p->mutex);
+	return ret;
+}
+
+void sys_mem_pool_free(void *ptr)
+{
+	struct sys_mem_pool *p;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	ptr = (char *)ptr - WB_UP(sizeof(struct sys_mem_pool_block));
+	p = ((struct sys_mem_pool_block *)ptr)->pool;
+
+	sys_mutex_lock(&p->mutex, K_FOREVER);
+	sys_heap_free(&p->heap, ptr);
+	sys_mutex_unlock(&p->mutex);
+}
+
+size_t sys_mem_pool_usable_size(void *ptr)
+{
+	struct sys_mem_pool *p;
+
+	ptr = (char *)ptr - WB_UP(sizeof(struct sys_mem_pool_block));
+	p = ((struct sys_mem_pool_block *)ptr)->pool;
+
+	return sys_heap_usable_size(&p->heap, ptr) -
+		WB_UP(sizeof(struct sys_mem_pool_block));
+}
+
+#else
+
 void *sys_mem_pool_alloc(struct sys_mem_pool *p, size_t size)
 {
 	struct sys_mem_pool_block *blk;
@@ -354,3 +404,21 @@ void sys_mem_pool_free(void *ptr)
 	sys_mutex_unlock(&p->mutex);
 }
 
+size_t sys_mem_pool_usable_size(void *ptr)
+{
+	struct sys_mem_pool_block *blk;
+	size_t block_size;
+
+	ptr = (char *)ptr - WB_UP(sizeof(struct sys_mem_pool_block));
+	blk = (struct sys_mem_pool_block *)ptr;
+
+	/* Determine size of previously allocated block by its level */
+	block_size = blk->pool->base.max_sz;
+	for (int i = 1; i <= blk->level; i++) {
+		block_size = WB_DN(block_size / 4);
+	}
+
+	return block_size - WB_UP(sizeof(struct sys_mem_pool_block));
+}
+
+#endif /* CONFIG_MEM_POOL_HEAP_BACKEND */
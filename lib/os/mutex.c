@@ -8,6 +8,7 @@
 #include <sys/mutex.h>
 #include <syscall_handler.h>
 #include <kernel_structs.h>
+#include <kernel_internal.h>
 
 static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 {
@@ -23,9 +24,8 @@ static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 
 static bool check_sys_mutex_addr(u32_t addr)
 {
-	/* sys_mutex memory is never touched, just used to lookup the
-	 * underlying k_mutex, but we don't want threads using mutexes
-	 * that are outside their memory domain
+	/* The kernel updates the mutex word and lock count, and we don't
+	 * want threads using mutexes that are outside their memory domain
 	 */
 	return Z_SYSCALL_MEMORY_WRITE(addr, sizeof(struct sys_mutex));
 }
@@ -38,7 +38,7 @@ int z_impl_z_sys_mutex_kernel_lock(struct sys_mutex *mutex, s32_t timeout)
 		return -EINVAL;
 	}
 
-	return k_mutex_lock(kernel_mutex, timeout);
+	return z_mutex_lock_for_sys(kernel_mutex, mutex, timeout);
 }
 
 Z_SYSCALL_HANDLER(z_sys_mutex_kernel_lock, mutex, timeout)
@@ -55,16 +55,11 @@ int z_impl_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
 {
 	struct k_mutex *kernel_mutex = get_k_mutex(mutex);
 
-	if (kernel_mutex == NULL || kernel_mutex->lock_count == 0) {
+	if (kernel_mutex == NULL) {
 		return -EINVAL;
 	}
 
-	if (kernel_mutex->owner != _current) {
-		return -EPERM;
-	}
-
-	k_mutex_unlock(kernel_mutex);
-	return 0;
+	return z_mutex_unlock_for_sys(kernel_mutex, mutex);
 }
 
 Z_SYSCALL_HANDLER(z_sys_mutex_kernel_unlock, mutex)
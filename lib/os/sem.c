@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <sys/sem.h>
+#include <sys/atomic.h>
+#include <limits.h>
+
+#ifdef CONFIG_USERSPACE
+/* The futex word holds the count.  A thread that finds it at zero and
+ * wants to wait first moves it to -1, so givers know they have to wake
+ * someone.  Waiters all wake up and race for the count when it goes up
+ * from -1, and the losers mark it -1 again before waiting, so a give
+ * can never be lost to a thread that is already asleep.
+ */
+#define SEM_WAITERS	(-1)
+
+int sys_sem_init(struct sys_sem *sem, unsigned int initial_count,
+		 unsigned int limit)
+{
+	if (limit == 0U || limit > INT_MAX || initial_count > limit) {
+		return -EINVAL;
+	}
+
+	atomic_set(&sem->futex.val, (atomic_val_t)initial_count);
+	sem->limit = (int)limit;
+
+	return 0;
+}
+
+int sys_sem_give(struct sys_sem *sem)
+{
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&sem->futex.val);
+		if (old >= sem->limit) {
+			return -EAGAIN;
+		}
+	} while (!atomic_cas(&sem->futex.val, old,
+			     old == SEM_WAITERS ? 1 : old + 1));
+
+	if (old == SEM_WAITERS) {
+		int ret = k_futex_wake(&sem->futex, true);
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int sys_sem_take(struct sys_sem *sem, s32_t timeout)
+{
+	bool expired = false;
+	atomic_val_t old;
+	s64_t end = 0;
+	int ret;
+
+	if (timeout != K_NO_WAIT && timeout != K_FOREVER) {
+		end = k_uptime_get() + timeout;
+	}
+
+	while (true) {
+		old = atomic_get(&sem->futex.val);
+		if (old > 0) {
+			if (atomic_cas(&sem->futex.val, old, old - 1)) {
+				return 0;
+			}
+			continue;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			return expired ? -EAGAIN : -EBUSY;
+		}
+
+		if (old == 0 &&
+		    !atomic_cas(&sem->futex.val, 0, SEM_WAITERS)) {
+			continue;
+		}
+
+		ret = k_futex_wait(&sem->futex, SEM_WAITERS, timeout);
+		if (ret == -ETIMEDOUT) {
+			return -EAGAIN;
+		}
+		if (ret != 0 && ret != -EAGAIN) {
+			return ret;
+		}
+
+		/* Lost the race for the count, wait only for what is left
+		 * of the caller's timeout
+		 */
+		if (timeout != K_FOREVER) {
+			timeout = end - k_uptime_get();
+			if (timeout <= 0) {
+				timeout = K_NO_WAIT;
+				expired = true;
+			}
+		}
+	}
+}
+
+unsigned int sys_sem_count_get(struct sys_sem *sem)
+{
+	atomic_val_t val = atomic_get(&sem->futex.val);
+
+	return val > 0 ? (unsigned int)val : 0U;
+}
+#else
+int sys_sem_init(struct sys_sem *sem, unsigned int initial_count,
+		 unsigned int limit)
+{
+	if (limit == 0U || initial_count > limit) {
+		return -EINVAL;
+	}
+
+	k_sem_init(&sem->kernel_sem, initial_count, limit);
+
+	return 0;
+}
+
+int sys_sem_give(struct sys_sem *sem)
+{
+	if (k_sem_count_get(&sem->kernel_sem) >= sem->kernel_sem.limit) {
+		return -EAGAIN;
+	}
+
+	k_sem_give(&sem->kernel_sem);
+
+	return 0;
+}
+
+int sys_sem_take(struct sys_sem *sem, s32_t timeout)
+{
+	return k_sem_take(&sem->kernel_sem, timeout);
+}
+
+unsigned int sys_sem_count_get(struct sys_sem *sem)
+{
+	return k_sem_count_get(&sem->kernel_sem);
+}
+#endif /* CONFIG_USERSPACE */
@@ -79,6 +79,8 @@ kobjects = OrderedDict ([
     ("k_mutex", (None, False)),
     ("k_pipe", (None, False)),
     ("k_queue", (None, False)),
+    ("k_spsc_ring", (None, False)),
+    ("k_mpmc_ring", (None, False)),
     ("k_poll_signal", (None, False)),
     ("k_sem", (None, False)),
     ("k_stack", (None, False)),
@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #include <errno.h>
 #include <sys/util.h>
+#include <spinlock.h>
 
 #include <net/net_core.h>
 #include <net/net_pkt.h>
@@ -51,10 +52,96 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+/** Remote address and port and local port are all specified */
+#define NET_CONN_EXACT			(NET_CONN_REMOTE_ADDR_SPEC | \
+					 NET_CONN_REMOTE_PORT_SPEC | \
+					 NET_CONN_LOCAL_PORT_SPEC)
+
+/* Connections in use are kept in one of three places:
+ *
+ * - conn_exact: connected endpoints, those with NET_CONN_EXACT set,
+ *   hashed on protocol, remote address and both ports.  A packet
+ *   normally finds its connection here with one bucket walk.
+ * - conn_port: listeners and other endpoints with a local port but
+ *   no full remote endpoint, hashed on protocol and local port.
+ * - conn_wild: everything without a local port (AF_PACKET, CAN and
+ *   catch-all handlers), which every packet has to look at.
+ *
+ * Each bucket has its own lock so RX threads only contend when they
+ * hit the same bucket.  A connection's bucket is derived from its
+ * registration data, which never changes while it is in use.
+ */
+struct conn_bucket {
+	struct k_spinlock lock;
+	sys_dlist_t list;
+};
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
-static sys_slist_t conn_unused;
-static sys_slist_t conn_used;
+static struct conn_bucket conn_exact[CONFIG_NET_CONN_HASH_SIZE];
+static struct conn_bucket conn_port[CONFIG_NET_CONN_HASH_SIZE];
+static struct conn_bucket conn_wild;
+
+static struct k_spinlock conn_unused_lock;
+static sys_dlist_t conn_unused;
+
+static inline u32_t conn_hash_mix(u32_t hash, u32_t val)
+{
+	hash ^= val;
+
+	return hash * 0x9e3779b1;
+}
+
+static inline u32_t conn_hash_done(u32_t hash)
+{
+	return (hash ^ (hash >> 16)) % CONFIG_NET_CONN_HASH_SIZE;
+}
+
+/* Ports are in network byte order, as found in the packet */
+static u32_t conn_hash_exact(u16_t proto, const u8_t *addr, size_t len,
+			     u16_t remote_port, u16_t local_port)
+{
+	u32_t hash = conn_hash_mix(proto, (remote_port << 16) | local_port);
+
+	for (size_t i = 0; i < len; i += 4) {
+		hash = conn_hash_mix(hash, UNALIGNED_GET((u32_t *)&addr[i]));
+	}
+
+	return conn_hash_done(hash);
+}
+
+static inline u32_t conn_hash_port(u16_t proto, u16_t local_port)
+{
+	return conn_hash_done(conn_hash_mix(proto, local_port));
+}
+
+static struct conn_bucket *conn_bucket_get(struct net_conn *conn)
+{
+	const u8_t *addr;
+	size_t len;
+
+	if (!(conn->flags & NET_CONN_LOCAL_PORT_SPEC)) {
+		return &conn_wild;
+	}
+
+	if ((conn->flags & NET_CONN_EXACT) != NET_CONN_EXACT) {
+		return &conn_port[conn_hash_port(conn->proto,
+				net_sin(&conn->local_addr)->sin_port)];
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    conn->remote_addr.sa_family == AF_INET6) {
+		addr = (const u8_t *)&net_sin6(&conn->remote_addr)->sin6_addr;
+		len = sizeof(struct in6_addr);
+	} else {
+		addr = (const u8_t *)&net_sin(&conn->remote_addr)->sin_addr;
+		len = sizeof(struct in_addr);
+	}
+
+	return &conn_exact[conn_hash_exact(conn->proto, addr, len,
+				net_sin(&conn->remote_addr)->sin_port,
+				net_sin(&conn->local_addr)->sin_port)];
+}
 
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
@@ -112,34 +199,44 @@ void conn_register_debug(struct net_conn *conn,
 
 static struct net_conn *conn_get_unused(void)
 {
-	sys_snode_t *node;
+	k_spinlock_key_t key = k_spin_lock(&conn_unused_lock);
+	sys_dnode_t *node;
+
+	node = sys_dlist_get(&conn_unused);
+	k_spin_unlock(&conn_unused_lock, key);
 
-	node = sys_slist_peek_head(&conn_unused);
 	if (!node) {
 		return NULL;
 	}
 
-	sys_slist_remove(&conn_unused, NULL, node);
-
 	return CONTAINER_OF(node, struct net_conn, node);
 }
 
-static void conn_set_used(struct net_conn *conn)
+/* Must be called with the bucket lock held */
+static void conn_set_used(struct conn_bucket *bucket, struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
 
-	sys_slist_prepend(&conn_used, &conn->node);
+	sys_dlist_prepend(&bucket->list, &conn->node);
 }
 
 static void conn_set_unused(struct net_conn *conn)
 {
+	k_spinlock_key_t key;
+
 	(void)memset(conn, 0, sizeof(*conn));
 
-	sys_slist_prepend(&conn_unused, &conn->node);
+	key = k_spin_lock(&conn_unused_lock);
+	sys_dlist_prepend(&conn_unused, &conn->node);
+	k_spin_unlock(&conn_unused_lock, key);
 }
 
-/* Check if we already have identical connection handler installed. */
-static struct net_conn *conn_find_handler(u16_t proto, u8_t family,
+/* Check if we already have identical connection handler installed.
+ * An identical handler always lives in the same bucket, which must be
+ * locked by the caller.
+ */
+static struct net_conn *conn_find_handler(struct conn_bucket *bucket,
+					  u16_t proto, u8_t family,
 					  const struct sockaddr *remote_addr,
 					  const struct sockaddr *local_addr,
 					  u16_t remote_port,
@@ -147,7 +244,7 @@ static struct net_conn *conn_find_handler(u16_t proto, u8_t family,
 {
 	struct net_conn *conn;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER(&bucket->list, conn, node) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -245,16 +342,11 @@ int net_conn_register(u16_t proto, u8_t family,
 		      void *user_data,
 		      struct net_conn_handle **handle)
 {
-	struct net_conn *conn;
+	struct conn_bucket *bucket;
+	struct net_conn *conn, *dup;
+	k_spinlock_key_t key;
 	u8_t flags = 0U;
 
-	conn = conn_find_handler(proto, family, remote_addr, local_addr,
-				 remote_port, local_port);
-	if (conn) {
-		NET_ERR("Identical connection handler %p already found.", conn);
-		return -EALREADY;
-	}
-
 	conn = conn_get_unused();
 	if (!conn) {
 		return -ENOENT;
@@ -341,11 +433,24 @@ int net_conn_register(u16_t proto, u8_t family,
 	conn->proto = proto;
 	conn->family = family;
 
+	bucket = conn_bucket_get(conn);
+	key = k_spin_lock(&bucket->lock);
+
+	dup = conn_find_handler(bucket, proto, family, remote_addr, local_addr,
+				remote_port, local_port);
+	if (dup) {
+		k_spin_unlock(&bucket->lock, key);
+		NET_ERR("Identical connection handler %p already found.", dup);
+		conn_set_unused(conn);
+		return -EALREADY;
+	}
+
 	if (handle) {
 		*handle = (struct net_conn_handle *)conn;
 	}
 
-	conn_set_used(conn);
+	conn_set_used(bucket, conn);
+	k_spin_unlock(&bucket->lock, key);
 
 	conn_register_debug(conn, remote_port, local_port);
 
@@ -358,6 +463,8 @@ error:
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
+	struct conn_bucket *bucket;
+	k_spinlock_key_t key;
 
 	if (conn < &conns[0] || conn > &conns[CONFIG_NET_MAX_CONN]) {
 		return -EINVAL;
@@ -367,9 +474,19 @@ int net_conn_unregister(struct net_conn_handle *handle)
 		return -ENOENT;
 	}
 
-	NET_DBG("Connection handler %p removed", conn);
+	bucket = conn_bucket_get(conn);
+	key = k_spin_lock(&bucket->lock);
 
-	sys_slist_find_and_remove(&conn_used, &conn->node);
+	if (!(conn->flags & NET_CONN_IN_USE)) {
+		k_spin_unlock(&bucket->lock, key);
+		return -ENOENT;
+	}
+
+	sys_dlist_remove(&conn->node);
+	conn->flags &= ~NET_CONN_IN_USE;
+	k_spin_unlock(&bucket->lock, key);
+
+	NET_DBG("Connection handler %p removed", conn);
 
 	conn_set_unused(conn);
 
@@ -497,56 +614,41 @@ static bool conn_are_end_points_valid(struct net_pkt *pkt,
 	return !(my_src_addr && (src_port == dst_port));
 }
 
-enum net_verdict net_conn_input(struct net_pkt *pkt,
-				union net_ip_header *ip_hdr,
-				u8_t proto,
-				union net_proto_header *proto_hdr)
+static struct conn_bucket *conn_bucket_exact(struct net_pkt *pkt,
+					     union net_ip_header *ip_hdr,
+					     u16_t proto, u16_t src_port,
+					     u16_t dst_port)
 {
-	struct net_if *pkt_iface = net_pkt_iface(pkt);
-	struct net_conn *best_match = NULL;
-	s16_t best_rank = -1;
-	struct net_conn *conn;
-	u16_t src_port;
-	u16_t dst_port;
+	const u8_t *addr;
+	size_t len;
 
-	if (IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) {
-		src_port = proto_hdr->udp->src_port;
-		dst_port = proto_hdr->udp->dst_port;
-	} else if (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP) {
-		src_port = proto_hdr->tcp->src_port;
-		dst_port = proto_hdr->tcp->dst_port;
-	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
-		if (net_pkt_family(pkt) != AF_PACKET || proto != ETH_P_ALL) {
-			return NET_DROP;
-		}
-
-		src_port = dst_port = 0U;
-	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
-		   net_pkt_family(pkt) == AF_CAN) {
-		if (proto != CAN_RAW) {
-			return NET_DROP;
-		}
-
-		src_port = dst_port = 0U;
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		addr = (const u8_t *)&ip_hdr->ipv6->src;
+		len = sizeof(struct in6_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_pkt_family(pkt) == AF_INET) {
+		addr = (const u8_t *)&ip_hdr->ipv4->src;
+		len = sizeof(struct in_addr);
 	} else {
-		NET_DBG("No suitable protocol handler configured");
-		return NET_DROP;
+		return NULL;
 	}
 
-	if (!conn_are_end_points_valid(pkt, ip_hdr, src_port, dst_port)) {
-		NET_DBG("Dropping invalid src/dst end-points packet");
-		return NET_DROP;
-	}
+	return &conn_exact[conn_hash_exact(proto, addr, len, src_port,
+					   dst_port)];
+}
 
-	/* TODO: Make core part of networing subsystem less dependent on
-	 * UDP, TCP, IPv4 or IPv6. So that we can add new features with
-	 * less cross-module changes.
-	 */
-	NET_DBG("Check %s listener for pkt %p src port %u dst port %u"
-		" family %d", net_proto2str(net_pkt_family(pkt), proto), pkt,
-		ntohs(src_port), ntohs(dst_port), net_pkt_family(pkt));
+/* Find the best matching connection in a bucket.  The best match so far
+ * is carried across calls so several buckets can be ranked together.
+ */
+static void conn_rank(struct conn_bucket *bucket, struct net_pkt *pkt,
+		      union net_ip_header *ip_hdr, u8_t proto,
+		      u16_t src_port, u16_t dst_port,
+		      struct net_conn **best_match, s16_t *best_rank)
+{
+	k_spinlock_key_t key = k_spin_lock(&bucket->lock);
+	struct net_conn *conn;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER(&bucket->list, conn, node) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -592,22 +694,98 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 			 * specifies a remote port, then we've matched to a
 			 * LISTENING connection that should not override.
 			 */
-			if (best_match != NULL &&
-			    best_match->flags & NET_CONN_REMOTE_PORT_SPEC) {
+			if (*best_match != NULL &&
+			    (*best_match)->flags & NET_CONN_REMOTE_PORT_SPEC) {
 				continue;
 			}
 
-			if (best_rank < NET_CONN_RANK(conn->flags)) {
-				best_rank = NET_CONN_RANK(conn->flags);
-				best_match = conn;
+			if (*best_rank < NET_CONN_RANK(conn->flags)) {
+				*best_rank = NET_CONN_RANK(conn->flags);
+				*best_match = conn;
 			}
 		} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) ||
 			   IS_ENABLED(CONFIG_NET_SOCKETS_CAN)) {
-			best_rank = 0;
-			best_match = conn;
+			*best_rank = 0;
+			*best_match = conn;
 		}
 	}
 
+	k_spin_unlock(&bucket->lock, key);
+}
+
+enum net_verdict net_conn_input(struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				u8_t proto,
+				union net_proto_header *proto_hdr)
+{
+	struct net_if *pkt_iface = net_pkt_iface(pkt);
+	struct net_conn *best_match = NULL;
+	struct conn_bucket *bucket;
+	s16_t best_rank = -1;
+	struct net_conn *conn;
+	u16_t src_port;
+	u16_t dst_port;
+
+	if (IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) {
+		src_port = proto_hdr->udp->src_port;
+		dst_port = proto_hdr->udp->dst_port;
+	} else if (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP) {
+		src_port = proto_hdr->tcp->src_port;
+		dst_port = proto_hdr->tcp->dst_port;
+	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
+		if (net_pkt_family(pkt) != AF_PACKET || proto != ETH_P_ALL) {
+			return NET_DROP;
+		}
+
+		src_port = dst_port = 0U;
+	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
+		   net_pkt_family(pkt) == AF_CAN) {
+		if (proto != CAN_RAW) {
+			return NET_DROP;
+		}
+
+		src_port = dst_port = 0U;
+	} else {
+		NET_DBG("No suitable protocol handler configured");
+		return NET_DROP;
+	}
+
+	if (!conn_are_end_points_valid(pkt, ip_hdr, src_port, dst_port)) {
+		NET_DBG("Dropping invalid src/dst end-points packet");
+		return NET_DROP;
+	}
+
+	/* TODO: Make core part of networing subsystem less dependent on
+	 * UDP, TCP, IPv4 or IPv6. So that we can add new features with
+	 * less cross-module changes.
+	 */
+	NET_DBG("Check %s listener for pkt %p src port %u dst port %u"
+		" family %d", net_proto2str(net_pkt_family(pkt), proto), pkt,
+		ntohs(src_port), ntohs(dst_port), net_pkt_family(pkt));
+
+	if ((IS_ENABLED(CONFIG_NET_UDP) || IS_ENABLED(CONFIG_NET_TCP)) &&
+	    (proto == IPPROTO_UDP || proto == IPPROTO_TCP)) {
+		bucket = conn_bucket_exact(pkt, ip_hdr, proto, src_port,
+					   dst_port);
+		if (bucket) {
+			conn_rank(bucket, pkt, ip_hdr, proto, src_port,
+				  dst_port, &best_match, &best_rank);
+		}
+
+		/* A connected endpoint wins over any listener */
+		if (!best_match) {
+			bucket = &conn_port[conn_hash_port(proto, dst_port)];
+			conn_rank(bucket, pkt, ip_hdr, proto, src_port,
+				  dst_port, &best_match, &best_rank);
+		}
+	}
+
+	if (!best_match ||
+	    !(best_match->flags & NET_CONN_REMOTE_PORT_SPEC)) {
+		conn_rank(&conn_wild, pkt, ip_hdr, proto, src_port, dst_port,
+			  &best_match, &best_rank);
+	}
+
 	conn = best_match;
 	if (conn) {
 		NET_DBG("[%p] match found cb %p ud %p rank 0x%02x",
@@ -655,10 +833,12 @@ drop:
 
 void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 {
-	struct net_conn *conn;
+	int i;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
-		cb(conn, user_data);
+	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
+		if (conns[i].flags & NET_CONN_IN_USE) {
+			cb(&conns[i], user_data);
+		}
 	}
 }
 
@@ -666,10 +846,15 @@ void net_conn_init(void)
 {
 	int i;
 
-	sys_slist_init(&conn_unused);
-	sys_slist_init(&conn_used);
+	sys_dlist_init(&conn_unused);
+	sys_dlist_init(&conn_wild.list);
+
+	for (i = 0; i < CONFIG_NET_CONN_HASH_SIZE; i++) {
+		sys_dlist_init(&conn_exact[i].list);
+		sys_dlist_init(&conn_port[i].list);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		sys_slist_prepend(&conn_unused, &conns[i].node);
+		sys_dlist_prepend(&conn_unused, &conns[i].node);
 	}
 }
@@ -113,6 +113,11 @@ struct net_ipv6_nbr_data {
 	 */
 	u32_t stale_counter;
 #endif
+
+#if defined(CONFIG_NET_IPV6_NBR_HASH)
+	/** Next neighbor in the same address hash bucket */
+	struct net_nbr *hash_next;
+#endif
 };
 
 static inline struct net_ipv6_nbr_data *net_ipv6_nbr_data(struct net_nbr *nbr)
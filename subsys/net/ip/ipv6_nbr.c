@@ -255,6 +255,77 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+#if defined(CONFIG_NET_IPV6_NBR_HASH)
+/* Neighbors in use, by IPv6 address. An entry goes in when it is set up
+ * by nbr_init() and out when its last reference is gone.
+ */
+static struct net_nbr *nbr_hash[CONFIG_NET_IPV6_MAX_NEIGHBORS];
+
+static struct net_nbr **nbr_hash_bucket(const struct in6_addr *addr)
+{
+	u32_t key;
+
+	key = UNALIGNED_GET(&addr->s6_addr32[0]) ^
+		UNALIGNED_GET(&addr->s6_addr32[1]) ^
+		UNALIGNED_GET(&addr->s6_addr32[2]) ^
+		UNALIGNED_GET(&addr->s6_addr32[3]);
+
+	return &nbr_hash[(key * 0x9e3779b1U) % ARRAY_SIZE(nbr_hash)];
+}
+
+static void nbr_hash_add(struct net_nbr *nbr)
+{
+	struct net_nbr **bucket;
+
+	bucket = nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr);
+
+	net_ipv6_nbr_data(nbr)->hash_next = *bucket;
+	*bucket = nbr;
+}
+
+static void nbr_hash_remove(struct net_nbr *nbr)
+{
+	struct net_nbr **link;
+
+	link = nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr);
+
+	while (*link) {
+		if (*link == nbr) {
+			*link = net_ipv6_nbr_data(nbr)->hash_next;
+			break;
+		}
+
+		link = &net_ipv6_nbr_data(*link)->hash_next;
+	}
+
+	net_ipv6_nbr_data(nbr)->hash_next = NULL;
+}
+
+static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
+				  struct net_if *iface,
+				  struct in6_addr *addr)
+{
+	struct net_nbr *nbr;
+
+	ARG_UNUSED(table);
+
+	for (nbr = *nbr_hash_bucket(addr); nbr;
+	     nbr = net_ipv6_nbr_data(nbr)->hash_next) {
+		if (iface && nbr->iface != iface) {
+			continue;
+		}
+
+		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+			return nbr;
+		}
+	}
+
+	return NULL;
+}
+#else
+#define nbr_hash_add(...)
+#define nbr_hash_remove(...)
+
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  struct in6_addr *addr)
@@ -279,6 +350,7 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 
 	return NULL;
 }
+#endif /* CONFIG_NET_IPV6_NBR_HASH */
 
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
 {
@@ -417,6 +489,8 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	net_ipv6_nbr_data(nbr)->reachable = 0;
 	net_ipv6_nbr_data(nbr)->reachable_timeout = 0;
 #endif
+
+	nbr_hash_add(nbr);
 }
 
 static struct net_nbr *nbr_new(struct net_if *iface,
@@ -647,6 +721,8 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
+	nbr_hash_remove(nbr);
+
 	return;
 }
 
@@ -779,9 +855,10 @@ enum net_verdict net_ipv6_prepare_for_send(struct net_pkt *pkt)
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 	/* If we have already fragmented the packet, the fragment id will
-	 * contain a proper value and we can skip other checks.
+	 * contain a proper value and we can skip other checks. TCP GSO
+	 * packets are cut into MSS sized segments when they are sent.
 	 */
-	if (net_pkt_ipv6_fragment_id(pkt) == 0U) {
+	if (net_pkt_ipv6_fragment_id(pkt) == 0U && !net_pkt_gso_size(pkt)) {
 		u16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
 		size_t pkt_len = net_pkt_get_len(pkt);
 
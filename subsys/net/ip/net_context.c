@@ -1131,10 +1131,39 @@ int net_context_get_timestamp(struct net_context *context,
 }
 #endif /* CONFIG_NET_CONTEXT_TIMESTAMP */
 
+/* Writes len bytes of payload, either from buf or gathered from the
+ * iovecs of msghdr when it is given.
+ */
+static int context_write_data(struct net_pkt *pkt, const void *buf,
+			      size_t len, const struct msghdr *msghdr)
+{
+	size_t i;
+	int ret;
+
+	if (!msghdr) {
+		return net_pkt_write(pkt, buf, len);
+	}
+
+	for (i = 0; i < msghdr->msg_iovlen && len; i++) {
+		size_t iov_len = MIN(msghdr->msg_iov[i].iov_len, len);
+
+		ret = net_pkt_write(pkt, msghdr->msg_iov[i].iov_base,
+				    iov_len);
+		if (ret < 0) {
+			return ret;
+		}
+
+		len -= iov_len;
+	}
+
+	return 0;
+}
+
 static int context_setup_udp_packet(struct net_context *context,
 				    struct net_pkt *pkt,
 				    const void *buf,
 				    size_t len,
+				    const struct msghdr *msghdr,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
 {
@@ -1176,7 +1205,7 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = net_pkt_write(pkt, buf, len);
+	ret = context_write_data(pkt, buf, len, msghdr);
 	if (ret) {
 		return ret;
 	}
@@ -1205,7 +1234,16 @@ static void context_finalize_packet(struct net_context *context,
 static struct net_pkt *context_alloc_pkt(struct net_context *context,
 					 size_t len, s32_t timeout)
 {
-	struct net_pkt *pkt;
+	struct net_pkt *pkt = NULL;
+	u16_t gso_size = 0U;
+
+#if defined(CONFIG_NET_TCP_GSO)
+	if (net_context_get_ip_proto(context) == IPPROTO_TCP &&
+	    context->tcp) {
+		/* Several segments at once, L2 cuts them to the MTU */
+		len = net_tcp_gso_len(context->tcp, len, &gso_size);
+	}
+#endif
 
 #if defined(CONFIG_NET_CONTEXT_NET_PKT_POOL)
 	if (context->tx_slab) {
@@ -1215,25 +1253,38 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 		}
 
 		net_pkt_set_iface(pkt, net_context_get_iface(context));
-		net_pkt_set_family(pkt, net_context_get_family(context));
-		net_pkt_set_context(pkt, context);
-
-		if (net_pkt_alloc_buffer(pkt, len,
-					 net_context_get_ip_proto(context),
-					 timeout)) {
-			net_pkt_unref(pkt);
-			return NULL;
+	}
+#endif
+	if (!pkt && !gso_size) {
+		pkt = net_pkt_alloc_with_buffer(net_context_get_iface(context),
+						len,
+						net_context_get_family(context),
+						net_context_get_ip_proto(context),
+						timeout);
+		if (pkt) {
+			net_pkt_set_context(pkt, context);
 		}
 
 		return pkt;
 	}
-#endif
-	pkt = net_pkt_alloc_with_buffer(net_context_get_iface(context), len,
-					net_context_get_family(context),
-					net_context_get_ip_proto(context),
-					timeout);
-	if (pkt) {
-		net_pkt_set_context(pkt, context);
+
+	if (!pkt) {
+		pkt = net_pkt_alloc_on_iface(net_context_get_iface(context),
+					     timeout);
+		if (!pkt) {
+			return NULL;
+		}
+	}
+
+	net_pkt_set_family(pkt, net_context_get_family(context));
+	net_pkt_set_context(pkt, context);
+	net_pkt_set_gso_size(pkt, gso_size);
+
+	if (net_pkt_alloc_buffer(pkt, len,
+				 net_context_get_ip_proto(context),
+				 timeout)) {
+		net_pkt_unref(pkt);
+		return NULL;
 	}
 
 	return pkt;
@@ -1243,6 +1294,7 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
+			  const struct msghdr *msghdr,
 			  const struct sockaddr *dst_addr,
 			  socklen_t addrlen,
 			  net_context_send_cb_t cb,
@@ -1391,7 +1443,7 @@ static int context_sendto(struct net_context *context,
 
 	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
-		ret = net_pkt_write(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1408,7 +1460,7 @@ static int context_sendto(struct net_context *context,
 		}
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
-		ret = context_setup_udp_packet(context, pkt, buf, len,
+		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
 					       dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
@@ -1419,7 +1471,7 @@ static int context_sendto(struct net_context *context,
 		ret = net_send_data(pkt);
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
-		ret = net_pkt_write(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1433,7 +1485,7 @@ static int context_sendto(struct net_context *context,
 		ret = net_tcp_send_data(context, cb, user_data);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = net_pkt_write(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1444,7 +1496,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN &&
 		   net_context_get_ip_proto(context) == CAN_RAW) {
-		ret = net_pkt_write(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1469,22 +1521,20 @@ fail:
 	return ret;
 }
 
-int net_context_send(struct net_context *context,
-		     const void *buf,
-		     size_t len,
-		     net_context_send_cb_t cb,
-		     s32_t timeout,
-		     void *user_data)
+/* Must be called with the context lock held */
+static int context_send(struct net_context *context,
+			const void *buf,
+			size_t len,
+			const struct msghdr *msghdr,
+			net_context_send_cb_t cb,
+			s32_t timeout,
+			void *user_data)
 {
 	socklen_t addrlen;
-	int ret = 0;
-
-	k_mutex_lock(&context->lock, K_FOREVER);
 
 	if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
 	    !net_sin(&context->remote)->sin_port) {
-		ret = -EDESTADDRREQ;
-		goto unlock;
+		return -EDESTADDRREQ;
 	}
 
 	if (IS_ENABLED(CONFIG_NET_IPV6) &&
@@ -1495,8 +1545,7 @@ int net_context_send(struct net_context *context,
 		addrlen = sizeof(struct sockaddr_in);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = -EOPNOTSUPP;
-		goto unlock;
+		return -EOPNOTSUPP;
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN) {
 		addrlen = sizeof(struct sockaddr_can);
@@ -1504,14 +1553,105 @@ int net_context_send(struct net_context *context,
 		addrlen = 0;
 	}
 
-	ret = context_sendto(context, buf, len, &context->remote,
-			     addrlen, cb, timeout, user_data, false);
-unlock:
+	return context_sendto(context, buf, len, msghdr, &context->remote,
+			      addrlen, cb, timeout, user_data, false);
+}
+
+int net_context_send(struct net_context *context,
+		     const void *buf,
+		     size_t len,
+		     net_context_send_cb_t cb,
+		     s32_t timeout,
+		     void *user_data)
+{
+	int ret;
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	ret = context_send(context, buf, len, NULL, cb, timeout, user_data);
+
 	k_mutex_unlock(&context->lock);
 
 	return ret;
 }
 
+/* Must be called with the context lock held */
+static int context_sendmsg(struct net_context *context,
+			   const struct msghdr *msghdr,
+			   net_context_send_cb_t cb,
+			   s32_t timeout,
+			   void *user_data)
+{
+	size_t len = 0;
+	size_t i;
+
+	for (i = 0; i < msghdr->msg_iovlen; i++) {
+		len += msghdr->msg_iov[i].iov_len;
+	}
+
+	if (msghdr->msg_name) {
+		return context_sendto(context, NULL, len, msghdr,
+				      msghdr->msg_name, msghdr->msg_namelen,
+				      cb, timeout, user_data, true);
+	}
+
+	return context_send(context, NULL, len, msghdr, cb, timeout,
+			    user_data);
+}
+
+int net_context_sendmsg(struct net_context *context,
+			const struct msghdr *msghdr,
+			int flags,
+			net_context_send_cb_t cb,
+			s32_t timeout,
+			void *user_data)
+{
+	int ret;
+
+	ARG_UNUSED(flags);
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	ret = context_sendmsg(context, msghdr, cb, timeout, user_data);
+
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
+int net_context_sendmmsg(struct net_context *context,
+			 struct mmsghdr *msgvec,
+			 unsigned int vlen,
+			 int flags,
+			 net_context_send_cb_t cb,
+			 s32_t timeout,
+			 void *user_data)
+{
+	unsigned int count;
+	int ret = 0;
+
+	ARG_UNUSED(flags);
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	for (count = 0; count < vlen; count++) {
+		ret = context_sendmsg(context, &msgvec[count].msg_hdr, cb,
+				      timeout, user_data);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+	}
+
+	k_mutex_unlock(&context->lock);
+
+	if (count == 0 && ret < 0) {
+		return ret;
+	}
+
+	return count;
+}
 
 int net_context_sendto(struct net_context *context,
 		       const void *buf,
@@ -1526,7 +1666,7 @@ int net_context_sendto(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto(context, buf, len, NULL, dst_addr, addrlen,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -25,6 +25,7 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 #include <net/net_mgmt.h>
 #include <net/net_pkt.h>
 #include <net/net_core.h>
+#include <net/ethernet.h>
 #include <net/dns_resolve.h>
 #include <net/gptp.h>
 
@@ -68,11 +69,55 @@ void net_analyze_stack(const char *name, const char *stack, size_t size)
 }
 #endif /* CONFIG_INIT_STACKS */
 
+static enum net_verdict ip_input(struct net_pkt *pkt, bool is_loopback)
+{
+	/* IP version and header length. */
+	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
+#if defined(CONFIG_NET_IPV6)
+	case 0x60:
+		return net_ipv6_input(pkt, is_loopback);
+#endif
+#if defined(CONFIG_NET_IPV4)
+	case 0x40:
+		return net_ipv4_input(pkt);
+#endif
+	}
+
+	NET_DBG("Unknown IP family packet (0x%x)",
+		NET_IPV6_HDR(pkt)->vtc & 0xf0);
+	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
+	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+
+	return NET_DROP;
+}
+
+#if defined(CONFIG_NET_TCP_GRO)
+/* TCP segments being coalesced, one flow per RX queue. Each is only
+ * touched by the thread of its queue.
+ */
+static struct net_tcp_gro rx_gro[NET_RX_QUEUE_COUNT];
+
+static void gro_deliver(struct net_pkt *pkt)
+{
+	NET_DBG("Coalesced pkt %p len %zu", pkt, net_pkt_get_len(pkt));
+
+	net_pkt_cursor_init(pkt);
+
+	if (ip_input(pkt, false) != NET_OK) {
+		NET_DBG("Dropping pkt %p", pkt);
+		net_pkt_unref(pkt);
+	}
+}
+#endif
+
 static inline enum net_verdict process_data(struct net_pkt *pkt,
 					    bool is_loopback)
 {
 	int ret;
 	bool locally_routed = false;
+#if defined(CONFIG_NET_TCP_GRO)
+	int queue;
+#endif
 
 	ret = net_packet_socket_input(pkt);
 	if (ret != NET_CONTINUE) {
@@ -115,29 +160,38 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 		return ret;
 	}
 
+#if defined(CONFIG_NET_RX_CONTIGUOUS_HEADERS)
+	/* So that the IP and transport headers can be read in place */
+	if (net_pkt_pullup(pkt, CONFIG_NET_RX_CONTIGUOUS_HEADERS_LEN) < 0) {
+		NET_DBG("Headers of pkt %p left scattered", pkt);
+	}
+#endif
+
 	/* L2 has modified the buffer starting point, it is easier
 	 * to re-initialize the cursor rather than updating it.
 	 */
 	net_pkt_cursor_init(pkt);
 
-	/* IP version and header length. */
-	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
-#if defined(CONFIG_NET_IPV6)
-	case 0x60:
-		return net_ipv6_input(pkt, is_loopback);
-#endif
-#if defined(CONFIG_NET_IPV4)
-	case 0x40:
-		return net_ipv4_input(pkt);
-#endif
-	}
+#if defined(CONFIG_NET_TCP_GRO)
+	/* Only from an RX queue thread, loopback is sent inline */
+	queue = net_tc_rx_queue_current();
+	if (!is_loopback && !locally_routed && queue >= 0) {
+		struct net_pkt *flush;
 
-	NET_DBG("Unknown IP family packet (0x%x)",
-		NET_IPV6_HDR(pkt)->vtc & 0xf0);
-	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
-	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+		ret = net_tcp_gro_receive(&rx_gro[queue], pkt, &flush);
+		if (flush) {
+			gro_deliver(flush);
+		}
 
-	return NET_DROP;
+		if (ret != NET_CONTINUE) {
+			return ret;
+		}
+
+		net_pkt_cursor_init(pkt);
+	}
+#endif
+
+	return ip_input(pkt, is_loopback);
 }
 
 static void processing_data(struct net_pkt *pkt, bool is_loopback)
@@ -336,6 +390,9 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 {
 	bool is_loopback = false;
 	size_t pkt_len;
+#if defined(CONFIG_NET_TCP_GRO)
+	int queue = net_tc_rx_queue_current();
+#endif
 
 	pkt_len = net_pkt_get_len(pkt);
 
@@ -353,6 +410,16 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 
 	processing_data(pkt, is_loopback);
 
+#if defined(CONFIG_NET_TCP_GRO)
+	/* Nothing left in the queue to coalesce with */
+	if (queue >= 0 && net_tc_rx_queue_is_empty(queue)) {
+		pkt = net_tcp_gro_flush(&rx_gro[queue]);
+		if (pkt) {
+			gro_deliver(pkt);
+		}
+	}
+#endif
+
 	net_print_statistics();
 	net_pkt_print();
 }
@@ -366,10 +433,113 @@ static void process_rx_packet(struct k_work *work)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+#if NET_RX_RSS_QUEUES > 1
+static inline u32_t rx_hash_mix(u32_t hash, u32_t val)
+{
+	hash ^= val;
+
+	return hash * 0x9e3779b1;
+}
+
+/* Hash of the addresses, protocol and ports of a frame as received from
+ * the driver, so all packets of a flow go to the same RX queue. Only
+ * the first fragment of the frame is looked at. IP fragments are hashed
+ * on addresses only, so they stay together.
+ */
+static u32_t rx_flow_hash(struct net_if *iface, struct net_pkt *pkt)
+{
+	const u8_t *data = pkt->buffer->data;
+	size_t len = pkt->buffer->len;
+	u32_t hash = 0U;
+	size_t i, off = 0;
+	u8_t proto;
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		const struct net_eth_hdr *hdr = (const void *)data;
+
+		off = sizeof(struct net_eth_hdr);
+		if (len >= off && ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
+			off = sizeof(struct net_eth_vlan_hdr);
+		}
+	}
+#endif
+
+	if (len <= off) {
+		return 0U;
+	}
+
+	data += off;
+	len -= off;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (data[0] & 0xf0) == 0x40) {
+		const struct net_ipv4_hdr *hdr = (const void *)data;
+
+		if (len < sizeof(*hdr)) {
+			return 0U;
+		}
+
+		hash = rx_hash_mix(hash, UNALIGNED_GET(&hdr->src.s_addr));
+		hash = rx_hash_mix(hash, UNALIGNED_GET(&hdr->dst.s_addr));
+		proto = hdr->proto;
+		off = (hdr->vhl & 0x0f) * 4U;
+
+		if ((hdr->offset[0] & 0x3f) || hdr->offset[1]) {
+			proto = 0U;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && (data[0] & 0xf0) == 0x60) {
+		const struct net_ipv6_hdr *hdr = (const void *)data;
+
+		if (len < sizeof(*hdr)) {
+			return 0U;
+		}
+
+		for (i = 0; i < ARRAY_SIZE(hdr->src.s6_addr32); i++) {
+			hash = rx_hash_mix(hash,
+					   UNALIGNED_GET(&hdr->src.s6_addr32[i]));
+			hash = rx_hash_mix(hash,
+					   UNALIGNED_GET(&hdr->dst.s6_addr32[i]));
+		}
+
+		proto = hdr->nexthdr;
+		off = sizeof(*hdr);
+	} else {
+		return 0U;
+	}
+
+	hash = rx_hash_mix(hash, proto);
+
+	if ((proto == IPPROTO_TCP || proto == IPPROTO_UDP) &&
+	    len >= off + 2 * sizeof(u16_t)) {
+		hash = rx_hash_mix(hash, UNALIGNED_GET((const u32_t *)(data + off)));
+	}
+
+	return hash ^ (hash >> 16);
+}
+#else
+#define rx_flow_hash(iface, pkt) 0U
+#endif /* NET_RX_RSS_QUEUES > 1 */
+
+/* Readies a received packet for its RX queue, and returns the queue */
+static u8_t net_queue_rx_prepare(struct net_if *iface, struct net_pkt *pkt)
 {
 	u8_t prio = net_pkt_priority(pkt);
 	u8_t tc = net_rx_priority2tc(prio);
+	u8_t queue;
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	NET_DBG("prio %d iface %p pkt %p len %zu", prio, iface, pkt,
+		net_pkt_get_len(pkt));
+
+	if (IS_ENABLED(CONFIG_NET_ROUTING)) {
+		net_pkt_set_orig_iface(pkt, iface);
+	}
+
+	net_pkt_set_iface(pkt, iface);
+
+	queue = net_tc_rx_queue(tc, rx_flow_hash(iface, pkt));
 
 	k_work_init(net_pkt_work(pkt), process_rx_packet);
 
@@ -379,11 +549,11 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	net_stats_update_tc_recv_priority(iface, tc, prio);
 #endif
 
-#if NET_TC_RX_COUNT > 1
-	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
+#if NET_RX_QUEUE_COUNT > 1
+	NET_DBG("TC %d queue %d with prio %d pkt %p", tc, queue, prio, pkt);
 #endif
 
-	net_tc_submit_to_rx_queue(tc, pkt);
+	return queue;
 }
 
 /* Called by driver when an IP packet has been received */
@@ -401,21 +571,56 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 		return -ENETDOWN;
 	}
 
-	net_pkt_set_overwrite(pkt, true);
-	net_pkt_cursor_init(pkt);
+	net_tc_submit_to_rx_queue(net_queue_rx_prepare(iface, pkt), pkt);
 
-	NET_DBG("prio %d iface %p pkt %p len %zu", net_pkt_priority(pkt),
-		iface, pkt, net_pkt_get_len(pkt));
+	return 0;
+}
 
-	if (IS_ENABLED(CONFIG_NET_ROUTING)) {
-		net_pkt_set_orig_iface(pkt, iface);
+/* Called by driver when it has several packets from one interface at hand.
+ * Packets going to the same RX queue one after the other are appended to it
+ * in one go.
+ */
+int net_recv_data_burst(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+	size_t first = 0;
+	u8_t queue = 0U;
+	size_t i;
+	u8_t q;
+
+	if (!pkts || !iface) {
+		return -EINVAL;
 	}
 
-	net_pkt_set_iface(pkt, iface);
+	if (!net_if_flag_is_set(iface, NET_IF_UP)) {
+		return -ENETDOWN;
+	}
 
-	net_queue_rx(iface, pkt);
+	for (i = 0; i < count; i++) {
+		if (!pkts[i] || !pkts[i]->frags) {
+			break;
+		}
 
-	return 0;
+		q = net_queue_rx_prepare(iface, pkts[i]);
+
+		if (i > first && q != queue) {
+			net_tc_submit_burst_to_rx_queue(queue, &pkts[first],
+							i - first);
+			first = i;
+		}
+
+		queue = q;
+	}
+
+	if (i > first) {
+		net_tc_submit_burst_to_rx_queue(queue, &pkts[first], i - first);
+	}
+
+	if (!i && count) {
+		return -ENODATA;
+	}
+
+	return i;
 }
 
 static inline void l3_init(void)
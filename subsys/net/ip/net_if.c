@@ -22,6 +22,7 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 #include "net_private.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
+#include "tcp_internal.h"
 
 #include "net_stats.h"
 
@@ -144,6 +145,47 @@ static inline void net_context_send_cb(struct net_context *context,
 	}
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static int l2_send_gso_seg(struct net_pkt *seg, void *user_data)
+{
+	struct net_if *iface = user_data;
+	int ret;
+
+	ret = net_if_l2(iface)->send(iface, seg);
+	if (ret < 0) {
+		net_pkt_unref(seg);
+	}
+
+	return ret;
+}
+
+/* TCP only builds GSO packets for interfaces whose L2 can cut them, but
+ * routing may have moved the packet to one that cannot.
+ */
+static int l2_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	const struct net_l2 *l2 = net_if_l2(iface);
+	int ret;
+
+	if (!net_pkt_gso_size(pkt) ||
+	    (l2->get_flags && (l2->get_flags(iface) & NET_L2_TCP_GSO))) {
+		return l2->send(iface, pkt);
+	}
+
+	ret = net_tcp_gso_segment(pkt, l2_send_gso_seg, iface);
+	if (ret >= 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return ret;
+}
+#else
+static inline int l2_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	return net_if_l2(iface)->send(iface, pkt);
+}
+#endif
+
 static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct net_linkaddr *dst;
@@ -186,7 +228,7 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 		}
 #endif
 
-		status = net_if_l2(iface)->send(iface, pkt);
+		status = l2_send(iface, pkt);
 
 #if defined(CONFIG_NET_CONTEXT_TIMESTAMP)
 		if (status >= 0 && context) {
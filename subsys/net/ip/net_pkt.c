@@ -946,6 +946,11 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 	sa_family_t family = net_pkt_family(pkt);
 	size_t max_len;
 
+	/* TCP already bounded the length, L2 cuts it down to the MTU */
+	if (net_pkt_gso_size(pkt)) {
+		return size;
+	}
+
 	if (net_pkt_iface(pkt)) {
 		max_len = net_if_get_mtu(net_pkt_iface(pkt));
 	} else {
@@ -1544,10 +1549,27 @@ static int net_pkt_cursor_operate(struct net_pkt *pkt,
 	return 0;
 }
 
+/* Reading or skipping data that ends before the current buffer does needs
+ * none of the buffer walking of net_pkt_cursor_operate(). This is the case
+ * for most header accesses on received packets.
+ */
+static inline bool pkt_cursor_in_buffer(struct net_pkt *pkt, size_t length)
+{
+	struct net_pkt_cursor *cursor = &pkt->cursor;
+
+	return net_pkt_is_being_overwritten(pkt) && cursor->buf &&
+		cursor->pos + length < cursor->buf->data + cursor->buf->len;
+}
+
 int net_pkt_skip(struct net_pkt *pkt, size_t skip)
 {
 	NET_DBG("pkt %p skip %zu", pkt, skip);
 
+	if (pkt_cursor_in_buffer(pkt, skip)) {
+		pkt->cursor.pos += skip;
+		return 0;
+	}
+
 	return net_pkt_cursor_operate(pkt, NULL, skip, false, true);
 }
 
@@ -1562,6 +1584,12 @@ int net_pkt_read(struct net_pkt *pkt, void *data, size_t length)
 {
 	NET_DBG("pkt %p data %p length %zu", pkt, data, length);
 
+	if (pkt_cursor_in_buffer(pkt, length)) {
+		memcpy(data, pkt->cursor.pos, length);
+		pkt->cursor.pos += length;
+		return 0;
+	}
+
 	return net_pkt_cursor_operate(pkt, data, length, true, false);
 }
 
@@ -1689,6 +1717,7 @@ struct net_pkt *net_pkt_clone(struct net_pkt *pkt, s32_t timeout)
 	net_pkt_set_timestamp(clone_pkt, net_pkt_timestamp(pkt));
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
@@ -1797,6 +1826,48 @@ int net_pkt_pull(struct net_pkt *pkt, size_t length)
 	return 0;
 }
 
+int net_pkt_pullup(struct net_pkt *pkt, size_t length)
+{
+	struct net_buf *buf = pkt->buffer;
+	struct net_buf *next;
+	size_t len;
+
+	if (!buf) {
+		return -ENOBUFS;
+	}
+
+	length = MIN(length, net_pkt_get_len(pkt));
+	if (buf->len >= length) {
+		return 0;
+	}
+
+	if (buf->size < length) {
+		return -ENOBUFS;
+	}
+
+	/* Headroom is given back first if the tailroom is too short */
+	if (net_buf_tailroom(buf) < length - buf->len) {
+		memmove(buf->__buf, buf->data, buf->len);
+		buf->data = buf->__buf;
+	}
+
+	while (buf->len < length) {
+		next = buf->frags;
+		len = MIN(length - buf->len, next->len);
+
+		net_buf_add_mem(buf, next->data, len);
+		net_buf_pull(next, len);
+
+		if (!next->len) {
+			buf->frags = next->frags;
+			next->frags = NULL;
+			net_pkt_frag_unref(next);
+		}
+	}
+
+	return 0;
+}
+
 u16_t net_pkt_get_current_offset(struct net_pkt *pkt)
 {
 	struct net_buf *buf = pkt->buffer;
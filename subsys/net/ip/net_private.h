@@ -48,7 +48,12 @@ enum net_verdict net_ipv6_input(struct net_pkt *pkt, bool is_loopback);
 extern void net_tc_tx_init(void);
 extern void net_tc_rx_init(void);
 extern void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt);
-extern void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt);
+extern u8_t net_tc_rx_queue(u8_t tc, u32_t hash);
+extern int net_tc_rx_queue_current(void);
+extern void net_tc_submit_to_rx_queue(u8_t queue, struct net_pkt *pkt);
+extern void net_tc_submit_burst_to_rx_queue(u8_t queue, struct net_pkt **pkts,
+					    size_t count);
+extern bool net_tc_rx_queue_is_empty(u8_t queue);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -130,6 +135,31 @@ static inline u16_t net_calc_chksum_tcp(struct net_pkt *pkt)
 	return net_calc_chksum(pkt, IPPROTO_TCP);
 }
 
+/* Incrementally update a checksum field (in network byte order) after a
+ * 16 bit header word changed from old to new (both in host byte order),
+ * as in RFC 1624 eqn. 3: HC' = ~(~HC + ~m + m').
+ */
+static inline u16_t net_calc_chksum_update_16(u16_t chksum, u16_t old,
+					      u16_t new)
+{
+	u32_t sum = (u16_t)~ntohs(chksum);
+
+	sum += (u16_t)~old;
+	sum += new;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return htons(~sum);
+}
+
+static inline u16_t net_calc_chksum_update_32(u16_t chksum, u32_t old,
+					      u32_t new)
+{
+	chksum = net_calc_chksum_update_16(chksum, old >> 16, new >> 16);
+
+	return net_calc_chksum_update_16(chksum, old & 0xffff, new & 0xffff);
+}
+
 static inline char *net_sprint_ll_addr(const u8_t *ll, u8_t ll_len)
 {
 	static char buf[sizeof("xx:xx:xx:xx:xx:xx:xx:xx")];
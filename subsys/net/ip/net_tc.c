@@ -28,19 +28,75 @@ NET_STACK_ARRAY_DEFINE(TX, tx_stack,
 NET_STACK_ARRAY_DEFINE(RX, rx_stack,
 		       CONFIG_NET_RX_STACK_SIZE,
 		       CONFIG_NET_RX_STACK_SIZE,
-		       NET_TC_RX_COUNT);
+		       NET_RX_QUEUE_COUNT);
 
 static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+
+/* RX queues of traffic class tc are rx_classes[tc * NET_RX_RSS_QUEUES]
+ * onwards.
+ */
+static struct net_traffic_class rx_classes[NET_RX_QUEUE_COUNT];
 
 void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt)
 {
 	k_work_submit_to_queue(&tx_classes[tc].work_q, net_pkt_work(pkt));
 }
 
-void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt)
+u8_t net_tc_rx_queue(u8_t tc, u32_t hash)
+{
+#if NET_RX_RSS_QUEUES > 1
+	return tc * NET_RX_RSS_QUEUES + hash % NET_RX_RSS_QUEUES;
+#else
+	ARG_UNUSED(hash);
+
+	return tc;
+#endif
+}
+
+int net_tc_rx_queue_current(void)
+{
+	struct k_thread *thread = k_current_get();
+	int i;
+
+	for (i = 0; i < NET_RX_QUEUE_COUNT; i++) {
+		if (thread == &rx_classes[i].work_q.thread) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+void net_tc_submit_to_rx_queue(u8_t queue, struct net_pkt *pkt)
 {
-	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
+	k_work_submit_to_queue(&rx_classes[queue].work_q, net_pkt_work(pkt));
+}
+
+void net_tc_submit_burst_to_rx_queue(u8_t queue, struct net_pkt **pkts,
+				     size_t count)
+{
+	struct k_work *work;
+	size_t i;
+
+	/* The work items are linked through their first word, which is
+	 * what k_queue_append() would do one at a time.
+	 */
+	for (i = 0; i < count; i++) {
+		work = net_pkt_work(pkts[i]);
+
+		atomic_set_bit(work->flags, K_WORK_STATE_PENDING);
+		work->_reserved = (i + 1 < count) ?
+			net_pkt_work(pkts[i + 1]) : NULL;
+	}
+
+	k_queue_append_list(&rx_classes[queue].work_q.queue,
+			    net_pkt_work(pkts[0]),
+			    net_pkt_work(pkts[count - 1]));
+}
+
+bool net_tc_rx_queue_is_empty(u8_t queue)
+{
+	return k_queue_is_empty(&rx_classes[queue].work_q.queue);
 }
 
 int net_tx_priority2tc(enum net_priority prio)
@@ -271,10 +327,10 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_RX_QUEUE_COUNT; i++) {
 		u8_t thread_priority;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_RX_RSS_QUEUES);
 		rx_classes[i].tc = thread_priority;
 
 #if defined(CONFIG_NET_SHELL)
@@ -297,5 +353,21 @@ void net_tc_rx_init(void)
 			       K_THREAD_STACK_SIZEOF(rx_stack[i]),
 			       K_PRIO_COOP(thread_priority));
 		k_thread_name_set(&rx_classes[i].work_q.thread, "rx_workq");
+
+#if defined(CONFIG_SCHED_CPU_MASK) && (CONFIG_MP_NUM_CPUS > 1) && \
+	(NET_RX_RSS_QUEUES > 1)
+		/* Other CPUs are not up yet, so the new thread has already
+		 * run and is waiting for work.
+		 */
+		if (k_thread_cpu_mask_clear(&rx_classes[i].work_q.thread) ||
+		    k_thread_cpu_mask_enable(&rx_classes[i].work_q.thread,
+					     (i % NET_RX_RSS_QUEUES) %
+					     CONFIG_MP_NUM_CPUS)) {
+			NET_WARN("[%d] Cannot pin RX queue to CPU %d", i,
+				 (i % NET_RX_RSS_QUEUES) % CONFIG_MP_NUM_CPUS);
+			(void)k_thread_cpu_mask_enable_all(
+				&rx_classes[i].work_q.thread);
+		}
+#endif
 	}
 }
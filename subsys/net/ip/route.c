@@ -256,8 +256,225 @@ static inline void update_route_access(struct net_route_entry *route)
 	sys_slist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* Path compressed binary trie of the route prefixes. A node holds the
+ * routes for exactly its prefix, if any, and its children extend that
+ * prefix, branching on the bit that follows it. A node without routes
+ * only joins two subtrees, so there are less than two nodes per route.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+	struct net_route_entry *routes;
+	struct in6_addr prefix;
+	u8_t prefix_len;
+};
+
+static struct route_trie_node route_trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *route_trie_free;
+static struct route_trie_node *route_trie;
+
+static inline int addr_bit(const struct in6_addr *addr, u8_t bit)
+{
+	return (addr->s6_addr[bit / 8U] >> (7 - bit % 8U)) & 1;
+}
+
+/* Number of leading bits a and b have in common, at most max */
+static u8_t common_prefix_len(const struct in6_addr *a,
+			      const struct in6_addr *b, u8_t max)
+{
+	u8_t len = 0U;
+	int i;
+
+	for (i = 0; i < 16 && len < max; i++) {
+		u8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_trie_node *route_trie_node_new(const struct in6_addr *prefix,
+						   u8_t prefix_len)
+{
+	struct route_trie_node *node = route_trie_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	route_trie_free = node->child[0];
+
+	(void)memset(node, 0, sizeof(*node));
+	net_ipaddr_copy(&node->prefix, prefix);
+	node->prefix_len = prefix_len;
+
+	return node;
+}
+
+static void route_trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = route_trie_free;
+	route_trie_free = node;
+}
+
+static int route_trie_add(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie;
+	struct route_trie_node *node, *leaf, *glue;
+	u8_t len = route->prefix_len;
+	u8_t common = 0U;
+
+	while (*link) {
+		node = *link;
+
+		common = common_prefix_len(&route->addr, &node->prefix,
+					   MIN(len, node->prefix_len));
+		if (common < node->prefix_len) {
+			break;
+		}
+
+		if (node->prefix_len == len) {
+			route->trie_next = node->routes;
+			node->routes = route;
+			return 0;
+		}
+
+		link = &node->child[addr_bit(&route->addr, node->prefix_len)];
+	}
+
+	leaf = route_trie_node_new(&route->addr, len);
+	if (!leaf) {
+		return -ENOMEM;
+	}
+
+	leaf->routes = route;
+	route->trie_next = NULL;
+
+	node = *link;
+	if (!node) {
+		*link = leaf;
+		return 0;
+	}
+
+	if (common == len) {
+		/* The new prefix covers the one of the node */
+		leaf->child[addr_bit(&node->prefix, len)] = node;
+		*link = leaf;
+		return 0;
+	}
+
+	glue = route_trie_node_new(&route->addr, common);
+	if (!glue) {
+		route_trie_node_free(leaf);
+		return -ENOMEM;
+	}
+
+	glue->child[addr_bit(&route->addr, common)] = leaf;
+	glue->child[addr_bit(&node->prefix, common)] = node;
+	*link = glue;
+
+	return 0;
+}
+
+/* A node without routes and with at most one child is not needed */
+static void route_trie_collapse(struct route_trie_node **link)
+{
+	struct route_trie_node *node = *link;
+
+	if (node->routes || (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	route_trie_node_free(node);
+}
+
+static void route_trie_del(struct net_route_entry *route)
+{
+	struct route_trie_node **parent_link = NULL;
+	struct route_trie_node **link = &route_trie;
+	struct net_route_entry **entry;
+	struct route_trie_node *node;
+
+	while ((node = *link) && node->prefix_len < route->prefix_len) {
+		parent_link = link;
+		link = &node->child[addr_bit(&route->addr, node->prefix_len)];
+	}
+
+	if (!node) {
+		return;
+	}
+
+	for (entry = &node->routes; *entry; entry = &(*entry)->trie_next) {
+		if (*entry == route) {
+			break;
+		}
+	}
+
+	if (!*entry) {
+		return;
+	}
+
+	*entry = route->trie_next;
+	route->trie_next = NULL;
+
+	route_trie_collapse(link);
+
+	if (parent_link) {
+		route_trie_collapse(parent_link);
+	}
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_trie_node *node = route_trie;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node && net_ipv6_is_prefix((u8_t *)dst,
+					  (u8_t *)&node->prefix,
+					  node->prefix_len)) {
+		for (route = node->routes; route; route = route->trie_next) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->prefix_len == 128U) {
+			break;
+		}
+
+		node = node->child[addr_bit(dst, node->prefix_len)];
+	}
+
+	return found;
+}
+
+static void route_trie_init(void)
+{
+	int i;
+
+	route_trie = NULL;
+	route_trie_free = NULL;
+
+	for (i = 0; i < ARRAY_SIZE(route_trie_nodes); i++) {
+		route_trie_node_free(&route_trie_nodes[i]);
+	}
+}
+#else
+#define route_trie_add(route) 0
+#define route_trie_del(route)
+#define route_trie_init()
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	u8_t longest_match = 0U;
@@ -285,6 +502,16 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+#endif /* CONFIG_NET_ROUTE_LPM */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = route_find(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -294,6 +521,27 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 	return found;
 }
 
+/* The route for exactly addr/prefix_len on iface. A lookup would find
+ * the longest prefix instead, which may be a more or a less specific
+ * route than the one being added.
+ */
+static struct net_route_entry *route_find_exact(struct net_if *iface,
+						struct in6_addr *addr,
+						u8_t prefix_len)
+{
+	struct net_route_entry *route;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&routes, route, node) {
+		if (route->iface == iface && route->prefix_len == prefix_len &&
+		    net_ipv6_is_prefix((u8_t *)addr, (u8_t *)&route->addr,
+				       prefix_len)) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
 struct net_route_entry *net_route_add(struct net_if *iface,
 				      struct in6_addr *addr,
 				      u8_t prefix_len,
@@ -332,7 +580,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		log_strdup(net_sprint_ll_addr(nexthop_lladdr->addr,
 					      nexthop_lladdr->len)));
 
-	route = net_route_lookup(iface, addr);
+	route = route_find_exact(iface, addr, prefix_len);
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -340,6 +588,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		nexthop_addr = net_route_get_nexthop(route);
 		if (nexthop_addr && net_ipv6_addr_cmp(nexthop, nexthop_addr)) {
 			NET_DBG("No changes, return old route %p", route);
+			update_route_access(route);
 			return route;
 		}
 
@@ -402,6 +651,10 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	sys_slist_prepend(&routes, &route->node);
 
+	if (route_trie_add(route) < 0) {
+		NET_ERR("No route trie node available!");
+	}
+
 	tmp = nbr_nexthop_get(iface, nexthop);
 
 	NET_ASSERT(tmp == nbr_nexthop);
@@ -454,6 +707,7 @@ int net_route_del(struct net_route_entry *route)
 #endif
 
 	sys_slist_find_and_remove(&routes, &route->node);
+	route_trie_del(route);
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -826,6 +1080,8 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop)
 
 void net_route_init(void)
 {
+	route_trie_init();
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
@@ -59,6 +59,11 @@ struct net_route_entry {
 
 	/** IPv6 address/prefix length. */
 	u8_t prefix_len;
+
+#if defined(CONFIG_NET_ROUTE_LPM)
+	/** Next route with the same prefix in the prefix trie. */
+	struct net_route_entry *trie_next;
+#endif
 };
 
 /**
@@ -52,6 +52,9 @@ static struct tcp_backlog_entry {
 	struct k_delayed_work ack_timer;
 	struct sockaddr remote;
 	u16_t send_mss;
+	u8_t send_wscale;
+	/* NET_TCP_SACK_OK and NET_TCP_WSCALE_OK as agreed in the SYN */
+	u8_t tcp_flags;
 } tcp_backlog[CONFIG_NET_TCP_BACKLOG_SIZE];
 
 #if defined(CONFIG_NET_TCP_ACK_TIMEOUT)
@@ -62,6 +65,16 @@ static struct tcp_backlog_entry {
 
 #define FIN_TIMEOUT K_SECONDS(1)
 
+/* RFC 6298 bounds for the retransmission timeout.  The lower one is
+ * relaxed from the RFC's 1 s, as in most stacks.
+ */
+#define RTO_MIN MIN(200, CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT)
+#define RTO_MAX K_SECONDS(120)
+
+#if defined(CONFIG_NET_TCP_CC_NEWRENO)
+#define tcp_cc (&net_tcp_cc_newreno)
+#endif
+
 /* Declares a wrapper function for a net_conn callback that refs the
  * context around the invocation (to protect it from premature
  * deletion).  Long term would be nice to see this feature be part of
@@ -163,8 +176,47 @@ static void net_tcp_trace(struct net_pkt *pkt,
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) *
-				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	/* rto fits in 17 bits, so the shift can't overflow below this */
+	if (tcp->retry_timeout_shift > 14) {
+		return RTO_MAX;
+	}
+
+	return MIN(tcp->rto << tcp->retry_timeout_shift, (u32_t)RTO_MAX);
+}
+
+/* RFC 6298 section 2, with srtt scaled by 8 and rttvar by 4 so that
+ * K * RTTVAR is just rttvar.
+ */
+static void tcp_rtt_sample(struct net_tcp *tcp, u32_t rtt)
+{
+	s32_t delta;
+
+	rtt = MAX(rtt, 1U);
+
+	if (tcp->srtt == 0U) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		delta = (s32_t)rtt - (s32_t)(tcp->srtt >> 3);
+		tcp->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		tcp->rttvar += delta - (tcp->rttvar >> 2);
+	}
+
+	tcp->rto = (tcp->srtt >> 3) + MAX(tcp->rttvar, 1U);
+	tcp->rto = MIN(MAX(tcp->rto, (u32_t)RTO_MIN), (u32_t)RTO_MAX);
+
+	NET_DBG("[%p] rtt %u srtt %u rttvar %u rto %u", tcp, rtt,
+		tcp->srtt >> 3, tcp->rttvar >> 2, tcp->rto);
+}
+
+static inline u32_t seq_max(u32_t seq1, u32_t seq2)
+{
+	return net_tcp_seq_greater(seq1, seq2) ? seq1 : seq2;
 }
 
 #define is_6lo_technology(pkt)						\
@@ -208,13 +260,388 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Sequence space taken by a segment on the sent list, SYN and FIN
+ * included.
+ */
+static int tcp_pkt_seq_range(struct net_pkt *pkt, u32_t *seq, u32_t *len,
+			     u8_t *flags)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_tcp_hdr *tcp_hdr;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			 net_pkt_ipv6_ext_len(pkt))) {
+		return -EMSGSIZE;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!tcp_hdr) {
+		/* The pkt does not contain TCP header, this should
+		 * not happen.
+		 */
+		NET_ERR("pkt %p has no TCP header", pkt);
+		return -EMSGSIZE;
+	}
+
+	net_pkt_acknowledge_data(pkt, &tcp_access);
+
+	*seq = sys_get_be32(tcp_hdr->seq);
+	*len = net_pkt_remaining_data(pkt);
+
+	/* Each of SYN and FIN flags are counted
+	 * as one sequence number.
+	 */
+	if (tcp_hdr->flags & NET_TCP_SYN) {
+		*len += 1U;
+	}
+	if (tcp_hdr->flags & NET_TCP_FIN) {
+		*len += 1U;
+	}
+
+	if (flags) {
+		*flags = tcp_hdr->flags;
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static bool tcp_is_sacked(struct net_tcp *tcp, u32_t seq, u32_t len)
+{
+	for (int i = 0; i < tcp->sack_count; i++) {
+		if (net_tcp_seq_cmp(seq, tcp->sack[i].left) >= 0 &&
+		    net_tcp_seq_cmp(seq + len, tcp->sack[i].right) <= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Right edge of the highest SACKed range, snd_una if there is none */
+static u32_t tcp_sack_high(struct net_tcp *tcp)
+{
+	u32_t high = tcp->snd_una;
+
+	for (int i = 0; i < tcp->sack_count; i++) {
+		high = seq_max(high, tcp->sack[i].right);
+	}
+
+	return high;
+}
+
+static void tcp_sack_add(struct net_tcp *tcp, u32_t left, u32_t right)
+{
+	int i = 0;
+	int high;
+
+	/* Merge with every block the new one overlaps or touches */
+	while (i < tcp->sack_count) {
+		struct net_tcp_sack_block *block = &tcp->sack[i];
+
+		if (net_tcp_seq_greater(left, block->right) ||
+		    net_tcp_seq_greater(block->left, right)) {
+			i++;
+			continue;
+		}
+
+		left = net_tcp_seq_greater(left, block->left) ?
+			block->left : left;
+		right = seq_max(right, block->right);
+
+		*block = tcp->sack[--tcp->sack_count];
+	}
+
+	if (tcp->sack_count == NET_TCP_SACK_MAX_BLOCKS) {
+		/* Forget the highest range, the holes below it go first */
+		high = 0;
+		for (i = 1; i < tcp->sack_count; i++) {
+			if (net_tcp_seq_greater(tcp->sack[i].left,
+						tcp->sack[high].left)) {
+				high = i;
+			}
+		}
+
+		if (net_tcp_seq_greater(left, tcp->sack[high].left)) {
+			return;
+		}
+
+		tcp->sack[high] = tcp->sack[--tcp->sack_count];
+	}
+
+	tcp->sack[tcp->sack_count].left = left;
+	tcp->sack[tcp->sack_count].right = right;
+	tcp->sack_count++;
+}
+
+/* Reads the SACK blocks of an inbound ACK into the scoreboard.  Blocks
+ * outside of what is in flight (e.g. D-SACK, RFC 2883) are ignored.
+ * The cursor is left at the options for the data path.
+ */
+static void tcp_sack_parse(struct net_tcp *tcp, struct net_pkt *pkt,
+			   int opt_totlen)
+{
+	struct net_tcp_options opts = { 0 };
+	struct net_pkt_cursor backup;
+	int ret;
+
+	if (!(tcp->flags & NET_TCP_SACK_OK) || opt_totlen <= 0) {
+		return;
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+	ret = net_tcp_parse_opts(pkt, opt_totlen, &opts);
+	net_pkt_cursor_restore(pkt, &backup);
+
+	if (ret < 0) {
+		return;
+	}
+
+	for (int i = 0; i < opts.sack_count; i++) {
+		u32_t left = opts.sack[i].left;
+		u32_t right = opts.sack[i].right;
+
+		if (!net_tcp_seq_greater(right, left) ||
+		    net_tcp_seq_greater(tcp->snd_una, left) ||
+		    net_tcp_seq_greater(right, tcp->snd_nxt)) {
+			continue;
+		}
+
+		tcp_sack_add(tcp, left, right);
+	}
+}
+
+/* Drop what the cumulative ACK now covers */
+static void tcp_sack_trim(struct net_tcp *tcp)
+{
+	int i = 0;
+
+	while (i < tcp->sack_count) {
+		struct net_tcp_sack_block *block = &tcp->sack[i];
+
+		if (!net_tcp_seq_greater(block->right, tcp->snd_una)) {
+			*block = tcp->sack[--tcp->sack_count];
+			continue;
+		}
+
+		block->left = seq_max(block->left, tcp->snd_una);
+		i++;
+	}
+}
+
+static inline void tcp_sack_clear(struct net_tcp *tcp)
+{
+	tcp->sack_count = 0U;
+}
+#else
+#define tcp_is_sacked(...) false
+#define tcp_sack_high(tcp) ((tcp)->snd_una)
+#define tcp_sack_parse(...)
+#define tcp_sack_trim(...)
+#define tcp_sack_clear(...)
+#endif /* CONFIG_NET_TCP_SACK */
+
+/* Sender state once the handshake is done, wnd being the window the
+ * peer offered in it.
+ */
+static void tcp_send_init(struct net_tcp *tcp, u32_t wnd)
+{
+	tcp->snd_una = tcp->send_seq;
+	tcp->snd_nxt = tcp->send_seq;
+	tcp->recover = tcp->send_seq - 1;
+	tcp->rexmit_nxt = tcp->send_seq;
+	tcp->send_wnd = wnd;
+	tcp->recovery = NET_TCP_RECOVERY_NONE;
+	tcp->dupacks = 0U;
+	tcp_sack_clear(tcp);
+
+	tcp_cc->init(tcp);
+}
+
+static void tcp_retransmit(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	/* Karn's algorithm: the ACK can't tell which copy it is for */
+	tcp->rtt_active = 0U;
+
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(tcp, pkt);
+		net_pkt_set_sent(pkt, false);
+	}
+
+	net_pkt_set_queued(pkt, true);
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		NET_DBG("retry %u: [%p] pkt %p send failed",
+			tcp->retry_timeout_shift, tcp, pkt);
+		net_pkt_unref(pkt);
+	} else {
+		NET_DBG("retry %u: [%p] sent pkt %p",
+			tcp->retry_timeout_shift, tcp, pkt);
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+		}
+	}
+}
+
+/* Retransmits the first segment in [from, limit) the peer has not
+ * SACKed.  Returns true if one was sent.
+ */
+static bool tcp_retransmit_hole(struct net_tcp *tcp, u32_t from, u32_t limit)
+{
+	struct net_pkt *pkt;
+	u32_t seq, len;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		if (!net_pkt_queued(pkt) && !net_pkt_sent(pkt)) {
+			/* Never sent, nor is anything after it */
+			break;
+		}
+
+		if (tcp_pkt_seq_range(pkt, &seq, &len, NULL) < 0 ||
+		    !net_tcp_seq_greater(limit, seq)) {
+			break;
+		}
+
+		if (!net_tcp_seq_greater(seq + len, from) ||
+		    tcp_is_sacked(tcp, seq, len)) {
+			continue;
+		}
+
+		/* Still waiting in the driver, sending it again is no use */
+		if (net_pkt_queued(pkt) && !is_6lo_technology(pkt)) {
+			return false;
+		}
+
+		tcp->rexmit_nxt = seq + len;
+		tcp_retransmit(tcp, pkt);
+
+		return true;
+	}
+
+	return false;
+}
+
+/* A duplicate ACK, RFC 5681 section 3.2 and RFC 6582 section 3.2 */
+static void tcp_dupack(struct net_tcp *tcp)
+{
+	switch (tcp->recovery) {
+	case NET_TCP_RECOVERY_FAST:
+		/* Each duplicate means another segment left the network */
+		tcp->cwnd = MIN(tcp->cwnd + tcp->send_mss,
+				NET_TCP_MAX_SEND_WIN);
+		tcp_retransmit_hole(tcp, seq_max(tcp->snd_una, tcp->rexmit_nxt),
+				    tcp_sack_high(tcp));
+		return;
+	case NET_TCP_RECOVERY_RTO:
+		return;
+	default:
+		break;
+	}
+
+	if (++tcp->dupacks < NET_TCP_DUPACK_THRESH) {
+		return;
+	}
+
+	tcp->dupacks = 0U;
+
+	/* Only one window reduction per loss episode */
+	if (!net_tcp_seq_greater(tcp->snd_una, tcp->recover)) {
+		return;
+	}
+
+	tcp->ssthresh = tcp_cc->ssthresh(tcp);
+	tcp->cwnd = tcp->ssthresh + NET_TCP_DUPACK_THRESH * tcp->send_mss;
+	tcp->recover = tcp->snd_nxt;
+	tcp->rexmit_nxt = tcp->snd_una;
+	tcp->recovery = NET_TCP_RECOVERY_FAST;
+
+	NET_DBG("[%p] fast retransmit, %s ssthresh %u", tcp, tcp_cc->name,
+		tcp->ssthresh);
+
+	tcp_retransmit_hole(tcp, tcp->snd_una, tcp->recover);
+}
+
+/* The cumulative ACK moved forward to ack */
+static void tcp_new_ack(struct net_tcp *tcp, u32_t ack)
+{
+	u32_t acked = ack - tcp->snd_una;
+
+	tcp->snd_una = ack;
+	/* The retransmit timer may have sent data we never counted */
+	tcp->snd_nxt = seq_max(tcp->snd_nxt, ack);
+	tcp->dupacks = 0U;
+	tcp_sack_trim(tcp);
+
+	if (tcp->rtt_active && !net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+		tcp_rtt_sample(tcp, k_uptime_get_32() - tcp->rtt_start);
+		tcp->rtt_active = 0U;
+	}
+
+	if (tcp->recovery == NET_TCP_RECOVERY_NONE) {
+		tcp_cc->ack(tcp, acked);
+		return;
+	}
+
+	if (!net_tcp_seq_greater(tcp->recover, ack)) {
+		/* Full ACK, recovery is over */
+		if (tcp->recovery == NET_TCP_RECOVERY_FAST) {
+			tcp->cwnd = MIN(tcp->ssthresh,
+					MAX(net_tcp_flight_size(tcp),
+					    tcp->send_mss) + tcp->send_mss);
+		}
+
+		NET_DBG("[%p] recovered, cwnd %u", tcp, tcp->cwnd);
+		tcp->recovery = NET_TCP_RECOVERY_NONE;
+		return;
+	}
+
+	/* Partial ACK: the next hole was lost as well.  Fast recovery
+	 * deflates cwnd by what left the network, after a timeout we
+	 * are in slow start.
+	 */
+	if (tcp->recovery == NET_TCP_RECOVERY_FAST) {
+		tcp->cwnd -= MIN(acked, tcp->cwnd);
+		if (acked >= tcp->send_mss) {
+			tcp->cwnd += tcp->send_mss;
+		}
+	} else {
+		tcp_cc->ack(tcp, acked);
+	}
+
+	tcp_retransmit_hole(tcp, seq_max(tcp->snd_una, tcp->rexmit_nxt),
+			    tcp->recover);
+}
+
+/* The retransmit timer expired with data in flight */
+static void tcp_rto_loss(struct net_tcp *tcp)
+{
+	/* Later expiries for the same segment keep ssthresh */
+	if (tcp->retry_timeout_shift == 1U) {
+		tcp->ssthresh = tcp_cc->ssthresh(tcp);
+	}
+
+	tcp->cwnd = tcp->send_mss;
+	tcp->recover = tcp->snd_nxt;
+	tcp->rexmit_nxt = tcp->snd_una;
+	tcp->recovery = NET_TCP_RECOVERY_RTO;
+	tcp->dupacks = 0U;
+
+	/* The peer may drop what it SACKed, RFC 2018 section 8 */
+	tcp_sack_clear(tcp);
+}
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
 	struct net_pkt *pkt;
 
 	/* Double the retry period for exponential backoff and resend
-	 * the first (only the first!) unack'd packet.
+	 * the first (only the first!) unack'd packet.  Any other holes
+	 * are retransmitted as partial ACKs come in.
 	 */
 	if (!sys_slist_is_empty(&tcp->sent_list)) {
 		tcp->retry_timeout_shift++;
@@ -226,29 +653,14 @@ static void tcp_retry_expired(struct k_work *work)
 
 		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
-
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
+		if (net_tcp_flight_size(tcp) > 0U) {
+			tcp_rto_loss(tcp);
 		}
 
-		net_pkt_set_queued(pkt, true);
+		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+				   struct net_pkt, sent_list);
 
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			NET_DBG("retry %u: [%p] pkt %p send failed",
-				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
-		} else {
-			NET_DBG("retry %u: [%p] sent pkt %p",
-				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
-		}
+		tcp_retransmit(tcp, pkt);
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
 			NET_DBG("[%p] Closing connection (context %p)",
@@ -284,6 +696,10 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].send_seq = tcp_init_isn();
 	tcp_context[i].recv_wnd = MIN(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
 	tcp_context[i].send_mss = NET_TCP_DEFAULT_MSS;
+	tcp_context[i].rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+
+	/* Until the handshake tells us better */
+	tcp_send_init(&tcp_context[i], UINT16_MAX);
 
 	tcp_context[i].accept_cb = NULL;
 
@@ -340,7 +756,7 @@ int net_tcp_release(struct net_tcp *tcp)
 	tcp->context = NULL;
 
 	key = irq_lock();
-	tcp->flags &= ~(NET_TCP_IN_USE | NET_TCP_RECV_MSS_SET);
+	tcp->flags &= ~NET_TCP_IN_USE;
 	irq_unlock(key);
 
 	NET_DBG("[%p] Disposed of TCP connection state", tcp);
@@ -655,25 +1071,39 @@ u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp)
 	return 0;
 }
 
+/* Options for a SYN or SYN-ACK.  A SYN-ACK may only carry window scale
+ * and SACK-permitted if the SYN did (RFC 7323 section 2.2, RFC 2018
+ * section 2).
+ */
 static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
-				u8_t *optionlen)
+				u8_t *optionlen, bool wscale, bool sack)
 {
-	u32_t recv_mss;
+	u32_t opt;
 
 	*optionlen = 0U;
 
-	if (!(tcp->flags & NET_TCP_RECV_MSS_SET)) {
-		recv_mss = net_tcp_get_recv_mss(tcp);
-		tcp->flags |= NET_TCP_RECV_MSS_SET;
-	} else {
-		recv_mss = 0U;
-	}
+	opt = net_tcp_get_recv_mss(tcp);
+	opt |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
+	UNALIGNED_PUT(htonl(opt), (u32_t *)(options + *optionlen));
+	*optionlen += NET_TCP_MSS_SIZE;
 
-	recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
-	UNALIGNED_PUT(htonl(recv_mss),
-		      (u32_t *)(options + *optionlen));
+	if (wscale) {
+		/* Our receive window fits in 16 bits, so the shift is 0.
+		 * Sending the option still lets the peer scale its own.
+		 */
+		opt = (NET_TCP_NOP_OPT << 24) |
+			(NET_TCP_WINDOW_SCALE_OPT << 16) |
+			(NET_TCP_WINDOW_SCALE_SIZE << 8);
+		UNALIGNED_PUT(htonl(opt), (u32_t *)(options + *optionlen));
+		*optionlen += NET_TCP_NOP_SIZE + NET_TCP_WINDOW_SCALE_SIZE;
+	}
 
-	*optionlen += NET_TCP_MSS_SIZE;
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && sack) {
+		opt = (NET_TCP_NOP_OPT << 24) | (NET_TCP_NOP_OPT << 16) |
+			(NET_TCP_SACK_PERM_OPT << 8) | NET_TCP_SACK_PERM_SIZE;
+		UNALIGNED_PUT(htonl(opt), (u32_t *)(options + *optionlen));
+		*optionlen += 2 * NET_TCP_NOP_SIZE + NET_TCP_SACK_PERM_SIZE;
+	}
 }
 
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
@@ -687,7 +1117,9 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		/* In the SYN_RCVD state acknowledgment must be with the
 		 * SYN flag.
 		 */
-		net_tcp_set_syn_opt(tcp, options, &optionlen);
+		net_tcp_set_syn_opt(tcp, options, &optionlen,
+				    tcp->flags & NET_TCP_WSCALE_OK,
+				    tcp->flags & NET_TCP_SACK_OK);
 
 		return net_tcp_prepare_segment(tcp, NET_TCP_SYN | NET_TCP_ACK,
 					       options, optionlen, NULL, remote,
@@ -857,7 +1289,7 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
 	struct net_context *ctx = net_pkt_context(pkt);
 	struct net_tcp_hdr *tcp_hdr;
-	bool calc_chksum = false;
+	bool calc_chksum;
 
 	if (!ctx || !ctx->tcp) {
 		NET_ERR("%scontext is not set on pkt %p",
@@ -879,10 +1311,19 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		return -EMSGSIZE;
 	}
 
+	/* Only the ACK number and flags may change here, so patch the
+	 * checksum for them rather than summing the whole segment again.
+	 */
+	calc_chksum = net_if_need_calc_tx_checksum(net_pkt_iface(pkt));
+
 	if (sys_get_be32(tcp_hdr->ack) != ctx->tcp->send_ack) {
+		if (calc_chksum) {
+			tcp_hdr->chksum = net_calc_chksum_update_32(
+				tcp_hdr->chksum, sys_get_be32(tcp_hdr->ack),
+				ctx->tcp->send_ack);
+		}
+
 		sys_put_be32(ctx->tcp->send_ack, tcp_hdr->ack);
-		tcp_hdr->chksum = 0U;
-		calc_chksum = true;
 	}
 
 	/* The data stream code always sets this flag, because
@@ -892,26 +1333,22 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	 */
 	if (ctx->tcp->sent_ack != ctx->tcp->send_ack &&
 		(tcp_hdr->flags & NET_TCP_ACK) == 0U) {
+		/* Flags share a 16 bit word with the data offset */
+		u16_t old = (tcp_hdr->offset << 8) | tcp_hdr->flags;
+
 		tcp_hdr->flags |= NET_TCP_ACK;
-		tcp_hdr->chksum = 0U;
-		calc_chksum = true;
+
+		if (calc_chksum) {
+			tcp_hdr->chksum = net_calc_chksum_update_16(
+				tcp_hdr->chksum, old,
+				(tcp_hdr->offset << 8) | tcp_hdr->flags);
+		}
 	}
 
 	/* As we modified the header, we need to write it back.
 	 */
 	net_pkt_set_data(pkt, &tcp_access);
 
-	if (calc_chksum) {
-		net_pkt_cursor_init(pkt);
-		net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt));
-
-		/* No need to get tcp_hdr again */
-		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
-
-		net_pkt_set_data(pkt, &tcp_access);
-	}
-
 	if (tcp_hdr->flags & NET_TCP_FIN) {
 		ctx->tcp->fin_sent = 1U;
 	}
@@ -993,33 +1430,61 @@ static void restart_timer(struct net_tcp *tcp)
 int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
 		      void *user_data)
 {
+	struct net_tcp *tcp = context->tcp;
+	u32_t wnd = MIN(tcp->cwnd, tcp->send_wnd);
 	struct net_pkt *pkt;
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
+	/* Send as much queued data as the congestion and peer windows
+	 * allow, the rest goes out as ACKs open them.  One segment may
+	 * always go with nothing in flight, so a zero window is probed
+	 * by the retransmit timer.
 	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		u32_t flight = net_tcp_flight_size(tcp);
+		u32_t seq, len;
+		int ret;
+
 		/* Do not resend packets that were sent by expire timer */
 		if (net_pkt_queued(pkt)) {
 			NET_DBG("[%p] Skipping pkt %p because it was already "
-				"sent.", context->tcp, pkt);
+				"sent.", tcp, pkt);
 			continue;
 		}
 
-		if (!net_pkt_sent(pkt)) {
-			int ret;
+		if (net_pkt_sent(pkt)) {
+			continue;
+		}
 
-			NET_DBG("[%p] Sending pkt %p (%zd bytes)", context->tcp,
-				pkt, net_pkt_get_len(pkt));
+		if (tcp_pkt_seq_range(pkt, &seq, &len, NULL) < 0) {
+			break;
+		}
 
-			ret = net_tcp_send_pkt(pkt);
-			if (ret < 0 && !is_6lo_technology(pkt)) {
-				NET_DBG("[%p] pkt %p not sent (%d)",
-					context->tcp, pkt, ret);
-				net_pkt_unref(pkt);
-			}
+		if (flight > 0 && flight + len > wnd) {
+			NET_DBG("[%p] Window full, flight %u cwnd %u wnd %u",
+				tcp, flight, tcp->cwnd, tcp->send_wnd);
+			break;
+		}
+
+		NET_DBG("[%p] Sending pkt %p (%zd bytes)", tcp,
+			pkt, net_pkt_get_len(pkt));
+
+		/* Mark it first, the driver may be done with it (and mark
+		 * it sent) by the time net_tcp_send_pkt() returns.
+		 */
+		net_pkt_set_queued(pkt, true);
 
-			net_pkt_set_queued(pkt, true);
+		ret = net_tcp_send_pkt(pkt);
+		if (ret < 0 && !is_6lo_technology(pkt)) {
+			NET_DBG("[%p] pkt %p not sent (%d)", tcp, pkt, ret);
+			net_pkt_unref(pkt);
+		}
+
+		tcp->snd_nxt = seq_max(tcp->snd_nxt, seq + len);
+
+		if (!tcp->rtt_active) {
+			tcp->rtt_seq = seq + len;
+			tcp->rtt_start = k_uptime_get_32();
+			tcp->rtt_active = 1U;
 		}
 	}
 
@@ -1055,61 +1520,27 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	}
 
 	while (!sys_slist_is_empty(list)) {
-		NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
-		struct net_tcp_hdr *tcp_hdr;
-		u32_t last_seq;
-		u32_t seq_len;
+		u32_t seq, seq_len;
+		u8_t flags;
 
 		head = sys_slist_peek_head(list);
 		pkt = CONTAINER_OF(head, struct net_pkt, sent_list);
 
-		net_pkt_cursor_init(pkt);
-		net_pkt_set_overwrite(pkt, true);
-
-		if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
-			 net_pkt_ipv6_ext_len(pkt))) {
+		if (tcp_pkt_seq_range(pkt, &seq, &seq_len, &flags) < 0) {
 			sys_slist_remove(list, NULL, head);
 			net_pkt_unref(pkt);
 			continue;
 		}
 
-		tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt,
-								 &tcp_access);
-		if (!tcp_hdr) {
-			/* The pkt does not contain TCP header, this should
-			 * not happen.
-			 */
-			NET_ERR("pkt %p has no TCP header", pkt);
-			sys_slist_remove(list, NULL, head);
-			net_pkt_unref(pkt);
-			continue;
-		}
-
-		net_pkt_acknowledge_data(pkt, &tcp_access);
-		seq_len = net_pkt_remaining_data(pkt);
-
-		/* Each of SYN and FIN flags are counted
-		 * as one sequence number.
-		 */
-		if (tcp_hdr->flags & NET_TCP_SYN) {
-			seq_len += 1U;
-		}
-		if (tcp_hdr->flags & NET_TCP_FIN) {
-			seq_len += 1U;
-		}
-
-		/* Last sequence number in this packet. */
-		last_seq = sys_get_be32(tcp_hdr->seq) + seq_len - 1;
-
 		/* Ack number should be strictly greater to acknowledged numbers
 		 * below it. For example, ack no. 10 acknowledges all numbers up
 		 * to and including 9.
 		 */
-		if (!net_tcp_seq_greater(ack, last_seq)) {
+		if (!net_tcp_seq_greater(ack, seq + seq_len - 1)) {
 			break;
 		}
 
-		if (tcp_hdr->flags & NET_TCP_FIN) {
+		if (flags & NET_TCP_FIN) {
 			enum net_tcp_state s = net_tcp_get_state(tcp);
 
 			if (s == NET_TCP_FIN_WAIT_1) {
@@ -1124,6 +1555,10 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 		valid_ack = true;
 	}
 
+	if (net_tcp_seq_greater(ack, tcp->snd_una)) {
+		tcp_new_ack(tcp, ack);
+	}
+
 	/* Restart the timer (if needed) on a valid inbound ACK.  This isn't
 	 * quite the same behavior as per-packet retry timers, but is close in
 	 * practice (it starts retries one timer period after the connection
@@ -1286,6 +1721,7 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		       struct net_tcp_options *opts)
 {
 	u8_t opt, optlen;
+	u16_t mss;
 
 	while (opt_totlen) {
 		if (net_pkt_read_u8(pkt, &opt)) {
@@ -1332,10 +1768,57 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 				goto error;
 			}
 
-			if (net_pkt_read_be16(pkt, &opts->mss)) {
+			if (net_pkt_read_be16(pkt, &mss)) {
 				goto error;
 			}
 
+			/* A zero MSS is meaningless, keep the default */
+			if (mss) {
+				opts->mss = mss;
+			}
+
+			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			if (optlen != 1U) {
+				goto error;
+			}
+
+			if (net_pkt_read_u8(pkt, &opts->wscale)) {
+				goto error;
+			}
+
+			opts->wscale = MIN(opts->wscale, NET_TCP_MAX_WSCALE);
+			opts->wscale_ok = true;
+
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (optlen != 0U) {
+				goto error;
+			}
+
+			opts->sack_ok = true;
+
+			break;
+		case NET_TCP_SACK_OPT:
+			if (optlen % NET_TCP_SACK_BLOCK_SIZE) {
+				goto error;
+			}
+
+			for (int i = 0; i < optlen / NET_TCP_SACK_BLOCK_SIZE;
+			     i++) {
+				struct net_tcp_sack_block block;
+
+				if (net_pkt_read_be32(pkt, &block.left) ||
+				    net_pkt_read_be32(pkt, &block.right)) {
+					goto error;
+				}
+
+				if (opts->sack_count <
+				    NET_TCP_SACK_MAX_BLOCKS) {
+					opts->sack[opts->sack_count++] = block;
+				}
+			}
+
 			break;
 		default:
 			if (net_pkt_skip(pkt, optlen)) {
@@ -1555,7 +2038,7 @@ static int tcp_backlog_syn(struct net_pkt *pkt,
 			   union net_ip_header *ip_hdr,
 			   struct net_tcp_hdr *tcp_hdr,
 			   struct net_context *context,
-			   u16_t send_mss)
+			   const struct net_tcp_options *opts)
 {
 	int empty_slot = -1;
 
@@ -1574,7 +2057,16 @@ static int tcp_backlog_syn(struct net_pkt *pkt,
 
 	tcp_backlog[empty_slot].send_seq = context->tcp->send_seq;
 	tcp_backlog[empty_slot].send_ack = context->tcp->send_ack;
-	tcp_backlog[empty_slot].send_mss = send_mss;
+	tcp_backlog[empty_slot].send_mss = opts->mss;
+
+	if (opts->wscale_ok) {
+		tcp_backlog[empty_slot].send_wscale = opts->wscale;
+		tcp_backlog[empty_slot].tcp_flags |= NET_TCP_WSCALE_OK;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && opts->sack_ok) {
+		tcp_backlog[empty_slot].tcp_flags |= NET_TCP_SACK_OK;
+	}
 
 	k_delayed_work_init(&tcp_backlog[empty_slot].ack_timer,
 			    backlog_ack_timeout);
@@ -1605,6 +2097,11 @@ static int tcp_backlog_ack(struct net_pkt *pkt,
 	context->tcp->send_seq = tcp_backlog[r].send_seq + 1;
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
 	context->tcp->send_mss = tcp_backlog[r].send_mss;
+	context->tcp->snd_wscale = tcp_backlog[r].send_wscale;
+	context->tcp->flags |= tcp_backlog[r].tcp_flags;
+
+	tcp_send_init(context->tcp, (u32_t)sys_get_be16(tcp_hdr->wnd) <<
+		      context->tcp->snd_wscale);
 
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	(void)memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
@@ -1787,15 +2284,20 @@ static void print_send_info(struct net_pkt *pkt,
 static inline int send_syn_segment(struct net_context *context,
 				       const struct sockaddr_ptr *local,
 				       const struct sockaddr *remote,
-				       int flags, const char *msg)
+				       int flags, const char *msg,
+				       const struct net_tcp_options *peer)
 {
 	struct net_pkt *pkt = NULL;
 	int ret;
 	u8_t options[NET_TCP_MAX_OPT_SIZE];
 	u8_t optionlen = 0U;
 
-	if (flags == NET_TCP_SYN) {
-		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
+	if (peer) {
+		net_tcp_set_syn_opt(context->tcp, options, &optionlen,
+				    peer->wscale_ok, peer->sack_ok);
+	} else {
+		net_tcp_set_syn_opt(context->tcp, options, &optionlen,
+				    true, true);
 	}
 
 	ret = net_tcp_prepare_segment(context->tcp, flags, options, optionlen,
@@ -1822,16 +2324,22 @@ static inline int send_syn(struct net_context *context,
 {
 	net_tcp_change_state(context->tcp, NET_TCP_SYN_SENT);
 
-	return send_syn_segment(context, NULL, remote, NET_TCP_SYN, "SYN");
+	/* The handshake gives the first RTT sample */
+	context->tcp->rtt_start = k_uptime_get_32();
+	context->tcp->rtt_active = 1U;
+
+	return send_syn_segment(context, NULL, remote, NET_TCP_SYN, "SYN",
+				NULL);
 }
 
 static inline int send_syn_ack(struct net_context *context,
 			       struct sockaddr_ptr *local,
-			       struct sockaddr *remote)
+			       struct sockaddr *remote,
+			       const struct net_tcp_options *peer)
 {
 	return send_syn_segment(context, local, remote,
 				    NET_TCP_SYN | NET_TCP_ACK,
-				    "SYN_ACK");
+				    "SYN_ACK", peer);
 }
 
 static int send_ack(struct net_context *context,
@@ -1902,6 +2410,57 @@ static u16_t adjust_data_len(struct net_pkt *pkt, struct net_tcp_hdr *tcp_hdr,
 	return data_len;
 }
 
+/* Sender side of an inbound ACK: SACK blocks, the peer window and
+ * duplicate ACK detection, then whatever the windows now allow is sent.
+ * Returns false if the ACK is not acceptable.
+ */
+static bool tcp_ack_segment(struct net_context *context, struct net_pkt *pkt,
+			    struct net_tcp_hdr *tcp_hdr)
+{
+	struct net_tcp *tcp = context->tcp;
+	int opt_totlen = NET_TCP_HDR_LEN(tcp_hdr) - sizeof(struct net_tcp_hdr);
+	u32_t ack = sys_get_be32(tcp_hdr->ack);
+	u32_t wnd = sys_get_be16(tcp_hdr->wnd);
+	bool dupack;
+
+	/* The window of a SYN is never scaled */
+	if (!(NET_TCP_FLAGS(tcp_hdr) & NET_TCP_SYN)) {
+		wnd <<= tcp->snd_wscale;
+	}
+
+	tcp_sack_parse(tcp, pkt, opt_totlen);
+
+	/* RFC 5681 section 2: no data, no SYN/FIN, same ACK and window
+	 * while data is outstanding.
+	 */
+	dupack = ack == tcp->snd_una && wnd == tcp->send_wnd &&
+		(int)net_pkt_remaining_data(pkt) == opt_totlen &&
+		!(NET_TCP_FLAGS(tcp_hdr) & (NET_TCP_SYN | NET_TCP_FIN)) &&
+		net_tcp_flight_size(tcp) > 0U;
+
+	if (!net_tcp_ack_received(context, ack)) {
+		return false;
+	}
+
+	tcp->send_wnd = wnd;
+
+	if (dupack) {
+		tcp_dupack(tcp);
+	}
+
+	net_tcp_send_data(context, NULL, NULL);
+
+	return true;
+}
+
+#if defined(CONFIG_NET_TEST)
+bool net_tcp_ack_segment(struct net_context *context, struct net_pkt *pkt,
+			 struct net_tcp_hdr *tcp_hdr)
+{
+	return tcp_ack_segment(context, pkt, tcp_hdr);
+}
+#endif
+
 /* This is called when we receive data after the connection has been
  * established. The core TCP logic is located here.
  *
@@ -1989,8 +2548,7 @@ resend_ack:
 
 	/* Handle TCP state transition */
 	if (tcp_flags & NET_TCP_ACK) {
-		if (!net_tcp_ack_received(context,
-					  sys_get_be32(tcp_hdr->ack))) {
+		if (!tcp_ack_segment(context, pkt, tcp_hdr)) {
 			ret = NET_DROP;
 			goto unlock;
 		}
@@ -2158,9 +2716,37 @@ NET_CONN_CB(tcp_synack_received)
 		/* Remove the temporary connection handler and register
 		 * a proper now as we have an established connection.
 		 */
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
+		struct net_tcp *tcp = context->tcp;
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
 
+		if (net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       sizeof(struct net_tcp_hdr),
+				       &tcp_opts) < 0) {
+			return NET_DROP;
+		}
+
+		tcp->send_mss = tcp_opts.mss;
+
+		if (tcp_opts.wscale_ok) {
+			tcp->snd_wscale = tcp_opts.wscale;
+			tcp->flags |= NET_TCP_WSCALE_OK;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_TCP_SACK) && tcp_opts.sack_ok) {
+			tcp->flags |= NET_TCP_SACK_OK;
+		}
+
+		if (tcp->rtt_active) {
+			tcp_rtt_sample(tcp, k_uptime_get_32() - tcp->rtt_start);
+			tcp->rtt_active = 0U;
+		}
+
+		tcp_send_init(tcp, sys_get_be16(tcp_hdr->wnd));
+
 		tcp_copy_ip_addr_from_hdr(net_pkt_family(pkt), ip_hdr, tcp_hdr,
 					  &remote_addr, true);
 		tcp_copy_ip_addr_from_hdr(net_pkt_family(pkt), ip_hdr, tcp_hdr,
@@ -2309,10 +2895,8 @@ NET_CONN_CB(tcp_syn_rcvd)
 		context->tcp->send_ack =
 			sys_get_be32(tcp_hdr->seq) + 1;
 
-		/* Get MSS from TCP options here*/
-
 		r = tcp_backlog_syn(pkt, ip_hdr, tcp_hdr,
-				    context, tcp_opts.mss);
+				    context, &tcp_opts);
 		if (r < 0) {
 			if (r == -EADDRINUSE) {
 				NET_DBG("TCP connection already exists");
@@ -2326,7 +2910,7 @@ NET_CONN_CB(tcp_syn_rcvd)
 		get_sockaddr_ptr(ip_hdr, tcp_hdr,
 				 net_context_get_family(context),
 				 &pkt_src_addr);
-		send_syn_ack(context, &pkt_src_addr, &remote_addr);
+		send_syn_ack(context, &pkt_src_addr, &remote_addr, &tcp_opts);
 		net_pkt_unref(pkt);
 		return NET_OK;
 	}
@@ -2591,6 +3175,7 @@ struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 	    net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	    !net_pkt_is_chksum_done(pkt) &&
 	    net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -0,0 +1,53 @@
+/** @file
+ * @brief TCP NewReno congestion control
+ *
+ * Slow start and congestion avoidance as in RFC 5681, with the initial
+ * window of RFC 3390 and byte counting of RFC 3465.  Fast recovery
+ * itself (RFC 6582) is run by the TCP engine.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+
+#include "tcp_internal.h"
+
+static void newreno_init(struct net_tcp *tcp)
+{
+	u32_t mss = tcp->send_mss;
+
+	tcp->cwnd = MIN(4U * mss, MAX(2U * mss, 4380U));
+	tcp->ssthresh = NET_TCP_MAX_SEND_WIN;
+}
+
+static void newreno_ack(struct net_tcp *tcp, u32_t acked)
+{
+	u32_t mss = tcp->send_mss;
+	u32_t inc;
+
+	if (tcp->cwnd < tcp->ssthresh) {
+		/* Slow start, at most one MSS per ACK (L = 1) */
+		inc = MIN(acked, mss);
+	} else {
+		/* Congestion avoidance, about one MSS per RTT */
+		inc = MAX(1U, mss * mss / tcp->cwnd);
+	}
+
+	tcp->cwnd = MIN(tcp->cwnd + inc, NET_TCP_MAX_SEND_WIN);
+}
+
+static u32_t newreno_ssthresh(struct net_tcp *tcp)
+{
+	return MAX(net_tcp_flight_size(tcp) / 2U, 2U * tcp->send_mss);
+}
+
+const struct net_tcp_cc net_tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.ack = newreno_ack,
+	.ssthresh = newreno_ssthresh,
+};
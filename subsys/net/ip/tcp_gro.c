@@ -0,0 +1,284 @@
+/** @file
+ * @brief TCP generic receive offload
+ *
+ * In order segments of one connection that sit back to back in an RX
+ * queue are appended to the first of them, so IP and TCP input run
+ * once for the lot. As in Linux tcp_gro_receive(), only ACK data
+ * segments whose headers match but for the sequence number and PSH are
+ * merged, so the result is what the peer would have sent with a bigger
+ * MSS. Checksums are verified segment by segment on the way in.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <sys/byteorder.h>
+
+#include "net_private.h"
+#include "ipv6.h"
+#include "tcp_internal.h"
+
+/* Where a candidate segment's headers are, all in the first fragment */
+struct gro_seg {
+	struct net_tcp_hdr *tcp_hdr;
+	u32_t seq;
+	u16_t len;
+	u8_t ip_len;
+	u8_t hdr_len;
+};
+
+static bool gro_parse(struct net_pkt *pkt, struct gro_seg *seg)
+{
+	struct net_buf *buf = pkt->buffer;
+	size_t tot_len;
+
+	if (!buf || !buf->len) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (buf->data[0] & 0xf0) == 0x40) {
+		struct net_ipv4_hdr *hdr = NET_IPV4_HDR(pkt);
+
+		/* No options and no fragments */
+		if (buf->len < sizeof(*hdr) || hdr->vhl != 0x45 ||
+		    hdr->proto != IPPROTO_TCP ||
+		    (hdr->offset[0] & 0x3f) || hdr->offset[1]) {
+			return false;
+		}
+
+		net_pkt_set_family(pkt, AF_INET);
+		seg->ip_len = sizeof(*hdr);
+		tot_len = ntohs(hdr->len);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   (buf->data[0] & 0xf0) == 0x60) {
+		struct net_ipv6_hdr *hdr = NET_IPV6_HDR(pkt);
+
+		/* No extension headers, and nothing to be routed on */
+		if (buf->len < sizeof(*hdr) || hdr->nexthdr != IPPROTO_TCP ||
+		    (IS_ENABLED(CONFIG_NET_ROUTING) &&
+		     !net_ipv6_is_my_addr(&hdr->dst))) {
+			return false;
+		}
+
+		net_pkt_set_family(pkt, AF_INET6);
+		net_pkt_set_ipv6_ext_len(pkt, 0);
+		seg->ip_len = sizeof(*hdr);
+		tot_len = ntohs(hdr->len) + sizeof(*hdr);
+	} else {
+		return false;
+	}
+
+	if (tot_len > net_pkt_get_len(pkt) ||
+	    buf->len < seg->ip_len + NET_TCPH_LEN) {
+		return false;
+	}
+
+	seg->tcp_hdr = (struct net_tcp_hdr *)(buf->data + seg->ip_len);
+	seg->hdr_len = seg->ip_len + NET_TCP_HDR_LEN(seg->tcp_hdr);
+
+	if (NET_TCP_HDR_LEN(seg->tcp_hdr) < NET_TCPH_LEN ||
+	    buf->len < seg->hdr_len || tot_len <= seg->hdr_len) {
+		return false;
+	}
+
+	/* Plain data: no SYN, FIN, RST, URG, nor ECN signalling */
+	if ((seg->tcp_hdr->flags & ~NET_TCP_PSH) != NET_TCP_ACK) {
+		return false;
+	}
+
+	seg->seq = sys_get_be32(seg->tcp_hdr->seq);
+	seg->len = tot_len - seg->hdr_len;
+
+	/* Ethernet padding would otherwise end up in the middle */
+	net_pkt_update_length(pkt, tot_len);
+	net_pkt_trim_buffer(pkt);
+	net_pkt_set_ip_hdr_len(pkt, seg->ip_len);
+
+	return true;
+}
+
+/* Checked now, as the headers of a merged segment are thrown away */
+static bool gro_verify(struct net_pkt *pkt)
+{
+	if (!net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+		return true;
+	}
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(pkt) == AF_INET && net_calc_chksum_ipv4(pkt) != 0U) {
+		return false;
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
+	    net_calc_chksum_tcp(pkt) != 0U) {
+		return false;
+	}
+
+	net_pkt_set_chksum_done(pkt, true);
+
+	return true;
+}
+
+static bool gro_same_flow(struct net_tcp_gro *gro, struct net_pkt *pkt,
+			  struct gro_seg *seg)
+{
+	struct net_pkt *head = gro->pkt;
+	struct net_tcp_hdr *head_tcp;
+
+	if (net_pkt_iface(head) != net_pkt_iface(pkt) ||
+	    net_pkt_family(head) != net_pkt_family(pkt) ||
+	    gro->hdr_len != seg->hdr_len) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		struct net_ipv4_hdr *a = NET_IPV4_HDR(head);
+		struct net_ipv4_hdr *b = NET_IPV4_HDR(pkt);
+
+		if (a->tos != b->tos || a->ttl != b->ttl ||
+		    !net_ipv4_addr_cmp(&a->src, &b->src) ||
+		    !net_ipv4_addr_cmp(&a->dst, &b->dst)) {
+			return false;
+		}
+	} else {
+		struct net_ipv6_hdr *a = NET_IPV6_HDR(head);
+		struct net_ipv6_hdr *b = NET_IPV6_HDR(pkt);
+
+		if (a->vtc != b->vtc || a->tcflow != b->tcflow ||
+		    a->flow != b->flow || a->hop_limit != b->hop_limit ||
+		    !net_ipv6_addr_cmp(&a->src, &b->src) ||
+		    !net_ipv6_addr_cmp(&a->dst, &b->dst)) {
+			return false;
+		}
+	}
+
+	head_tcp = (struct net_tcp_hdr *)(head->buffer->data + seg->ip_len);
+
+	/* Ports, then ACK, data offset and window, then urgent pointer
+	 * and options: everything but sequence number, flags and checksum.
+	 */
+	return !memcmp(head_tcp, seg->tcp_hdr, 4) &&
+		!memcmp(head_tcp->ack, seg->tcp_hdr->ack, 5) &&
+		!memcmp(head_tcp->wnd, seg->tcp_hdr->wnd, 2) &&
+		!memcmp(head_tcp->urg, seg->tcp_hdr->urg,
+			seg->hdr_len - seg->ip_len - 18);
+}
+
+/* Appends the payload of pkt to the packet being coalesced */
+static void gro_merge(struct net_tcp_gro *gro, struct net_pkt *pkt,
+		      struct gro_seg *seg)
+{
+	struct net_pkt *head = gro->pkt;
+	struct net_tcp_hdr *head_tcp;
+	struct net_buf *buf;
+	size_t strip = seg->hdr_len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(head) == AF_INET) {
+		struct net_ipv4_hdr *hdr = NET_IPV4_HDR(head);
+		u16_t len = ntohs(hdr->len);
+
+		hdr->len = htons(len + seg->len);
+		hdr->chksum = net_calc_chksum_update_16(hdr->chksum, len,
+							len + seg->len);
+	} else {
+		struct net_ipv6_hdr *hdr = NET_IPV6_HDR(head);
+
+		hdr->len = htons(ntohs(hdr->len) + seg->len);
+	}
+
+	head_tcp = (struct net_tcp_hdr *)(head->buffer->data + seg->ip_len);
+	head_tcp->flags |= seg->tcp_hdr->flags & NET_TCP_PSH;
+
+	while (strip) {
+		buf = pkt->buffer;
+
+		if (buf->len > strip) {
+			net_buf_pull(buf, strip);
+			break;
+		}
+
+		strip -= buf->len;
+		pkt->buffer = buf->frags;
+		buf->frags = NULL;
+		net_pkt_frag_unref(buf);
+	}
+
+	net_pkt_append_buffer(head, pkt->buffer);
+	pkt->buffer = NULL;
+	net_pkt_unref(pkt);
+
+	gro->next_seq += seg->len;
+}
+
+struct net_pkt *net_tcp_gro_flush(struct net_tcp_gro *gro)
+{
+	struct net_pkt *pkt = gro->pkt;
+
+	gro->pkt = NULL;
+
+	return pkt;
+}
+
+enum net_verdict net_tcp_gro_receive(struct net_tcp_gro *gro,
+				     struct net_pkt *pkt,
+				     struct net_pkt **flush)
+{
+	struct gro_seg seg;
+	bool psh;
+	size_t len;
+
+	*flush = NULL;
+
+	if (!gro_parse(pkt, &seg) || !gro_verify(pkt)) {
+		*flush = net_tcp_gro_flush(gro);
+		return NET_CONTINUE;
+	}
+
+	psh = !!(seg.tcp_hdr->flags & NET_TCP_PSH);
+
+	if (gro->pkt) {
+		len = net_pkt_get_len(gro->pkt) + seg.len;
+
+		if (seg.seq == gro->next_seq && seg.len <= gro->seg_len &&
+		    len <= CONFIG_NET_TCP_GRO_MAX_SIZE &&
+		    gro_same_flow(gro, pkt, &seg)) {
+			NET_DBG("pkt %p merged into %p (%zu bytes)", pkt,
+				gro->pkt, len);
+
+			gro_merge(gro, pkt, &seg);
+
+			/* Nothing can follow a pushed or short segment */
+			if (psh || seg.len < gro->seg_len ||
+			    len + gro->seg_len > CONFIG_NET_TCP_GRO_MAX_SIZE) {
+				*flush = net_tcp_gro_flush(gro);
+			}
+
+			return NET_OK;
+		}
+
+		*flush = net_tcp_gro_flush(gro);
+	}
+
+	if (psh) {
+		return NET_CONTINUE;
+	}
+
+	gro->pkt = pkt;
+	gro->next_seq = seg.seq + seg.len;
+	gro->seg_len = seg.len;
+	gro->hdr_len = seg.hdr_len;
+
+	return NET_OK;
+}
@@ -0,0 +1,226 @@
+/** @file
+ * @brief TCP generic segmentation offload
+ *
+ * TCP builds data packets spanning several segments when the interface
+ * L2 can cut them, so that the per segment work of the TCP engine
+ * (queueing, timers, ACK processing) is done once per packet. This is
+ * the software cutting used for drivers without TSO.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <errno.h>
+
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/net_l2.h>
+#include <sys/byteorder.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "ipv6.h"
+#include "tcp_internal.h"
+
+#define SEG_ALLOC_TIMEOUT K_MSEC(100)
+
+size_t net_tcp_gso_len(struct net_tcp *tcp, size_t len, u16_t *gso_size)
+{
+	struct net_if *iface = net_context_get_iface(tcp->context);
+	u32_t mss = MIN(tcp->send_mss, net_tcp_get_recv_mss(tcp));
+	u32_t max_len;
+
+	*gso_size = 0U;
+
+	if (!iface || !mss || !net_if_l2(iface)->get_flags ||
+	    !(net_if_l2(iface)->get_flags(iface) & NET_L2_TCP_GSO)) {
+		return len;
+	}
+
+	/* Half the usable window keeps the ACK clock running while one
+	 * packet is out, see tcp_xmit_size_goal() in Linux.
+	 */
+	max_len = MIN(tcp->cwnd, tcp->send_wnd) / 2U;
+
+	if (net_context_get_family(tcp->context) == AF_INET6) {
+		max_len = MIN(max_len,
+			      CONFIG_NET_TCP_GSO_MAX_SIZE - NET_IPV6TCPH_LEN);
+	} else {
+		max_len = MIN(max_len,
+			      CONFIG_NET_TCP_GSO_MAX_SIZE - NET_IPV4TCPH_LEN);
+	}
+
+	max_len -= max_len % mss;
+
+	if (len <= mss || max_len <= mss) {
+		return len;
+	}
+
+	*gso_size = mss;
+
+	return MIN(len, max_len);
+}
+
+static void copy_metadata(struct net_pkt *seg, struct net_pkt *pkt)
+{
+	memcpy(&seg->lladdr_src, &pkt->lladdr_src, sizeof(seg->lladdr_src));
+	memcpy(&seg->lladdr_dst, &pkt->lladdr_dst, sizeof(seg->lladdr_dst));
+
+	net_pkt_set_family(seg, net_pkt_family(pkt));
+	net_pkt_set_ip_hdr_len(seg, net_pkt_ip_hdr_len(pkt));
+	net_pkt_set_vlan_tag(seg, net_pkt_vlan_tag(pkt));
+	net_pkt_set_priority(seg, net_pkt_priority(pkt));
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		net_pkt_set_ipv4_ttl(seg, net_pkt_ipv4_ttl(pkt));
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		net_pkt_set_ipv6_hop_limit(seg, net_pkt_ipv6_hop_limit(pkt));
+		net_pkt_set_ipv6_ext_len(seg, net_pkt_ipv6_ext_len(pkt));
+		net_pkt_set_ipv6_next_hdr(seg, net_pkt_ipv6_next_hdr(pkt));
+	}
+}
+
+/* Sequence number, flags and checksums of one segment */
+static int fixup_segment(struct net_pkt *seg, size_t ip_len, u32_t seq,
+			 bool last)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_tcp_hdr *tcp_hdr;
+
+	net_pkt_cursor_init(seg);
+	net_pkt_set_overwrite(seg, true);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(seg) == AF_INET) {
+		NET_IPV4_HDR(seg)->chksum = 0U;
+	}
+
+	if (net_pkt_skip(seg, ip_len)) {
+		return -ENOBUFS;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(seg, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	sys_put_be32(seq, tcp_hdr->seq);
+
+	if (!last) {
+		tcp_hdr->flags &= ~(NET_TCP_FIN | NET_TCP_PSH);
+	}
+
+	net_pkt_set_data(seg, &tcp_access);
+
+	net_pkt_cursor_init(seg);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(seg) == AF_INET) {
+		return net_ipv4_finalize(seg, IPPROTO_TCP);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(seg) == AF_INET6) {
+		return net_ipv6_finalize(seg, IPPROTO_TCP);
+	}
+
+	return -EINVAL;
+}
+
+int net_tcp_gso_segment(struct net_pkt *pkt, net_tcp_gso_cb_t cb,
+			void *user_data)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	u16_t mss = net_pkt_gso_size(pkt);
+	struct net_pkt_cursor payload;
+	struct net_tcp_hdr *tcp_hdr;
+	size_t ip_len, hdr_len;
+	size_t len, off = 0;
+	int total = 0;
+	u32_t seq;
+	int ret;
+
+	if (!mss) {
+		return -EINVAL;
+	}
+
+	ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ipv6_ext_len(pkt);
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, ip_len)) {
+		return -ENOBUFS;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	hdr_len = ip_len + NET_TCP_HDR_LEN(tcp_hdr);
+	seq = sys_get_be32(tcp_hdr->seq);
+
+	if (net_pkt_get_len(pkt) < hdr_len) {
+		return -EINVAL;
+	}
+
+	len = net_pkt_get_len(pkt) - hdr_len;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, hdr_len);
+	net_pkt_cursor_backup(pkt, &payload);
+
+	do {
+		size_t seg_len = MIN(len - off, mss);
+		struct net_pkt *seg;
+
+		seg = net_pkt_alloc_with_buffer(net_pkt_iface(pkt),
+						hdr_len + seg_len, AF_UNSPEC,
+						0, SEG_ALLOC_TIMEOUT);
+		if (!seg) {
+			ret = -ENOMEM;
+			goto out;
+		}
+
+		net_pkt_cursor_init(pkt);
+		ret = net_pkt_copy(seg, pkt, hdr_len);
+		if (!ret) {
+			net_pkt_cursor_restore(pkt, &payload);
+			ret = net_pkt_copy(seg, pkt, seg_len);
+			net_pkt_cursor_backup(pkt, &payload);
+		}
+
+		if (!ret) {
+			copy_metadata(seg, pkt);
+			ret = fixup_segment(seg, ip_len, seq + off,
+					    off + seg_len == len);
+		}
+
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			goto out;
+		}
+
+		NET_DBG("pkt %p segment %p seq %u len %zu", pkt, seg,
+			seq + (u32_t)off, seg_len);
+
+		ret = cb(seg, user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total += ret;
+		off += seg_len;
+	} while (off < len);
+
+	ret = total;
+out:
+	net_pkt_cursor_init(pkt);
+
+	return ret;
+}
@@ -29,7 +29,11 @@ extern "C" {
 /** Is this TCP context/socket used or not */
 #define NET_TCP_IN_USE BIT(0)
 
-/* BIT(1), BIT(2) are unused and available */
+/** Peer agreed to use selective acknowledgments (RFC 2018) */
+#define NET_TCP_SACK_OK BIT(1)
+
+/** Peer agreed to use window scaling (RFC 7323) */
+#define NET_TCP_WSCALE_OK BIT(2)
 
 /** Is the socket shutdown for read/write */
 #define NET_TCP_IS_SHUTDOWN BIT(3)
@@ -37,8 +41,7 @@ extern "C" {
 /** A retransmitted packet has been sent and not yet ack'd */
 #define NET_TCP_RETRYING BIT(4)
 
-/** MSS option has been set already */
-#define NET_TCP_RECV_MSS_SET BIT(5)
+/* BIT(5) is unused and available */
 
 /*
  * TCP connection states
@@ -83,23 +86,50 @@ enum net_tcp_state {
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
 
-#define NET_TCP_MAX_OPT_SIZE  8
+/* MSS, window scale and SACK-permitted, each padded to 4 bytes */
+#define NET_TCP_MAX_OPT_SIZE  12
 
 /* TCP Option codes */
 #define NET_TCP_END_OPT          0
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+
+/* Largest window scale shift allowed by RFC 7323 */
+#define NET_TCP_MAX_WSCALE 14
+
+/* A SACK option carries at most 4 blocks */
+#define NET_TCP_SACK_MAX_BLOCKS 4
+
+/* Duplicate ACKs that trigger a fast retransmit */
+#define NET_TCP_DUPACK_THRESH 3
+
+/** Range of sequence space, [left, right) */
+struct net_tcp_sack_block {
+	u32_t left;
+	u32_t right;
+};
 
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+	/** Window scale shift, valid if wscale_ok is set */
+	u8_t wscale;
+	/** Number of valid entries in sack */
+	u8_t sack_count;
+	bool wscale_ok;
+	bool sack_ok;
+	struct net_tcp_sack_block sack[NET_TCP_SACK_MAX_BLOCKS];
 };
 
 /* Max received bytes to buffer internally */
@@ -161,6 +191,50 @@ struct net_tcp {
 	 */
 	u16_t send_mss;
 
+	/** Oldest unacknowledged sequence number */
+	u32_t snd_una;
+
+	/** End of the highest segment sent so far */
+	u32_t snd_nxt;
+
+	/** Send window offered by the peer, already scaled */
+	u32_t send_wnd;
+
+	/** Congestion window, in bytes */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** snd_nxt when the current loss recovery started */
+	u32_t recover;
+
+	/** Everything below this has been retransmitted in this recovery */
+	u32_t rexmit_nxt;
+
+	/** Smoothed RTT in 1/8 ms, zero until the first sample */
+	u32_t srtt;
+
+	/** RTT variation in 1/4 ms */
+	u32_t rttvar;
+
+	/** Retransmission timeout in ms, before backoff */
+	u32_t rto;
+
+	/** Sequence number whose ACK ends the RTT measurement */
+	u32_t rtt_seq;
+
+	/** Uptime in ms when the timed segment was sent */
+	u32_t rtt_start;
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/** Sequence ranges above snd_una the peer has reported as received */
+	struct net_tcp_sack_block sack[NET_TCP_SACK_MAX_BLOCKS];
+
+	/** Number of valid entries in sack */
+	u8_t sack_count;
+#endif
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
@@ -171,10 +245,62 @@ struct net_tcp {
 	u32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	u32_t fin_rcvd : 1;
+	/** Window scale shift for windows the peer advertises */
+	u32_t snd_wscale : 4;
+	/** A segment is being timed for an RTT sample */
+	u32_t rtt_active : 1;
+	/** Loss recovery in progress, see enum net_tcp_recovery */
+	u32_t recovery : 2;
+	/** Duplicate ACKs seen in a row */
+	u32_t dupacks : 2;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 13;
+	u32_t _padding : 4;
+};
+
+/** Loss recovery states */
+enum net_tcp_recovery {
+	NET_TCP_RECOVERY_NONE = 0,
+	/** Fast retransmit/fast recovery, RFC 6582 */
+	NET_TCP_RECOVERY_FAST,
+	/** Retransmission timer expired */
+	NET_TCP_RECOVERY_RTO,
+};
+
+/**
+ * Congestion control algorithm.  The engine tracks what is in flight,
+ * detects loss and runs the recovery; an algorithm only decides how
+ * cwnd grows and what ssthresh becomes after a loss.
+ */
+struct net_tcp_cc {
+	/** Algorithm name, for debugging */
+	const char *name;
+	/** Set the initial cwnd and ssthresh once the send MSS is known */
+	void (*init)(struct net_tcp *tcp);
+	/** New data was acknowledged outside of fast recovery */
+	void (*ack)(struct net_tcp *tcp, u32_t acked);
+	/** Loss was detected, return the new ssthresh */
+	u32_t (*ssthresh)(struct net_tcp *tcp);
 };
 
+#if defined(CONFIG_NET_TCP_CC_NEWRENO)
+extern const struct net_tcp_cc net_tcp_cc_newreno;
+#endif
+
+/* Largest window a peer can offer us */
+#define NET_TCP_MAX_SEND_WIN ((u32_t)UINT16_MAX << NET_TCP_MAX_WSCALE)
+
+/**
+ * @brief Bytes sent but not yet acknowledged
+ *
+ * @param tcp TCP context
+ *
+ * @return Flight size
+ */
+static inline u32_t net_tcp_flight_size(const struct net_tcp *tcp)
+{
+	return tcp->snd_nxt - tcp->snd_una;
+}
+
 typedef void (*net_tcp_cb_t)(struct net_tcp *tcp, void *user_data);
 
 static inline bool net_tcp_is_used(struct net_tcp *tcp)
@@ -559,8 +685,8 @@ static inline int net_tcp_finalize(struct net_pkt *pkt)
 /**
  * @brief Parse TCP options from network packet.
  *
- * Parse TCP options, returning MSS value (as that the only one we
- * handle so far).
+ * Parse TCP options, returning the MSS, window scale, SACK-permitted
+ * and SACK values.  Other options are skipped.
  *
  * @param pkt Network packet
  * @param opt_totlen Total length of options to parse
@@ -791,6 +917,138 @@ void net_tcp_init(void);
 #define net_tcp_init(...)
 #endif
 
+/**
+ * @brief Size the next data packet for segmentation offload
+ *
+ * When the interface L2 can segment, a packet may carry up to half of
+ * the usable send window, in whole segments.
+ *
+ * @param tcp TCP context
+ * @param len Length of the user data to send
+ * @param gso_size Set to the segment size, or to 0 if the packet is
+ * not to be segmented
+ *
+ * @return Payload length to allocate the packet for
+ */
+#if defined(CONFIG_NET_TCP_GSO)
+size_t net_tcp_gso_len(struct net_tcp *tcp, size_t len, u16_t *gso_size);
+#else
+static inline size_t net_tcp_gso_len(struct net_tcp *tcp, size_t len,
+				     u16_t *gso_size)
+{
+	ARG_UNUSED(tcp);
+
+	*gso_size = 0U;
+
+	return len;
+}
+#endif
+
+/**
+ * @typedef net_tcp_gso_cb_t
+ * @brief Callback receiving the segments of a GSO packet
+ *
+ * @param seg Segment, owned by the callback from here on
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return Length sent on success, <0 on error
+ */
+typedef int (*net_tcp_gso_cb_t)(struct net_pkt *seg, void *user_data);
+
+/**
+ * @brief Cut a TCP packet into net_pkt_gso_size() sized segments
+ *
+ * Each segment gets its own copy of the IP and TCP headers, with the
+ * sequence number, lengths and checksums fixed up. FIN and PSH are
+ * only kept on the last one.
+ *
+ * @param pkt TCP packet with net_pkt_gso_size() set, left untouched
+ * @param cb Called for each segment in order
+ * @param user_data User data passed to cb
+ *
+ * @return Sum of what cb returned on success, <0 on error
+ */
+#if defined(CONFIG_NET_TCP_GSO)
+int net_tcp_gso_segment(struct net_pkt *pkt, net_tcp_gso_cb_t cb,
+			void *user_data);
+#else
+static inline int net_tcp_gso_segment(struct net_pkt *pkt,
+				      net_tcp_gso_cb_t cb, void *user_data)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
+/** Receive coalescing state of one RX thread */
+struct net_tcp_gro {
+	/** Packet the following segments are appended to */
+	struct net_pkt *pkt;
+
+	/** Sequence number the next segment has to start at */
+	u32_t next_seq;
+
+	/** Payload length of the first segment */
+	u16_t seg_len;
+
+	/** IP and TCP header length */
+	u8_t hdr_len;
+};
+
+/**
+ * @brief Offer a received packet for coalescing
+ *
+ * Called before IP input, with the cursor at the IP header. In order
+ * TCP segments of the connection being coalesced are appended to it,
+ * their checksums verified.
+ *
+ * @param gro Coalescing state
+ * @param pkt Received packet
+ * @param flush Set to a coalesced packet that has to go to IP input
+ * before pkt does, or to NULL
+ *
+ * @return NET_OK if pkt was taken, NET_CONTINUE if it has to go to IP
+ * input as is
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+enum net_verdict net_tcp_gro_receive(struct net_tcp_gro *gro,
+				     struct net_pkt *pkt,
+				     struct net_pkt **flush);
+#else
+static inline enum net_verdict net_tcp_gro_receive(struct net_tcp_gro *gro,
+						   struct net_pkt *pkt,
+						   struct net_pkt **flush)
+{
+	ARG_UNUSED(gro);
+	ARG_UNUSED(pkt);
+
+	*flush = NULL;
+
+	return NET_CONTINUE;
+}
+#endif
+
+/**
+ * @brief End coalescing
+ *
+ * @param gro Coalescing state
+ *
+ * @return Packet that has to go to IP input now, or NULL
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+struct net_pkt *net_tcp_gro_flush(struct net_tcp_gro *gro);
+#else
+static inline struct net_pkt *net_tcp_gro_flush(struct net_tcp_gro *gro)
+{
+	ARG_UNUSED(gro);
+
+	return NULL;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
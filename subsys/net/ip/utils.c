@@ -482,37 +482,105 @@ Z_SYSCALL_HANDLER(net_addr_pton, family, src, dst)
 }
 #endif /* CONFIG_USERSPACE */
 
-static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+static inline u16_t chksum_add(u16_t sum, u16_t val)
 {
-	const u8_t *end;
-	u16_t tmp;
+	sum += val;
+	if (sum < val) {
+		sum++;
+	}
 
-	end = data + len - 1;
+	return sum;
+}
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+static inline u16_t chksum_swap(u16_t sum)
+{
+	return (sum << 8) | (sum >> 8);
+}
+
+/* One's complement sum of the buffer, taken as 16 bit words in memory
+ * byte order (that is, the sum is itself in network byte order).
+ *
+ * The words are summed 32 bits at a time into a 64 bit accumulator, so
+ * carries are only folded back in at the end.  A buffer starting at an
+ * odd address is summed from the next byte and the result is
+ * byte-swapped, which is equivalent in one's complement arithmetic.
+ */
+static u16_t chksum_block(const u8_t *data, size_t len)
+{
+	const u32_t *p32;
+	u64_t acc = 0U;
+	bool odd = false;
 
+	if (len == 0) {
+		return 0U;
+	}
+
+	if ((uintptr_t)data & 1) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		acc = *data;
+#else
+		acc = (u16_t)*data << 8;
+#endif
+		odd = true;
+		data++;
+		len--;
+	}
+
+	if (len >= 2 && ((uintptr_t)data & 2)) {
+		acc += *(const u16_t *)data;
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	p32 = (const u32_t *)data;
+
+	while (len >= 16) {
+		acc += p32[0];
+		acc += p32[1];
+		acc += p32[2];
+		acc += p32[3];
+		p32 += 4;
+		len -= 16;
 	}
 
-	return sum;
+	while (len >= 4) {
+		acc += *p32++;
+		len -= 4;
+	}
+
+	data = (const u8_t *)p32;
+
+	if (len >= 2) {
+		acc += *(const u16_t *)data;
+		data += 2;
+		len -= 2;
+	}
+
+	if (len) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		acc += (u16_t)*data << 8;
+#else
+		acc += *data;
+#endif
+	}
+
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	return odd ? chksum_swap((u16_t)acc) : (u16_t)acc;
+}
+
+static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	return chksum_add(sum, ntohs(chksum_block(data, len)));
 }
 
 static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
+	bool odd = false;
 	size_t len;
 
 	if (!cur->buf || !cur->pos) {
@@ -522,7 +590,13 @@ static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 	len = cur->buf->len - (cur->pos - cur->buf->data);
 
 	while (cur->buf) {
-		sum = calc_chksum(sum, cur->pos, len);
+		u16_t block = ntohs(chksum_block(cur->pos, len));
+
+		/* After an odd number of bytes, this fragment's words are
+		 * offset by one byte from the packet's
+		 */
+		sum = chksum_add(sum, odd ? chksum_swap(block) : block);
+		odd ^= (len & 1);
 
 		cur->buf = cur->buf->frags;
 		if (!cur->buf || !cur->buf->len) {
@@ -530,18 +604,7 @@ static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 		}
 
 		cur->pos = cur->buf->data;
-
-		if (len % 2) {
-			sum += *cur->pos;
-			if (sum < *cur->pos) {
-				sum++;
-			}
-
-			cur->pos++;
-			len = cur->buf->len - 1;
-		} else {
-			len = cur->buf->len;
-		}
+		len = cur->buf->len;
 	}
 
 	return sum;
@@ -26,6 +26,7 @@ LOG_MODULE_REGISTER(net_ethernet, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
 #include "net_private.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
+#include "tcp_internal.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 
@@ -545,6 +546,143 @@ static void ethernet_remove_l2_header(struct net_pkt *pkt)
 	net_pkt_frag_unref(buf);
 }
 
+/* Adds VLAN tag and Ethernet header in front of an IP packet */
+static int ethernet_prepare_frame(struct ethernet_context *ctx,
+				  struct net_if *iface, struct net_pkt *pkt,
+				  u16_t ptype)
+{
+	if (IS_ENABLED(CONFIG_NET_VLAN) &&
+	    net_eth_is_vlan_enabled(ctx, iface)) {
+		if (set_vlan_tag(ctx, iface, pkt) == NET_DROP) {
+			return -EINVAL;
+		}
+
+		set_vlan_priority(ctx, pkt);
+	}
+
+	/* Then set the ethernet header.
+	 */
+	if (!ethernet_fill_header(ctx, pkt, ptype)) {
+		return -ENOMEM;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_TCP_GSO)
+struct ethernet_tx_burst {
+	struct ethernet_context *ctx;
+	struct net_if *iface;
+	u16_t ptype;
+	size_t count;
+	struct net_pkt *pkts[CONFIG_NET_L2_ETHERNET_TX_BURST];
+};
+
+/* Gives the pending frames to the driver, in one call if it can take
+ * them so, and releases them. Returns the number of bytes sent, or <0 if
+ * any of the frames could not be sent.
+ */
+static int ethernet_tx_burst_flush(struct ethernet_tx_burst *burst)
+{
+	struct device *dev = net_if_get_device(burst->iface);
+	const struct ethernet_api *api = dev->driver_api;
+	size_t sent = 0;
+	int total = 0;
+	int ret = 0;
+	size_t i;
+
+	if (!burst->count) {
+		return 0;
+	}
+
+	if (api->send_burst) {
+		ret = api->send_burst(dev, burst->pkts, burst->count);
+		if (ret > 0) {
+			sent = MIN((size_t)ret, burst->count);
+		}
+	} else {
+		while (sent < burst->count) {
+			ret = api->send(dev, burst->pkts[sent]);
+			if (ret != 0) {
+				break;
+			}
+
+			sent++;
+		}
+	}
+
+	for (i = 0; i < burst->count; i++) {
+		struct net_pkt *pkt = burst->pkts[i];
+
+		if (i < sent) {
+			ethernet_update_tx_stats(burst->iface, pkt);
+			total += net_pkt_get_len(pkt);
+		} else {
+			eth_stats_update_errors_tx(burst->iface);
+		}
+
+		ethernet_remove_l2_header(pkt);
+		net_pkt_unref(pkt);
+	}
+
+	burst->count = 0;
+
+	if (sent < i) {
+		return ret < 0 ? ret : -EIO;
+	}
+
+	return total;
+}
+
+static int ethernet_send_gso_seg(struct net_pkt *seg, void *user_data)
+{
+	struct ethernet_tx_burst *burst = user_data;
+	int ret;
+
+	ret = ethernet_prepare_frame(burst->ctx, burst->iface, seg,
+				     burst->ptype);
+	if (ret < 0) {
+		net_pkt_unref(seg);
+		return ret;
+	}
+
+	burst->pkts[burst->count++] = seg;
+
+	if (burst->count < ARRAY_SIZE(burst->pkts)) {
+		return 0;
+	}
+
+	return ethernet_tx_burst_flush(burst);
+}
+
+/* The segments share the link addresses resolved for the large packet,
+ * so they only need their L2 header before going out in bursts.
+ */
+static int ethernet_send_gso(struct ethernet_context *ctx,
+			     struct net_if *iface, struct net_pkt *pkt,
+			     u16_t ptype)
+{
+	struct ethernet_tx_burst burst = {
+		.ctx = ctx,
+		.iface = iface,
+		.ptype = ptype,
+	};
+	int flushed;
+	int ret;
+
+	ret = net_tcp_gso_segment(pkt, ethernet_send_gso_seg, &burst);
+
+	flushed = ethernet_tx_burst_flush(&burst);
+	if (ret >= 0) {
+		ret = flushed < 0 ? flushed : ret + flushed;
+	}
+
+	return ret;
+}
+#endif
+
 static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 {
 	const struct ethernet_api *api = net_if_get_device(iface)->driver_api;
@@ -608,25 +746,27 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 		net_pkt_lladdr_dst(pkt)->len = sizeof(struct net_eth_addr);
 	}
 
-	if (IS_ENABLED(CONFIG_NET_VLAN) &&
-	    net_eth_is_vlan_enabled(ctx, iface)) {
-		if (set_vlan_tag(ctx, iface, pkt) == NET_DROP) {
-			ret = -EINVAL;
+#if defined(CONFIG_NET_TCP_GSO)
+	/* Link address is resolved, cut TCP into MTU sized frames unless
+	 * the device does it.
+	 */
+	if (net_pkt_gso_size(pkt) &&
+	    !(net_eth_get_hw_capabilities(iface) & ETHERNET_HW_TX_TSO)) {
+		ret = ethernet_send_gso(ctx, iface, pkt, ptype);
+		if (ret < 0) {
 			goto error;
 		}
 
-		set_vlan_priority(ctx, pkt);
+		net_pkt_unref(pkt);
+		return ret;
 	}
+#endif
 
-	/* Then set the ethernet header.
-	 */
-	if (!ethernet_fill_header(ctx, pkt, ptype)) {
-		ret = -ENOMEM;
+	ret = ethernet_prepare_frame(ctx, iface, pkt, ptype);
+	if (ret < 0) {
 		goto error;
 	}
 
-	net_pkt_cursor_init(pkt);
-
 send:
 	ret = api->send(net_if_get_device(iface), pkt);
 	if (ret != 0) {
@@ -1059,6 +1199,10 @@ void ethernet_init(struct net_if *iface)
 
 	ctx->ethernet_l2_flags = NET_L2_MULTICAST;
 
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO)) {
+		ctx->ethernet_l2_flags |= NET_L2_TCP_GSO;
+	}
+
 	if (net_eth_get_hw_capabilities(iface) & ETHERNET_PROMISC_MODE) {
 		ctx->ethernet_l2_flags |= NET_L2_PROMISC_MODE;
 	}
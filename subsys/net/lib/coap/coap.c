@@ -139,6 +139,10 @@ int coap_packet_init(struct coap_packet *cpkt, u8_t *data,
 	/* Header length : (version + type + tkl) + code + id + [token] */
 	cpkt->hdr_len = 1 + 1 + 2 + tokenlen;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_indexed = true;
+#endif
+
 	return 0;
 }
 
@@ -229,6 +233,65 @@ static int encode_option(struct coap_packet *cpkt, u16_t code,
 	return  (1 + delta_size + len_size + len);
 }
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/* Options are added in ascending order, so the index stays sorted */
+static void option_index_add(struct coap_packet *cpkt, u16_t code,
+			     u16_t offset, u16_t len)
+{
+	struct coap_option_index *entry;
+
+	if (cpkt->opt_count >= ARRAY_SIZE(cpkt->opt_index)) {
+		/* Lookups go back to parsing the options */
+		cpkt->opt_indexed = false;
+		return;
+	}
+
+	entry = &cpkt->opt_index[cpkt->opt_count++];
+	entry->code = code;
+	entry->offset = offset;
+	entry->len = len;
+}
+
+static int option_index_find(const struct coap_packet *cpkt, u16_t code,
+			     struct coap_option *options, u16_t veclen)
+{
+	const struct coap_option_index *entry;
+	u8_t lo = 0U, hi = cpkt->opt_count;
+	u16_t num = 0U;
+
+	/* First option with a number not below code */
+	while (lo < hi) {
+		u8_t mid = (lo + hi) / 2U;
+
+		if (cpkt->opt_index[mid].code < code) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	for (entry = &cpkt->opt_index[lo];
+	     entry < &cpkt->opt_index[cpkt->opt_count] &&
+	     entry->code == code && num < veclen; entry++) {
+		if (entry->len > sizeof(options[num].value)) {
+			NET_ERR("%u is > sizeof(coap_option->value)(%zu)!",
+				entry->len, sizeof(options[num].value));
+			return -EINVAL;
+		}
+
+		options[num].delta = code;
+		options[num].len = entry->len;
+		memcpy(options[num].value, cpkt->data + entry->offset,
+		       entry->len);
+		num++;
+	}
+
+	return num;
+}
+#else
+#define option_index_add(...)
+#endif /* CONFIG_COAP_OPTION_INDEX */
+
 /* TODO Add support for inserting options in proper place
  * and modify other option's delta accordingly.
  */
@@ -263,6 +326,8 @@ int coap_packet_append_option(struct coap_packet *cpkt, u16_t code,
 	cpkt->opt_len += r;
 	cpkt->delta += code;
 
+	option_index_add(cpkt, cpkt->delta, cpkt->offset - len, len);
+
 	return 0;
 }
 
@@ -424,7 +489,7 @@ static int decode_delta(u8_t *data, u16_t offset, u16_t *pos, u16_t max_len,
 
 static int parse_option(u8_t *data, u16_t offset, u16_t *pos,
 			u16_t max_len, u16_t *opt_delta, u16_t *opt_len,
-			struct coap_option *option)
+			u16_t *value_len, struct coap_option *option)
 {
 	u16_t hdr_len;
 	u16_t delta;
@@ -480,6 +545,7 @@ static int parse_option(u8_t *data, u16_t offset, u16_t *pos,
 
 	*opt_delta += delta;
 	*opt_len += len;
+	*value_len = len;
 
 	if (r == 0) {
 		if (len == 0U) {
@@ -524,6 +590,7 @@ static int parse_option(u8_t *data, u16_t offset, u16_t *pos,
 int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 		      struct coap_option *options, u8_t opt_num)
 {
+	u16_t value_len;
 	u16_t opt_len;
 	u16_t offset;
 	u16_t delta;
@@ -549,6 +616,10 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 	cpkt->opt_len = 0U;
 	cpkt->hdr_len = 0U;
 	cpkt->delta = 0U;
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_count = 0U;
+	cpkt->opt_indexed = false;
+#endif
 
 	/* Token lengths 9-15 are reserved. */
 	tkl = cpkt->data[0] & 0x0f;
@@ -561,6 +632,10 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 		return -EINVAL;
 	}
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_indexed = true;
+#endif
+
 	cpkt->offset = cpkt->hdr_len;
 	if (cpkt->hdr_len == len) {
 		return 0;
@@ -573,13 +648,24 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 
 	while (1) {
 		struct coap_option *option;
+		bool marker = cpkt->data[offset] == COAP_MARKER;
 
 		option = num < opt_num ? &options[num++] : NULL;
 		ret = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
-				   &delta, &opt_len, option);
+				   &delta, &opt_len, &value_len, option);
 		if (ret < 0) {
+#if defined(CONFIG_COAP_OPTION_INDEX)
+			cpkt->opt_indexed = false;
+#endif
 			return ret;
-		} else if (ret == 0) {
+		}
+
+		if (!marker) {
+			option_index_add(cpkt, delta, offset - value_len,
+					 value_len);
+		}
+
+		if (ret == 0) {
 			break;
 		}
 	}
@@ -594,12 +680,19 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 		      struct coap_option *options, u16_t veclen)
 {
+	u16_t value_len;
 	u16_t opt_len;
 	u16_t offset;
 	u16_t delta;
 	u8_t num;
 	int r;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->opt_indexed) {
+		return option_index_find(cpkt, code, options, veclen);
+	}
+#endif
+
 	offset = cpkt->hdr_len;
 	opt_len = 0U;
 	delta = 0U;
@@ -607,7 +700,7 @@ int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 
 	while (delta <= code && num < veclen) {
 		r = parse_option(cpkt->data, offset, &offset,
-				 cpkt->max_len, &delta, &opt_len,
+				 cpkt->max_len, &delta, &opt_len, &value_len,
 				 &options[num]);
 		if (r < 0) {
 			return -EINVAL;
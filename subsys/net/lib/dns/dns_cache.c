@@ -0,0 +1,175 @@
+/** @file
+ * @brief DNS answer cache
+ *
+ * The answers of the resolver are kept for their TTL, so that names
+ * looked up again and again, like the server of a client that
+ * reconnects, are resolved without a round trip.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <kernel.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/slist.h>
+
+#include <net/dns_resolve.h>
+#include "dns_cache.h"
+
+struct dns_cache_entry {
+	/** Entries are in least recently used order, unused ones last */
+	sys_snode_t node;
+
+	/** When the answer expires, in ms of uptime */
+	s64_t expires;
+
+	/** Name that was queried, empty if the entry is unused */
+	char query[CONFIG_DNS_RESOLVER_CACHE_NAME_LEN + 1];
+
+	/** Addresses of the answer */
+	u8_t addrs[CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS][DNS_CACHE_ADDR_LEN];
+
+	/** Number of addresses, 0 for a name that does not exist */
+	u8_t count;
+
+	/** Type of the query */
+	u8_t type;
+};
+
+static struct dns_cache_entry entries[CONFIG_DNS_RESOLVER_CACHE_SIZE];
+static sys_slist_t lru;
+static K_MUTEX_DEFINE(cache_lock);
+
+static void cache_init(void)
+{
+	int i;
+
+	if (!sys_slist_is_empty(&lru)) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		sys_slist_append(&lru, &entries[i].node);
+	}
+}
+
+static void entry_drop(struct dns_cache_entry *entry)
+{
+	entry->query[0] = '\0';
+
+	sys_slist_find_and_remove(&lru, &entry->node);
+	sys_slist_append(&lru, &entry->node);
+}
+
+/* Names are compared ignoring case, see RFC 4343 */
+static struct dns_cache_entry *entry_find(const char *query,
+					  enum dns_query_type type)
+{
+	struct dns_cache_entry *entry, *next;
+	s64_t now = k_uptime_get();
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&lru, entry, next, node) {
+		if (!entry->query[0]) {
+			break;
+		}
+
+		if (entry->expires <= now) {
+			entry_drop(entry);
+			continue;
+		}
+
+		if (entry->type == type &&
+		    !strncasecmp(entry->query, query, sizeof(entry->query))) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+int dns_cache_find(const char *query, enum dns_query_type type,
+		   u8_t addrs[][DNS_CACHE_ADDR_LEN], int count)
+{
+	struct dns_cache_entry *entry;
+	int ret = -ENOENT;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	cache_init();
+
+	entry = entry_find(query, type);
+	if (entry) {
+		ret = MIN(count, entry->count);
+		memcpy(addrs, entry->addrs, ret * DNS_CACHE_ADDR_LEN);
+
+		sys_slist_find_and_remove(&lru, &entry->node);
+		sys_slist_prepend(&lru, &entry->node);
+
+		NET_DBG("Cache hit for %s, %d addresses",
+			log_strdup(query), ret);
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return ret;
+}
+
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   u8_t addrs[][DNS_CACHE_ADDR_LEN], int count, u32_t ttl)
+{
+	struct dns_cache_entry *entry;
+
+	/* A TTL with the top bit set is to be read as 0, RFC 2181 ch 8 */
+	if (!ttl || (ttl & BIT(31)) ||
+	    strlen(query) > CONFIG_DNS_RESOLVER_CACHE_NAME_LEN) {
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	cache_init();
+
+	entry = entry_find(query, type);
+	if (!entry) {
+		entry = CONTAINER_OF(sys_slist_peek_tail(&lru),
+				     struct dns_cache_entry, node);
+		strcpy(entry->query, query);
+		entry->type = type;
+	}
+
+	entry->count = MIN(count, CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS);
+	if (entry->count) {
+		memcpy(entry->addrs, addrs, entry->count * DNS_CACHE_ADDR_LEN);
+	}
+
+	entry->expires = k_uptime_get() + ttl * (s64_t)MSEC_PER_SEC;
+
+	sys_slist_find_and_remove(&lru, &entry->node);
+	sys_slist_prepend(&lru, &entry->node);
+
+	NET_DBG("Cached %s, %d addresses for %u s", log_strdup(query),
+		entry->count, ttl);
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void dns_resolve_cache_flush(void)
+{
+	struct dns_cache_entry *entry, *next;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&lru, entry, next, node) {
+		entry->query[0] = '\0';
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _DNS_CACHE_H_
+#define _DNS_CACHE_H_
+
+#include <zephyr/types.h>
+#include <net/dns_resolve.h>
+
+/* Room for an IPv6 address, also used for IPv4 ones */
+#define DNS_CACHE_ADDR_LEN	16
+
+/**
+ * @brief Look up the answer to a query in the cache.
+ *
+ * @param query Name that was queried.
+ * @param type Type of the query.
+ * @param addrs Where the addresses are copied.
+ * @param count How many addresses fit in addrs.
+ *
+ * @return Number of addresses copied, 0 if the name is known not to
+ * exist, -ENOENT if the answer is not in the cache or has expired.
+ */
+int dns_cache_find(const char *query, enum dns_query_type type,
+		   u8_t addrs[][DNS_CACHE_ADDR_LEN], int count);
+
+/**
+ * @brief Store the answer to a query in the cache.
+ *
+ * @details An answer that is already cached for the query is replaced,
+ * otherwise the least recently used entry is. Answers with a TTL of 0
+ * and names too long for an entry are not stored.
+ *
+ * @param query Name that was queried.
+ * @param type Type of the query.
+ * @param addrs Addresses of the answer, DNS_IPV4_LEN or DNS_IPV6_LEN
+ * bytes used of each depending on type.
+ * @param count Number of addresses, 0 for a name that does not exist.
+ * @param ttl Time to live of the answer in seconds.
+ */
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   u8_t addrs[][DNS_CACHE_ADDR_LEN], int count, u32_t ttl);
+
+#endif /* _DNS_CACHE_H_ */
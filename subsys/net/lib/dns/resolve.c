@@ -23,6 +23,7 @@ LOG_MODULE_REGISTER(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #include <net/net_mgmt.h>
 #include <net/dns_resolve.h>
 #include "dns_pack.h"
+#include "dns_cache.h"
 
 #define DNS_SERVER_COUNT CONFIG_DNS_RESOLVER_MAX_SERVERS
 #define SERVER_COUNT     (DNS_SERVER_COUNT + DNS_MAX_MCAST_SERVERS)
@@ -343,6 +344,9 @@ static int dns_read(struct dns_resolve_context *ctx,
 	/* Helper struct to track the dns msg received from the server */
 	struct dns_msg_t dns_msg;
 	u32_t ttl; /* RR ttl, so far it is not passed to caller */
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	u8_t cached[CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS][DNS_CACHE_ADDR_LEN];
+#endif
 	u8_t *src, *addr;
 	int address_size;
 	/* index that points to the current answer being analyzed */
@@ -438,6 +442,11 @@ static int dns_read(struct dns_resolve_context *ctx,
 			goto quit;
 		}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		ctx->queries[query_idx].ttl = MIN(ctx->queries[query_idx].ttl,
+						  ttl);
+#endif
+
 		switch (dns_msg.response_type) {
 		case DNS_RESPONSE_IP:
 			if (dns_msg.response_length < address_size) {
@@ -450,6 +459,12 @@ static int dns_read(struct dns_resolve_context *ctx,
 
 			memcpy(addr, src, address_size);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			if (items < CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS) {
+				memcpy(cached[items], src, address_size);
+			}
+#endif
+
 			ctx->queries[query_idx].cb(DNS_EAI_INPROGRESS, &info,
 					ctx->queries[query_idx].user_data);
 			items++;
@@ -499,6 +514,22 @@ static int dns_read(struct dns_resolve_context *ctx,
 		ret = DNS_EAI_ALLDONE;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* An empty name was too long to be cached */
+	if (ctx->queries[query_idx].name[0] == '\0') {
+		NET_DBG("Not caching answer to query %u", query_idx);
+	} else if (items) {
+		dns_cache_add(ctx->queries[query_idx].name,
+			      ctx->queries[query_idx].query_type,
+			      cached, items, ctx->queries[query_idx].ttl);
+	} else if (dns_header_rcode(dns_msg.msg) == DNS_HEADER_NAMEERROR) {
+		dns_cache_add(ctx->queries[query_idx].name,
+			      ctx->queries[query_idx].query_type, NULL, 0,
+			      MIN(ctx->queries[query_idx].ttl,
+				  CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL));
+	}
+#endif
+
 	if (k_delayed_work_remaining_get(&ctx->queries[query_idx].timer) > 0) {
 		k_delayed_work_cancel(&ctx->queries[query_idx].timer);
 	}
@@ -712,6 +743,48 @@ int dns_resolve_cancel(struct dns_resolve_context *ctx, u16_t dns_id)
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Answer the query from the cache, as a server would have */
+static int dns_resolve_cached(const char *query,
+			      enum dns_query_type type,
+			      dns_resolve_cb_t cb,
+			      void *user_data)
+{
+	u8_t cached[CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS][DNS_CACHE_ADDR_LEN];
+	struct dns_addrinfo info = { 0 };
+	int count, i;
+
+	count = dns_cache_find(query, type, cached, ARRAY_SIZE(cached));
+	if (count < 0) {
+		return count;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (type == DNS_QUERY_TYPE_A) {
+			memcpy(&net_sin(&info.ai_addr)->sin_addr, cached[i],
+			       DNS_IPV4_LEN);
+			info.ai_family = AF_INET;
+			info.ai_addr.sa_family = AF_INET;
+			info.ai_addrlen = sizeof(struct sockaddr_in);
+		} else {
+#if defined(CONFIG_NET_IPV6)
+			memcpy(&net_sin6(&info.ai_addr)->sin6_addr, cached[i],
+			       DNS_IPV6_LEN);
+			info.ai_family = AF_INET6;
+			info.ai_addr.sa_family = AF_INET6;
+			info.ai_addrlen = sizeof(struct sockaddr_in6);
+#endif
+		}
+
+		cb(DNS_EAI_INPROGRESS, &info, user_data);
+	}
+
+	cb(count ? DNS_EAI_ALLDONE : DNS_EAI_NODATA, NULL, user_data);
+
+	return 0;
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 static void query_timeout(struct k_work *work)
 {
 	struct dns_pending_query *pending_query =
@@ -782,6 +855,16 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 		return 0;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (!dns_resolve_cached(query, type, cb, user_data)) {
+		if (dns_id) {
+			*dns_id = 0U;
+		}
+
+		return 0;
+	}
+#endif
+
 try_resolve:
 	i = get_cb_slot(ctx);
 	if (i < 0) {
@@ -794,6 +877,15 @@ try_resolve:
 	ctx->queries[i].query_type = type;
 	ctx->queries[i].user_data = user_data;
 	ctx->queries[i].ctx = ctx;
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ctx->queries[i].ttl = UINT32_MAX;
+
+	if (strlen(query) < sizeof(ctx->queries[i].name)) {
+		strcpy(ctx->queries[i].name, query);
+	} else {
+		ctx->queries[i].name[0] = '\0';
+	}
+#endif
 
 	k_delayed_work_init(&ctx->queries[i].timer, query_timeout);
 
@@ -948,6 +1040,9 @@ int dns_resolve_close(struct dns_resolve_context *ctx)
 
 	ctx->is_used = false;
 
+	/* The cached answers may have come from these servers */
+	dns_resolve_cache_flush();
+
 	return 0;
 }
 
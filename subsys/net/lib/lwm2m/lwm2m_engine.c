@@ -131,6 +131,26 @@ static sys_slist_t engine_obj_inst_list;
 static sys_slist_t engine_observer_list;
 static sys_slist_t engine_service_list;
 
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+#define OBJ_INDEX_BUCKETS	CONFIG_LWM2M_ENGINE_OBJ_INDEX_BUCKETS
+
+/* objects and object instances hashed by their IDs */
+static sys_slist_t engine_obj_index[OBJ_INDEX_BUCKETS];
+static sys_slist_t engine_obj_inst_index[OBJ_INDEX_BUCKETS];
+
+static inline sys_slist_t *obj_index_bucket(u16_t obj_id)
+{
+	return &engine_obj_index[obj_id % OBJ_INDEX_BUCKETS];
+}
+
+static inline sys_slist_t *obj_inst_index_bucket(u16_t obj_id,
+						 u16_t obj_inst_id)
+{
+	return &engine_obj_inst_index[(obj_id * 31U + obj_inst_id) %
+				      OBJ_INDEX_BUCKETS];
+}
+#endif
+
 static K_THREAD_STACK_DEFINE(engine_thread_stack,
 			      CONFIG_LWM2M_ENGINE_STACK_SIZE);
 static struct k_thread engine_thread_data;
@@ -398,7 +418,7 @@ int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
 	return ret;
 }
 
-int lwm2m_notify_observer_path(struct lwm2m_obj_path *path)
+int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path)
 {
 	return lwm2m_notify_observer(path->obj_id, path->obj_inst_id,
 				     path->res_id);
@@ -610,23 +630,39 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 {
 	sys_slist_append(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	sys_slist_append(obj_index_bucket(obj->obj_id), &obj->index_node);
+#endif
 }
 
 void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 {
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	sys_slist_find_and_remove(obj_index_bucket(obj->obj_id),
+				  &obj->index_node);
+#endif
 }
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	SYS_SLIST_FOR_EACH_CONTAINER(obj_index_bucket(obj_id), obj,
+				     index_node) {
+		if (obj->obj_id == obj_id) {
+			return obj;
+		}
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
 	}
+#endif
 
 	return NULL;
 }
@@ -652,6 +688,11 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	sys_slist_append(obj_inst_index_bucket(obj_inst->obj->obj_id,
+					       obj_inst->obj_inst_id),
+			 &obj_inst->index_node);
+#endif
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -659,6 +700,11 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	sys_slist_find_and_remove(obj_inst_index_bucket(obj_inst->obj->obj_id,
+							obj_inst->obj_inst_id),
+				  &obj_inst->index_node);
+#endif
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -666,6 +712,15 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	SYS_SLIST_FOR_EACH_CONTAINER(obj_inst_index_bucket(obj_id, obj_inst_id),
+				     obj_inst, index_node) {
+		if (obj_inst->obj->obj_id == obj_id &&
+		    obj_inst->obj_inst_id == obj_inst_id) {
+			return obj_inst;
+		}
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
 				     node) {
 		if (obj_inst->obj->obj_id == obj_id &&
@@ -673,6 +728,7 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 			return obj_inst;
 		}
 	}
+#endif
 
 	return NULL;
 }
@@ -1360,9 +1416,26 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, u16_t data_len,
 	return ret;
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+int lwm2m_engine_parse_path(char *pathstr, struct lwm2m_obj_path *path)
+{
+	int ret;
+
+	ret = string_to_path(pathstr, path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path->level < 3) {
+		LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int engine_set_by_path(const struct lwm2m_obj_path *path,
+			      void *value, u16_t len)
 {
-	struct lwm2m_obj_path path;
 	struct lwm2m_engine_obj_inst *obj_inst;
 	struct lwm2m_engine_obj_field *obj_field;
 	struct lwm2m_engine_res_inst *res = NULL;
@@ -1371,27 +1444,19 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	int ret = 0;
 	bool changed = false;
 
-	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
+	if (path->level < 3) {
 		LOG_ERR("path must have 3 parts");
 		return -EINVAL;
 	}
 
 	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
+	ret = path_to_objs(path, &obj_inst, &obj_field, &res);
 	if (ret < 0) {
 		return ret;
 	}
 
 	if (!res) {
-		LOG_ERR("res instance %d not found", path.res_id);
+		LOG_ERR("res instance %d not found", path->res_id);
 		return -ENOENT;
 	}
 
@@ -1418,7 +1483,7 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	if (len > res->data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		LOG_ERR("length %u is too long for resource %d data",
-			len, path.res_id);
+			len, path->res_id);
 		return -ENOMEM;
 	}
 
@@ -1500,12 +1565,28 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	}
 
 	if (changed) {
-		NOTIFY_OBSERVER_PATH(&path);
+		NOTIFY_OBSERVER_PATH(path);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+{
+	struct lwm2m_obj_path path;
+	int ret = 0;
+
+	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_set_by_path(&path, value, len);
+}
+
 int lwm2m_engine_set_opaque(char *pathstr, char *data_ptr, u16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -1573,6 +1654,86 @@ int lwm2m_engine_set_float64(char *pathstr, float64_value_t *value)
 	return lwm2m_engine_set(pathstr, value, sizeof(float64_value_t));
 }
 
+int lwm2m_engine_set_opaque_by_path(const struct lwm2m_obj_path *path,
+				char *data_ptr, u16_t data_len)
+{
+	return engine_set_by_path(path, data_ptr, data_len);
+}
+
+int lwm2m_engine_set_string_by_path(const struct lwm2m_obj_path *path,
+				char *data_ptr)
+{
+	return engine_set_by_path(path, data_ptr, strlen(data_ptr));
+}
+
+int lwm2m_engine_set_u8_by_path(const struct lwm2m_obj_path *path,
+				u8_t value)
+{
+	return engine_set_by_path(path, &value, 1);
+}
+
+int lwm2m_engine_set_u16_by_path(const struct lwm2m_obj_path *path,
+				u16_t value)
+{
+	return engine_set_by_path(path, &value, 2);
+}
+
+int lwm2m_engine_set_u32_by_path(const struct lwm2m_obj_path *path,
+				u32_t value)
+{
+	return engine_set_by_path(path, &value, 4);
+}
+
+int lwm2m_engine_set_u64_by_path(const struct lwm2m_obj_path *path,
+				u64_t value)
+{
+	return engine_set_by_path(path, &value, 8);
+}
+
+int lwm2m_engine_set_s8_by_path(const struct lwm2m_obj_path *path,
+				s8_t value)
+{
+	return engine_set_by_path(path, &value, 1);
+}
+
+int lwm2m_engine_set_s16_by_path(const struct lwm2m_obj_path *path,
+				s16_t value)
+{
+	return engine_set_by_path(path, &value, 2);
+}
+
+int lwm2m_engine_set_s32_by_path(const struct lwm2m_obj_path *path,
+				s32_t value)
+{
+	return engine_set_by_path(path, &value, 4);
+}
+
+int lwm2m_engine_set_s64_by_path(const struct lwm2m_obj_path *path,
+				s64_t value)
+{
+	return engine_set_by_path(path, &value, 8);
+}
+
+int lwm2m_engine_set_bool_by_path(const struct lwm2m_obj_path *path,
+				bool value)
+{
+	u8_t temp = (value != 0 ? 1 : 0);
+
+	return engine_set_by_path(path, &temp, 1);
+}
+
+int lwm2m_engine_set_float32_by_path(const struct lwm2m_obj_path *path,
+				float32_value_t *value)
+{
+	return engine_set_by_path(path, value, sizeof(float32_value_t));
+}
+
+int lwm2m_engine_set_float64_by_path(const struct lwm2m_obj_path *path,
+				float64_value_t *value)
+{
+	return engine_set_by_path(path, value, sizeof(float64_value_t));
+}
+
 /* user data getter functions */
 
 int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, u16_t *data_len,
@@ -139,15 +139,6 @@
 struct lwm2m_engine_obj;
 struct lwm2m_message;
 
-/* path representing object instances */
-struct lwm2m_obj_path {
-	u16_t obj_id;
-	u16_t obj_inst_id;
-	u16_t res_id;
-	u16_t res_inst_id;
-	u8_t  level;  /* 0/1/2/3 = 3 = resource */
-};
-
 #define OBJ_FIELD(res_id, perm, type, multi_max) \
 	{ res_id, LWM2M_PERM_ ## perm, LWM2M_RES_TYPE_ ## type, multi_max }
 
@@ -174,6 +165,10 @@ typedef int (*lwm2m_engine_obj_delete_cb_t)(u16_t obj_inst_id);
 struct lwm2m_engine_obj {
 	/* object list */
 	sys_snode_t node;
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	/* object ID index */
+	sys_snode_t index_node;
+#endif
 
 	/* object field definitions */
 	struct lwm2m_engine_obj_field *fields;
@@ -256,6 +251,10 @@ struct lwm2m_engine_res_inst {
 struct lwm2m_engine_obj_inst {
 	/* instance list */
 	sys_snode_t node;
+#if defined(CONFIG_LWM2M_ENGINE_OBJ_INDEX)
+	/* object and instance ID index */
+	sys_snode_t index_node;
+#endif
 
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_res_inst *resources;
@@ -21,6 +21,12 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include "sockets_internal.h"
 
+/* Most iovecs a user mode sendmsg() or recvmsg() can pass */
+#define SOCK_IOV_MAX 16
+
+/* Datagrams recvmmsg() takes off the receive queue per lock */
+#define SOCK_MMSG_BATCH 8
+
 #define SET_ERRNO(x) \
 	{ int _err = x; if (_err < 0) { errno = -_err; return -1; } }
 
@@ -102,6 +108,7 @@ int zsock_socket_internal(int family, int type, int proto)
 
 	/* recv_q and accept_q are in union */
 	k_fifo_init(&ctx->recv_q);
+	zsock_epoll_init_ctx(ctx);
 
 #ifdef CONFIG_USERSPACE
 	/* Set net context object as initialized and grant access to the
@@ -174,6 +181,7 @@ int zsock_close_ctx(struct net_context *ctx)
 		(void)net_context_recv(ctx, NULL, K_NO_WAIT, NULL);
 	}
 
+	zsock_epoll_release_ctx(ctx);
 	zsock_flush_queue(ctx);
 
 	SET_ERRNO(net_context_put(ctx));
@@ -237,8 +245,10 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		(void)net_context_recv(new_ctx, zsock_received_cb, K_NO_WAIT,
 				       NULL);
 		k_fifo_init(&new_ctx->recv_q);
+		zsock_epoll_init_ctx(new_ctx);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		zsock_epoll_notify_ctx(parent);
 	}
 }
 
@@ -268,6 +278,8 @@ static void zsock_received_cb(struct net_context *ctx,
 			net_pkt_set_eof(last_pkt, true);
 			NET_DBG("Set EOF flag on pkt %p", last_pkt);
 		}
+
+		zsock_epoll_notify_ctx(ctx);
 		return;
 	}
 
@@ -279,6 +291,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	}
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	zsock_epoll_notify_ctx(ctx);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -509,6 +522,225 @@ Z_SYSCALL_HANDLER(zsock_sendto, sock, buf, len, flags, dest_addr, addrlen)
 }
 #endif /* CONFIG_USERSPACE */
 
+ssize_t zsock_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
+			  int flags)
+{
+	s32_t timeout = K_FOREVER;
+	int status;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	status = net_context_sendmsg(ctx, msg, flags, NULL, timeout,
+				     ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	return status;
+}
+
+ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	return vtable->sendmsg(ctx, msg, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+/* Copies a user msghdr and its iovec array in, checking the buffers the
+ * iovecs point to for the given access.
+ */
+static int sock_msghdr_from_user(struct msghdr *msg, struct iovec *iov,
+				 const struct msghdr *user_msg, bool write)
+{
+	size_t i;
+
+	if (z_user_from_copy(msg, (void *)user_msg, sizeof(*msg))) {
+		return -EFAULT;
+	}
+
+	if (msg->msg_iovlen > SOCK_IOV_MAX) {
+		return -EMSGSIZE;
+	}
+
+	if (z_user_from_copy(iov, msg->msg_iov,
+			     msg->msg_iovlen * sizeof(struct iovec))) {
+		return -EFAULT;
+	}
+
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		if (Z_SYSCALL_MEMORY(iov[i].iov_base, iov[i].iov_len, write)) {
+			return -EFAULT;
+		}
+	}
+
+	msg->msg_iov = iov;
+
+	return 0;
+}
+
+/* Only the value-result fields go back, not the kernel iovec pointer */
+static int sock_msghdr_to_user(struct msghdr *user_msg,
+			       const struct msghdr *msg)
+{
+	return z_user_to_copy(&user_msg->msg_namelen, &msg->msg_namelen,
+			      sizeof(msg->msg_namelen)) ||
+	       z_user_to_copy(&user_msg->msg_controllen,
+			      &msg->msg_controllen,
+			      sizeof(msg->msg_controllen)) ||
+	       z_user_to_copy(&user_msg->msg_flags, &msg->msg_flags,
+			      sizeof(msg->msg_flags));
+}
+
+Z_SYSCALL_HANDLER(zsock_sendmsg, sock, msg, flags)
+{
+	struct sockaddr_storage dest_addr_copy;
+	struct iovec iov[SOCK_IOV_MAX];
+	struct msghdr msg_copy;
+	int ret;
+
+	ret = sock_msghdr_from_user(&msg_copy, iov,
+				    (const struct msghdr *)msg, false);
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	if (msg_copy.msg_name) {
+		Z_OOPS(Z_SYSCALL_VERIFY(msg_copy.msg_namelen <=
+					sizeof(dest_addr_copy)));
+		Z_OOPS(z_user_from_copy(&dest_addr_copy, msg_copy.msg_name,
+					msg_copy.msg_namelen));
+		msg_copy.msg_name = &dest_addr_copy;
+	}
+
+	return z_impl_zsock_sendmsg(sock, &msg_copy, flags);
+}
+#endif /* CONFIG_USERSPACE */
+
+int zsock_sendmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+		       unsigned int vlen, int flags)
+{
+	s32_t timeout = K_FOREVER;
+	int status;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	status = net_context_sendmmsg(ctx, msgvec, vlen, flags, NULL,
+				      timeout, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	return status;
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+	unsigned int count;
+	ssize_t len;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable == &sock_fd_op_vtable) {
+		return zsock_sendmmsg_ctx(ctx, msgvec, vlen, flags);
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	for (count = 0; count < vlen; count++) {
+		len = vtable->sendmsg(ctx, &msgvec[count].msg_hdr, flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = len;
+	}
+
+	return (count == 0 && vlen) ? -1 : count;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_sendmmsg, sock, msgvec, vlen, flags)
+{
+	struct mmsghdr *user_vec = (struct mmsghdr *)msgvec;
+	struct sockaddr_storage dest_addr_copy;
+	struct iovec iov[SOCK_IOV_MAX];
+	struct mmsghdr mmsg;
+	unsigned int count;
+	int ret;
+
+	/* Each message is copied in and sent on its own; only the system
+	 * call itself is saved.
+	 */
+	for (count = 0; count < vlen; count++) {
+		ret = sock_msghdr_from_user(&mmsg.msg_hdr, iov,
+					    &user_vec[count].msg_hdr, false);
+		if (ret < 0) {
+			errno = -ret;
+			break;
+		}
+
+		if (mmsg.msg_hdr.msg_name) {
+			Z_OOPS(Z_SYSCALL_VERIFY(mmsg.msg_hdr.msg_namelen <=
+						sizeof(dest_addr_copy)));
+			Z_OOPS(z_user_from_copy(&dest_addr_copy,
+						mmsg.msg_hdr.msg_name,
+						mmsg.msg_hdr.msg_namelen));
+			mmsg.msg_hdr.msg_name = &dest_addr_copy;
+		}
+
+		ret = z_impl_zsock_sendmmsg(sock, &mmsg, 1, flags);
+		if (ret <= 0) {
+			break;
+		}
+
+		Z_OOPS(z_user_to_copy(&user_vec[count].msg_len,
+				      &mmsg.msg_len, sizeof(mmsg.msg_len)));
+	}
+
+	return (count == 0 && vlen) ? -1 : count;
+}
+#endif /* CONFIG_USERSPACE */
+
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
 				 enum net_ip_protocol proto,
 				 struct sockaddr *addr,
@@ -610,16 +842,122 @@ error:
 	return ret;
 }
 
+static int sock_fill_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+			      struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	int rv;
+
+	rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+				   src_addr, *addrlen);
+	if (rv < 0) {
+		return rv;
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static size_t sock_iov_len(const struct iovec *iov, size_t iovlen)
+{
+	size_t len = 0;
+	size_t i;
+
+	for (i = 0; i < iovlen; i++) {
+		len += iov[i].iov_len;
+	}
+
+	return len;
+}
+
+/* Scatters len bytes from the packet cursor over the iovecs */
+static int sock_read_iov(struct net_pkt *pkt, const struct iovec *iov,
+			 size_t iovlen, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < iovlen && len; i++) {
+		size_t iov_len = MIN(iov[i].iov_len, len);
+
+		if (net_pkt_read(pkt, iov[i].iov_base, iov_len)) {
+			return -ENOBUFS;
+		}
+
+		len -= iov_len;
+	}
+
+	return 0;
+}
+
+/* Copies out a datagram taken from (or, with ZSOCK_MSG_PEEK, still at
+ * the head of) the receive queue, and drops it unless peeking.
+ */
+static ssize_t sock_recv_dgram_pkt(struct net_context *ctx,
+				   struct net_pkt *pkt,
+				   const struct iovec *iov,
+				   size_t iovlen,
+				   int flags,
+				   struct sockaddr *src_addr,
+				   socklen_t *addrlen,
+				   int *msg_flags)
+{
+	size_t max_len = sock_iov_len(iov, iovlen);
+	struct net_pkt_cursor backup;
+	size_t recv_len;
+	int rv = 0;
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	if (src_addr && addrlen) {
+		rv = sock_fill_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			goto out;
+		}
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+	if (recv_len > max_len) {
+		recv_len = max_len;
+		if (msg_flags) {
+			*msg_flags |= ZSOCK_MSG_TRUNC;
+		}
+	}
+
+	rv = sock_read_iov(pkt, iov, iovlen, recv_len);
+
+out:
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_pkt_unref(pkt);
+	} else {
+		net_pkt_cursor_restore(pkt, &backup);
+	}
+
+	if (rv < 0) {
+		errno = -rv;
+		return -1;
+	}
+
+	return recv_len;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
+				       const struct iovec *iov,
+				       size_t iovlen,
 				       int flags,
 				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+				       socklen_t *addrlen,
+				       int *msg_flags)
 {
 	s32_t timeout = K_FOREVER;
-	size_t recv_len = 0;
-	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
@@ -646,55 +984,16 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		return -1;
 	}
 
-	net_pkt_cursor_backup(pkt, &backup);
-
-	if (src_addr && addrlen) {
-		int rv;
-
-		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-					   src_addr, *addrlen);
-		if (rv < 0) {
-			errno = -rv;
-			return -1;
-		}
-
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
-			return -1;
-		}
-	}
-
-	recv_len = net_pkt_remaining_data(pkt);
-	if (recv_len > max_len) {
-		recv_len = max_len;
-	}
-
-	if (net_pkt_read(pkt, buf, recv_len)) {
-		errno = ENOBUFS;
-		return -1;
-	}
-
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_pkt_unref(pkt);
-	} else {
-		net_pkt_cursor_restore(pkt, &backup);
-	}
-
-	return recv_len;
+	return sock_recv_dgram_pkt(ctx, pkt, iov, iovlen, flags, src_addr,
+				   addrlen, msg_flags);
 }
 
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
-					void *buf,
-					size_t max_len,
+					const struct iovec *iov,
+					size_t iovlen,
 					int flags)
 {
+	size_t max_len = sock_iov_len(iov, iovlen);
 	s32_t timeout = K_FOREVER;
 	size_t recv_len = 0;
 	struct net_pkt_cursor backup;
@@ -747,7 +1046,7 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 		}
 
 		/* Actually copy data to application buffer */
-		if (net_pkt_read(pkt, buf, recv_len)) {
+		if (sock_read_iov(pkt, iov, iovlen, recv_len)) {
 			errno = ENOBUFS;
 			return -1;
 		}
@@ -776,16 +1075,18 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 	return recv_len;
 }
 
-ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
-			   int flags,
-			   struct sockaddr *src_addr, socklen_t *addrlen)
+static ssize_t sock_recv_iov(struct net_context *ctx, const struct iovec *iov,
+			     size_t iovlen, int flags,
+			     struct sockaddr *src_addr, socklen_t *addrlen,
+			     int *msg_flags)
 {
 	enum net_sock_type sock_type = net_context_get_type(ctx);
 
 	if (sock_type == SOCK_DGRAM) {
-		return zsock_recv_dgram(ctx, buf, max_len, flags, src_addr, addrlen);
+		return zsock_recv_dgram(ctx, iov, iovlen, flags, src_addr,
+					addrlen, msg_flags);
 	} else if (sock_type == SOCK_STREAM) {
-		return zsock_recv_stream(ctx, buf, max_len, flags);
+		return zsock_recv_stream(ctx, iov, iovlen, flags);
 	} else {
 		__ASSERT(0, "Unknown socket type");
 	}
@@ -793,6 +1094,18 @@ ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 	return 0;
 }
 
+ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
+			   int flags,
+			   struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+
+	return sock_recv_iov(ctx, &iov, 1, flags, src_addr, addrlen, NULL);
+}
+
 ssize_t z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 			     struct sockaddr *src_addr, socklen_t *addrlen)
 {
@@ -832,6 +1145,376 @@ Z_SYSCALL_HANDLER(zsock_recvfrom, sock, buf, max_len, flags, src_addr,
 }
 #endif /* CONFIG_USERSPACE */
 
+ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			  int flags)
+{
+	msg->msg_flags = 0;
+	msg->msg_controllen = 0;
+
+	return sock_recv_iov(ctx, msg->msg_iov, msg->msg_iovlen, flags,
+			     msg->msg_name,
+			     msg->msg_name ? &msg->msg_namelen : NULL,
+			     &msg->msg_flags);
+}
+
+ssize_t z_impl_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable->recvmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	return vtable->recvmsg(ctx, msg, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_recvmsg, sock, msg, flags)
+{
+	struct msghdr *user_msg = (struct msghdr *)msg;
+	struct iovec iov[SOCK_IOV_MAX];
+	struct msghdr msg_copy;
+	ssize_t ret;
+
+	ret = sock_msghdr_from_user(&msg_copy, iov, user_msg, true);
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	Z_OOPS(msg_copy.msg_name &&
+	       Z_SYSCALL_MEMORY_WRITE(msg_copy.msg_name,
+				      msg_copy.msg_namelen));
+
+	ret = z_impl_zsock_recvmsg(sock, &msg_copy, flags);
+
+	Z_OOPS(sock_msghdr_to_user(user_msg, &msg_copy));
+
+	return ret;
+}
+#endif /* CONFIG_USERSPACE */
+
+static int zsock_recvmmsg_dgram(struct net_context *ctx,
+				struct mmsghdr *msgvec, unsigned int vlen,
+				int flags)
+{
+	struct net_pkt *pkts[SOCK_MMSG_BATCH];
+	s32_t timeout = K_FOREVER;
+	unsigned int count = 0;
+	int err = EAGAIN;
+	int n, i;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	/* Wait only for the first datagram, then take whatever else is
+	 * queued, a batch per lock acquisition.
+	 */
+	while (count < vlen) {
+		n = k_fifo_get_batch(&ctx->recv_q, (void **)pkts,
+				     MIN(vlen - count, SOCK_MMSG_BATCH),
+				     count ? K_NO_WAIT : timeout);
+		if (n == 0) {
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			struct msghdr *msg = &msgvec[count].msg_hdr;
+			ssize_t len;
+
+			msg->msg_flags = 0;
+			msg->msg_controllen = 0;
+
+			/* A datagram that fails is dropped, and its slot
+			 * is used for the next one.
+			 */
+			len = sock_recv_dgram_pkt(ctx, pkts[i], msg->msg_iov,
+						  msg->msg_iovlen, flags,
+						  msg->msg_name,
+						  msg->msg_name ?
+						  &msg->msg_namelen : NULL,
+						  &msg->msg_flags);
+			if (len < 0) {
+				err = errno;
+				continue;
+			}
+
+			msgvec[count++].msg_len = len;
+		}
+	}
+
+	if (count == 0) {
+		errno = err;
+		return -1;
+	}
+
+	return count;
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+	unsigned int count;
+	ssize_t len;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* Nothing to receive into, leave everything queued */
+	if (vlen == 0U) {
+		return 0;
+	}
+
+	if (vtable == &sock_fd_op_vtable && !(flags & ZSOCK_MSG_PEEK) &&
+	    net_context_get_type(ctx) == SOCK_DGRAM) {
+		return zsock_recvmmsg_dgram(ctx, msgvec, vlen, flags);
+	}
+
+	if (vtable->recvmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	for (count = 0; count < vlen; count++) {
+		len = vtable->recvmsg(ctx, &msgvec[count].msg_hdr,
+				      count ? flags | ZSOCK_MSG_DONTWAIT : flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = len;
+
+		/* End of stream, don't report it again */
+		if (len == 0) {
+			count++;
+			break;
+		}
+	}
+
+	return count ? count : -1;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_recvmmsg, sock, msgvec, vlen, flags)
+{
+	struct mmsghdr *user_vec = (struct mmsghdr *)msgvec;
+	struct iovec iov[SOCK_IOV_MAX];
+	struct mmsghdr mmsg;
+	unsigned int count;
+	int ret;
+
+	if (vlen == 0U) {
+		return z_impl_zsock_recvmmsg(sock, NULL, 0, flags);
+	}
+
+	/* Each message is copied in and received on its own; only the
+	 * system call itself is saved.
+	 */
+	for (count = 0; count < vlen; count++) {
+		ret = sock_msghdr_from_user(&mmsg.msg_hdr, iov,
+					    &user_vec[count].msg_hdr, true);
+		if (ret < 0) {
+			errno = -ret;
+			break;
+		}
+
+		Z_OOPS(mmsg.msg_hdr.msg_name &&
+		       Z_SYSCALL_MEMORY_WRITE(mmsg.msg_hdr.msg_name,
+					      mmsg.msg_hdr.msg_namelen));
+
+		ret = z_impl_zsock_recvmmsg(sock, &mmsg, 1, count ?
+					    flags | ZSOCK_MSG_DONTWAIT : flags);
+		if (ret <= 0) {
+			break;
+		}
+
+		Z_OOPS(sock_msghdr_to_user(&user_vec[count].msg_hdr,
+					   &mmsg.msg_hdr));
+		Z_OOPS(z_user_to_copy(&user_vec[count].msg_len,
+				      &mmsg.msg_len, sizeof(mmsg.msg_len)));
+
+		/* Possibly end of stream; a short batch is always allowed */
+		if (mmsg.msg_len == 0) {
+			count++;
+			break;
+		}
+	}
+
+	return count ? count : -1;
+}
+#endif /* CONFIG_USERSPACE */
+
+static ssize_t zsock_recv_zc_ctx(struct net_context *ctx, struct msghdr *msg,
+				 int flags, void **token)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+	s32_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	size_t recv_len;
+	size_t data_len;
+	int res;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	msg->msg_flags = 0;
+	msg->msg_controllen = 0;
+
+	do {
+		struct net_buf *frag;
+		u8_t *pos;
+		size_t i;
+
+		if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		if (sock_type == SOCK_DGRAM && !(flags & ZSOCK_MSG_PEEK)) {
+			pkt = k_fifo_get(&ctx->recv_q, timeout);
+		} else {
+			res = k_fifo_wait_non_empty(&ctx->recv_q, timeout);
+			/* EAGAIN when timeout expired, EINTR when cancelled */
+			if (res && res != -EAGAIN && res != -EINTR) {
+				errno = -res;
+				return -1;
+			}
+
+			pkt = k_fifo_peek_head(&ctx->recv_q);
+		}
+
+		if (!pkt) {
+			if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+				return 0;
+			}
+
+			errno = EAGAIN;
+			return -1;
+		}
+
+		if (sock_type == SOCK_DGRAM && msg->msg_name) {
+			res = sock_fill_src_addr(ctx, pkt, msg->msg_name,
+						 &msg->msg_namelen);
+			if (res < 0) {
+				if (!(flags & ZSOCK_MSG_PEEK)) {
+					net_pkt_unref(pkt);
+				}
+
+				errno = -res;
+				return -1;
+			}
+		}
+
+		/* Point the iovecs at the fragments, from the cursor on */
+		data_len = net_pkt_remaining_data(pkt);
+		frag = pkt->cursor.buf;
+		pos = pkt->cursor.pos;
+		recv_len = 0;
+
+		for (i = 0; frag && i < msg->msg_iovlen && recv_len < data_len;
+		     frag = frag->frags, pos = frag ? frag->data : NULL) {
+			size_t len = frag->len - (pos - frag->data);
+
+			if (len == 0) {
+				continue;
+			}
+
+			msg->msg_iov[i].iov_base = pos;
+			msg->msg_iov[i].iov_len = len;
+			recv_len += len;
+			i++;
+		}
+
+		msg->msg_iovlen = i;
+
+		if (sock_type == SOCK_DGRAM) {
+			if (recv_len < data_len) {
+				msg->msg_flags |= ZSOCK_MSG_TRUNC;
+			}
+
+			/* A dequeued datagram hands its reference over */
+			if (flags & ZSOCK_MSG_PEEK) {
+				net_pkt_ref(pkt);
+			}
+
+			break;
+		}
+
+		if (flags & ZSOCK_MSG_PEEK) {
+			if (recv_len) {
+				net_pkt_ref(pkt);
+			}
+		} else if (recv_len == data_len) {
+			/* Finished processing head pkt in the fifo: its
+			 * reference goes over to the caller if there's
+			 * data, else it is dropped.
+			 */
+			k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+			if (net_pkt_eof(pkt)) {
+				sock_set_eof(ctx);
+			}
+
+			if (!recv_len) {
+				net_pkt_unref(pkt);
+			}
+		} else {
+			bool overwrite = net_pkt_is_being_overwritten(pkt);
+
+			/* Leave the rest for the next read */
+			net_pkt_ref(pkt);
+			net_pkt_set_overwrite(pkt, true);
+			net_pkt_skip(pkt, recv_len);
+			net_pkt_set_overwrite(pkt, overwrite);
+		}
+	} while (recv_len == 0);
+
+	if (sock_type == SOCK_STREAM && !(flags & ZSOCK_MSG_PEEK)) {
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	*token = pkt;
+
+	return recv_len;
+}
+
+ssize_t zsock_recvmsg_zc(int sock, struct msghdr *msg, int flags,
+			 void **token)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (msg->msg_iovlen == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return zsock_recv_zc_ctx(ctx, msg, flags, token);
+}
+
+void zsock_recvmsg_zc_release(void *token)
+{
+	net_pkt_unref(token);
+}
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1431,6 +2114,17 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static ssize_t sock_sendmsg_vmeth(void *obj, const struct msghdr *msg,
+				  int flags)
+{
+	return zsock_sendmsg_ctx(obj, msg, flags);
+}
+
+static ssize_t sock_recvmsg_vmeth(void *obj, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg_ctx(obj, msg, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -1456,6 +2150,8 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.accept = sock_accept_vmeth,
 	.sendto = sock_sendto_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
+	.sendmsg = sock_sendmsg_vmeth,
+	.recvmsg = sock_recvmsg_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 };
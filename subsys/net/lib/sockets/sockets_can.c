@@ -69,6 +69,7 @@ int zcan_socket(int family, int type, int proto)
 	ctx->user_data = NULL;
 
 	k_fifo_init(&ctx->recv_q);
+	zsock_epoll_init_ctx(ctx);
 
 #ifdef CONFIG_USERSPACE
 	/* Set net context object as initialized and grant access to the
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief epoll() style readiness notification for sockets
+ *
+ * Each registration of a socket with an epoll instance is an item,
+ * linked both to the instance and to the socket. When the receive
+ * callback queues a packet (or a connection, or EOF) on a socket, its
+ * items are put on the ready list of their instance, and the instance
+ * is woken. epoll_wait() only looks at the ready list: a level
+ * triggered item is checked again and stays on it while the socket is
+ * still ready, an edge triggered one is taken off once reported.
+ *
+ * A single spinlock covers the items, the ready lists and the per
+ * socket item lists, as the receive callbacks run in the RX thread.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <spinlock.h>
+#include <net/net_context.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+extern const struct socket_op_vtable sock_fd_op_vtable;
+
+struct epoll_instance;
+
+struct epoll_item {
+	/** On the instance's ready list, while possibly ready */
+	sys_dnode_t ready_node;
+	/** On the instance's list of items */
+	sys_dnode_t ep_node;
+	/** On the socket's list of items */
+	sys_dnode_t ctx_node;
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	u32_t events;
+	zsock_epoll_data_t data;
+};
+
+struct epoll_instance {
+	sys_dlist_t ready;
+	sys_dlist_t items;
+	struct k_sem wake;
+	bool in_use;
+};
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+static struct k_spinlock lock;
+static struct epoll_instance instances[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+K_MEM_SLAB_DEFINE(epoll_item_slab, sizeof(struct epoll_item),
+		  CONFIG_NET_SOCKETS_EPOLL_ITEMS, 4);
+
+/* For now, assume that socket is always writable, as poll() does */
+static u32_t sock_events(struct net_context *ctx)
+{
+	u32_t events = ZSOCK_EPOLLOUT;
+
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	return events;
+}
+
+/* Must be called with the lock held */
+static bool item_check_ready(struct epoll_item *item)
+{
+	if ((sock_events(item->ctx) & item->events) == 0U) {
+		return false;
+	}
+
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+	}
+
+	return true;
+}
+
+/* Must be called with the lock held */
+static void item_unlink(struct epoll_item *item)
+{
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+
+	sys_dlist_remove(&item->ep_node);
+	sys_dlist_remove(&item->ctx_node);
+}
+
+/* Must be called with the lock held */
+static struct epoll_item *item_find(struct epoll_instance *ep,
+				    struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if (item->ep == ep) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+void zsock_epoll_init_ctx(struct net_context *ctx)
+{
+	sys_dlist_init(&ctx->epoll_items);
+}
+
+void zsock_epoll_notify_ctx(struct net_context *ctx)
+{
+	struct epoll_instance *wake[CONFIG_NET_SOCKETS_EPOLL_MAX];
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	int n = 0;
+
+	if (sys_dlist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	/* A socket has at most one item per instance */
+	key = k_spin_lock(&lock);
+	SYS_DLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if ((item->events & ZSOCK_EPOLLIN) &&
+		    !sys_dnode_is_linked(&item->ready_node)) {
+			sys_dlist_append(&item->ep->ready, &item->ready_node);
+			wake[n++] = item->ep;
+		}
+	}
+	k_spin_unlock(&lock, key);
+
+	while (n--) {
+		k_sem_give(&wake[n]->wake);
+	}
+}
+
+void zsock_epoll_release_ctx(struct net_context *ctx)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+
+	while (true) {
+		key = k_spin_lock(&lock);
+		item = SYS_DLIST_PEEK_HEAD_CONTAINER(&ctx->epoll_items, item,
+						     ctx_node);
+		if (item != NULL) {
+			item_unlink(item);
+		}
+		k_spin_unlock(&lock, key);
+
+		if (item == NULL) {
+			break;
+		}
+
+		k_mem_slab_free(&epoll_item_slab, (void **)&item);
+	}
+}
+
+static int epoll_close(struct epoll_instance *ep)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+
+	while (true) {
+		key = k_spin_lock(&lock);
+		item = SYS_DLIST_PEEK_HEAD_CONTAINER(&ep->items, item, ep_node);
+		if (item != NULL) {
+			item_unlink(item);
+		} else {
+			ep->in_use = false;
+		}
+		k_spin_unlock(&lock, key);
+
+		if (item == NULL) {
+			break;
+		}
+
+		k_mem_slab_free(&epoll_item_slab, (void **)&item);
+	}
+
+	return 0;
+}
+
+int z_impl_zsock_epoll_create(int size)
+{
+	struct epoll_instance *ep = NULL;
+	k_spinlock_key_t key;
+	int fd, i;
+
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	key = k_spin_lock(&lock);
+	for (i = 0; i < ARRAY_SIZE(instances); i++) {
+		if (!instances[i].in_use) {
+			ep = &instances[i];
+			ep->in_use = true;
+			break;
+		}
+	}
+	k_spin_unlock(&lock, key);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	sys_dlist_init(&ep->ready);
+	sys_dlist_init(&ep->items);
+	k_sem_init(&ep->wake, 0, 1);
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	NET_DBG("epoll: ep=%p, fd=%d", ep, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_epoll_create, size)
+{
+	return z_impl_zsock_epoll_create(size);
+}
+#endif /* CONFIG_USERSPACE */
+
+static int epoll_add(struct epoll_instance *ep, struct net_context *ctx,
+		     const struct zsock_epoll_event *event)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	bool ready;
+
+	if (k_mem_slab_alloc(&epoll_item_slab, (void **)&item, K_NO_WAIT)) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	sys_dnode_init(&item->ready_node);
+	item->ep = ep;
+	item->ctx = ctx;
+	item->events = event->events;
+	item->data = event->data;
+
+	key = k_spin_lock(&lock);
+
+	if (item_find(ep, ctx) != NULL) {
+		k_spin_unlock(&lock, key);
+		k_mem_slab_free(&epoll_item_slab, (void **)&item);
+		errno = EEXIST;
+		return -1;
+	}
+
+	sys_dlist_append(&ep->items, &item->ep_node);
+	sys_dlist_append(&ctx->epoll_items, &item->ctx_node);
+	ready = item_check_ready(item);
+
+	k_spin_unlock(&lock, key);
+
+	if (ready) {
+		k_sem_give(&ep->wake);
+	}
+
+	return 0;
+}
+
+static int epoll_mod(struct epoll_instance *ep, struct net_context *ctx,
+		     const struct zsock_epoll_event *event)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	bool ready;
+
+	key = k_spin_lock(&lock);
+
+	item = item_find(ep, ctx);
+	if (item == NULL) {
+		k_spin_unlock(&lock, key);
+		errno = ENOENT;
+		return -1;
+	}
+
+	item->events = event->events;
+	item->data = event->data;
+	ready = item_check_ready(item);
+
+	k_spin_unlock(&lock, key);
+
+	if (ready) {
+		k_sem_give(&ep->wake);
+	}
+
+	return 0;
+}
+
+static int epoll_del(struct epoll_instance *ep, struct net_context *ctx)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+
+	item = item_find(ep, ctx);
+	if (item != NULL) {
+		item_unlink(item);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (item == NULL) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	k_mem_slab_free(&epoll_item_slab, (void **)&item);
+
+	return 0;
+}
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int fd,
+			   struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	ctx = z_get_fd_obj_and_vtable(fd, &vtable);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* Readiness is only tracked for native sockets */
+	if (vtable != &sock_fd_op_vtable.fd_vtable) {
+		errno = EPERM;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		return epoll_add(ep, ctx, event);
+	case ZSOCK_EPOLL_CTL_MOD:
+		return epoll_mod(ep, ctx, event);
+	case ZSOCK_EPOLL_CTL_DEL:
+		return epoll_del(ep, ctx);
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_epoll_ctl, epfd, op, fd, event)
+{
+	struct zsock_epoll_event event_copy;
+
+	if (op == ZSOCK_EPOLL_CTL_DEL) {
+		return z_impl_zsock_epoll_ctl(epfd, op, fd, NULL);
+	}
+
+	Z_OOPS(z_user_from_copy(&event_copy, (void *)event,
+				sizeof(event_copy)));
+
+	return z_impl_zsock_epoll_ctl(epfd, op, fd, &event_copy);
+}
+#endif /* CONFIG_USERSPACE */
+
+/* Must be called with the lock held */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct epoll_item *item, *next;
+	sys_dlist_t requeue;
+	sys_dnode_t *node;
+	u32_t revents;
+	int n = 0;
+
+	sys_dlist_init(&requeue);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ep->ready, item, next, ready_node) {
+		if (n == maxevents) {
+			break;
+		}
+
+		sys_dlist_remove(&item->ready_node);
+
+		revents = sock_events(item->ctx) & item->events;
+		if (revents == 0U) {
+			continue;
+		}
+
+		events[n].events = revents;
+		events[n].data = item->data;
+		n++;
+
+		/* Level triggered items go to the back of the list, so
+		 * a busy socket can't hide the others from a short
+		 * events array.
+		 */
+		if (!(item->events & ZSOCK_EPOLLET)) {
+			sys_dlist_append(&requeue, &item->ready_node);
+		}
+	}
+
+	while ((node = sys_dlist_get(&requeue)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	return n;
+}
+
+static inline int time_left(u32_t start, u32_t timeout)
+{
+	u32_t elapsed = k_uptime_get_32() - start;
+
+	return timeout - elapsed;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	u32_t entry_time = k_uptime_get_32();
+	struct epoll_instance *ep;
+	int remaining_time;
+	k_spinlock_key_t key;
+	int n;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		timeout = K_FOREVER;
+	}
+
+	remaining_time = timeout;
+
+	while (true) {
+		key = k_spin_lock(&lock);
+		n = epoll_collect(ep, events, maxevents);
+		k_spin_unlock(&lock, key);
+
+		if (n > 0 || timeout == K_NO_WAIT) {
+			return n;
+		}
+
+		if (timeout != K_FOREVER) {
+			remaining_time = time_left(entry_time, timeout);
+			if (remaining_time <= 0) {
+				return 0;
+			}
+		}
+
+		/* A wakeup given since the ready list was looked at is
+		 * still counted by the semaphore, so none is lost.
+		 */
+		(void)k_sem_take(&ep->wake, remaining_time);
+	}
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_epoll_wait, epfd, events, maxevents, timeout)
+{
+	if ((int)maxevents > 0) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(events, maxevents,
+					sizeof(struct zsock_epoll_event)));
+	}
+
+	return z_impl_zsock_epoll_wait(epfd, (struct zsock_epoll_event *)events,
+				       maxevents, timeout);
+}
+#endif /* CONFIG_USERSPACE */
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(args);
+
+	switch (request) {
+	case ZFD_IOCTL_CLOSE:
+		return epoll_close(obj);
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
@@ -30,6 +30,27 @@ static inline u32_t sock_get_flag(struct net_context *ctx, u32_t mask)
 #define sock_set_eof(ctx) sock_set_flag(ctx, SOCK_EOF, SOCK_EOF)
 #define sock_is_nonblock(ctx) sock_get_flag(ctx, SOCK_NONBLOCK)
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+void zsock_epoll_init_ctx(struct net_context *ctx);
+void zsock_epoll_notify_ctx(struct net_context *ctx);
+void zsock_epoll_release_ctx(struct net_context *ctx);
+#else
+static inline void zsock_epoll_init_ctx(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+static inline void zsock_epoll_notify_ctx(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+static inline void zsock_epoll_release_ctx(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 struct socket_op_vtable {
 	struct fd_op_vtable fd_vtable;
 	int (*bind)(void *obj, const struct sockaddr *addr, socklen_t addrlen);
@@ -41,6 +62,8 @@ struct socket_op_vtable {
 			  const struct sockaddr *dest_addr, socklen_t addrlen);
 	ssize_t (*recvfrom)(void *obj, void *buf, size_t max_len, int flags,
 			    struct sockaddr *src_addr, socklen_t *addrlen);
+	ssize_t (*sendmsg)(void *obj, const struct msghdr *msg, int flags);
+	ssize_t (*recvmsg)(void *obj, struct msghdr *msg, int flags);
 	int (*getsockopt)(void *obj, int level, int optname,
 			  void *optval, socklen_t *optlen);
 	int (*setsockopt)(void *obj, int level, int optname,
@@ -59,6 +59,7 @@ static int zpacket_socket(int family, int type, int proto)
 
 	/* recv_q and accept_q are in union */
 	k_fifo_init(&ctx->recv_q);
+	zsock_epoll_init_ctx(ctx);
 
 #ifdef CONFIG_USERSPACE
 	/* Set net context object as initialized and grant access to the
@@ -32,8 +32,11 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/x509_crt.h>
 #include <mbedtls/ssl.h>
 #include <mbedtls/ssl_cookie.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
+#include <mbedtls/version.h>
 #endif /* CONFIG_MBEDTLS */
 
 #include "sockets_internal.h"
@@ -102,6 +105,9 @@ struct tls_context {
 
 		/** DTLS role, client by default. */
 		s8_t role;
+
+		/** Information whether sessions are cached for resumption. */
+		bool cache_enabled;
 	} options;
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
@@ -147,6 +153,53 @@ static struct tls_context tls_contexts[CONFIG_NET_SOCKETS_TLS_MAX_CONTEXTS];
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/* Longest hostname that a client session can be cached for. */
+#define TLS_SESSION_HOSTNAME_LEN 64
+
+/** A client session kept for resuming later connections to the peer.
+ *
+ * A resumed session skips the certificate check, so it is only offered
+ * to sockets with the same credentials and verification level as the
+ * one it was established on.
+ */
+struct tls_session_entry {
+	/** Peer hostname, empty if the entry is not used. */
+	char hostname[TLS_SESSION_HOSTNAME_LEN + 1];
+
+	/** Credentials the session was established with. */
+	struct sec_tag_list sec_tag_list;
+
+	/** Peer verification level the session was established with. */
+	s8_t verify_level;
+
+	/** Uptime when the session was stored, in ms. */
+	s64_t timestamp;
+
+	/** mbedTLS session, including the session ticket if any. */
+	mbedtls_ssl_session session;
+};
+
+static struct tls_session_entry
+	client_sessions[CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE];
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/* Session ID cache of the TLS servers. */
+static mbedtls_ssl_cache_context server_cache;
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+/* Session ticket keys of the TLS servers. */
+static mbedtls_ssl_ticket_context server_ticket;
+static bool server_ticket_ready;
+#endif
+
+/* A mutex for protecting the session caches, as mbedTLS may be built
+ * without threading support.
+ */
+static struct k_mutex session_lock;
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 #define IS_LISTENING(context) (net_context_get_state(context) == \
 			       NET_CONTEXT_LISTENING)
 
@@ -289,6 +342,38 @@ static int tls_init(struct device *unused)
 	mbedtls_debug_set_threshold(CONFIG_MBEDTLS_DEBUG_LEVEL);
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	k_mutex_init(&session_lock);
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_init(&server_cache);
+	mbedtls_ssl_cache_set_max_entries(
+		&server_cache, CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE);
+#if defined(MBEDTLS_HAVE_TIME)
+	mbedtls_ssl_cache_set_timeout(
+		&server_cache, CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME);
+#endif
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_init(&server_ticket);
+
+	ret = mbedtls_ssl_ticket_setup(&server_ticket, mbedtls_ctr_drbg_random,
+				       &tls_ctr_drbg,
+#if defined(MBEDTLS_GCM_C)
+				       MBEDTLS_CIPHER_AES_128_GCM,
+#else
+				       MBEDTLS_CIPHER_AES_128_CCM,
+#endif
+				       CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME);
+	if (ret != 0) {
+		NET_WARN("TLS session tickets not available: -%x", -ret);
+	} else {
+		server_ticket_ready = true;
+	}
+#endif
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 	return 0;
 }
 
@@ -753,6 +838,256 @@ exit:
 	return err;
 }
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/* Hostname a client session is cached for, NULL if none. */
+static const char *tls_session_hostname(struct tls_context *tls)
+{
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (tls->options.is_hostname_set && tls->ssl.hostname &&
+	    tls->ssl.hostname[0] != '\0' &&
+	    strlen(tls->ssl.hostname) <= TLS_SESSION_HOSTNAME_LEN) {
+		return tls->ssl.hostname;
+	}
+#endif
+
+	return NULL;
+}
+
+static void tls_session_entry_clear(struct tls_session_entry *entry)
+{
+	mbedtls_ssl_session_free(&entry->session);
+	entry->hostname[0] = '\0';
+}
+
+/* Whether a socket may resume an entry: same peer, credentials and
+ * peer verification level.
+ */
+static bool tls_session_match(struct tls_session_entry *entry,
+			      struct tls_context *tls, const char *hostname)
+{
+	const struct sec_tag_list *tags = &tls->options.sec_tag_list;
+
+	return !strcmp(entry->hostname, hostname) &&
+	       entry->verify_level == tls->options.verify_level &&
+	       entry->sec_tag_list.sec_tag_count == tags->sec_tag_count &&
+	       !memcmp(entry->sec_tag_list.sec_tags, tags->sec_tags,
+		       tags->sec_tag_count * sizeof(sec_tag_t));
+}
+
+/* Find the entry of a socket, expired entries are dropped on the way.
+ * The session lock must be held.
+ */
+static struct tls_session_entry *tls_session_find(struct tls_context *tls,
+						  const char *hostname)
+{
+	s64_t now = k_uptime_get();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+		struct tls_session_entry *entry = &client_sessions[i];
+
+		if (entry->hostname[0] == '\0') {
+			continue;
+		}
+
+		if (now - entry->timestamp >=
+		    CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME * MSEC_PER_SEC) {
+			tls_session_entry_clear(entry);
+			continue;
+		}
+
+		if (tls_session_match(entry, tls, hostname)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* Entry to store a session of a socket in, an unused one or else the
+ * oldest. The session lock must be held.
+ */
+static struct tls_session_entry *tls_session_slot(struct tls_context *tls,
+						  const char *hostname)
+{
+	struct tls_session_entry *entry;
+	int i;
+
+	entry = tls_session_find(tls, hostname);
+	if (!entry) {
+		entry = &client_sessions[0];
+
+		for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+			if (client_sessions[i].hostname[0] == '\0') {
+				entry = &client_sessions[i];
+				break;
+			}
+
+			if (client_sessions[i].timestamp < entry->timestamp) {
+				entry = &client_sessions[i];
+			}
+		}
+	}
+
+	tls_session_entry_clear(entry);
+	mbedtls_ssl_session_init(&entry->session);
+
+	return entry;
+}
+
+static void tls_session_entry_set(struct tls_session_entry *entry,
+				  struct tls_context *tls,
+				  const char *hostname)
+{
+	strcpy(entry->hostname, hostname);
+	memcpy(&entry->sec_tag_list, &tls->options.sec_tag_list,
+	       sizeof(entry->sec_tag_list));
+	entry->verify_level = tls->options.verify_level;
+	entry->timestamp = k_uptime_get();
+}
+
+/* Keep the session of a client after a successful handshake. */
+static void tls_session_store(struct tls_context *tls)
+{
+	struct tls_session_entry *entry;
+	const char *hostname;
+
+	hostname = tls_session_hostname(tls);
+	if (!tls->options.cache_enabled || !hostname ||
+	    tls->config.endpoint != MBEDTLS_SSL_IS_CLIENT) {
+		return;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = tls_session_slot(tls, hostname);
+	if (mbedtls_ssl_get_session(&tls->ssl, &entry->session) == 0) {
+		tls_session_entry_set(entry, tls, hostname);
+
+		NET_DBG("Stored TLS session for %s", log_strdup(hostname));
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+
+/* Offer the cached session of the peer in the client handshake. */
+static void tls_session_restore(struct tls_context *tls)
+{
+	struct tls_session_entry *entry;
+	const char *hostname;
+
+	hostname = tls_session_hostname(tls);
+	if (!tls->options.cache_enabled || !hostname) {
+		return;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = tls_session_find(tls, hostname);
+	if (entry && mbedtls_ssl_set_session(&tls->ssl, &entry->session) == 0) {
+		NET_DBG("Resuming TLS session for %s", log_strdup(hostname));
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+
+static void tls_session_purge(void)
+{
+	int i;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+		tls_session_entry_clear(&client_sessions[i]);
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+static int tls_server_cache_get(void *data, mbedtls_ssl_session *session)
+{
+	int ret;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_get(data, session);
+	k_mutex_unlock(&session_lock);
+
+	return ret;
+}
+
+static int tls_server_cache_set(void *data,
+				const mbedtls_ssl_session *session)
+{
+	int ret;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_set(data, session);
+	k_mutex_unlock(&session_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+static int tls_server_ticket_write(void *p_ticket,
+				   const mbedtls_ssl_session *session,
+				   unsigned char *start,
+				   const unsigned char *end,
+				   size_t *tlen, uint32_t *lifetime)
+{
+	int ret;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_write(p_ticket, session, start, end, tlen,
+				       lifetime);
+	k_mutex_unlock(&session_lock);
+
+	return ret;
+}
+
+static int tls_server_ticket_parse(void *p_ticket,
+				   mbedtls_ssl_session *session,
+				   unsigned char *buf, size_t len)
+{
+	int ret;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_parse(p_ticket, session, buf, len);
+	k_mutex_unlock(&session_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_TICKET_C */
+
+/* Let a server resume the sessions of its clients. */
+static void tls_session_server_setup(struct tls_context *tls)
+{
+	if (!tls->options.cache_enabled) {
+		return;
+	}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_conf_session_cache(&tls->config, &server_cache,
+				       tls_server_cache_get,
+				       tls_server_cache_set);
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	if (server_ticket_ready) {
+		mbedtls_ssl_conf_session_tickets_cb(&tls->config,
+						    tls_server_ticket_write,
+						    tls_server_ticket_parse,
+						    &server_ticket);
+	}
+#endif
+}
+#else
+#define tls_session_store(...)
+#define tls_session_restore(...)
+#define tls_session_server_setup(...)
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 static int tls_mbedtls_reset(struct net_context *context)
 {
 	int ret;
@@ -805,6 +1140,8 @@ static int tls_mbedtls_handshake(struct net_context *context, bool block)
 
 	if (ret == 0) {
 		k_sem_give(&context->tls->tls_established);
+
+		tls_session_store(context->tls);
 	}
 
 	return ret;
@@ -893,6 +1230,10 @@ static int tls_mbedtls_init(struct net_context *context, bool is_server)
 			     mbedtls_ctr_drbg_random,
 			     &tls_ctr_drbg);
 
+	if (is_server) {
+		tls_session_server_setup(context->tls);
+	}
+
 	ret = tls_mbedtls_set_credentials(context->tls);
 	if (ret != 0) {
 		return ret;
@@ -907,6 +1248,10 @@ static int tls_mbedtls_init(struct net_context *context, bool is_server)
 		return -ENOMEM;
 	}
 
+	if (!is_server) {
+		tls_session_restore(context->tls);
+	}
+
 	context->tls->is_initialized = true;
 
 	return 0;
@@ -1100,6 +1445,154 @@ static int tls_opt_dtls_role_set(struct net_context *context,
 	return 0;
 }
 
+static int tls_opt_session_cache_set(struct net_context *context,
+				     const void *optval, socklen_t optlen)
+{
+	int *cache;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	cache = (int *)optval;
+	if (*cache != TLS_SESSION_CACHE_DISABLED &&
+	    *cache != TLS_SESSION_CACHE_ENABLED) {
+		return -EINVAL;
+	}
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	context->tls->options.cache_enabled =
+		(*cache == TLS_SESSION_CACHE_ENABLED);
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_session_cache_get(struct net_context *context,
+				     void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->tls->options.cache_enabled ?
+		TLS_SESSION_CACHE_ENABLED : TLS_SESSION_CACHE_DISABLED;
+
+	return 0;
+}
+
+static int tls_opt_session_cache_purge_set(struct net_context *context,
+					   const void *optval,
+					   socklen_t optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	tls_session_purge();
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+/* Session serialization appeared in mbedTLS 2.19. */
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE) && \
+	MBEDTLS_VERSION_NUMBER >= 0x02130000
+static int tls_opt_session_get(struct net_context *context,
+			       void *optval, socklen_t *optlen)
+{
+	mbedtls_ssl_session session;
+	size_t len;
+	int ret;
+
+	if (!is_handshake_complete(context)) {
+		return -ENOTCONN;
+	}
+
+	mbedtls_ssl_session_init(&session);
+
+	ret = mbedtls_ssl_get_session(&context->tls->ssl, &session);
+	if (ret == 0) {
+		ret = mbedtls_ssl_session_save(&session, optval, *optlen,
+					       &len);
+	}
+
+	mbedtls_ssl_session_free(&session);
+
+	if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+		return -ENOBUFS;
+	} else if (ret != 0) {
+		return -EINVAL;
+	}
+
+	*optlen = len;
+
+	return 0;
+}
+
+static int tls_opt_session_set(struct net_context *context,
+			       const void *optval, socklen_t optlen)
+{
+	struct tls_session_entry *entry;
+	const char *hostname;
+	int ret;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	/* The session is used by the next connection to the hostname. */
+	hostname = tls_session_hostname(context->tls);
+	if (!hostname) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = tls_session_slot(context->tls, hostname);
+
+	ret = mbedtls_ssl_session_load(&entry->session, optval, optlen);
+	if (ret == 0) {
+		tls_session_entry_set(entry, context->tls, hostname);
+	} else {
+		tls_session_entry_clear(entry);
+	}
+
+	k_mutex_unlock(&session_lock);
+
+	return ret == 0 ? 0 : -EINVAL;
+}
+#else
+static int tls_opt_session_get(struct net_context *context,
+			       void *optval, socklen_t *optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+	return -ENOPROTOOPT;
+}
+
+static int tls_opt_session_set(struct net_context *context,
+			       const void *optval, socklen_t optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+	return -ENOPROTOOPT;
+}
+#endif
+
 static int ztls_socket(int family, int type, int proto)
 {
 	enum net_ip_protocol_secure tls_proto = 0;
@@ -1834,6 +2327,14 @@ int ztls_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 		err = tls_opt_ciphersuite_used_get(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_get(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION:
+		err = tls_opt_session_get(ctx, optval, optlen);
+		break;
+
 	default:
 		/* Unknown or write-only option. */
 		err = -ENOPROTOOPT;
@@ -1884,6 +2385,18 @@ int ztls_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 		err = tls_opt_dtls_role_set(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_set(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_CACHE_PURGE:
+		err = tls_opt_session_cache_purge_set(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION:
+		err = tls_opt_session_set(ctx, optval, optlen);
+		break;
+
 	default:
 		/* Unknown or read-only option. */
 		err = -ENOPROTOOPT;
@@ -123,6 +123,114 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_SCHED_STATS)
+static u32_t cycles_to_us(u32_t cycles)
+{
+	return (u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC);
+}
+
+static void shell_hist_dump(const struct shell *shell, const char *label,
+			    const u32_t *hist)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "\t%-5s", label);
+	for (int i = 0; i < K_SCHED_STATS_BUCKETS; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %u", hist[i]);
+	}
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static void shell_sched_stats_dump(const struct shell *shell,
+				   const struct k_sched_stats *stats)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "\tswitches %u, preemptions %u, "
+		      "wait max %u us, run max %u us\n",
+		      stats->switches, stats->preemptions,
+		      cycles_to_us(stats->wait_max),
+		      cycles_to_us(stats->run_max));
+	shell_hist_dump(shell, "wait", stats->wait_hist);
+	shell_hist_dump(shell, "run", stats->run_hist);
+}
+
+static int cmd_kernel_sched(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	struct k_sched_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Histogram buckets start at (us):\n\t     ");
+	for (int i = 0; i < K_SCHED_STATS_BUCKETS; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %u",
+			      cycles_to_us(k_sched_stats_bucket_floor(i)));
+	}
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+
+	for (int prio = K_HIGHEST_THREAD_PRIO; prio <= K_LOWEST_THREAD_PRIO;
+	     prio++) {
+		if (k_sched_prio_stats_get(prio, &stats) != 0 ||
+		    stats.switches == 0U) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "Priority %d:\n", prio);
+		shell_sched_stats_dump(shell, &stats);
+	}
+
+	return 0;
+}
+
+static int cmd_kernel_sched_reset(const struct shell *shell,
+				  size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	k_sched_stats_reset();
+	shell_fprintf(shell, SHELL_NORMAL, "Scheduling statistics reset\n");
+	return 0;
+}
+
+#if defined(CONFIG_THREAD_MONITOR)
+static void shell_thread_sched_dump(const struct k_thread *thread,
+				    void *user_data)
+{
+	const struct shell *shell = user_data;
+	struct k_sched_stats stats;
+	const char *tname;
+
+	tname = k_thread_name_get((struct k_thread *)thread);
+	(void)k_thread_sched_stats_get((k_tid_t)thread, &stats);
+
+	shell_fprintf(shell, SHELL_NORMAL, "%p %-10s priority %d\n",
+		      thread, tname ? tname : "NA", thread->base.prio);
+	shell_sched_stats_dump(shell, &stats);
+}
+
+static int cmd_kernel_sched_threads(const struct shell *shell,
+				    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	k_thread_foreach(shell_thread_sched_dump, (void *)shell);
+	return 0;
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_sched,
+	SHELL_CMD(reset, NULL, "Reset scheduling statistics.",
+		  cmd_kernel_sched_reset),
+#if defined(CONFIG_THREAD_MONITOR)
+	SHELL_CMD(threads, NULL, "Scheduling statistics per thread.",
+		  cmd_kernel_sched_threads),
+#endif
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -158,6 +266,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 				&& defined(CONFIG_THREAD_STACK_INFO)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
+#endif
+#if defined(CONFIG_SCHED_STATS)
+	SHELL_CMD(sched, &sub_kernel_sched,
+		  "Scheduling statistics per priority.", cmd_kernel_sched),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
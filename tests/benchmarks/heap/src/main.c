@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <sys/sys_heap.h>
+
+/* This is a heap allocator benchmark comparing k_mem_pool with
+ * sys_heap on identical request streams.  See README.rst for what
+ * is measured.
+ */
+
+#define POOL_SZ 16384
+#define MIN_BLK 16
+#define MIN_REQ 8
+#define MAX_REQ 512
+
+#define N_SLOTS 64
+#define N_RUNS 20000
+
+K_MEM_POOL_DEFINE(bench_pool, MIN_BLK, POOL_SZ, 1, 8);
+
+static char __aligned(8) heap_mem[SYS_HEAP_BUF_SIZE(POOL_SZ, 1)];
+static struct sys_heap heap;
+
+struct allocator {
+	const char *name;
+	void *(*alloc)(size_t bytes);
+	void (*free)(void *mem);
+};
+
+struct result {
+	u32_t alloc_cycles;
+	u32_t free_cycles;
+	u32_t max_cycles;
+	u32_t used_pct;
+};
+
+static struct k_mem_block blocks[N_SLOTS];
+static void *slots[N_SLOTS];
+static size_t sizes[N_SLOTS];
+
+/* Both allocators must see the same request stream */
+static u32_t prng_state;
+
+static u32_t prng(void)
+{
+	prng_state = prng_state * 1103515245U + 12345U;
+	return prng_state >> 8;
+}
+
+static size_t rand_size(void)
+{
+	return MIN_REQ + prng() % (MAX_REQ - MIN_REQ + 1);
+}
+
+/* The k_mem_pool API hands back a descriptor rather than a pointer,
+ * so keep those in a parallel array indexed by slot.
+ */
+static int pool_slot;
+
+static void *pool_alloc(size_t bytes)
+{
+	if (k_mem_pool_alloc(&bench_pool, &blocks[pool_slot], bytes,
+			     K_NO_WAIT) != 0) {
+		return NULL;
+	}
+	return blocks[pool_slot].data;
+}
+
+static void pool_free(void *mem)
+{
+	ARG_UNUSED(mem);
+	k_mem_pool_free(&blocks[pool_slot]);
+}
+
+static void *heap_alloc(size_t bytes)
+{
+	return sys_heap_alloc(&heap, bytes);
+}
+
+static void heap_free(void *mem)
+{
+	sys_heap_free(&heap, mem);
+}
+
+static const struct allocator allocators[] = {
+	{ "k_mem_pool", pool_alloc, pool_free },
+	{ "sys_heap  ", heap_alloc, heap_free },
+};
+
+static void reset(void)
+{
+	(void)memset(slots, 0, sizeof(slots));
+	prng_state = 0xbeef;
+}
+
+static void release_all(const struct allocator *a)
+{
+	for (int i = 0; i < N_SLOTS; i++) {
+		if (slots[i] != NULL) {
+			pool_slot = i;
+			a->free(slots[i]);
+			slots[i] = NULL;
+		}
+	}
+}
+
+static void measure_latency(const struct allocator *a, struct result *r)
+{
+	u64_t alloc_tot = 0U, free_tot = 0U;
+	u32_t n_alloc = 0U, n_free = 0U;
+	u32_t t0, dt;
+
+	reset();
+	r->max_cycles = 0U;
+
+	for (int i = 0; i < N_RUNS; i++) {
+		int s = prng() % N_SLOTS;
+
+		pool_slot = s;
+		if (slots[s] == NULL) {
+			size_t sz = rand_size();
+
+			t0 = k_cycle_get_32();
+			slots[s] = a->alloc(sz);
+			dt = k_cycle_get_32() - t0;
+			if (slots[s] == NULL) {
+				continue;
+			}
+			alloc_tot += dt;
+			n_alloc++;
+		} else {
+			t0 = k_cycle_get_32();
+			a->free(slots[s]);
+			dt = k_cycle_get_32() - t0;
+			slots[s] = NULL;
+			free_tot += dt;
+			n_free++;
+		}
+
+		r->max_cycles = MAX(r->max_cycles, dt);
+	}
+
+	release_all(a);
+
+	r->alloc_cycles = n_alloc ? alloc_tot / n_alloc : 0;
+	r->free_cycles = n_free ? free_tot / n_free : 0;
+}
+
+static void measure_fragmentation(const struct allocator *a,
+				  struct result *r)
+{
+	size_t live = 0;
+
+	reset();
+
+	for (int n = 1; n < N_RUNS; n++) {
+		int s;
+
+		/* Find a free slot, evicting a random block if full */
+		for (s = 0; s < N_SLOTS && slots[s] != NULL; s++) {
+		}
+		if (s == N_SLOTS) {
+			s = prng() % N_SLOTS;
+			pool_slot = s;
+			a->free(slots[s]);
+			slots[s] = NULL;
+			live -= sizes[s];
+		}
+
+		pool_slot = s;
+		sizes[s] = rand_size();
+		slots[s] = a->alloc(sizes[s]);
+		if (slots[s] == NULL) {
+			break;
+		}
+		live += sizes[s];
+
+		if ((n % 3) == 0) {
+			s = prng() % N_SLOTS;
+			if (slots[s] != NULL) {
+				pool_slot = s;
+				a->free(slots[s]);
+				slots[s] = NULL;
+				live -= sizes[s];
+			}
+		}
+	}
+
+	release_all(a);
+
+	r->used_pct = (live * 100U) / POOL_SZ;
+}
+
+void main(void)
+{
+	struct result r;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	for (int i = 0; i < ARRAY_SIZE(allocators); i++) {
+		const struct allocator *a = &allocators[i];
+
+		measure_latency(a, &r);
+		measure_fragmentation(a, &r);
+
+		printk("%s alloc %4u free %4u max %4u used %3u%%\n",
+		       a->name, r.alloc_cycles, r.free_cycles,
+		       r.max_cycles, r.used_pct);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#include "net_private.h"
+#include "udp_internal.h"
+
+/* This is a benchmark of the IPv6 and UDP input path, for a packet
+ * whose headers are in one buffer and for one whose IPv6 header is
+ * split over two. See README.rst for what is measured.
+ */
+
+#define N_RUNS 1000
+#define N_SETTLE 10
+
+#define PORT 4242
+#define PAYLOAD_LEN 64
+#define PKT_LEN (NET_IPV6UDPH_LEN + PAYLOAD_LEN)
+
+/* Where the split layout cuts the packet, within the IPv6 addresses */
+#define SPLIT_AT 24
+
+static const struct in6_addr my_addr = { { {
+	0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static const struct in6_addr peer_addr = { { {
+	0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static u8_t frame[PKT_LEN];
+static u32_t received;
+
+static void bench_iface_init(struct net_if *iface)
+{
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	static u8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static int bench_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_rx_bench, "net_rx_bench", bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static enum net_verdict udp_received(struct net_conn *conn,
+				     struct net_pkt *pkt,
+				     union net_ip_header *ip_hdr,
+				     union net_proto_header *proto_hdr,
+				     void *user_data)
+{
+	received++;
+	net_pkt_unref(pkt);
+
+	return NET_OK;
+}
+
+static void build_frame(void)
+{
+	struct net_ipv6_hdr *ipv6_hdr = (struct net_ipv6_hdr *)frame;
+	struct net_udp_hdr *udp_hdr =
+		(struct net_udp_hdr *)(frame + NET_IPV6H_LEN);
+
+	ipv6_hdr->vtc = 0x60;
+	ipv6_hdr->len = htons(NET_UDPH_LEN + PAYLOAD_LEN);
+	ipv6_hdr->nexthdr = IPPROTO_UDP;
+	ipv6_hdr->hop_limit = 64U;
+	net_ipaddr_copy(&ipv6_hdr->src, &peer_addr);
+	net_ipaddr_copy(&ipv6_hdr->dst, &my_addr);
+
+	udp_hdr->src_port = htons(PORT);
+	udp_hdr->dst_port = htons(PORT);
+	udp_hdr->len = htons(NET_UDPH_LEN + PAYLOAD_LEN);
+
+	(void)memset(frame + NET_IPV6UDPH_LEN, 'x', PAYLOAD_LEN);
+}
+
+/* What a driver hands up, in buffers of at most split bytes */
+static struct net_pkt *get_pkt(struct net_if *iface, size_t split)
+{
+	struct net_pkt *pkt;
+	struct net_buf *buf;
+	size_t off, len;
+
+	pkt = net_pkt_rx_alloc_on_iface(iface, K_FOREVER);
+
+	for (off = 0; off < sizeof(frame); off += len) {
+		len = MIN(split, sizeof(frame) - off);
+
+		buf = net_pkt_get_reserve_rx_data(K_FOREVER);
+		net_buf_add_mem(buf, frame + off, len);
+		net_pkt_frag_add(pkt, buf);
+	}
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_overwrite(pkt, true);
+
+	return pkt;
+}
+
+static void measure(struct net_if *iface, const char *name, size_t split)
+{
+	u32_t start, cycles, max = 0U;
+	enum net_verdict verdict;
+	struct net_pkt *pkt;
+	u64_t tot = 0U;
+	int i;
+
+	received = 0U;
+
+	for (i = 0; i < N_RUNS + N_SETTLE; i++) {
+		pkt = get_pkt(iface, split);
+
+		start = k_cycle_get_32();
+
+#if defined(CONFIG_NET_RX_CONTIGUOUS_HEADERS)
+		net_pkt_pullup(pkt, CONFIG_NET_RX_CONTIGUOUS_HEADERS_LEN);
+#endif
+		net_pkt_cursor_init(pkt);
+		verdict = net_ipv6_input(pkt, false);
+
+		cycles = k_cycle_get_32() - start;
+
+		if (verdict == NET_DROP) {
+			net_pkt_unref(pkt);
+		}
+
+		/* Let the caches settle before keeping count */
+		if (i < N_SETTLE) {
+			continue;
+		}
+
+		tot += cycles;
+		max = MAX(max, cycles);
+	}
+
+	if (received != N_RUNS + N_SETTLE) {
+		printk("%s: %u packets out of %u received\n", name, received,
+		       N_RUNS + N_SETTLE);
+	}
+
+	printk("%-10s avg %5u max %5u\n", name, (u32_t)(tot / N_RUNS), max);
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct sockaddr_in6 local = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(PORT),
+	};
+	struct net_conn_handle *handle;
+
+	build_frame();
+
+	net_ipaddr_copy(&local.sin6_addr, &my_addr);
+
+	if (!net_if_ipv6_addr_add(iface, &local.sin6_addr, NET_ADDR_MANUAL,
+				  0)) {
+		printk("Cannot add address\n");
+		return;
+	}
+
+	if (net_udp_register(AF_INET6, NULL, (struct sockaddr *)&local, 0,
+			     PORT, udp_received, NULL, &handle)) {
+		printk("Cannot register UDP handler\n");
+		return;
+	}
+
+	measure(iface, "contiguous", sizeof(frame));
+	measure(iface, "split", SPLIT_AT);
+
+	net_udp_unregister(handle);
+
+	printk("fin\n");
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* This is a timeout queue microbenchmark, measuring the cost of
+ * arming and cancelling kernel timeouts as a function of how many
+ * are already pending.  See README.rst for details.
+ */
+
+#define MAX_PENDING 1024
+
+/* Far enough out that nothing expires while we measure */
+#define MIN_TICKS 100000
+#define SPAN_TICKS 1000000
+
+static const int depths[] = { 16, 64, 256, MAX_PENDING };
+
+static struct _timeout timeouts[MAX_PENDING];
+static u16_t order[MAX_PENDING];
+
+static u32_t prng_state;
+
+static u32_t prng(void)
+{
+	prng_state = prng_state * 1103515245U + 12345U;
+	return prng_state >> 8;
+}
+
+static void expired(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+	printk("unexpected timeout expiry\n");
+}
+
+static void shuffle(int n)
+{
+	for (int i = 0; i < n; i++) {
+		order[i] = i;
+	}
+
+	for (int i = n - 1; i > 0; i--) {
+		int j = prng() % (i + 1);
+		u16_t tmp = order[i];
+
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+}
+
+static void run(int n)
+{
+	u64_t add_tot = 0U, abort_tot = 0U;
+	u32_t max = 0U;
+	u32_t t0, dt;
+
+	prng_state = 0xbeef;
+
+	for (int i = 0; i < n; i++) {
+		s32_t ticks = MIN_TICKS + prng() % SPAN_TICKS;
+
+		t0 = k_cycle_get_32();
+		z_add_timeout(&timeouts[i], expired, ticks);
+		dt = k_cycle_get_32() - t0;
+
+		add_tot += dt;
+		max = MAX(max, dt);
+	}
+
+	shuffle(n);
+
+	for (int i = 0; i < n; i++) {
+		t0 = k_cycle_get_32();
+		z_abort_timeout(&timeouts[order[i]]);
+		dt = k_cycle_get_32() - t0;
+
+		abort_tot += dt;
+		max = MAX(max, dt);
+	}
+
+	printk("pending %4d add %6u abort %6u max %6u\n", n,
+	       (u32_t)(add_tot / n), (u32_t)(abort_tot / n), max);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(depths); i++) {
+		run(depths[i]);
+	}
+
+	printk("fin\n");
+}
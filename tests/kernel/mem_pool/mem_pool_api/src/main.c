@@ -19,6 +19,7 @@ extern void test_mpool_alloc_free_isr(void);
 extern void test_mpool_kdefine_extern(void);
 extern void test_mpool_alloc_size(void);
 extern void test_mpool_alloc_timeout(void);
+extern void test_mpool_alloc_size_zero(void);
 extern void test_sys_heap_mem_pool_assign(void);
 
 /*test case main entry*/
@@ -30,6 +31,7 @@ void test_main(void)
 			 ztest_unit_test(test_mpool_kdefine_extern),
 			 ztest_unit_test(test_mpool_alloc_size),
 			 ztest_unit_test(test_mpool_alloc_timeout),
+			 ztest_unit_test(test_mpool_alloc_size_zero),
 			 ztest_unit_test(test_sys_heap_mem_pool_assign)
 			 );
 	ztest_run_test_suite(mpool_api);
@@ -172,6 +172,29 @@ void test_mpool_alloc_timeout(void)
 	}
 }
 
+/**
+ * @brief Verify a zero size request returns without waiting
+ *
+ * @details The buddy allocator hands out its smallest block, the heap
+ * backend rejects the request. Neither waits, even with K_FOREVER.
+ *
+ * @see k_mem_pool_alloc()
+ */
+void test_mpool_alloc_size_zero(void)
+{
+	struct k_mem_block block;
+	int ret;
+
+	ret = k_mem_pool_alloc(&kmpool, &block, 0, K_FOREVER);
+
+	if (IS_ENABLED(CONFIG_MEM_POOL_HEAP_BACKEND)) {
+		zassert_equal(ret, -EINVAL, NULL);
+	} else {
+		zassert_equal(ret, 0, NULL);
+		k_mem_pool_free(&block);
+	}
+}
+
 /**
  * @brief Validate allocation and free from system heap memory pool
  *
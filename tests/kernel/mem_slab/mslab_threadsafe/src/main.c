@@ -7,11 +7,13 @@
 #include <ztest.h>
 
 extern void test_mslab_threadsafe(void);
+extern void test_mslab_cpu_cache(void);
 
 /*test case main entry*/
 void test_main(void)
 {
 	ztest_test_suite(mslab_threadsafe,
-			 ztest_unit_test(test_mslab_threadsafe));
+			 ztest_unit_test(test_mslab_threadsafe),
+			 ztest_unit_test(test_mslab_cpu_cache));
 	ztest_run_test_suite(mslab_threadsafe);
 }
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define BLK_ALIGN 8
+#define BLK_SIZE 16
+#define CACHE_BLOCKS 9
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+
+K_MEM_SLAB_DEFINE(cslab, BLK_SIZE, CACHE_BLOCKS, BLK_ALIGN);
+static K_THREAD_STACK_DEFINE(cstack, STACK_SIZE);
+static struct k_thread cthread;
+static K_THREAD_STACK_DEFINE(wstack, STACK_SIZE);
+static struct k_thread wthread;
+static K_SEM_DEFINE(done_sema, 0, 1);
+static K_SEM_DEFINE(wait_sema, 0, 1);
+static void *blocks[CACHE_BLOCKS];
+static void *wait_block;
+
+/* Start entry on a thread pinned to cpu */
+static k_tid_t start_on_cpu(struct k_thread *thread, k_thread_stack_t *stack,
+			    int cpu, k_thread_entry_t entry)
+{
+	k_tid_t tid = k_thread_create(thread, stack, STACK_SIZE, entry,
+				      NULL, NULL, NULL, K_PRIO_PREEMPT(1),
+				      0, K_FOREVER);
+
+	zassert_equal(k_thread_cpu_mask_clear(tid), 0, "");
+	zassert_equal(k_thread_cpu_mask_enable(tid, cpu), 0, "");
+	k_thread_start(tid);
+
+	return tid;
+}
+
+/* Run entry on a thread pinned to cpu and wait for it to finish */
+static void run_on_cpu(int cpu, k_thread_entry_t entry)
+{
+	k_tid_t tid = start_on_cpu(&cthread, cstack, cpu, entry);
+
+	zassert_equal(k_sem_take(&done_sema, K_SECONDS(5)), 0,
+		      "pinned thread did not finish");
+	k_thread_abort(tid);
+}
+
+/* Allocate the whole slab and free it again, leaving blocks cached */
+static void fill_cache(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		zassert_equal(k_mem_slab_alloc(&cslab, &blocks[i], K_NO_WAIT),
+			      0, "");
+	}
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		k_mem_slab_free(&cslab, &blocks[i]);
+	}
+
+	k_sem_give(&done_sema);
+}
+
+/* Allocate the whole slab and free a single block, which is cached */
+static void hold_all_but_one(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		zassert_equal(k_mem_slab_alloc(&cslab, &blocks[i], K_NO_WAIT),
+			      0, "");
+	}
+	k_mem_slab_free(&cslab, &blocks[0]);
+
+	k_sem_give(&done_sema);
+}
+
+static void alloc_all_no_wait(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_mem_slab_num_free_get(&cslab), CACHE_BLOCKS, "");
+
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		zassert_equal(k_mem_slab_alloc(&cslab, &blocks[i], K_NO_WAIT),
+			      0, "free block cached on another CPU not found");
+	}
+	zassert_equal(k_mem_slab_alloc(&cslab, &blocks[0], K_NO_WAIT),
+		      -ENOMEM, "");
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		k_mem_slab_free(&cslab, &blocks[i]);
+	}
+
+	k_sem_give(&done_sema);
+}
+
+static void alloc_one_wait(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_mem_slab_num_free_get(&cslab), 1, "");
+	zassert_equal(k_mem_slab_alloc(&cslab, &blocks[0], K_SECONDS(1)),
+		      0, "free block cached on another CPU not found");
+
+	k_sem_give(&done_sema);
+}
+
+static void hold_all(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		zassert_equal(k_mem_slab_alloc(&cslab, &blocks[i], K_NO_WAIT),
+			      0, "");
+	}
+
+	k_sem_give(&done_sema);
+}
+
+static void free_one(void *p1, void *p2, void *p3)
+{
+	k_mem_slab_free(&cslab, &blocks[0]);
+
+	k_sem_give(&done_sema);
+}
+
+static void alloc_forever(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_mem_slab_alloc(&cslab, &wait_block, K_FOREVER), 0,
+		      "");
+
+	k_sem_give(&wait_sema);
+}
+
+#endif /* CONFIG_MEM_SLAB_CPU_CACHE */
+
+/**
+ * @brief Verify blocks cached on one CPU can be allocated on another
+ *
+ * @details A thread pinned to CPU 1 leaves free blocks in that CPU's
+ * magazine and exits, so CPU 1 never touches the slab again.  A thread
+ * pinned to CPU 0 must then be able to allocate every block counted by
+ * k_mem_slab_num_free_get(), both without waiting and with a timeout.
+ * A thread blocked on an exhausted slab must get a block freed on
+ * another CPU after it started waiting, rather than the block going
+ * into that CPU's magazine.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_cpu_cache(void)
+{
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	k_tid_t tid;
+
+	run_on_cpu(1, fill_cache);
+	run_on_cpu(0, alloc_all_no_wait);
+
+	run_on_cpu(1, hold_all_but_one);
+	run_on_cpu(0, alloc_one_wait);
+
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		k_mem_slab_free(&cslab, &blocks[i]);
+	}
+	zassert_equal(k_mem_slab_num_free_get(&cslab), CACHE_BLOCKS, "");
+
+	run_on_cpu(1, hold_all);
+	tid = start_on_cpu(&wthread, wstack, 0, alloc_forever);
+
+	/* Let it block before the block is freed */
+	k_sleep(100);
+	zassert_equal(k_sem_take(&wait_sema, K_NO_WAIT), -EBUSY,
+		      "allocation from an exhausted slab did not wait");
+
+	run_on_cpu(1, free_one);
+	zassert_equal(k_sem_take(&wait_sema, K_SECONDS(5)), 0,
+		      "waiter not woken by a free on another CPU");
+	k_thread_abort(tid);
+
+	blocks[0] = wait_block;
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		k_mem_slab_free(&cslab, &blocks[i]);
+	}
+	zassert_equal(k_mem_slab_num_free_get(&cslab), CACHE_BLOCKS, "");
+#else
+	ztest_test_skip();
+#endif
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+#define BATCH_LEN 5
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+extern struct k_msgq msgq;
+static char __aligned(4) tbuffer[MSG_SIZE * BATCH_LEN];
+static u32_t tx[2 * BATCH_LEN];
+static u32_t rx[2 * BATCH_LEN];
+
+static void put_n_entry(void *p1, void *p2, void *p3)
+{
+	/* the queue is full: this waits and sends the first message only */
+	int ret = k_msgq_put_n(p1, &tx[BATCH_LEN], 2, TIMEOUT);
+
+	zassert_equal(ret, 1, NULL);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test sending and receiving several messages at once
+ * @see k_msgq_put_n(), k_msgq_get_n()
+ */
+void test_msgq_batch(void)
+{
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(tx); i++) {
+		tx[i] = MSG0 + i;
+	}
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, BATCH_LEN);
+
+	zassert_equal(k_msgq_get_n(&msgq, rx, 2, K_NO_WAIT), -ENOMSG, NULL);
+	zassert_equal(k_msgq_get_n(&msgq, rx, 2, TIMEOUT), -EAGAIN, NULL);
+
+	/**TESTPOINT: batches wrap around the end of the buffer */
+	for (int i = 0; i < 2 * BATCH_LEN; i++) {
+		ret = k_msgq_put_n(&msgq, tx, 3, K_NO_WAIT);
+		zassert_equal(ret, 3, NULL);
+		ret = k_msgq_get_n(&msgq, rx, ARRAY_SIZE(rx), K_NO_WAIT);
+		zassert_equal(ret, 3, NULL);
+		zassert_equal(memcmp(rx, tx, 3 * MSG_SIZE), 0, NULL);
+	}
+
+	/**TESTPOINT: put_n stops when the queue is full */
+	ret = k_msgq_put_n(&msgq, tx, ARRAY_SIZE(tx), K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN, NULL);
+	zassert_equal(k_msgq_num_free_get(&msgq), 0, NULL);
+	zassert_equal(k_msgq_put_n(&msgq, tx, 1, K_NO_WAIT), -ENOMSG, NULL);
+
+	/**TESTPOINT: get_n lets a blocked sender in */
+	k_thread_create(&tdata, tstack, STACK_SIZE, put_n_entry, &msgq,
+			NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+
+	ret = k_msgq_get_n(&msgq, rx, 2, K_NO_WAIT);
+	zassert_equal(ret, 2, NULL);
+	zassert_equal(memcmp(rx, tx, 2 * MSG_SIZE), 0, NULL);
+	k_sleep(TIMEOUT >> 1);
+
+	ret = k_msgq_get_n(&msgq, rx, ARRAY_SIZE(rx), K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN - 1, NULL);
+	zassert_equal(memcmp(rx, &tx[2], (BATCH_LEN - 2) * MSG_SIZE), 0, NULL);
+	zassert_equal(rx[BATCH_LEN - 2], tx[BATCH_LEN], NULL);
+
+	k_thread_abort(&tdata);
+	k_msgq_purge(&msgq);
+}
+
+/**
+ * @}
+ */
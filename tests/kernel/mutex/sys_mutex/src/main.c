@@ -375,7 +375,7 @@ void test_supervisor_access(void)
 	zassert_true(rv == -EINVAL, "accepted bad mutex pointer");
 	rv = sys_mutex_unlock((struct sys_mutex *)k_current_get());
 	zassert_true(rv == -EINVAL, "accepted object that was not a mutex");
-#endif /* CONFIG_USERSPACE */
+#endif
 
 	rv = sys_mutex_unlock(&not_my_mutex);
 	zassert_true(rv == -EPERM, "unlocked a mutex that wasn't owner");
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_queue.h"
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LIST_LEN 6
+#define BATCH 4
+
+static qdata_t data[LIST_LEN];
+static struct k_queue queue;
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static void tqueue_append_later(void *p1, void *p2, void *p3)
+{
+	k_sleep(10);
+	k_queue_append_list(&queue, &data[0], &data[2]);
+}
+
+/**
+ * @addtogroup kernel_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test getting several queue items at once
+ * @see k_queue_get_batch(), k_queue_append_list()
+ */
+void test_queue_get_batch(void)
+{
+	void *items[BATCH];
+	int n;
+
+	k_queue_init(&queue);
+
+	/**TESTPOINT: empty queue, no wait */
+	zassert_equal(k_queue_get_batch(&queue, items, BATCH, K_NO_WAIT), 0,
+		      NULL);
+	zassert_equal(k_queue_get_batch(&queue, items, BATCH, 10), 0, NULL);
+
+	for (int i = 0; i < LIST_LEN; i++) {
+		k_queue_append(&queue, &data[i]);
+	}
+
+	/**TESTPOINT: batches are capped and keep FIFO order */
+	n = k_queue_get_batch(&queue, items, BATCH, K_NO_WAIT);
+	zassert_equal(n, BATCH, NULL);
+	for (int i = 0; i < n; i++) {
+		zassert_equal(items[i], &data[i], NULL);
+	}
+
+	n = k_queue_get_batch(&queue, items, BATCH, K_NO_WAIT);
+	zassert_equal(n, LIST_LEN - BATCH, NULL);
+	for (int i = 0; i < n; i++) {
+		zassert_equal(items[i], &data[BATCH + i], NULL);
+	}
+	zassert_true(k_queue_is_empty(&queue), NULL);
+
+	/**TESTPOINT: a blocked batch get returns the whole appended list */
+	data[0].snode.next = &data[1].snode;
+	data[1].snode.next = &data[2].snode;
+	data[2].snode.next = NULL;
+	k_thread_create(&tdata, tstack, STACK_SIZE, tqueue_append_later,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+
+	n = k_queue_get_batch(&queue, items, BATCH, K_FOREVER);
+	zassert_equal(n, 3, NULL);
+	for (int i = 0; i < n; i++) {
+		zassert_equal(items[i], &data[i], NULL);
+	}
+
+	k_thread_abort(&tdata);
+}
+
+/**
+ * @}
+ */
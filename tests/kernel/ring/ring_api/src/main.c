@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @defgroup kernel_ring_tests Rings
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_RECS 4
+
+struct rec {
+	u32_t seq;
+	u16_t tag;
+};
+
+K_SPSC_RING_DEFINE(sring, sizeof(struct rec), NUM_RECS, 4);
+K_MPMC_RING_DEFINE(mring, sizeof(struct rec), NUM_RECS);
+
+static struct k_spsc_ring sring_rt;
+static char __aligned(4) sring_rt_buf[NUM_RECS * sizeof(struct rec)];
+static struct k_mpmc_ring mring_rt;
+static char __aligned(4)
+	mring_rt_buf[K_MPMC_RING_BUF_SIZE(sizeof(struct rec), NUM_RECS)];
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+static K_SEM_DEFINE(end_sema, 0, 1);
+
+/* Small shim so every test body runs against both flavors */
+struct ring_ops {
+	void *ring;
+	int (*put)(void *ring, const void *data);
+	int (*get)(void *ring, void *data, s32_t timeout);
+	u32_t (*used)(void *ring);
+};
+
+static int spsc_put(void *r, const void *data)
+{
+	return k_spsc_ring_put(r, data);
+}
+
+static int spsc_get(void *r, void *data, s32_t timeout)
+{
+	return k_spsc_ring_get(r, data, timeout);
+}
+
+static u32_t spsc_used(void *r)
+{
+	return k_spsc_ring_num_used_get(r);
+}
+
+static int mpmc_put(void *r, const void *data)
+{
+	return k_mpmc_ring_put(r, data);
+}
+
+static int mpmc_get(void *r, void *data, s32_t timeout)
+{
+	return k_mpmc_ring_get(r, data, timeout);
+}
+
+static u32_t mpmc_used(void *r)
+{
+	return k_mpmc_ring_num_used_get(r);
+}
+
+#define SPSC_OPS(r) { .ring = (r), .put = spsc_put, .get = spsc_get, \
+		      .used = spsc_used }
+#define MPMC_OPS(r) { .ring = (r), .put = mpmc_put, .get = mpmc_get, \
+		      .used = mpmc_used }
+
+static void fill(struct ring_ops *ops, u32_t first, u32_t n)
+{
+	for (u32_t i = 0; i < n; i++) {
+		struct rec r = { .seq = first + i, .tag = 0xa5 };
+
+		zassert_equal(ops->put(ops->ring, &r), 0, NULL);
+	}
+}
+
+static void drain(struct ring_ops *ops, u32_t first, u32_t n)
+{
+	struct rec r;
+
+	for (u32_t i = 0; i < n; i++) {
+		zassert_equal(ops->get(ops->ring, &r, K_NO_WAIT), 0, NULL);
+		zassert_equal(r.seq, first + i, "records out of order");
+		zassert_equal(r.tag, 0xa5, NULL);
+	}
+}
+
+static void ring_fifo(struct ring_ops *ops)
+{
+	struct rec r = { 0 };
+
+	zassert_equal(ops->used(ops->ring), 0, NULL);
+	zassert_equal(ops->get(ops->ring, &r, K_NO_WAIT), -ENOMSG, NULL);
+	zassert_equal(ops->get(ops->ring, &r, TIMEOUT), -EAGAIN, NULL);
+
+	/**TESTPOINT: wrap the indices around several times */
+	for (u32_t base = 0; base < 5 * NUM_RECS; base += NUM_RECS - 1) {
+		fill(ops, base, NUM_RECS - 1);
+		zassert_equal(ops->used(ops->ring), NUM_RECS - 1, NULL);
+		drain(ops, base, NUM_RECS - 1);
+	}
+
+	/**TESTPOINT: a full ring rejects puts without blocking */
+	fill(ops, 100, NUM_RECS);
+	zassert_equal(ops->put(ops->ring, &r), -ENOMSG, NULL);
+	zassert_equal(ops->used(ops->ring), NUM_RECS, NULL);
+	drain(ops, 100, NUM_RECS);
+	zassert_equal(ops->used(ops->ring), 0, NULL);
+}
+
+static void isr_put(void *p)
+{
+	struct ring_ops *ops = p;
+
+	fill(ops, 200, NUM_RECS);
+}
+
+static void ring_isr(struct ring_ops *ops)
+{
+	/**TESTPOINT: ISR to thread data passing */
+	irq_offload(isr_put, ops);
+	drain(ops, 200, NUM_RECS);
+}
+
+static void reader_entry(void *p1, void *p2, void *p3)
+{
+	struct ring_ops *ops = p1;
+	struct rec r;
+
+	zassert_equal(ops->get(ops->ring, &r, K_FOREVER), 0, NULL);
+	zassert_equal(r.seq, 300, NULL);
+	k_sem_give(&end_sema);
+}
+
+static void ring_pend(struct ring_ops *ops)
+{
+	/**TESTPOINT: a put hands the record to a blocked reader */
+	k_thread_create(&tdata, tstack, STACK_SIZE, reader_entry, ops,
+			NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(10);
+
+	fill(ops, 300, 1);
+	zassert_equal(k_sem_take(&end_sema, TIMEOUT), 0, NULL);
+	zassert_equal(ops->used(ops->ring), 0, NULL);
+	k_thread_abort(&tdata);
+}
+
+static void ring_poll(struct ring_ops *ops)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_RING_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+		ops->ring);
+
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), -EAGAIN, NULL);
+
+	/**TESTPOINT: k_poll wakes up when a record is put */
+	irq_offload(isr_put, ops);
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), 0, NULL);
+	zassert_equal(event.state, K_POLL_STATE_DATA_AVAILABLE, NULL);
+	drain(ops, 200, NUM_RECS);
+}
+
+/**
+ * @brief Test record ordering and full/empty handling
+ * @see k_spsc_ring_put(), k_spsc_ring_get(), k_mpmc_ring_put(),
+ * k_mpmc_ring_get()
+ */
+void test_ring_fifo(void)
+{
+	struct ring_ops ops[] = { SPSC_OPS(&sring), MPMC_OPS(&mring) };
+
+	for (int i = 0; i < ARRAY_SIZE(ops); i++) {
+		ring_fifo(&ops[i]);
+	}
+}
+
+/**
+ * @brief Test runtime initialized rings
+ * @see k_spsc_ring_init(), k_mpmc_ring_init()
+ */
+void test_ring_init(void)
+{
+	k_spsc_ring_init(&sring_rt, sring_rt_buf, sizeof(struct rec),
+			 NUM_RECS);
+	k_mpmc_ring_init(&mring_rt, mring_rt_buf, sizeof(struct rec),
+			 NUM_RECS);
+
+	struct ring_ops ops[] = { SPSC_OPS(&sring_rt), MPMC_OPS(&mring_rt) };
+
+	for (int i = 0; i < ARRAY_SIZE(ops); i++) {
+		ring_fifo(&ops[i]);
+	}
+}
+
+/**
+ * @brief Test putting records from an ISR
+ */
+void test_ring_isr(void)
+{
+	struct ring_ops ops[] = { SPSC_OPS(&sring), MPMC_OPS(&mring) };
+
+	for (int i = 0; i < ARRAY_SIZE(ops); i++) {
+		ring_isr(&ops[i]);
+	}
+}
+
+/**
+ * @brief Test waking a reader blocked on an empty ring
+ */
+void test_ring_pend(void)
+{
+	struct ring_ops ops[] = { SPSC_OPS(&sring), MPMC_OPS(&mring) };
+
+	for (int i = 0; i < ARRAY_SIZE(ops); i++) {
+		ring_pend(&ops[i]);
+	}
+}
+
+/**
+ * @brief Test polling a ring for data
+ * @see k_poll()
+ */
+void test_ring_poll(void)
+{
+	struct ring_ops ops[] = { SPSC_OPS(&sring), MPMC_OPS(&mring) };
+
+	for (int i = 0; i < ARRAY_SIZE(ops); i++) {
+		ring_poll(&ops[i]);
+	}
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(ring_api,
+			 ztest_unit_test(test_ring_fifo),
+			 ztest_unit_test(test_ring_init),
+			 ztest_unit_test(test_ring_isr),
+			 ztest_unit_test(test_ring_pend),
+			 ztest_unit_test(test_ring_poll));
+	ztest_run_test_suite(ring_api);
+}
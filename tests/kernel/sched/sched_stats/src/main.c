@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_WAKEUPS 8
+
+K_THREAD_STACK_DEFINE(helper_stack, STACK_SIZE);
+static struct k_thread helper_thread;
+static K_SEM_DEFINE(wake_sem, 0, 1);
+
+static u32_t hist_sum(const u32_t *hist)
+{
+	u32_t sum = 0U;
+
+	for (int i = 0; i < K_SCHED_STATS_BUCKETS; i++) {
+		sum += hist[i];
+	}
+
+	return sum;
+}
+
+static void helper(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < NUM_WAKEUPS; i++) {
+		k_sem_take(&wake_sem, K_FOREVER);
+	}
+}
+
+/**
+ * @brief Wake a higher priority thread and check both threads' counters
+ *
+ * Each k_sem_give() switches to the helper, which preempts the test
+ * thread, then switches back once the helper pends again.
+ */
+void test_sched_stats_thread(void)
+{
+	struct k_sched_stats before, after, helper_stats;
+	k_tid_t tid;
+
+	k_sched_stats_reset();
+	zassert_equal(k_thread_sched_stats_get(k_current_get(), &before), 0,
+		      NULL);
+
+	tid = k_thread_create(&helper_thread, helper_stack, STACK_SIZE,
+			      helper, NULL, NULL, NULL,
+			      k_thread_priority_get(k_current_get()) - 1, 0,
+			      K_NO_WAIT);
+
+	for (int i = 0; i < NUM_WAKEUPS; i++) {
+		k_sem_give(&wake_sem);
+	}
+	k_thread_abort(tid);
+
+	zassert_equal(k_thread_sched_stats_get(k_current_get(), &after), 0,
+		      NULL);
+	zassert_true(after.switches >= before.switches + NUM_WAKEUPS,
+		     "switches %u", after.switches);
+	zassert_true(after.preemptions >= before.preemptions + NUM_WAKEUPS,
+		     "preemptions %u", after.preemptions);
+	zassert_equal(hist_sum(after.wait_hist), after.switches, NULL);
+
+	zassert_equal(k_thread_sched_stats_get(tid, &helper_stats), 0, NULL);
+	zassert_true(helper_stats.switches >= NUM_WAKEUPS, NULL);
+	zassert_equal(hist_sum(helper_stats.run_hist), helper_stats.switches,
+		      NULL);
+}
+
+/**
+ * @brief Check the per-priority table and its argument checking
+ */
+void test_sched_stats_prio(void)
+{
+	struct k_sched_stats stats;
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_sched_stats_reset();
+	k_yield();
+	k_sleep(1);
+
+	zassert_equal(k_sched_prio_stats_get(prio, &stats), 0, NULL);
+	zassert_true(stats.switches > 0U, NULL);
+	zassert_equal(hist_sum(stats.wait_hist), stats.switches, NULL);
+
+	zassert_equal(k_sched_prio_stats_get(K_HIGHEST_THREAD_PRIO - 1,
+					     &stats), -EINVAL, NULL);
+	zassert_equal(k_sched_prio_stats_get(K_LOWEST_THREAD_PRIO + 1,
+					     &stats), -EINVAL, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_stats,
+			 ztest_unit_test(test_sched_stats_thread),
+			 ztest_unit_test(test_sched_stats_prio));
+	ztest_run_test_suite(sched_stats);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/sem.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_WAITERS 3
+#define SEM_LIMIT 4
+
+#ifdef CONFIG_USERSPACE
+#define THREAD_FLAGS (K_USER | K_INHERIT_PERMS)
+#else
+#define THREAD_FLAGS 0
+#endif
+
+K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, NUM_WAITERS, STACK_SIZE);
+static struct k_thread waiter_threads[NUM_WAITERS];
+
+ZTEST_BMEM SYS_SEM_DEFINE(simple_sem, 0, SEM_LIMIT);
+ZTEST_BMEM SYS_SEM_DEFINE(multi_sem, 0, SEM_LIMIT);
+ZTEST_BMEM static atomic_t taken;
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	struct sys_sem *sem = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (sys_sem_take(sem, K_FOREVER) == 0) {
+		(void)atomic_inc(&taken);
+	}
+}
+
+static void spawn_waiters(struct sys_sem *sem, int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&waiter_threads[i], waiter_stacks[i],
+				STACK_SIZE, waiter, sem, NULL, NULL,
+				K_PRIO_PREEMPT(1), THREAD_FLAGS, K_NO_WAIT);
+	}
+
+	/* Let them all block on the semaphore */
+	k_sleep(K_MSEC(50));
+}
+
+/**
+ * @brief Give and take without contention, up to the count limit
+ */
+void test_sys_sem_give_take(void)
+{
+	zassert_equal(sys_sem_init(&simple_sem, 0, SEM_LIMIT), 0, NULL);
+	zassert_equal(sys_sem_take(&simple_sem, K_NO_WAIT), -EBUSY, NULL);
+
+	for (int i = 0; i < SEM_LIMIT; i++) {
+		zassert_equal(sys_sem_give(&simple_sem), 0, NULL);
+	}
+	zassert_equal(sys_sem_give(&simple_sem), -EAGAIN, NULL);
+	zassert_equal(sys_sem_count_get(&simple_sem), SEM_LIMIT, NULL);
+
+	for (int i = 0; i < SEM_LIMIT; i++) {
+		zassert_equal(sys_sem_take(&simple_sem, K_NO_WAIT), 0, NULL);
+	}
+	zassert_equal(sys_sem_count_get(&simple_sem), 0, NULL);
+	zassert_equal(sys_sem_take(&simple_sem, K_MSEC(10)), -EAGAIN, NULL);
+	zassert_equal(sys_sem_count_get(&simple_sem), 0, NULL);
+}
+
+/**
+ * @brief Wake several waiters with separate gives
+ *
+ * Each give must release exactly one waiter, including gives made
+ * while earlier woken waiters haven't run yet.
+ */
+void test_sys_sem_waiters(void)
+{
+	zassert_equal(sys_sem_init(&multi_sem, 0, SEM_LIMIT), 0, NULL);
+	atomic_set(&taken, 0);
+
+	spawn_waiters(&multi_sem, NUM_WAITERS);
+	zassert_equal(atomic_get(&taken), 0, NULL);
+
+	for (int i = 0; i < NUM_WAITERS - 1; i++) {
+		zassert_equal(sys_sem_give(&multi_sem), 0, NULL);
+	}
+	k_sleep(K_MSEC(50));
+	zassert_equal(atomic_get(&taken), NUM_WAITERS - 1, NULL);
+	zassert_equal(sys_sem_count_get(&multi_sem), 0, NULL);
+
+	zassert_equal(sys_sem_give(&multi_sem), 0, NULL);
+	k_sleep(K_MSEC(50));
+	zassert_equal(atomic_get(&taken), NUM_WAITERS, NULL);
+	zassert_equal(sys_sem_count_get(&multi_sem), 0, NULL);
+
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		k_thread_abort(&waiter_threads[i]);
+	}
+}
+
+void test_main(void)
+{
+#ifdef CONFIG_USERSPACE
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		k_thread_access_grant(k_current_get(), &waiter_threads[i],
+				      waiter_stacks[i]);
+	}
+#endif
+
+	ztest_test_suite(sys_sem,
+			 ztest_user_unit_test(test_sys_sem_give_take),
+			 ztest_user_unit_test(test_sys_sem_waiters));
+	ztest_run_test_suite(sys_sem);
+}
@@ -430,6 +430,113 @@ void test_wakeup_threads(void)
 	cleanup_resources();
 }
 
+static void pinned_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	tinfo[0].cpu_id = z_arch_curr_cpu()->id;
+	tinfo[0].executed = 1;
+}
+
+/**
+ * @brief Test CPU affinity of threads
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Pin a thread to each CPU in turn with the CPU mask API
+ * and check that it runs, and runs on that CPU, while the main
+ * thread sleeps.
+ */
+void test_cpu_mask_pinning(void)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		k_tid_t tid = k_thread_create(&tthread[0], tstack[0],
+					      STACK_SIZE, pinned_entry,
+					      NULL, NULL, NULL,
+					      K_PRIO_PREEMPT(2), 0, K_FOREVER);
+
+		zassert_equal(k_thread_cpu_mask_clear(tid), 0, "");
+		zassert_equal(k_thread_cpu_mask_enable(tid, cpu), 0, "");
+
+		tinfo[0].executed = 0;
+		k_thread_start(tid);
+		k_sleep(100);
+
+		zassert_true(tinfo[0].executed == 1,
+			     "pinned thread did not run");
+		zassert_equal(tinfo[0].cpu_id, cpu,
+			      "pinned thread ran on the wrong CPU");
+
+		k_thread_abort(tid);
+	}
+
+	cleanup_resources();
+#endif
+}
+
+static volatile bool spin_stop;
+
+static void spin_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	int thread_num = (int)p1;
+
+	tinfo[thread_num].executed = 1;
+	while (!spin_stop) {
+	}
+}
+
+static void urgent_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	int thread_num = (int)p1;
+
+	tinfo[thread_num].cpu_id = z_arch_curr_cpu()->id;
+	tinfo[thread_num].executed = 1;
+}
+
+/**
+ * @brief Test that a higher priority thread is not queued behind
+ * lower priority work
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Keep every other CPU busy with low priority threads, and
+ * the main thread busy on its own CPU, then make a higher priority
+ * thread ready. It must get a CPU while the low priority threads are
+ * still running.
+ */
+void test_prio_over_busy_cpus(void)
+{
+	int urgent = THREADS_NUM - 1;
+
+	spin_stop = false;
+	spawn_threads(K_PRIO_PREEMPT(10), THREADS_NUM - 1, EQUAL_PRIORITY,
+		      &spin_entry, 0);
+
+	/* Let the spinners take the other CPUs */
+	k_busy_wait(DELAY_US);
+
+	tinfo[urgent].tid = k_thread_create(&tthread[urgent], tstack[urgent],
+					    STACK_SIZE, urgent_entry,
+					    (void *)urgent, NULL, NULL,
+					    K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+
+	k_busy_wait(DELAY_US);
+
+	zassert_true(tinfo[urgent].executed == 1,
+		     "high priority thread waited behind spinning threads");
+
+	spin_stop = true;
+	abort_threads(THREADS_NUM);
+	cleanup_resources();
+}
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -445,7 +552,9 @@ void test_main(void)
 			 ztest_unit_test(test_preempt_resched_threads),
 			 ztest_unit_test(test_yield_threads),
 			 ztest_unit_test(test_sleep_threads),
-			 ztest_unit_test(test_wakeup_threads)
+			 ztest_unit_test(test_wakeup_threads),
+			 ztest_unit_test(test_cpu_mask_pinning),
+			 ztest_unit_test(test_prio_over_busy_cpus)
 			 );
 	ztest_run_test_suite(smp);
 }
@@ -34,6 +34,12 @@ static struct k_timer status_timer;
 static struct k_timer status_anytime_timer;
 static struct k_timer status_sync_timer;
 static struct k_timer remain_timer;
+#ifdef CONFIG_TIMEOUT_SLACK
+static struct k_timer slack_timer;
+static struct k_timer exact_timer;
+
+static ZTEST_BMEM s64_t slack_stamp, exact_stamp;
+#endif
 
 static ZTEST_BMEM struct timer_data tdata;
 
@@ -533,6 +539,60 @@ void test_timer_remaining_get(void)
 	zassert_true(remaining <= (DURATION / 2) + __ticks_to_ms(1), NULL);
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+static void slack_expire(struct k_timer *timer)
+{
+	slack_stamp = k_uptime_get();
+}
+
+static void exact_expire(struct k_timer *timer)
+{
+	exact_stamp = k_uptime_get();
+}
+
+/**
+ * @brief Test timer expiry with slack
+ *
+ * Starts a timer with a slack window that covers the expiry of a second
+ * timer started without slack.  The first timer must expire within its
+ * window, and on tickless kernels it must expire together with the
+ * second one, in the same clock interrupt.
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_timer_start_slack()
+ */
+void test_timer_slack(void)
+{
+	s64_t start;
+
+	slack_stamp = 0;
+	exact_stamp = 0;
+
+	tick_sync();
+	start = k_uptime_get();
+	k_timer_start_slack(&slack_timer, DURATION, 0, DURATION);
+	k_timer_start(&exact_timer, DURATION + PERIOD, 0);
+	busy_wait_ms(2 * DURATION + PERIOD);
+
+	zassert_true(WITHIN_ERROR(slack_stamp - start, DURATION,
+				  DURATION + __ticks_to_ms(1)), NULL);
+	zassert_true(exact_stamp - start >= DURATION + PERIOD, NULL);
+	if (IS_ENABLED(CONFIG_TICKLESS_KERNEL)) {
+		zassert_equal(slack_stamp, exact_stamp,
+			      "timer expiries were not coalesced");
+	}
+
+	k_timer_stop(&slack_timer);
+	k_timer_stop(&exact_timer);
+}
+#else
+void test_timer_slack(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 static void timer_init(struct k_timer *timer, k_timer_expiry_t expiry_fn,
 		       k_timer_stop_t stop_fn)
 {
@@ -551,6 +611,10 @@ void test_main(void)
 	timer_init(&status_anytime_timer, NULL, NULL);
 	timer_init(&status_sync_timer, duration_expire, duration_stop);
 	timer_init(&remain_timer, NULL, NULL);
+#ifdef CONFIG_TIMEOUT_SLACK
+	timer_init(&slack_timer, slack_expire, NULL);
+	timer_init(&exact_timer, exact_expire, NULL);
+#endif
 
 	k_thread_access_grant(k_current_get(), &ktimer, &timer0, &timer1,
 			      &timer2, &timer3, &timer4);
@@ -565,6 +629,7 @@ void test_main(void)
 			 ztest_user_unit_test(test_timer_status_sync),
 			 ztest_user_unit_test(test_timer_k_define),
 			 ztest_user_unit_test(test_timer_user_data),
-			 ztest_user_unit_test(test_timer_remaining_get));
+			 ztest_user_unit_test(test_timer_remaining_get),
+			 ztest_user_unit_test(test_timer_slack));
 	ztest_run_test_suite(timer_api);
 }
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @defgroup kernel_work_pool_tests Work Pools
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#include <ztest.h>
+
+#define NUM_WORKERS 2
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_ITEMS 8
+#define TIMEOUT 500
+
+K_WORK_POOL_DEFINE(pool, NUM_WORKERS, STACK_SIZE);
+
+static struct k_work items[NUM_ITEMS];
+static int order[NUM_ITEMS];
+static atomic_t done;
+static atomic_t running;
+static atomic_t max_running;
+static k_tid_t ran_on[NUM_ITEMS];
+static K_SEM_DEFINE(done_sema, 0, NUM_ITEMS);
+static K_SEM_DEFINE(block_sema, 0, 1);
+
+static int item_index(struct k_work *work)
+{
+	return work - items;
+}
+
+static void reset(k_work_handler_t handler)
+{
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_init(&items[i], handler);
+		ran_on[i] = NULL;
+	}
+	atomic_clear(&done);
+	atomic_clear(&running);
+	atomic_clear(&max_running);
+	k_sem_reset(&done_sema);
+}
+
+static void wait_all(void)
+{
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		zassert_equal(k_sem_take(&done_sema, TIMEOUT), 0,
+			      "work item not run");
+	}
+}
+
+static void simple_handler(struct k_work *work)
+{
+	ran_on[item_index(work)] = k_current_get();
+	k_sem_give(&done_sema);
+}
+
+static void ordered_handler(struct k_work *work)
+{
+	atomic_val_t now = atomic_inc(&running) + 1;
+
+	if (now > atomic_get(&max_running)) {
+		atomic_set(&max_running, now);
+	}
+
+	/* give another worker the chance to run something concurrently */
+	k_sleep(2);
+
+	order[atomic_inc(&done)] = item_index(work);
+	atomic_dec(&running);
+	k_sem_give(&done_sema);
+}
+
+static void blocking_handler(struct k_work *work)
+{
+	k_sem_take(&block_sema, K_FOREVER);
+	k_sem_give(&done_sema);
+}
+
+/**
+ * @brief Test that every submitted item is run exactly once
+ * @see k_work_pool_submit()
+ */
+void test_work_pool_submit(void)
+{
+	reset(simple_handler);
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_pool_submit(&pool, &items[i]);
+		/* already pending: no effect */
+		k_work_pool_submit(&pool, &items[i]);
+	}
+
+	wait_all();
+	zassert_equal(k_sem_take(&done_sema, 50), -EAGAIN,
+		      "work item run twice");
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		zassert_false(k_work_pending(&items[i]), NULL);
+	}
+}
+
+/**
+ * @brief Test that pinned items only run on their worker
+ * @see k_work_pool_submit_to_worker()
+ */
+void test_work_pool_affinity(void)
+{
+	reset(simple_handler);
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_pool_submit_to_worker(&pool, &items[i],
+					     i % NUM_WORKERS);
+	}
+
+	wait_all();
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		zassert_equal(ran_on[i],
+			      &pool.workers[i % NUM_WORKERS].thread,
+			      "item %d ran on the wrong worker", i);
+	}
+}
+
+/**
+ * @brief Test that ordered items run one at a time, in order
+ * @see k_work_pool_submit_ordered()
+ */
+void test_work_pool_ordered(void)
+{
+	reset(ordered_handler);
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_pool_submit_ordered(&pool, &items[i]);
+	}
+
+	wait_all();
+
+	zassert_equal(atomic_get(&max_running), 1,
+		      "ordered items ran concurrently");
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		zassert_equal(order[i], i, "ordered items out of order");
+	}
+}
+
+/**
+ * @brief Test that a blocked handler doesn't stall other items
+ * @see k_work_pool_submit()
+ */
+void test_work_pool_steal(void)
+{
+	reset(simple_handler);
+	k_work_init(&items[0], blocking_handler);
+
+	/* both go to the same worker's queue, which blocks in the first
+	 * handler: the second one has to be stolen
+	 */
+	k_work_pool_submit_to_worker(&pool, &items[0], 0);
+	k_sleep(10);
+	for (int i = 1; i < NUM_ITEMS; i++) {
+		k_work_pool_submit(&pool, &items[i]);
+	}
+
+	for (int i = 1; i < NUM_ITEMS; i++) {
+		zassert_equal(k_sem_take(&done_sema, TIMEOUT), 0,
+			      "work item stalled behind a blocked handler");
+	}
+	for (int i = 1; i < NUM_ITEMS; i++) {
+		zassert_equal(ran_on[i], &pool.workers[1].thread, NULL);
+	}
+
+	k_sem_give(&block_sema);
+	zassert_equal(k_sem_take(&done_sema, TIMEOUT), 0, NULL);
+}
+
+void test_main(void)
+{
+	k_work_pool_start(&pool, K_PRIO_PREEMPT(1));
+
+	ztest_test_suite(work_pool,
+			 ztest_unit_test(test_work_pool_submit),
+			 ztest_unit_test(test_work_pool_affinity),
+			 ztest_unit_test(test_work_pool_ordered),
+			 ztest_unit_test(test_work_pool_steal));
+	ztest_run_test_suite(work_pool);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <sys/sys_heap.h>
+
+#define BLK_SZ 100
+#define BLK_NUM 32
+
+#define BIG_HEAP_SZ 32768
+#define N_SLOTS 256
+#define N_ITERATIONS 20000
+
+static char __aligned(8) heapmem[SYS_HEAP_BUF_SIZE(BLK_SZ, BLK_NUM)];
+static char __aligned(8) bigheapmem[BIG_HEAP_SZ];
+
+static void *slots[N_SLOTS];
+
+/* Trivial deterministic PRNG, so failures are reproducible */
+static u32_t rand32(void)
+{
+	static u64_t state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ULL + 3037000493ULL;
+
+	return (u32_t)(state >> 32);
+}
+
+/**
+ * @brief Test that a heap sized with SYS_HEAP_BUF_SIZE() holds exactly
+ * the number of blocks it was sized for
+ */
+void test_heap_sizing(void)
+{
+	struct sys_heap heap;
+
+	sys_heap_init(&heap, heapmem, sizeof(heapmem));
+	zassert_true(sys_heap_validate(&heap), "invalid heap after init");
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		slots[i] = sys_heap_alloc(&heap, BLK_SZ);
+		zassert_not_null(slots[i], "allocation %d failed", i);
+		zassert_false((uintptr_t)slots[i] & 7, "misaligned block");
+		zassert_true(sys_heap_usable_size(&heap, slots[i]) >= BLK_SZ,
+			     "block too small");
+		(void)memset(slots[i], 0xa5, BLK_SZ);
+	}
+	zassert_true(sys_heap_validate(&heap), "invalid heap when full");
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		sys_heap_free(&heap, slots[i]);
+	}
+	zassert_true(sys_heap_validate(&heap), "invalid heap after free");
+}
+
+/**
+ * @brief Test that corner case requests fail cleanly
+ */
+void test_heap_bad_requests(void)
+{
+	struct sys_heap heap;
+
+	sys_heap_init(&heap, heapmem, sizeof(heapmem));
+
+	zassert_is_null(sys_heap_alloc(&heap, 0), "zero size allocated");
+	zassert_is_null(sys_heap_alloc(&heap, sizeof(heapmem)),
+			"oversized allocation succeeded");
+	zassert_is_null(sys_heap_alloc(&heap, (size_t)-1),
+			"huge allocation succeeded");
+
+	/* Freeing NULL is a no-op */
+	sys_heap_free(&heap, NULL);
+	zassert_true(sys_heap_validate(&heap), "invalid heap");
+}
+
+/**
+ * @brief Test that freed neighbors are coalesced immediately
+ *
+ * Fills the heap with small blocks, frees them in an interleaved
+ * order and checks that the whole heap is then available again as a
+ * single block.
+ */
+void test_heap_coalesce(void)
+{
+	struct sys_heap heap;
+	void *big;
+	int n;
+
+	sys_heap_init(&heap, bigheapmem, sizeof(bigheapmem));
+
+	big = sys_heap_alloc(&heap, BIG_HEAP_SZ / 2);
+	zassert_not_null(big, "big allocation failed");
+	sys_heap_free(&heap, big);
+
+	for (n = 0; n < N_SLOTS; n++) {
+		slots[n] = sys_heap_alloc(&heap, 24);
+		if (slots[n] == NULL) {
+			break;
+		}
+	}
+
+	for (int i = 0; i < n; i += 2) {
+		sys_heap_free(&heap, slots[i]);
+	}
+	zassert_true(sys_heap_validate(&heap), "invalid heap");
+	for (int i = 1; i < n; i += 2) {
+		sys_heap_free(&heap, slots[i]);
+	}
+	zassert_true(sys_heap_validate(&heap), "invalid heap");
+
+	big = sys_heap_alloc(&heap, BIG_HEAP_SZ / 2);
+	zassert_not_null(big, "heap was not coalesced");
+	sys_heap_free(&heap, big);
+}
+
+/**
+ * @brief Random alloc/free stress, validating the heap and the
+ * contents of every live block as it goes
+ */
+void test_heap_stress(void)
+{
+	struct sys_heap heap;
+	size_t sizes[N_SLOTS] = { 0 };
+
+	sys_heap_init(&heap, bigheapmem, sizeof(bigheapmem));
+	(void)memset(slots, 0, sizeof(slots));
+
+	for (int i = 0; i < N_ITERATIONS; i++) {
+		u32_t r = rand32();
+		int s = r % N_SLOTS;
+
+		if (slots[s] == NULL) {
+			sizes[s] = 1 + ((r >> 8) % 512);
+			slots[s] = sys_heap_alloc(&heap, sizes[s]);
+			if (slots[s] != NULL) {
+				(void)memset(slots[s], s, sizes[s]);
+			}
+		} else {
+			u8_t *p = slots[s];
+
+			for (size_t j = 0; j < sizes[s]; j++) {
+				zassert_equal(p[j], (u8_t)s,
+					      "block %d corrupted", s);
+			}
+			sys_heap_free(&heap, slots[s]);
+			slots[s] = NULL;
+		}
+
+		if ((i % 1000) == 0) {
+			zassert_true(sys_heap_validate(&heap),
+				     "invalid heap at iteration %d", i);
+		}
+	}
+
+	for (int s = 0; s < N_SLOTS; s++) {
+		sys_heap_free(&heap, slots[s]);
+	}
+	zassert_true(sys_heap_validate(&heap), "invalid heap");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lib_heap_test,
+			 ztest_unit_test(test_heap_sizing),
+			 ztest_unit_test(test_heap_bad_requests),
+			 ztest_unit_test(test_heap_coalesce),
+			 ztest_unit_test(test_heap_stress)
+			 );
+
+	ztest_run_test_suite(lib_heap_test);
+}
@@ -378,6 +378,115 @@ done:
 	return result;
 }
 
+static int check_options(const struct coap_packet *cpkt, u16_t code,
+			 const char * const *values, int expected)
+{
+	struct coap_option options[8] = {};
+	int i, count;
+
+	count = coap_find_options(cpkt, code, options, ARRAY_SIZE(options));
+	if (count != expected) {
+		TC_PRINT("Unexpected number of options %u (%d)\n",
+			 code, count);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (options[i].len != strlen(values[i]) ||
+		    memcmp(options[i].value, values[i], options[i].len)) {
+			TC_PRINT("Option %u value doesn't match\n", code);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/* More options than CONFIG_COAP_OPTION_INDEX_SIZE when the index is small */
+static int test_find_many_options(void)
+{
+	static const char * const path[] = { "a", "bb", "ccc", "dddd", "e" };
+	static const char * const query[] = { "q=1", "r=22" };
+	/* Content format 0 is encoded as an empty value */
+	static const char * const format[] = { "" };
+	struct coap_packet cpkt;
+	struct coap_packet parsed;
+	u8_t *data;
+	int result = TC_FAIL;
+	int i, r;
+
+	data = (u8_t *)k_malloc(COAP_BUF_SIZE);
+	if (!data) {
+		goto done;
+	}
+
+	r = coap_packet_init(&cpkt, data, COAP_BUF_SIZE,
+			     1, COAP_TYPE_CON, 0, NULL,
+			     COAP_METHOD_GET, 0x1234);
+	if (r < 0) {
+		TC_PRINT("Could not initialize packet\n");
+		goto done;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(path); i++) {
+		r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					      path[i], strlen(path[i]));
+		if (r < 0) {
+			TC_PRINT("Could not append option\n");
+			goto done;
+		}
+	}
+
+	r = coap_append_option_int(&cpkt, COAP_OPTION_CONTENT_FORMAT, 0);
+	if (r < 0) {
+		TC_PRINT("Could not append option\n");
+		goto done;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(query); i++) {
+		r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_QUERY,
+					      query[i], strlen(query[i]));
+		if (r < 0) {
+			TC_PRINT("Could not append option\n");
+			goto done;
+		}
+	}
+
+	/* Look up options on the built packet and on a parsed copy */
+	if (check_options(&cpkt, COAP_OPTION_URI_PATH, path,
+			  ARRAY_SIZE(path)) ||
+	    check_options(&cpkt, COAP_OPTION_URI_QUERY, query,
+			  ARRAY_SIZE(query)) ||
+	    check_options(&cpkt, COAP_OPTION_ETAG, NULL, 0)) {
+		goto done;
+	}
+
+	r = coap_packet_parse(&parsed, data, cpkt.offset, NULL, 0);
+	if (r) {
+		TC_PRINT("Could not parse packet\n");
+		goto done;
+	}
+
+	if (check_options(&parsed, COAP_OPTION_URI_PATH, path,
+			  ARRAY_SIZE(path)) ||
+	    check_options(&parsed, COAP_OPTION_URI_QUERY, query,
+			  ARRAY_SIZE(query)) ||
+	    check_options(&parsed, COAP_OPTION_IF_MATCH, NULL, 0) ||
+	    check_options(&parsed, COAP_OPTION_CONTENT_FORMAT, format, 1) ||
+	    check_options(&parsed, COAP_OPTION_SIZE1, NULL, 0)) {
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	k_free(data);
+
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 static int test_parse_malformed_opt(void)
 {
 	u8_t opt[] = { 0x55, 0xA5, 0x12, 0x34, 't', 'o', 'k', 'e', 'n',
@@ -1465,6 +1574,7 @@ static const struct {
 	{ "Parse empty PDU test", test_parse_empty_pdu, },
 	{ "Parse empty PDU test no marker", test_parse_empty_pdu_1, },
 	{ "Parse simple PDU test", test_parse_simple_pdu, },
+	{ "Find many options test", test_find_many_options, },
 	{ "Parse malformed option", test_parse_malformed_opt },
 	{ "Parse malformed option length", test_parse_malformed_opt_len },
 	{ "Parse malformed option ext", test_parse_malformed_opt_ext },
@@ -26,6 +26,10 @@ LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+#include "dns_cache.h"
+#endif
+
 #if defined(CONFIG_DNS_RESOLVER_LOG_LEVEL_DBG)
 #define DBG(fmt, ...) printk(fmt, ##__VA_ARGS__)
 #else
@@ -36,6 +40,9 @@ LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #define NAME6 "6.zephyr.test"
 #define NAME_IPV4 "192.0.2.1"
 #define NAME_IPV6 "2001:db8::1"
+#define NAME_CACHED "cached.zephyr.test"
+#define NAME_CACHED_UPPER "CACHED.Zephyr.Test"
+#define NAME_NX "nx.zephyr.test"
 
 #define DNS_TIMEOUT 500 /* ms */
 
@@ -750,6 +757,106 @@ static void dns_query_ipv6_numeric(void)
 }
 #endif
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_query_cached(void)
+{
+	struct expected_addr_status status = {
+		.status1 = DNS_EAI_INPROGRESS,
+		.status2 = DNS_EAI_ALLDONE,
+		.caller = __func__,
+	};
+	u8_t addrs[1][DNS_CACHE_ADDR_LEN];
+	int ret;
+
+	memcpy(addrs[0], &my_addr2, sizeof(my_addr2));
+	dns_cache_add(NAME_CACHED, DNS_QUERY_TYPE_A, addrs, 1, 60);
+
+	/* Names differing only in case are the same */
+	ret = dns_get_addr_info(NAME_CACHED_UPPER,
+				DNS_QUERY_TYPE_A,
+				&current_dns_id,
+				dns_result_numeric_cb,
+				&status,
+				DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot create cached query");
+	zassert_equal(current_dns_id, 0, "Query was sent");
+
+	/* A cached answer is given before returning */
+	zassert_equal(k_sem_take(&wait_data2, K_NO_WAIT), 0,
+		      "No address from the cache");
+	zassert_equal(k_sem_take(&wait_data2, K_NO_WAIT), 0,
+		      "No end of results from the cache");
+
+	ret = dns_cache_find(NAME_CACHED, DNS_QUERY_TYPE_AAAA, addrs, 1);
+	zassert_equal(ret, -ENOENT, "Answer cached for the wrong type");
+}
+
+static void dns_query_cached_negative(void)
+{
+	struct expected_addr_status status = {
+		.status1 = DNS_EAI_NODATA,
+		.status2 = DNS_EAI_NODATA,
+		.caller = __func__,
+	};
+	int ret;
+
+	dns_cache_add(NAME_NX, DNS_QUERY_TYPE_A, NULL, 0, 60);
+
+	ret = dns_get_addr_info(NAME_NX,
+				DNS_QUERY_TYPE_A,
+				&current_dns_id,
+				dns_result_numeric_cb,
+				&status,
+				DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot create cached query");
+
+	zassert_equal(k_sem_take(&wait_data2, K_NO_WAIT), 0,
+		      "No name error from the cache");
+}
+
+static void dns_query_cache_expire(void)
+{
+	u8_t addrs[1][DNS_CACHE_ADDR_LEN];
+	int ret;
+
+	memcpy(addrs[0], &my_addr2, sizeof(my_addr2));
+
+	/* A TTL of 0 means the answer must not be cached */
+	dns_cache_add(NAME4, DNS_QUERY_TYPE_A, addrs, 1, 0);
+	ret = dns_cache_find(NAME4, DNS_QUERY_TYPE_A, addrs, 1);
+	zassert_equal(ret, -ENOENT, "Answer with TTL 0 cached");
+
+	dns_cache_add(NAME4, DNS_QUERY_TYPE_A, addrs, 1, 1);
+	ret = dns_cache_find(NAME4, DNS_QUERY_TYPE_A, addrs, 1);
+	zassert_equal(ret, 1, "Answer not cached");
+
+	k_sleep(K_SECONDS(1));
+
+	ret = dns_cache_find(NAME4, DNS_QUERY_TYPE_A, addrs, 1);
+	zassert_equal(ret, -ENOENT, "Answer kept after its TTL");
+
+	dns_resolve_cache_flush();
+
+	ret = dns_cache_find(NAME_CACHED, DNS_QUERY_TYPE_A, addrs, 1);
+	zassert_equal(ret, -ENOENT, "Answer kept after flush");
+}
+#else
+static void dns_query_cached(void)
+{
+	ztest_test_skip();
+}
+
+static void dns_query_cached_negative(void)
+{
+	ztest_test_skip();
+}
+
+static void dns_query_cache_expire(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 void test_main(void)
 {
 	ztest_test_suite(dns_tests,
@@ -767,7 +874,10 @@ void test_main(void)
 			 ztest_unit_test(dns_query_ipv4_cancel),
 			 ztest_unit_test(dns_query_ipv6_cancel),
 			 ztest_unit_test(dns_query_ipv4),
-			 ztest_unit_test(dns_query_ipv4_numeric));
+			 ztest_unit_test(dns_query_ipv4_numeric),
+			 ztest_unit_test(dns_query_cached),
+			 ztest_unit_test(dns_query_cached_negative),
+			 ztest_unit_test(dns_query_cache_expire));
 
 	ztest_run_test_suite(dns_tests);
 }
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2019 Foundries.io
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+/* Vendor specific object with one resource of each data type */
+#define TEST_OBJ_ID		32769
+#define MAX_INSTANCE_COUNT	2
+
+#define RES_OPAQUE	0
+#define RES_STRING	1
+#define RES_U8		2
+#define RES_U16		3
+#define RES_U32		4
+#define RES_U64		5
+#define RES_S8		6
+#define RES_S16		7
+#define RES_S32		8
+#define RES_S64		9
+#define RES_BOOL	10
+#define RES_FLOAT32	11
+#define RES_FLOAT64	12
+
+#define TEST_MAX_ID	13
+
+struct test_data {
+	u8_t opaque[8];
+	char string[16];
+	u8_t u8;
+	u16_t u16;
+	u32_t u32;
+	u64_t u64;
+	s8_t s8;
+	s16_t s16;
+	s32_t s32;
+	s64_t s64;
+	bool b;
+	float32_value_t f32;
+	float64_value_t f64;
+};
+
+static struct test_data data[MAX_INSTANCE_COUNT];
+
+static struct lwm2m_engine_obj test_obj;
+static struct lwm2m_engine_obj_field fields[] = {
+	OBJ_FIELD_DATA(RES_OPAQUE, RW, OPAQUE),
+	OBJ_FIELD_DATA(RES_STRING, RW, STRING),
+	OBJ_FIELD_DATA(RES_U8, RW, U8),
+	OBJ_FIELD_DATA(RES_U16, RW, U16),
+	OBJ_FIELD_DATA(RES_U32, RW, U32),
+	OBJ_FIELD_DATA(RES_U64, RW, U64),
+	OBJ_FIELD_DATA(RES_S8, RW, S8),
+	OBJ_FIELD_DATA(RES_S16, RW, S16),
+	OBJ_FIELD_DATA(RES_S32, RW, S32),
+	OBJ_FIELD_DATA(RES_S64, RW, S64),
+	OBJ_FIELD_DATA(RES_BOOL, RW, BOOL),
+	OBJ_FIELD_DATA(RES_FLOAT32, RW, FLOAT32),
+	OBJ_FIELD_DATA(RES_FLOAT64, RW, FLOAT64),
+};
+
+static struct lwm2m_engine_obj_inst inst[MAX_INSTANCE_COUNT];
+static struct lwm2m_engine_res_inst res[MAX_INSTANCE_COUNT][TEST_MAX_ID];
+
+static struct lwm2m_engine_obj_inst *test_obj_create(u16_t obj_inst_id)
+{
+	struct test_data *d;
+	int index, i = 0;
+
+	for (index = 0; index < MAX_INSTANCE_COUNT; index++) {
+		if (!inst[index].obj) {
+			break;
+		}
+	}
+
+	if (index >= MAX_INSTANCE_COUNT) {
+		return NULL;
+	}
+
+	d = &data[index];
+	(void)memset(d, 0, sizeof(*d));
+
+	INIT_OBJ_RES_DATA(res[index], i, RES_OPAQUE,
+			  d->opaque, sizeof(d->opaque));
+	INIT_OBJ_RES_DATA(res[index], i, RES_STRING,
+			  d->string, sizeof(d->string));
+	INIT_OBJ_RES_DATA(res[index], i, RES_U8, &d->u8, sizeof(d->u8));
+	INIT_OBJ_RES_DATA(res[index], i, RES_U16, &d->u16, sizeof(d->u16));
+	INIT_OBJ_RES_DATA(res[index], i, RES_U32, &d->u32, sizeof(d->u32));
+	INIT_OBJ_RES_DATA(res[index], i, RES_U64, &d->u64, sizeof(d->u64));
+	INIT_OBJ_RES_DATA(res[index], i, RES_S8, &d->s8, sizeof(d->s8));
+	INIT_OBJ_RES_DATA(res[index], i, RES_S16, &d->s16, sizeof(d->s16));
+	INIT_OBJ_RES_DATA(res[index], i, RES_S32, &d->s32, sizeof(d->s32));
+	INIT_OBJ_RES_DATA(res[index], i, RES_S64, &d->s64, sizeof(d->s64));
+	INIT_OBJ_RES_DATA(res[index], i, RES_BOOL, &d->b, sizeof(d->b));
+	INIT_OBJ_RES_DATA(res[index], i, RES_FLOAT32, &d->f32,
+			  sizeof(d->f32));
+	INIT_OBJ_RES_DATA(res[index], i, RES_FLOAT64, &d->f64,
+			  sizeof(d->f64));
+
+	inst[index].resources = res[index];
+	inst[index].resource_count = i;
+
+	return &inst[index];
+}
+
+static struct test_data *data_of(u16_t obj_inst_id)
+{
+	for (int index = 0; index < MAX_INSTANCE_COUNT; index++) {
+		if (inst[index].obj && inst[index].obj_inst_id == obj_inst_id) {
+			return &data[index];
+		}
+	}
+
+	return NULL;
+}
+
+static char *res_path(u16_t obj_inst_id, u16_t res_id)
+{
+	static char buf[sizeof("65535/65535/65535")];
+
+	snprintk(buf, sizeof(buf), "%u/%u/%u", TEST_OBJ_ID, obj_inst_id,
+		 res_id);
+
+	return buf;
+}
+
+static struct lwm2m_obj_path parse(u16_t obj_inst_id, u16_t res_id)
+{
+	struct lwm2m_obj_path path;
+
+	zassert_equal(lwm2m_engine_parse_path(res_path(obj_inst_id, res_id),
+					      &path), 0,
+		      "Failed to parse path");
+
+	return path;
+}
+
+static void test_create_obj_inst(void)
+{
+	char path[sizeof("65535/65535")];
+	int i;
+
+	test_obj.obj_id = TEST_OBJ_ID;
+	test_obj.fields = fields;
+	test_obj.field_count = ARRAY_SIZE(fields);
+	test_obj.max_instance_count = MAX_INSTANCE_COUNT;
+	test_obj.create_cb = test_obj_create;
+	lwm2m_register_obj(&test_obj);
+
+	for (i = 0; i < MAX_INSTANCE_COUNT; i++) {
+		snprintk(path, sizeof(path), "%u/%u", TEST_OBJ_ID, i);
+		zassert_equal(lwm2m_engine_create_obj_inst(path), 0,
+			      "Failed to create instance %d", i);
+	}
+
+	/* A third instance is more than the object allows */
+	zassert_equal(lwm2m_engine_create_obj_inst(path), -ENOMEM,
+		      "Created too many instances");
+	zassert_true(lwm2m_delete_obj_inst(TEST_OBJ_ID, 7) == -ENOENT,
+		     "Deleted an instance that does not exist");
+	zassert_true(lwm2m_delete_obj_inst(TEST_OBJ_ID + 1, 0) == -ENOENT,
+		     "Deleted an instance of an unknown object");
+}
+
+static void test_parse_path(void)
+{
+	struct lwm2m_obj_path path;
+	char full[] = "/32769/1/12/3";
+	char obj_only[] = "32769";
+	char obj_inst[] = "32769/1";
+
+	zassert_equal(lwm2m_engine_parse_path(full, &path), 0,
+		      "Failed to parse path");
+	zassert_true(path.obj_id == TEST_OBJ_ID && path.obj_inst_id == 1U &&
+		     path.res_id == 12U && path.res_inst_id == 3U &&
+		     path.level == 4U, "Wrong path");
+
+	zassert_equal(lwm2m_engine_parse_path(obj_only, &path), -EINVAL,
+		      "Accepted object path");
+	zassert_equal(lwm2m_engine_parse_path(obj_inst, &path), -EINVAL,
+		      "Accepted object instance path");
+}
+
+static void test_set_by_string(void)
+{
+	struct test_data *d = data_of(0);
+	float32_value_t f32 = { 1, 500000 };
+	float64_value_t f64 = { -2, 250000000 };
+	char opaque[] = { 1, 2, 3, 4 };
+
+	zassert_not_null(d, "No instance 0");
+
+	zassert_equal(lwm2m_engine_set_opaque(res_path(0, RES_OPAQUE), opaque,
+					      sizeof(opaque)), 0, "opaque");
+	zassert_equal(lwm2m_engine_set_string(res_path(0, RES_STRING),
+					      "zero"), 0, "string");
+	zassert_equal(lwm2m_engine_set_u8(res_path(0, RES_U8), 8U), 0, "u8");
+	zassert_equal(lwm2m_engine_set_u16(res_path(0, RES_U16), 16U), 0,
+		      "u16");
+	zassert_equal(lwm2m_engine_set_u32(res_path(0, RES_U32), 32U), 0,
+		      "u32");
+	zassert_equal(lwm2m_engine_set_u64(res_path(0, RES_U64), 64U), 0,
+		      "u64");
+	zassert_equal(lwm2m_engine_set_s8(res_path(0, RES_S8), -8), 0, "s8");
+	zassert_equal(lwm2m_engine_set_s16(res_path(0, RES_S16), -16), 0,
+		      "s16");
+	zassert_equal(lwm2m_engine_set_s32(res_path(0, RES_S32), -32), 0,
+		      "s32");
+	zassert_equal(lwm2m_engine_set_s64(res_path(0, RES_S64), -64), 0,
+		      "s64");
+	zassert_equal(lwm2m_engine_set_bool(res_path(0, RES_BOOL), true), 0,
+		      "bool");
+	zassert_equal(lwm2m_engine_set_float32(res_path(0, RES_FLOAT32),
+					       &f32), 0, "float32");
+	zassert_equal(lwm2m_engine_set_float64(res_path(0, RES_FLOAT64),
+					       &f64), 0, "float64");
+
+	zassert_mem_equal(d->opaque, opaque, sizeof(opaque), "opaque");
+	zassert_true(strcmp(d->string, "zero") == 0, "string");
+	zassert_true(d->u8 == 8U && d->u16 == 16U && d->u32 == 32U &&
+		     d->u64 == 64U, "unsigned");
+	zassert_true(d->s8 == -8 && d->s16 == -16 && d->s32 == -32 &&
+		     d->s64 == -64, "signed");
+	zassert_true(d->b, "bool");
+	zassert_true(d->f32.val1 == 1 && d->f32.val2 == 500000, "float32");
+	zassert_true(d->f64.val1 == -2 && d->f64.val2 == 250000000,
+		     "float64");
+
+	/* The other instance is left alone */
+	zassert_true(data_of(1)->u8 == 0U, "Set the wrong instance");
+}
+
+static void test_set_by_path(void)
+{
+	struct test_data *d = data_of(1);
+	float32_value_t f32 = { 3, 250000 };
+	float64_value_t f64 = { 4, 125000000 };
+	char opaque[] = { 5, 6, 7, 8, 9, 10, 11, 12 };
+	struct lwm2m_obj_path path;
+
+	zassert_not_null(d, "No instance 1");
+
+	path = parse(1, RES_OPAQUE);
+	zassert_equal(lwm2m_engine_set_opaque_by_path(&path, opaque,
+						      sizeof(opaque)), 0,
+		      "opaque");
+	path = parse(1, RES_STRING);
+	zassert_equal(lwm2m_engine_set_string_by_path(&path, "one"), 0,
+		      "string");
+	path = parse(1, RES_U8);
+	zassert_equal(lwm2m_engine_set_u8_by_path(&path, 0xf8), 0, "u8");
+	path = parse(1, RES_U16);
+	zassert_equal(lwm2m_engine_set_u16_by_path(&path, 0xf16), 0, "u16");
+	path = parse(1, RES_U32);
+	zassert_equal(lwm2m_engine_set_u32_by_path(&path, 0xf0000032), 0,
+		      "u32");
+	path = parse(1, RES_U64);
+	zassert_equal(lwm2m_engine_set_u64_by_path(&path,
+						   0xf000000000000064ULL), 0,
+		      "u64");
+	path = parse(1, RES_S8);
+	zassert_equal(lwm2m_engine_set_s8_by_path(&path, 8), 0, "s8");
+	path = parse(1, RES_S16);
+	zassert_equal(lwm2m_engine_set_s16_by_path(&path, -1600), 0, "s16");
+	path = parse(1, RES_S32);
+	zassert_equal(lwm2m_engine_set_s32_by_path(&path, -320000), 0, "s32");
+	path = parse(1, RES_S64);
+	zassert_equal(lwm2m_engine_set_s64_by_path(&path, -6400000000LL), 0,
+		      "s64");
+	path = parse(1, RES_BOOL);
+	zassert_equal(lwm2m_engine_set_bool_by_path(&path, true), 0, "bool");
+	path = parse(1, RES_FLOAT32);
+	zassert_equal(lwm2m_engine_set_float32_by_path(&path, &f32), 0,
+		      "float32");
+	path = parse(1, RES_FLOAT64);
+	zassert_equal(lwm2m_engine_set_float64_by_path(&path, &f64), 0,
+		      "float64");
+
+	zassert_mem_equal(d->opaque, opaque, sizeof(opaque), "opaque");
+	zassert_true(strcmp(d->string, "one") == 0, "string");
+	zassert_true(d->u8 == 0xf8 && d->u16 == 0xf16 &&
+		     d->u32 == 0xf0000032 && d->u64 == 0xf000000000000064ULL,
+		     "unsigned");
+	zassert_true(d->s8 == 8 && d->s16 == -1600 && d->s32 == -320000 &&
+		     d->s64 == -6400000000LL, "signed");
+	zassert_true(d->b, "bool");
+	zassert_true(d->f32.val1 == 3 && d->f32.val2 == 250000, "float32");
+	zassert_true(d->f64.val1 == 4 && d->f64.val2 == 125000000,
+		     "float64");
+
+	/* Too long for the resource, or not a resource of the object */
+	path = parse(1, RES_STRING);
+	zassert_equal(lwm2m_engine_set_string_by_path(&path,
+						      "sixteen or more chars"),
+		      -ENOMEM, "Accepted a string that does not fit");
+	path = parse(1, TEST_MAX_ID);
+	zassert_equal(lwm2m_engine_set_u8_by_path(&path, 1U), -ENOENT,
+		      "Set an unknown resource");
+
+	/* The other instance is left alone */
+	zassert_true(data_of(0)->u8 == 8U, "Set the wrong instance");
+}
+
+static void test_delete_obj_inst(void)
+{
+	struct lwm2m_obj_path path = parse(1, RES_U8);
+	struct lwm2m_engine_obj_inst *obj_inst;
+	u8_t u8;
+
+	zassert_equal(lwm2m_delete_obj_inst(TEST_OBJ_ID, 1), 0,
+		      "Failed to delete instance");
+
+	/* Both kinds of lookup now miss the deleted instance */
+	zassert_equal(lwm2m_engine_set_u8_by_path(&path, 1U), -ENOENT,
+		      "Set a resource of a deleted instance by path");
+	zassert_equal(lwm2m_engine_set_u8(res_path(1, RES_U8), 1U), -ENOENT,
+		      "Set a resource of a deleted instance");
+	zassert_true(lwm2m_engine_get_u8(res_path(1, RES_U8), &u8) < 0,
+		     "Read a resource of a deleted instance");
+	zassert_equal(lwm2m_delete_obj_inst(TEST_OBJ_ID, 1), -ENOENT,
+		      "Deleted an instance twice");
+
+	/* While the remaining one is still found */
+	zassert_equal(lwm2m_engine_get_u8(res_path(0, RES_U8), &u8), 0,
+		      "Lost instance 0");
+	zassert_equal(u8, 8U, "Wrong value in instance 0");
+	path = parse(0, RES_U8);
+	zassert_equal(lwm2m_engine_set_u8_by_path(&path, 80U), 0,
+		      "Failed to set instance 0 by path");
+	zassert_equal(data_of(0)->u8, 80U, "Wrong value in instance 0");
+
+	/* The slot can be used again, under a new ID */
+	zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, 5, &obj_inst), 0,
+		      "Failed to create instance 5");
+	path = parse(5, RES_U8);
+	zassert_equal(lwm2m_engine_set_u8_by_path(&path, 5U), 0,
+		      "Failed to set new instance by path");
+	zassert_equal(data_of(5)->u8, 5U, "Wrong value in instance 5");
+
+	zassert_equal(lwm2m_delete_obj_inst(TEST_OBJ_ID, 0), 0,
+		      "Failed to delete instance 0");
+	zassert_equal(lwm2m_delete_obj_inst(TEST_OBJ_ID, 5), 0,
+		      "Failed to delete instance 5");
+	zassert_equal(lwm2m_engine_set_u8_by_path(&path, 1U), -ENOENT,
+		      "Set a resource of a deleted instance by path");
+
+	lwm2m_unregister_obj(&test_obj);
+	zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, 0, &obj_inst),
+		      -ENOENT, "Created an instance of an unregistered object");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine,
+			 ztest_unit_test(test_create_obj_inst),
+			 ztest_unit_test(test_parse_path),
+			 ztest_unit_test(test_set_by_string),
+			 ztest_unit_test(test_set_by_path),
+			 ztest_unit_test(test_delete_obj_inst));
+
+	ztest_run_test_suite(lwm2m_engine);
+}
@@ -629,6 +629,192 @@ void test_net_pkt_copy(void)
 		     "Pkt not properly unreferenced");
 }
 
+/* Builds an RX packet whose buffers hold lens[i] bytes each of an
+ * incrementing byte pattern, with headroom reserved in the first one.
+ */
+static struct net_pkt *pkt_with_frags(const size_t *lens, int count,
+				      size_t headroom)
+{
+	struct net_pkt *pkt;
+	u8_t val = 0U;
+
+	pkt = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_true(pkt != NULL, "Pkt not allocated");
+
+	for (int i = 0; i < count; i++) {
+		struct net_buf *frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+
+		zassert_true(frag != NULL, "Frag not allocated");
+
+		if (i == 0) {
+			net_buf_reserve(frag, headroom);
+		}
+
+		for (size_t j = 0; j < lens[i]; j++) {
+			net_buf_add_u8(frag, val++);
+		}
+
+		net_pkt_frag_add(pkt, frag);
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	return pkt;
+}
+
+static void pkt_check_pattern(struct net_pkt *pkt, size_t len)
+{
+	zassert_true(len <= sizeof(small_buffer), "Pattern too long");
+	zassert_true(net_pkt_get_len(pkt) == len, "Wrong length");
+
+	net_pkt_cursor_init(pkt);
+	zassert_true(net_pkt_read(pkt, small_buffer, len) == 0,
+		     "Pkt read failed");
+
+	for (size_t i = 0; i < len; i++) {
+		zassert_true(small_buffer[i] == (u8_t)i,
+			     "Wrong data at %zu", i);
+	}
+}
+
+void test_net_pkt_pullup(void)
+{
+	static const size_t four_frags[] = { 10, 10, 10, 10 };
+	static const size_t two_frags[] = { 20, 40 };
+	static const size_t short_frags[] = { 6, 6 };
+	static const size_t big_frags[] = { 100, 100 };
+	struct net_pkt *pkt;
+	int ret;
+
+	/* Across several buffers: the second and third ones are emptied
+	 * and freed, the fourth one only partly pulled
+	 */
+	pkt = pkt_with_frags(four_frags, ARRAY_SIZE(four_frags), 0);
+
+	ret = net_pkt_pullup(pkt, 35);
+	zassert_true(ret == 0, "Pullup failed");
+	zassert_true(pkt->buffer->len == 35, "Wrong first buffer length");
+	zassert_true(pkt->buffer->frags != NULL &&
+		     pkt->buffer->frags->len == 5 &&
+		     pkt->buffer->frags->frags == NULL,
+		     "Wrong remaining buffers");
+	pkt_check_pattern(pkt, 40);
+
+	/* Already contiguous, nothing moves */
+	ret = net_pkt_pullup(pkt, 20);
+	zassert_true(ret == 0, "Pullup failed");
+	zassert_true(pkt->buffer->len == 35, "First buffer changed");
+
+	net_pkt_unref(pkt);
+
+	/* Not enough tailroom in the first buffer: its headroom has to be
+	 * given back to fit the 60 bytes
+	 */
+	pkt = pkt_with_frags(two_frags, ARRAY_SIZE(two_frags),
+			     CONFIG_NET_BUF_DATA_SIZE - 28);
+	zassert_true(net_buf_tailroom(pkt->buffer) < 40,
+		     "Tailroom should be too short");
+
+	ret = net_pkt_pullup(pkt, 60);
+	zassert_true(ret == 0, "Pullup failed");
+	zassert_true(net_buf_headroom(pkt->buffer) == 0,
+		     "Headroom not reclaimed");
+	zassert_true(pkt->buffer->len == 60 && pkt->buffer->frags == NULL,
+		     "Not pulled into a single buffer");
+	pkt_check_pattern(pkt, 60);
+
+	net_pkt_unref(pkt);
+
+	/* More than the first buffer can ever hold fails and leaves the
+	 * packet as it was
+	 */
+	pkt = pkt_with_frags(big_frags, ARRAY_SIZE(big_frags), 0);
+
+	ret = net_pkt_pullup(pkt, pkt->buffer->size + 1);
+	zassert_true(ret == -ENOBUFS, "Pullup beyond buffer size succeeded");
+	zassert_true(pkt->buffer->len == 100 &&
+		     pkt->buffer->frags->len == 100, "Buffers changed");
+	pkt_check_pattern(pkt, 200);
+
+	net_pkt_unref(pkt);
+
+	/* A packet shorter than asked for is pulled up entirely, and
+	 * reading past its end then fails
+	 */
+	pkt = pkt_with_frags(short_frags, ARRAY_SIZE(short_frags), 0);
+
+	ret = net_pkt_pullup(pkt, 40);
+	zassert_true(ret == 0, "Pullup of short packet failed");
+	zassert_true(pkt->buffer->len == 12 && pkt->buffer->frags == NULL,
+		     "Short packet not pulled up entirely");
+	pkt_check_pattern(pkt, 12);
+
+	net_pkt_cursor_init(pkt);
+	ret = net_pkt_read(pkt, small_buffer, 40);
+	zassert_true(ret == -ENOBUFS, "Read past the end succeeded");
+
+	net_pkt_unref(pkt);
+
+	/* No buffer at all */
+	pkt = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_true(pkt != NULL, "Pkt not allocated");
+	zassert_true(net_pkt_pullup(pkt, 1) == -ENOBUFS,
+		     "Pullup without buffer succeeded");
+	net_pkt_unref(pkt);
+}
+
+void test_net_pkt_read_skip_boundaries(void)
+{
+	static const size_t frags[] = { 10, 10 };
+	struct net_pkt *pkt;
+	u8_t data[10];
+	int ret;
+
+	pkt = pkt_with_frags(frags, ARRAY_SIZE(frags), 0);
+
+	/* Reads ending exactly at the end of a buffer leave the fast
+	 * path, the cursor then moves on to the next buffer
+	 */
+	ret = net_pkt_read(pkt, data, 10);
+	zassert_true(ret == 0, "Pkt read failed");
+	zassert_true(data[0] == 0U && data[9] == 9U, "Wrong data");
+	zassert_true(net_pkt_get_current_offset(pkt) == 10, "Wrong offset");
+
+	ret = net_pkt_read(pkt, data, 1);
+	zassert_true(ret == 0 && data[0] == 10U, "Wrong data after boundary");
+
+	/* Skip up to the very end of the packet */
+	ret = net_pkt_skip(pkt, 9);
+	zassert_true(ret == 0, "Pkt skip failed");
+	zassert_true(net_pkt_get_current_offset(pkt) == 20, "Wrong offset");
+	zassert_true(net_pkt_remaining_data(pkt) == 0, "Data left");
+
+	ret = net_pkt_read(pkt, data, 1);
+	zassert_true(ret == -ENOBUFS, "Read past the end succeeded");
+
+	/* Skip ending on the boundary, then read within the next buffer */
+	net_pkt_cursor_init(pkt);
+
+	ret = net_pkt_skip(pkt, 10);
+	zassert_true(ret == 0, "Pkt skip failed");
+	zassert_true(net_pkt_get_current_offset(pkt) == 10, "Wrong offset");
+
+	ret = net_pkt_read(pkt, data, 9);
+	zassert_true(ret == 0 && data[0] == 10U && data[8] == 18U,
+		     "Wrong data after boundary");
+
+	/* And a read crossing it */
+	net_pkt_cursor_init(pkt);
+	ret = net_pkt_skip(pkt, 8);
+	zassert_true(ret == 0, "Pkt skip failed");
+	ret = net_pkt_read(pkt, data, 4);
+	zassert_true(ret == 0 && data[0] == 8U && data[3] == 11U,
+		     "Wrong data across boundary");
+
+	net_pkt_unref(pkt);
+}
+
 void test_main(void)
 {
 	eth_if = net_if_get_default();
@@ -639,7 +825,9 @@ void test_main(void)
 			 ztest_unit_test(test_net_pkt_basics_of_rw),
 			 ztest_unit_test(test_net_pkt_advanced_basics),
 			 ztest_unit_test(test_net_pkt_easier_rw_usage),
-			 ztest_unit_test(test_net_pkt_copy)
+			 ztest_unit_test(test_net_pkt_copy),
+			 ztest_unit_test(test_net_pkt_pullup),
+			 ztest_unit_test(test_net_pkt_read_skip_boundaries)
 		);
 
 	ztest_run_test_suite(net_pkt_tests);
@@ -468,6 +468,174 @@ static void route_del_many(void)
 	}
 }
 
+/* Nested routes under a default route, added in an order that makes
+ * the trie insert above an existing node and split two /64 siblings
+ * under a glue node.
+ */
+enum {
+	LPM_HOST,
+	LPM_DEFAULT,
+	LPM_64,
+	LPM_64_SIBLING,
+	LPM_48,
+	LPM_ROUTES
+};
+
+static const struct {
+	struct in6_addr addr;
+	u8_t len;
+} lpm_prefixes[LPM_ROUTES] = {
+	[LPM_HOST] = { { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x01, 0, 0x02,
+			     0, 0x03, 0, 0x04, 0, 0x05, 0, 0x06 } } }, 128 },
+	[LPM_DEFAULT] = { { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x05, 0, 0,
+				0, 0, 0, 0, 0, 0, 0, 0x01 } } }, 0 },
+	[LPM_64] = { { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x01, 0, 0x02,
+			   0, 0, 0, 0, 0, 0, 0, 0 } } }, 64 },
+	[LPM_64_SIBLING] = { { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x01, 0, 0x03,
+				   0, 0, 0, 0, 0, 0, 0, 0 } } }, 64 },
+	[LPM_48] = { { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x01, 0, 0,
+			   0, 0, 0, 0, 0, 0, 0, 0 } } }, 48 },
+};
+
+/* 2001:db8:1:2::7, 2001:db8:1:3::1, 2001:db8:1:ffff::1, 2001:db8:2::1 */
+static struct in6_addr lpm_in_64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x01,
+					 0, 0x02, 0, 0, 0, 0, 0, 0, 0,
+					 0x07 } } };
+static struct in6_addr lpm_in_sibling = { { { 0x20, 0x01, 0x0d, 0xb8, 0,
+					      0x01, 0, 0x03, 0, 0, 0, 0, 0,
+					      0, 0, 0x01 } } };
+static struct in6_addr lpm_in_48 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x01,
+					 0xff, 0xff, 0, 0, 0, 0, 0, 0, 0,
+					 0x01 } } };
+static struct in6_addr lpm_outside = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0x02,
+					   0, 0, 0, 0, 0, 0, 0, 0, 0,
+					   0x01 } } };
+
+static struct net_route_entry *lpm_routes[LPM_ROUTES];
+static struct net_route_entry *lpm_peer_route;
+
+static void lpm_check(struct net_if *iface, struct in6_addr *dst,
+		      struct net_route_entry *expected)
+{
+	struct net_route_entry *route;
+
+	route = net_route_lookup(iface, dst);
+	zassert_equal_ptr(route, expected, "Wrong route for %s",
+			  net_sprint_ipv6_addr(dst));
+}
+
+static void route_add_nested(void)
+{
+	struct in6_addr host = lpm_prefixes[LPM_HOST].addr;
+	int i;
+
+	for (i = 0; i < LPM_ROUTES; i++) {
+		struct in6_addr addr = lpm_prefixes[i].addr;
+
+		lpm_routes[i] = net_route_add(my_iface, &addr,
+					      lpm_prefixes[i].len,
+					      &peer_addr);
+		zassert_not_null(lpm_routes[i], "Route add %d failed", i);
+	}
+
+	for (i = 0; i < LPM_ROUTES; i++) {
+		zassert_equal(lpm_routes[i]->prefix_len, lpm_prefixes[i].len,
+			      "Route %d has prefix length %d", i,
+			      lpm_routes[i]->prefix_len);
+	}
+
+	lpm_check(my_iface, &host, lpm_routes[LPM_HOST]);
+	lpm_check(my_iface, &lpm_in_64, lpm_routes[LPM_64]);
+	lpm_check(my_iface, &lpm_in_sibling, lpm_routes[LPM_64_SIBLING]);
+	lpm_check(my_iface, &lpm_in_48, lpm_routes[LPM_48]);
+	lpm_check(my_iface, &lpm_outside, lpm_routes[LPM_DEFAULT]);
+	lpm_check(NULL, &lpm_in_64, lpm_routes[LPM_64]);
+	lpm_check(peer_iface, &lpm_in_64, NULL);
+}
+
+static void route_del_nested(void)
+{
+	struct in6_addr host = lpm_prefixes[LPM_HOST].addr;
+	struct in6_addr addr = lpm_prefixes[LPM_48].addr;
+
+	/* Leaves the /64 siblings hanging off the default route */
+	zassert_false(net_route_del(lpm_routes[LPM_48]), "Route del failed");
+
+	lpm_check(my_iface, &lpm_in_48, lpm_routes[LPM_DEFAULT]);
+	lpm_check(my_iface, &lpm_in_64, lpm_routes[LPM_64]);
+	lpm_check(my_iface, &lpm_in_sibling, lpm_routes[LPM_64_SIBLING]);
+	lpm_check(my_iface, &host, lpm_routes[LPM_HOST]);
+
+	/* Only one /64 is left, so the glue node above it goes too */
+	zassert_false(net_route_del(lpm_routes[LPM_64_SIBLING]),
+		      "Route del failed");
+
+	lpm_check(my_iface, &lpm_in_sibling, lpm_routes[LPM_DEFAULT]);
+	lpm_check(my_iface, &lpm_in_64, lpm_routes[LPM_64]);
+	lpm_check(my_iface, &host, lpm_routes[LPM_HOST]);
+
+	lpm_routes[LPM_48] = net_route_add(my_iface, &addr,
+					   lpm_prefixes[LPM_48].len,
+					   &peer_addr);
+	zassert_not_null(lpm_routes[LPM_48], "Route add failed");
+
+	lpm_check(my_iface, &lpm_in_48, lpm_routes[LPM_48]);
+	lpm_check(my_iface, &lpm_in_sibling, lpm_routes[LPM_48]);
+	lpm_check(my_iface, &lpm_in_64, lpm_routes[LPM_64]);
+	lpm_check(my_iface, &lpm_outside, lpm_routes[LPM_DEFAULT]);
+}
+
+static void route_add_nested_peer(void)
+{
+	struct in6_addr host = lpm_prefixes[LPM_HOST].addr;
+	struct in6_addr addr = lpm_prefixes[LPM_64].addr;
+	struct net_nbr *nbr;
+
+	nbr = net_ipv6_nbr_add(peer_iface, &peer_addr,
+			       &net_route_data_peer.ll_addr, false,
+			       NET_IPV6_NBR_STATE_REACHABLE);
+	zassert_not_null(nbr, "Cannot add peer to neighbor cache");
+
+	/* Same prefix as LPM_64, on the other interface */
+	lpm_peer_route = net_route_add(peer_iface, &addr,
+				       lpm_prefixes[LPM_64].len, &peer_addr);
+	zassert_not_null(lpm_peer_route, "Route add failed");
+	zassert_not_equal(lpm_peer_route, lpm_routes[LPM_64],
+			  "Route of the other interface replaced");
+
+	lpm_check(peer_iface, &lpm_in_64, lpm_peer_route);
+	lpm_check(peer_iface, &host, lpm_peer_route);
+	lpm_check(peer_iface, &lpm_in_48, NULL);
+	lpm_check(my_iface, &lpm_in_64, lpm_routes[LPM_64]);
+	lpm_check(my_iface, &host, lpm_routes[LPM_HOST]);
+
+	zassert_false(net_route_del(lpm_routes[LPM_64]), "Route del failed");
+
+	lpm_check(peer_iface, &lpm_in_64, lpm_peer_route);
+	lpm_check(my_iface, &lpm_in_64, lpm_routes[LPM_48]);
+	lpm_check(my_iface, &host, lpm_routes[LPM_HOST]);
+
+	zassert_false(net_route_del(lpm_peer_route), "Route del failed");
+
+	lpm_check(peer_iface, &lpm_in_64, NULL);
+}
+
+static void route_del_nested_all(void)
+{
+	struct in6_addr host = lpm_prefixes[LPM_HOST].addr;
+
+	zassert_false(net_route_del(lpm_routes[LPM_HOST]), "Route del failed");
+	zassert_false(net_route_del(lpm_routes[LPM_48]), "Route del failed");
+
+	lpm_check(my_iface, &host, lpm_routes[LPM_DEFAULT]);
+
+	zassert_false(net_route_del(lpm_routes[LPM_DEFAULT]),
+		      "Route del failed");
+
+	lpm_check(my_iface, &lpm_outside, NULL);
+	lpm_check(NULL, &lpm_in_64, NULL);
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -487,6 +655,10 @@ void test_main(void)
 			ztest_unit_test(route_del_nexthop_again),
 			ztest_unit_test(populate_nbr_cache),
 			ztest_unit_test(route_add_many),
-			ztest_unit_test(route_del_many));
+			ztest_unit_test(route_del_many),
+			ztest_unit_test(route_add_nested),
+			ztest_unit_test(route_del_nested),
+			ztest_unit_test(route_add_nested_peer),
+			ztest_unit_test(route_del_nested_all));
 	ztest_run_test_suite(test_route);
 }
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <errno.h>
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+static int c_sock;
+static int s_sock;
+
+static void setup_socks(void)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+}
+
+static void close_socks(void)
+{
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+void test_epoll_level(void)
+{
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	u32_t tstamp;
+	ssize_t len;
+	char buf[10];
+	int epfd;
+	int res;
+
+	setup_socks();
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	ev.events = EPOLLIN;
+	ev.data.fd = c_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	ev.data.fd = s_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "adding twice should fail");
+	zassert_equal(errno, EEXIST, "unexpected errno");
+
+	/* Nothing ready */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Only the socket that received something is reported */
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	/* Level triggered: reported again while still readable */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Removed sockets are not reported */
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 0, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, -1, "removing twice should fail");
+	zassert_equal(errno, ENOENT, "unexpected errno");
+
+	/* Closing a registered socket unregisters it */
+	close_socks();
+	zassert_equal(close(epfd), 0, "close failed");
+}
+
+void test_epoll_edge(void)
+{
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	ssize_t len;
+	char buf[10];
+	int epfd;
+	int res;
+
+	setup_socks();
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.u32 = 1234U;
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.u32, 1234U, "");
+
+	/* Edge triggered: not reported again until more data comes */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 1, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	/* Switching to level triggered writability reports it at once */
+	ev.events = EPOLLOUT;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLOUT, "");
+
+	/* Closing the instance first leaves the sockets usable */
+	zassert_equal(close(epfd), 0, "close failed");
+	close_socks();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_level),
+			 ztest_unit_test(test_epoll_edge));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+#include <mbedtls/ssl.h>
+
+#include "../../socket_helpers.h"
+
+#define SERVER_PORT 4243
+/* Not the name in the server certificate, which is localhost */
+#define SERVER_HOSTNAME "server.test"
+
+/* Peer verification levels, as in mbedTLS */
+#define VERIFY_NONE 0
+#define VERIFY_REQUIRED 2
+
+#define SERVER_TAG 1
+#define CLIENT_TAG 2
+#define OTHER_TAG 3
+
+#define STACK_SIZE 4096
+#define SESSION_LEN 2048
+
+/* Whether the server side of this build can resume sessions at all */
+#if defined(MBEDTLS_SSL_CACHE_C) || defined(MBEDTLS_SSL_TICKET_C)
+#define SERVER_RESUMES 1
+#else
+#define SERVER_RESUMES 0
+#endif
+
+static const unsigned char server_certificate[] = {
+#include "echo-apps-cert.der.inc"
+};
+
+static const unsigned char private_key[] = {
+#include "echo-apps-key.der.inc"
+};
+
+static int listen_sock = -1;
+static struct sockaddr_in server_addr;
+
+static K_THREAD_STACK_DEFINE(server_stack, STACK_SIZE);
+static struct k_thread server_thread;
+
+static u8_t session[SESSION_LEN];
+static u8_t other_session[SESSION_LEN];
+
+/* Accept connections until aborted, the TLS handshake is done by
+ * accept(). Failed handshakes are expected, see
+ * test_session_verify_level().
+ */
+static void server_entry(void *p1, void *p2, void *p3)
+{
+	int sock;
+
+	while (true) {
+		sock = accept(listen_sock, NULL, NULL);
+		if (sock >= 0) {
+			close(sock);
+		}
+	}
+}
+
+static int tls_socket(void)
+{
+	int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+
+	zassert_true(sock >= 0, "socket open failed");
+
+	return sock;
+}
+
+/* Client socket with session caching on and the given credentials */
+static int client_socket(sec_tag_t tag, int verify)
+{
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	int sock = tls_socket();
+
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST,
+				 &tag, sizeof(tag)), 0, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_HOSTNAME,
+				 SERVER_HOSTNAME, sizeof(SERVER_HOSTNAME)),
+		      0, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_PEER_VERIFY,
+				 &verify, sizeof(verify)), 0, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &cache, sizeof(cache)), 0, "");
+
+	return sock;
+}
+
+static int client_connect(int sock)
+{
+	return connect(sock, (struct sockaddr *)&server_addr,
+		       sizeof(server_addr));
+}
+
+/* Serialized session of a connected socket, 0 if this mbedTLS cannot
+ * export sessions
+ */
+static socklen_t session_get(int sock, u8_t *buf)
+{
+	socklen_t len = SESSION_LEN;
+
+	if (getsockopt(sock, SOL_TLS, TLS_SESSION, buf, &len) < 0) {
+		zassert_equal(errno, ENOPROTOOPT, "session export failed");
+		return 0;
+	}
+
+	return len;
+}
+
+/* Connect a client and return its serialized session */
+static socklen_t connect_session(sec_tag_t tag, int verify, u8_t *buf)
+{
+	int sock = client_socket(tag, verify);
+	socklen_t len;
+
+	zassert_equal(client_connect(sock), 0, "TLS connect failed (%d)",
+		      errno);
+	len = session_get(sock, buf);
+	zassert_equal(close(sock), 0, "close failed");
+
+	return len;
+}
+
+static bool same_session(u8_t *a, socklen_t a_len, u8_t *b, socklen_t b_len)
+{
+	return a_len == b_len && !memcmp(a, b, a_len);
+}
+
+void test_setup(void)
+{
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	sec_tag_t tag = SERVER_TAG;
+	int ret;
+
+	ret = tls_credential_add(SERVER_TAG, TLS_CREDENTIAL_SERVER_CERTIFICATE,
+				 server_certificate,
+				 sizeof(server_certificate));
+	zassert_equal(ret, 0, "cannot add server certificate");
+	ret = tls_credential_add(SERVER_TAG, TLS_CREDENTIAL_PRIVATE_KEY,
+				 private_key, sizeof(private_key));
+	zassert_equal(ret, 0, "cannot add private key");
+
+	/* The clients trust the self-signed server certificate, under
+	 * two different tags so that their credentials differ
+	 */
+	ret = tls_credential_add(CLIENT_TAG, TLS_CREDENTIAL_CA_CERTIFICATE,
+				 server_certificate,
+				 sizeof(server_certificate));
+	zassert_equal(ret, 0, "cannot add CA certificate");
+	ret = tls_credential_add(OTHER_TAG, TLS_CREDENTIAL_CA_CERTIFICATE,
+				 server_certificate,
+				 sizeof(server_certificate));
+	zassert_equal(ret, 0, "cannot add CA certificate");
+
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	zassert_equal(inet_pton(AF_INET, "127.0.0.1", &server_addr.sin_addr),
+		      1, "inet_pton failed");
+
+	listen_sock = tls_socket();
+	zassert_equal(setsockopt(listen_sock, SOL_TLS, TLS_SEC_TAG_LIST,
+				 &tag, sizeof(tag)), 0, "");
+	zassert_equal(setsockopt(listen_sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &cache, sizeof(cache)), 0, "");
+	zassert_equal(bind(listen_sock, (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)), 0, "bind failed");
+	zassert_equal(listen(listen_sock, 2), 0, "listen failed");
+
+	k_thread_create(&server_thread, server_stack, STACK_SIZE,
+			server_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+}
+
+void test_session_cache_opts(void)
+{
+	int sock = tls_socket();
+	socklen_t len;
+	int val;
+
+	/* TLS_SESSION_CACHE */
+	val = 2;
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &val, sizeof(val)), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &val, 1), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 NULL, sizeof(val)), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	len = sizeof(val);
+	zassert_equal(getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &val, &len), 0, "");
+	zassert_equal(val, TLS_SESSION_CACHE_DISABLED, "cache on by default");
+
+	val = TLS_SESSION_CACHE_ENABLED;
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &val, sizeof(val)), 0, "");
+	val = TLS_SESSION_CACHE_DISABLED;
+	len = sizeof(val);
+	zassert_equal(getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &val, &len), 0, "");
+	zassert_equal(val, TLS_SESSION_CACHE_ENABLED, "cache not enabled");
+
+	len = 1;
+	zassert_equal(getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &val, &len), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* TLS_SESSION_CACHE_PURGE ignores its value */
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE_PURGE,
+				 NULL, 0), 0, "");
+
+	/* TLS_SESSION needs a connected socket to read, and a hostname to
+	 * cache a session under
+	 */
+	len = sizeof(session);
+	zassert_equal(getsockopt(sock, SOL_TLS, TLS_SESSION,
+				 session, &len), -1, "");
+	zassert_true(errno == ENOTCONN || errno == ENOPROTOOPT, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION,
+				 session, sizeof(session)), -1, "");
+	zassert_true(errno == EINVAL || errno == ENOPROTOOPT, "");
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION,
+				 NULL, 0), -1, "");
+	zassert_true(errno == EINVAL || errno == ENOPROTOOPT, "");
+
+	zassert_equal(close(sock), 0, "close failed");
+}
+
+void test_session_store_restore(void)
+{
+	socklen_t len, other_len;
+
+	zassert_equal(setsockopt(listen_sock, SOL_TLS,
+				 TLS_SESSION_CACHE_PURGE, NULL, 0), 0, "");
+
+	/* Full handshake, the session is stored */
+	len = connect_session(CLIENT_TAG, VERIFY_NONE, session);
+
+	/* Same hostname and credentials, the session is offered again */
+	other_len = connect_session(CLIENT_TAG, VERIFY_NONE,
+				    other_session);
+	if (len && SERVER_RESUMES) {
+		zassert_true(same_session(session, len, other_session,
+					  other_len), "session not resumed");
+	}
+
+	/* Other credentials, no session to offer */
+	other_len = connect_session(OTHER_TAG, VERIFY_NONE,
+				    other_session);
+	if (len) {
+		zassert_false(same_session(session, len, other_session,
+					   other_len),
+			      "session resumed with other credentials");
+	}
+}
+
+void test_session_verify_level(void)
+{
+	int sock;
+
+	zassert_equal(setsockopt(listen_sock, SOL_TLS,
+				 TLS_SESSION_CACHE_PURGE, NULL, 0), 0, "");
+
+	(void)connect_session(CLIENT_TAG, VERIFY_NONE, session);
+
+	/* The server certificate does not match the hostname, so this
+	 * connection only succeeds if it resumes the unverified session.
+	 */
+	sock = client_socket(CLIENT_TAG, VERIFY_REQUIRED);
+	zassert_equal(client_connect(sock), -1,
+		      "unverified session resumed by a verifying socket");
+	zassert_equal(close(sock), 0, "close failed");
+}
+
+void test_session_purge(void)
+{
+	socklen_t len, other_len;
+	int sock = tls_socket();
+
+	len = connect_session(CLIENT_TAG, VERIFY_NONE, session);
+
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE_PURGE,
+				 NULL, 0), 0, "");
+	zassert_equal(close(sock), 0, "close failed");
+
+	/* Nothing to offer anymore, a full handshake is done */
+	other_len = connect_session(CLIENT_TAG, VERIFY_NONE,
+				    other_session);
+	if (len) {
+		zassert_false(same_session(session, len, other_session,
+					   other_len),
+			      "purged session resumed");
+	}
+}
+
+void test_session_import(void)
+{
+	socklen_t len, other_len;
+	int sock;
+
+	zassert_equal(setsockopt(listen_sock, SOL_TLS,
+				 TLS_SESSION_CACHE_PURGE, NULL, 0), 0, "");
+
+	len = connect_session(CLIENT_TAG, VERIFY_NONE, session);
+	if (!len) {
+		ztest_test_skip();
+		return;
+	}
+
+	zassert_equal(setsockopt(listen_sock, SOL_TLS,
+				 TLS_SESSION_CACHE_PURGE, NULL, 0), 0, "");
+
+	/* Garbage is refused */
+	sock = client_socket(CLIENT_TAG, VERIFY_NONE);
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION,
+				 other_session, 4), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* An imported session is offered by the next connection */
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION,
+				 session, len), 0, "");
+	zassert_equal(client_connect(sock), 0, "TLS connect failed (%d)",
+		      errno);
+	other_len = session_get(sock, other_session);
+	zassert_equal(close(sock), 0, "close failed");
+
+	if (SERVER_RESUMES) {
+		zassert_true(same_session(session, len, other_session,
+					  other_len), "session not resumed");
+	}
+}
+
+void test_teardown(void)
+{
+	k_thread_abort(&server_thread);
+	zassert_equal(close(listen_sock), 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_tls,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_session_cache_opts),
+			 ztest_unit_test(test_session_store_restore),
+			 ztest_unit_test(test_session_verify_level),
+			 ztest_unit_test(test_session_purge),
+			 ztest_unit_test(test_session_import),
+			 ztest_unit_test(test_teardown));
+
+	ztest_run_test_suite(socket_tls);
+}
@@ -7,6 +7,7 @@
 #include <logging/log.h>
 LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
+#include <errno.h>
 #include <stdio.h>
 #include <ztest_assert.h>
 
@@ -335,6 +336,198 @@ void test_so_priority(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+void test_v4_sendmsg_recvmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr;
+	struct iovec iov[3];
+	struct iovec zc_iov[8];
+	struct msghdr msg;
+	static char rx_buf[400];
+	char head[16];
+	ssize_t len;
+	void *token;
+	size_t i, off;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* Gather the datagram from three pieces */
+	iov[0].iov_base = TEST_STR2;
+	iov[0].iov_len = 10;
+	iov[1].iov_base = TEST_STR2 + 10;
+	iov[1].iov_len = 0;
+	iov[2].iov_base = TEST_STR2 + 10;
+	iov[2].iov_len = STRLEN(TEST_STR2) - 10;
+
+	(void)memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = sizeof(server_addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = ARRAY_SIZE(iov);
+
+	len = sendmsg(client_sock, &msg, 0);
+	zassert_equal(len, STRLEN(TEST_STR2), "sendmsg failed");
+
+	/* Scatter it into a short head and the rest, with a peek */
+	iov[0].iov_base = head;
+	iov[0].iov_len = sizeof(head);
+	iov[1].iov_base = rx_buf;
+	iov[1].iov_len = sizeof(rx_buf);
+
+	(void)memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &addr;
+	msg.msg_namelen = sizeof(addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = 2;
+
+	len = recvmsg(server_sock, &msg, MSG_PEEK);
+	zassert_equal(len, STRLEN(TEST_STR2), "recvmsg failed");
+
+	clear_buf(rx_buf);
+	len = recvmsg(server_sock, &msg, 0);
+	zassert_equal(len, STRLEN(TEST_STR2), "recvmsg failed");
+	zassert_equal(msg.msg_namelen, sizeof(struct sockaddr_in),
+		      "unexpected addrlen");
+	zassert_equal(msg.msg_flags, 0, "unexpected flags");
+	zassert_mem_equal(head, TEST_STR2, sizeof(head), "wrong data");
+	zassert_mem_equal(rx_buf, TEST_STR2 + sizeof(head),
+			  STRLEN(TEST_STR2) - sizeof(head), "wrong data");
+
+	/* A datagram longer than the buffers is truncated */
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR2), "sendto failed");
+
+	msg.msg_iovlen = 1;
+	len = recvmsg(server_sock, &msg, 0);
+	zassert_equal(len, sizeof(head), "recvmsg failed");
+	zassert_equal(msg.msg_flags, MSG_TRUNC, "datagram not truncated");
+
+	/* Zero-copy receive points the iovecs into the packet */
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR2), "sendto failed");
+
+	msg.msg_iov = zc_iov;
+	msg.msg_iovlen = ARRAY_SIZE(zc_iov);
+	len = zsock_recvmsg_zc(server_sock, &msg, 0, &token);
+	zassert_equal(len, STRLEN(TEST_STR2), "zero-copy recvmsg failed");
+	zassert_true(msg.msg_iovlen > 0, "no iovecs filled in");
+
+	for (i = 0, off = 0; i < msg.msg_iovlen; i++) {
+		zassert_mem_equal(zc_iov[i].iov_base, TEST_STR2 + off,
+				  zc_iov[i].iov_len, "wrong data");
+		off += zc_iov[i].iov_len;
+	}
+
+	zassert_equal(off, STRLEN(TEST_STR2), "wrong iovec lengths");
+	zsock_recvmsg_zc_release(token);
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_sendmmsg_recvmmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr[3];
+	struct mmsghdr msgvec[3];
+	struct iovec iov[3];
+	static char rx_buf[3][64];
+	int count, i;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* Datagram i carries the first 10 * (i + 1) bytes of TEST_STR2 */
+	(void)memset(msgvec, 0, sizeof(msgvec));
+	for (i = 0; i < ARRAY_SIZE(msgvec); i++) {
+		iov[i].iov_base = TEST_STR2;
+		iov[i].iov_len = 10 * (i + 1);
+		msgvec[i].msg_hdr.msg_name = &server_addr;
+		msgvec[i].msg_hdr.msg_namelen = sizeof(server_addr);
+		msgvec[i].msg_hdr.msg_iov = &iov[i];
+		msgvec[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = sendmmsg(client_sock, msgvec, ARRAY_SIZE(msgvec), 0);
+	zassert_equal(rv, ARRAY_SIZE(msgvec), "sendmmsg failed");
+
+	for (i = 0; i < ARRAY_SIZE(msgvec); i++) {
+		zassert_equal(msgvec[i].msg_len, 10 * (i + 1),
+			      "wrong length sent");
+	}
+
+	(void)memset(msgvec, 0, sizeof(msgvec));
+	for (i = 0; i < ARRAY_SIZE(msgvec); i++) {
+		iov[i].iov_base = rx_buf[i];
+		iov[i].iov_len = sizeof(rx_buf[i]);
+		msgvec[i].msg_hdr.msg_name = &addr[i];
+		msgvec[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+		msgvec[i].msg_hdr.msg_iov = &iov[i];
+		msgvec[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/* An empty vector receives nothing and takes nothing off the
+	 * queue
+	 */
+	rv = recvmmsg(server_sock, msgvec, 0, MSG_DONTWAIT);
+	zassert_equal(rv, 0, "recvmmsg with no messages failed");
+
+	/* Only the first datagram is waited for, so the rest may come in
+	 * a later call.
+	 */
+	for (count = 0; count < ARRAY_SIZE(msgvec); count += rv) {
+		rv = recvmmsg(server_sock, &msgvec[count],
+			      ARRAY_SIZE(msgvec) - count, 0);
+		zassert_true(rv > 0, "recvmmsg failed");
+	}
+
+	for (i = 0; i < ARRAY_SIZE(msgvec); i++) {
+		zassert_equal(msgvec[i].msg_len, 10 * (i + 1),
+			      "wrong length received");
+		zassert_mem_equal(rx_buf[i], TEST_STR2, msgvec[i].msg_len,
+				  "wrong data");
+		zassert_equal(msgvec[i].msg_hdr.msg_namelen,
+			      sizeof(struct sockaddr_in), "unexpected addrlen");
+		zassert_equal(msgvec[i].msg_hdr.msg_flags, 0,
+			      "unexpected flags");
+	}
+
+	/* Nothing left */
+	rv = recvmmsg(server_sock, msgvec, ARRAY_SIZE(msgvec), MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg should fail");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(socket_udp,
@@ -343,7 +536,9 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendto_recvfrom),
 			 ztest_unit_test(test_v4_bind_sendto),
 			 ztest_unit_test(test_v6_bind_sendto),
-			 ztest_unit_test(test_so_priority)
+			 ztest_unit_test(test_so_priority),
+			 ztest_unit_test(test_v4_sendmsg_recvmsg),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg)
 		);
 
 	ztest_run_test_suite(socket_udp);
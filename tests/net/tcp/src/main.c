@@ -1533,6 +1533,585 @@ static bool test_tcp_seq_validity(void)
 	return true;
 }
 
+static const u8_t syn_opts[] = {
+	/* MSS 1440 */
+	NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, 0x05, 0xa0,
+	/* Window scale 7 */
+	NET_TCP_NOP_OPT, NET_TCP_WINDOW_SCALE_OPT, NET_TCP_WINDOW_SCALE_SIZE,
+	7,
+	/* SACK permitted */
+	NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_PERM_OPT,
+	NET_TCP_SACK_PERM_SIZE,
+	/* Two SACK blocks */
+	NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_OPT,
+	2 + 2 * NET_TCP_SACK_BLOCK_SIZE,
+	0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x20, 0x00,
+	0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x40, 0x00,
+};
+
+static const u8_t bad_sack_opts[] = {
+	/* SACK block of 7 bytes */
+	NET_TCP_SACK_OPT, 2 + 7, 0, 0, 0, 0, 0, 0, 0,
+	NET_TCP_END_OPT, NET_TCP_END_OPT, NET_TCP_END_OPT,
+};
+
+static int parse_opts(const u8_t *buf, size_t len,
+		      struct net_tcp_options *opts)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(net_if_get_default(), len,
+					AF_UNSPEC, 0, K_SECONDS(1));
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	net_pkt_write(pkt, buf, len);
+	net_pkt_cursor_init(pkt);
+
+	ret = net_tcp_parse_opts(pkt, len, opts);
+
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
+static bool test_tcp_parse_opts(void)
+{
+	struct net_tcp_options opts = {
+		.mss = NET_TCP_DEFAULT_MSS,
+	};
+
+	if (parse_opts(syn_opts, sizeof(syn_opts), &opts) < 0) {
+		DBG("Parsing options failed\n");
+		return false;
+	}
+
+	if (opts.mss != 1440U || !opts.wscale_ok || opts.wscale != 7U ||
+	    !opts.sack_ok) {
+		DBG("Invalid options mss %u wscale %u/%d sack %d\n",
+		    opts.mss, opts.wscale, opts.wscale_ok, opts.sack_ok);
+		return false;
+	}
+
+	if (opts.sack_count != 2U ||
+	    opts.sack[0].left != 0x1000 || opts.sack[0].right != 0x2000 ||
+	    opts.sack[1].left != 0x3000 || opts.sack[1].right != 0x4000) {
+		DBG("Invalid SACK blocks (%u)\n", opts.sack_count);
+		return false;
+	}
+
+	if (parse_opts(bad_sack_opts, sizeof(bad_sack_opts), &opts) == 0) {
+		DBG("Malformed SACK option accepted\n");
+		return false;
+	}
+
+	return true;
+}
+
+/* The sender tests below queue segments on v6_ctx and feed it ACKs
+ * directly, there is no connection behind it.
+ */
+#define CC_MSS 100
+#define RTT_SLACK 20
+#define RTO_TEST 100
+
+extern bool net_tcp_ack_segment(struct net_context *context,
+				struct net_pkt *pkt,
+				struct net_tcp_hdr *tcp_hdr);
+
+static void cc_reset(struct net_tcp *tcp, u32_t cwnd, u32_t wnd)
+{
+	tcp->send_mss = CC_MSS;
+	tcp->snd_wscale = 0U;
+	tcp->snd_una = tcp->send_seq;
+	tcp->snd_nxt = tcp->send_seq;
+	tcp->recover = tcp->send_seq - 1;
+	tcp->rexmit_nxt = tcp->send_seq;
+	tcp->send_wnd = wnd;
+	tcp->cwnd = cwnd;
+	tcp->ssthresh = NET_TCP_MAX_SEND_WIN;
+	tcp->recovery = NET_TCP_RECOVERY_NONE;
+	tcp->dupacks = 0U;
+	tcp->rto = MSEC_PER_SEC;
+	tcp->retry_timeout_shift = 0U;
+	tcp->rtt_active = 0U;
+#if defined(CONFIG_NET_TCP_SACK)
+	tcp->flags |= NET_TCP_SACK_OK;
+	tcp->sack_count = 0U;
+#endif
+}
+
+static bool cc_queue(struct net_tcp *tcp, int count)
+{
+	struct net_context *ctx = tcp->context;
+	struct net_pkt *pkt;
+	int ret;
+
+	while (count--) {
+		pkt = net_pkt_alloc_with_buffer(net_context_get_iface(ctx),
+						CC_MSS, AF_INET6, IPPROTO_TCP,
+						K_SECONDS(1));
+		if (!pkt) {
+			DBG("Cannot allocate segment\n");
+			return false;
+		}
+
+		net_pkt_set_context(pkt, ctx);
+
+		if (net_pkt_memset(pkt, count, CC_MSS)) {
+			net_pkt_unref(pkt);
+			return false;
+		}
+
+		ret = net_tcp_prepare_segment(tcp, NET_TCP_PSH | NET_TCP_ACK,
+					      NULL, 0, NULL,
+					      (struct sockaddr *)&peer_v6_addr,
+					      &pkt);
+		if (ret) {
+			DBG("Prepare segment failed (%d)\n", ret);
+			net_pkt_unref(pkt);
+			return false;
+		}
+
+		tcp->send_seq += CC_MSS;
+
+		/* As net_tcp_queue_data() does */
+		sys_slist_append(&tcp->sent_list, &pkt->sent_list);
+		net_pkt_ref(pkt);
+	}
+
+	return true;
+}
+
+/* Let the TX path mark what was sent */
+static void cc_flush(void)
+{
+	k_sleep(K_MSEC(10));
+}
+
+static bool cc_ack(struct net_tcp *tcp, u32_t ack, u16_t wnd,
+		   const u8_t *opts, size_t optlen)
+{
+	struct net_tcp_hdr hdr;
+	struct net_pkt *pkt;
+	bool ret;
+
+	pkt = net_pkt_alloc_with_buffer(net_if_get_default(), optlen,
+					AF_UNSPEC, 0, K_SECONDS(1));
+	if (!pkt) {
+		return false;
+	}
+
+	if (optlen && net_pkt_write(pkt, opts, optlen)) {
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	(void)memset(&hdr, 0, sizeof(hdr));
+	sys_put_be32(ack, hdr.ack);
+	sys_put_be16(wnd, hdr.wnd);
+	hdr.offset = ((NET_TCPH_LEN + optlen) / 4) << 4;
+	hdr.flags = NET_TCP_ACK;
+
+	ret = net_tcp_ack_segment(tcp->context, pkt, &hdr);
+
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static bool cc_sack(struct net_tcp *tcp, u32_t ack, u16_t wnd,
+		    u32_t left, u32_t right)
+{
+	u8_t opts[4 + NET_TCP_SACK_BLOCK_SIZE] = {
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_OPT,
+		2 + NET_TCP_SACK_BLOCK_SIZE,
+	};
+
+	sys_put_be32(left, &opts[4]);
+	sys_put_be32(right, &opts[8]);
+
+	return cc_ack(tcp, ack, wnd, opts, sizeof(opts));
+}
+#endif
+
+/* Sends and acknowledges whatever is left, so every segment is freed */
+static bool cc_finish(struct net_tcp *tcp)
+{
+	tcp->cwnd = NET_TCP_MAX_SEND_WIN;
+	tcp->send_wnd = UINT16_MAX;
+	net_tcp_send_data(tcp->context, NULL, NULL);
+	cc_flush();
+
+	if (!cc_ack(tcp, tcp->send_seq, UINT16_MAX, NULL, 0)) {
+		return false;
+	}
+
+	k_delayed_work_cancel(&tcp->retry_timer);
+
+	if (!sys_slist_is_empty(&tcp->sent_list)) {
+		DBG("Segments left on the sent list\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_tcp_cwnd_gating(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t una;
+
+	cc_reset(tcp, 2 * CC_MSS, 4 * CC_MSS);
+	una = tcp->snd_una;
+
+	if (!cc_queue(tcp, 6)) {
+		return false;
+	}
+
+	net_tcp_send_data(v6_ctx, NULL, NULL);
+	cc_flush();
+
+	if (net_tcp_flight_size(tcp) != 2 * CC_MSS) {
+		DBG("1) cwnd %u let %u bytes out\n", tcp->cwnd,
+		    net_tcp_flight_size(tcp));
+		return false;
+	}
+
+	/* Slow start opens cwnd by the MSS acked */
+	if (!cc_ack(tcp, una + CC_MSS, 4 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	cc_flush();
+
+	if (tcp->cwnd != 3 * CC_MSS ||
+	    net_tcp_flight_size(tcp) != 3 * CC_MSS) {
+		DBG("2) cwnd %u flight %u\n", tcp->cwnd,
+		    net_tcp_flight_size(tcp));
+		return false;
+	}
+
+	/* The peer window limits what cwnd would allow */
+	if (!cc_ack(tcp, una + 2 * CC_MSS, 2 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	cc_flush();
+
+	if (tcp->cwnd <= 3 * CC_MSS ||
+	    net_tcp_flight_size(tcp) != 2 * CC_MSS) {
+		DBG("3) cwnd %u wnd %u flight %u\n", tcp->cwnd, tcp->send_wnd,
+		    net_tcp_flight_size(tcp));
+		return false;
+	}
+
+	/* A zero window still lets one segment out to probe it */
+	if (!cc_ack(tcp, una + 4 * CC_MSS, 0, NULL, 0)) {
+		return false;
+	}
+
+	cc_flush();
+
+	if (tcp->send_wnd != 0U || net_tcp_flight_size(tcp) != CC_MSS ||
+	    tcp->snd_nxt != una + 5 * CC_MSS) {
+		DBG("4) flight %u snd_nxt %u\n", net_tcp_flight_size(tcp),
+		    tcp->snd_nxt - una);
+		return false;
+	}
+
+	return cc_finish(tcp);
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static bool test_tcp_fast_recovery(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t una;
+	int i;
+
+	cc_reset(tcp, 4 * CC_MSS, 8 * CC_MSS);
+	una = tcp->snd_una;
+
+	if (!cc_queue(tcp, 5)) {
+		return false;
+	}
+
+	net_tcp_send_data(v6_ctx, NULL, NULL);
+	cc_flush();
+
+	/* The first two segments are lost, the peer SACKs the rest */
+	for (i = 0; i < NET_TCP_DUPACK_THRESH; i++) {
+		if (tcp->recovery != NET_TCP_RECOVERY_NONE) {
+			DBG("Recovery after %d duplicates\n", i);
+			return false;
+		}
+
+		if (!cc_sack(tcp, una, 8 * CC_MSS, una + 2 * CC_MSS,
+			     una + (3 + MIN(i, 1)) * CC_MSS)) {
+			return false;
+		}
+	}
+
+	cc_flush();
+
+	/* The first hole is resent and the inflated cwnd lets the
+	 * queued segment out.
+	 */
+	if (tcp->recovery != NET_TCP_RECOVERY_FAST ||
+	    tcp->ssthresh != 2 * CC_MSS ||
+	    tcp->cwnd != (2 + NET_TCP_DUPACK_THRESH) * CC_MSS ||
+	    tcp->recover != una + 4 * CC_MSS ||
+	    tcp->rexmit_nxt != una + CC_MSS ||
+	    tcp->snd_nxt != una + 5 * CC_MSS) {
+		DBG("1) recovery %u ssthresh %u cwnd %u recover %u rexmit %u "
+		    "snd_nxt %u\n", tcp->recovery, tcp->ssthresh, tcp->cwnd,
+		    tcp->recover - una, tcp->rexmit_nxt - una,
+		    tcp->snd_nxt - una);
+		return false;
+	}
+
+	/* Another duplicate inflates cwnd and resends the next hole */
+	if (!cc_sack(tcp, una, 8 * CC_MSS, una + 2 * CC_MSS,
+		     una + 4 * CC_MSS)) {
+		return false;
+	}
+
+	cc_flush();
+
+	if (tcp->cwnd != 6 * CC_MSS || tcp->rexmit_nxt != una + 2 * CC_MSS) {
+		DBG("2) cwnd %u rexmit %u\n", tcp->cwnd,
+		    tcp->rexmit_nxt - una);
+		return false;
+	}
+
+	/* Partial ACK: deflate by what was acked, add back one MSS */
+	if (!cc_sack(tcp, una + CC_MSS, 8 * CC_MSS, una + 2 * CC_MSS,
+		     una + 4 * CC_MSS)) {
+		return false;
+	}
+
+	if (tcp->recovery != NET_TCP_RECOVERY_FAST ||
+	    tcp->cwnd != 6 * CC_MSS) {
+		DBG("3) recovery %u cwnd %u\n", tcp->recovery, tcp->cwnd);
+		return false;
+	}
+
+	/* Full ACK ends the recovery with cwnd pulled down to ssthresh
+	 * and takes the SACKed range off the scoreboard.
+	 */
+	if (!cc_ack(tcp, una + 4 * CC_MSS, 8 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	if (tcp->recovery != NET_TCP_RECOVERY_NONE ||
+	    tcp->cwnd != 2 * CC_MSS || tcp->sack_count != 0U) {
+		DBG("4) recovery %u cwnd %u, %u SACK blocks\n", tcp->recovery,
+		    tcp->cwnd, tcp->sack_count);
+		return false;
+	}
+
+	return cc_finish(tcp);
+}
+
+static bool test_tcp_sack_scoreboard(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t una;
+
+	cc_reset(tcp, 8 * CC_MSS, 8 * CC_MSS);
+	una = tcp->snd_una;
+
+	if (!cc_queue(tcp, 6)) {
+		return false;
+	}
+
+	net_tcp_send_data(v6_ctx, NULL, NULL);
+	cc_flush();
+
+	if (!cc_sack(tcp, una, 8 * CC_MSS, una + CC_MSS, una + 2 * CC_MSS) ||
+	    !cc_sack(tcp, una, 8 * CC_MSS, una + 3 * CC_MSS,
+		     una + 5 * CC_MSS)) {
+		return false;
+	}
+
+	if (tcp->sack_count != 2U) {
+		DBG("1) %u SACK blocks\n", tcp->sack_count);
+		return false;
+	}
+
+	/* Fills the gap between the two */
+	if (!cc_sack(tcp, una + 2 * CC_MSS, 8 * CC_MSS, una + 2 * CC_MSS,
+		     una + 3 * CC_MSS)) {
+		return false;
+	}
+
+	/* The cumulative ACK cut into the merged block */
+	if (tcp->sack_count != 1U || tcp->sack[0].left != una + 2 * CC_MSS ||
+	    tcp->sack[0].right != una + 5 * CC_MSS) {
+		DBG("2) %u SACK blocks, first %u-%u\n", tcp->sack_count,
+		    tcp->sack[0].left - una, tcp->sack[0].right - una);
+		return false;
+	}
+
+	/* Blocks beyond what was sent are ignored */
+	if (!cc_sack(tcp, una + 2 * CC_MSS, 8 * CC_MSS, una + 6 * CC_MSS,
+		     una + 7 * CC_MSS)) {
+		return false;
+	}
+
+	if (tcp->sack_count != 1U) {
+		DBG("3) %u SACK blocks\n", tcp->sack_count);
+		return false;
+	}
+
+	if (!cc_ack(tcp, una + 5 * CC_MSS, 8 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	if (tcp->sack_count != 0U) {
+		DBG("4) %u SACK blocks\n", tcp->sack_count);
+		return false;
+	}
+
+	return cc_finish(tcp);
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+static bool rtt_close(u32_t value, u32_t expected, u32_t slack)
+{
+	return value + slack >= expected && value <= expected + slack;
+}
+
+static bool test_tcp_rtt(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t una;
+
+	cc_reset(tcp, 4 * CC_MSS, 8 * CC_MSS);
+	tcp->srtt = 0U;
+	tcp->rttvar = 0U;
+	una = tcp->snd_una;
+
+	if (!cc_queue(tcp, 1)) {
+		return false;
+	}
+
+	net_tcp_send_data(v6_ctx, NULL, NULL);
+	cc_flush();
+
+	/* First sample: srtt = rtt, rttvar = rtt / 2, rto = srtt + 4 rttvar */
+	tcp->rtt_start = k_uptime_get_32() - 400;
+
+	if (!cc_ack(tcp, una + CC_MSS, 8 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	if (!rtt_close(tcp->srtt >> 3, 400, RTT_SLACK) ||
+	    !rtt_close(tcp->rttvar >> 2, 200, RTT_SLACK) ||
+	    !rtt_close(tcp->rto, 1200, 3 * RTT_SLACK)) {
+		DBG("1) srtt %u rttvar %u rto %u\n", tcp->srtt >> 3,
+		    tcp->rttvar >> 2, tcp->rto);
+		return false;
+	}
+
+	if (!cc_queue(tcp, 1)) {
+		return false;
+	}
+
+	net_tcp_send_data(v6_ctx, NULL, NULL);
+	cc_flush();
+
+	/* srtt moves 1/8 and rttvar 1/4 of the way to the new sample */
+	tcp->rtt_start = k_uptime_get_32() - 200;
+
+	if (!cc_ack(tcp, una + 2 * CC_MSS, 8 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	if (!rtt_close(tcp->srtt >> 3, 375, RTT_SLACK) ||
+	    !rtt_close(tcp->rttvar >> 2, 200, RTT_SLACK) ||
+	    !rtt_close(tcp->rto, 1175, 3 * RTT_SLACK)) {
+		DBG("2) srtt %u rttvar %u rto %u\n", tcp->srtt >> 3,
+		    tcp->rttvar >> 2, tcp->rto);
+		return false;
+	}
+
+	return cc_finish(tcp);
+}
+
+static bool test_tcp_rto_backoff(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	s32_t remaining;
+	u32_t una;
+
+	cc_reset(tcp, 4 * CC_MSS, 8 * CC_MSS);
+	una = tcp->snd_una;
+
+	if (!cc_queue(tcp, 4)) {
+		return false;
+	}
+
+	net_tcp_send_data(v6_ctx, NULL, NULL);
+
+	tcp->rto = RTO_TEST;
+	k_delayed_work_submit(&tcp->retry_timer, tcp->rto);
+
+	/* Halfway to the second, doubled, expiry */
+	k_sleep(RTO_TEST + RTO_TEST / 2);
+
+	remaining = k_delayed_work_remaining_get(&tcp->retry_timer);
+
+	if (tcp->retry_timeout_shift != 1U || remaining <= RTO_TEST) {
+		DBG("1) shift %u remaining %d\n", tcp->retry_timeout_shift,
+		    remaining);
+		return false;
+	}
+
+	if (tcp->recovery != NET_TCP_RECOVERY_RTO ||
+	    tcp->cwnd != CC_MSS || tcp->ssthresh != 2 * CC_MSS ||
+	    tcp->recover != una + 4 * CC_MSS || tcp->rtt_active) {
+		DBG("2) recovery %u cwnd %u ssthresh %u recover %u rtt %u\n",
+		    tcp->recovery, tcp->cwnd, tcp->ssthresh,
+		    tcp->recover - una, tcp->rtt_active);
+		return false;
+	}
+
+	/* Slow start again, the retransmission gives no RTT sample and
+	 * the ACK ends the backoff.
+	 */
+	if (!cc_ack(tcp, una + CC_MSS, 8 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	if (tcp->recovery != NET_TCP_RECOVERY_RTO ||
+	    tcp->cwnd != 2 * CC_MSS || tcp->rto != RTO_TEST ||
+	    tcp->retry_timeout_shift != 0U) {
+		DBG("3) recovery %u cwnd %u rto %u shift %u\n", tcp->recovery,
+		    tcp->cwnd, tcp->rto, tcp->retry_timeout_shift);
+		return false;
+	}
+
+	cc_flush();
+
+	if (!cc_ack(tcp, una + 4 * CC_MSS, 8 * CC_MSS, NULL, 0)) {
+		return false;
+	}
+
+	if (tcp->recovery != NET_TCP_RECOVERY_NONE) {
+		DBG("4) recovery %u\n", tcp->recovery);
+		return false;
+	}
+
+	return cc_finish(tcp);
+}
+
 static bool test_init_tcp_reply_context(void)
 {
 	struct net_if *iface = peer_iface;
@@ -1799,6 +2378,174 @@ static bool test_cleanup(void)
 	return true;
 }
 
+#if defined(CONFIG_NET_TCP_GSO) && defined(CONFIG_NET_TCP_GRO)
+#define GSO_MSS 536
+#define GSO_PAYLOAD (3 * GSO_MSS + 100)
+
+static u8_t gso_data[GSO_PAYLOAD];
+
+struct gso_rx {
+	struct net_tcp_gro gro;
+	struct net_pkt *out;
+	int count;
+};
+
+static int gso_to_gro(struct net_pkt *seg, void *user_data)
+{
+	struct gso_rx *rx = user_data;
+	size_t len = net_pkt_get_len(seg);
+	struct net_pkt *flush;
+
+	rx->count++;
+
+	net_pkt_cursor_init(seg);
+
+	if (net_tcp_gro_receive(&rx->gro, seg, &flush) != NET_OK) {
+		DBG("Segment %d not coalesced\n", rx->count);
+		return -EINVAL;
+	}
+
+	if (flush) {
+		if (rx->out) {
+			DBG("Segment %d flushed twice\n", rx->count);
+			net_pkt_unref(flush);
+			return -EINVAL;
+		}
+
+		rx->out = flush;
+	}
+
+	return len;
+}
+
+static struct net_pkt *setup_gso_pkt(struct net_if *iface)
+{
+	struct net_tcp_hdr tcp_hdr;
+	struct net_pkt *pkt;
+	size_t i;
+
+	pkt = net_pkt_alloc_on_iface(iface, K_SECONDS(1));
+	if (!pkt) {
+		return NULL;
+	}
+
+	/* Set before allocating, or the buffer is cut to the MTU */
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_gso_size(pkt, GSO_MSS);
+
+	if (net_pkt_alloc_buffer(pkt, GSO_PAYLOAD, IPPROTO_TCP,
+				 K_SECONDS(1))) {
+		goto fail;
+	}
+
+	(void)memset(&tcp_hdr, 0, sizeof(tcp_hdr));
+	tcp_hdr.src_port = htons(4242);
+	tcp_hdr.dst_port = htons(80);
+	sys_put_be32(0xfffffff0, tcp_hdr.seq);
+	sys_put_be32(1000, tcp_hdr.ack);
+	tcp_hdr.offset = (NET_TCPH_LEN / 4) << 4;
+	tcp_hdr.flags = NET_TCP_ACK | NET_TCP_PSH;
+	tcp_hdr.wnd[0] = 0x10;
+
+	for (i = 0; i < sizeof(gso_data); i++) {
+		gso_data[i] = i;
+	}
+
+	if (net_ipv4_create(pkt, &my_v4_inaddr, &peer_v4_inaddr) ||
+	    net_pkt_write(pkt, &tcp_hdr, sizeof(tcp_hdr)) ||
+	    net_pkt_write(pkt, gso_data, sizeof(gso_data))) {
+		goto fail;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_ipv4_finalize(pkt, IPPROTO_TCP)) {
+		goto fail;
+	}
+
+	return pkt;
+
+fail:
+	net_pkt_unref(pkt);
+	return NULL;
+}
+
+static bool test_tcp_gso_gro(void)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct gso_rx rx = { 0 };
+	struct net_tcp_hdr *tcp_hdr;
+	struct net_pkt *pkt;
+	size_t len;
+	bool ret = false;
+	int total;
+
+	pkt = setup_gso_pkt(net_if_get_default());
+	if (!pkt) {
+		DBG("Cannot create GSO packet\n");
+		return false;
+	}
+
+	len = net_pkt_get_len(pkt);
+
+	total = net_tcp_gso_segment(pkt, gso_to_gro, &rx);
+	if (total != (int)(len + 3 * NET_IPV4TCPH_LEN)) {
+		DBG("Segmentation failed (%d)\n", total);
+		goto out;
+	}
+
+	if (rx.count != 4 || !rx.out || net_tcp_gro_flush(&rx.gro)) {
+		DBG("Invalid coalescing (%d segments, pkt %p)\n",
+		    rx.count, rx.out);
+		goto out;
+	}
+
+	if (net_pkt_get_len(rx.out) != len ||
+	    ntohs(NET_IPV4_HDR(rx.out)->len) != len ||
+	    net_calc_chksum_ipv4(rx.out) != 0U) {
+		DBG("Invalid coalesced IPv4 header\n");
+		goto out;
+	}
+
+	net_pkt_cursor_init(rx.out);
+	net_pkt_set_overwrite(rx.out, true);
+	net_pkt_skip(rx.out, NET_IPV4H_LEN);
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(rx.out, &tcp_access);
+	if (!tcp_hdr || sys_get_be32(tcp_hdr->seq) != 0xfffffff0 ||
+	    tcp_hdr->flags != (NET_TCP_ACK | NET_TCP_PSH)) {
+		DBG("Invalid coalesced TCP header\n");
+		goto out;
+	}
+
+	net_pkt_set_data(rx.out, &tcp_access);
+
+	(void)memset(gso_data, 0, sizeof(gso_data));
+
+	if (net_pkt_read(rx.out, gso_data, sizeof(gso_data))) {
+		DBG("Coalesced payload too short\n");
+		goto out;
+	}
+
+	for (len = 0; len < sizeof(gso_data); len++) {
+		if (gso_data[len] != (u8_t)len) {
+			DBG("Payload mismatch at %zu\n", len);
+			goto out;
+		}
+	}
+
+	ret = true;
+out:
+	if (rx.out) {
+		net_pkt_unref(rx.out);
+	}
+
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO && CONFIG_NET_TCP_GRO */
+
 static const struct {
 	const char *name;
 	bool (*func)(void);
@@ -1817,6 +2564,17 @@ static const struct {
 	{ "test IPv6 TCP seq check", test_v6_seq_check },
 	{ "test IPv4 TCP seq check", test_v4_seq_check },
 	{ "test TCP seq validity", test_tcp_seq_validity },
+	{ "test TCP option parsing", test_tcp_parse_opts },
+	{ "test TCP cwnd and send window", test_tcp_cwnd_gating },
+#if defined(CONFIG_NET_TCP_SACK)
+	{ "test TCP fast recovery", test_tcp_fast_recovery },
+	{ "test TCP SACK scoreboard", test_tcp_sack_scoreboard },
+#endif
+	{ "test TCP RTT estimation", test_tcp_rtt },
+	{ "test TCP RTO backoff", test_tcp_rto_backoff },
+#if defined(CONFIG_NET_TCP_GSO) && defined(CONFIG_NET_TCP_GRO)
+	{ "test TCP segmentation and coalescing", test_tcp_gso_gro },
+#endif
 	{ "test TCP reply context init", test_init_tcp_reply_context },
 	{ "test TCP accept init", test_init_tcp_accept },
 #if 0
@@ -392,6 +392,63 @@ static bool send_ipv4_udp_msg(struct net_if *iface,
 	return !fail;
 }
 
+#define BURST_LEN 4
+
+/* IPv4 and IPv6 packets one after the other in a single receive burst */
+static bool send_udp_burst(struct net_if *iface,
+			   struct in_addr *src4, struct in_addr *dst4,
+			   struct in6_addr *src6, struct in6_addr *dst6,
+			   u16_t src_port, u16_t dst_port, struct ud *ud)
+{
+	struct net_pkt *pkts[BURST_LEN];
+	int ret, i;
+
+	for (i = 0; i < BURST_LEN; i++) {
+		sa_family_t family = (i % 2) ? AF_INET6 : AF_INET;
+
+		pkts[i] = net_pkt_alloc_with_buffer(iface, 0, family,
+						    IPPROTO_UDP, K_SECONDS(1));
+		zassert_not_null(pkts[i], "Out of mem");
+
+		if (family == AF_INET6) {
+			ret = net_ipv6_create(pkts[i], src6, dst6);
+		} else {
+			ret = net_ipv4_create(pkts[i], src4, dst4);
+		}
+
+		if (ret || net_udp_create(pkts[i], htons(src_port),
+					  htons(dst_port))) {
+			printk("Cannot create UDP pkt %p", pkts[i]);
+			zassert_true(0, "exiting");
+		}
+
+		net_pkt_cursor_init(pkts[i]);
+
+		if (family == AF_INET6) {
+			net_ipv6_finalize(pkts[i], IPPROTO_UDP);
+		} else {
+			net_ipv4_finalize(pkts[i], IPPROTO_UDP);
+		}
+	}
+
+	ret = net_recv_data_burst(iface, pkts, BURST_LEN);
+	zassert_equal(ret, BURST_LEN, "Burst not taken (%d)", ret);
+
+	for (i = 0; i < BURST_LEN; i++) {
+		if (k_sem_take(&recv_lock, TIMEOUT)) {
+			zassert_true(0, "Timeout, packet %d not received", i);
+		}
+
+		if (ud != returned_ud) {
+			printk("Burst wrong user data %p returned, "
+			       "expected %p\n", returned_ud, ud);
+			zassert_true(0, "exiting");
+		}
+	}
+
+	return !fail;
+}
+
 static void set_port(sa_family_t family, struct sockaddr *raddr,
 		     struct sockaddr *laddr, u16_t rport,
 		     u16_t lport)
@@ -426,7 +483,7 @@ void test_udp(void)
 	struct net_conn_handle *handlers[CONFIG_NET_MAX_CONN];
 	struct net_if *iface = net_if_get_default();
 	struct net_if_addr *ifaddr;
-	struct ud *ud;
+	struct ud *ud, *ud2;
 	int ret, i = 0;
 	bool st;
 
@@ -618,6 +675,15 @@ void test_udp(void)
 	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 1234, 4242);
 	TEST_IPV4_FAIL(ud, &in4addr_peer, &in4addr_my, 1234, 4243);
 
+	/* A connected endpoint and a listener sharing a local port */
+	ud = REGISTER(AF_INET6, NULL, &any_addr6, 0, 4244);
+	ud2 = REGISTER(AF_INET6, &peer_addr6, &any_addr6, 1235, 4244);
+	TEST_IPV6_OK(ud2, &in6addr_peer, &in6addr_my, 1235, 4244);
+	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1236, 4244);
+	UNREGISTER(ud2);
+	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1235, 4244);
+	UNREGISTER(ud);
+
 	ud = REGISTER(AF_UNSPEC, NULL, NULL, 1234, 42423);
 	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 1234, 42423);
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1234, 42423);
@@ -636,6 +702,10 @@ void test_udp(void)
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 	TEST_IPV6_LONG_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 
+	st = send_udp_burst(iface, &in4addr_peer, &in4addr_my, &in6addr_peer,
+			    &in6addr_my, 12345, 42421, ud);
+	zassert_true(st, "UDP burst test fail");
+
 	/* Remote addr same as local addr, these two will never match */
 	REGISTER(AF_INET6, &my_addr6, NULL, 1234, 4242);
 	REGISTER(AF_INET, &my_addr4, NULL, 1234, 4242);
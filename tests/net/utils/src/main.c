@@ -832,12 +832,86 @@ void test_addr_parse(void)
 #endif
 }
 
+static u16_t ref_chksum(const u8_t *data, size_t len, u32_t sum)
+{
+	for (size_t i = 0; i < len; i++) {
+		sum += (i & 1) ? data[i] : (data[i] << 8);
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+void test_chksum(void)
+{
+	/* Odd sized fragments, some of them starting at odd addresses */
+	static const u8_t frag_len[] = { 20 + 7, 1, 13, 64 + 3, 4 };
+	u8_t data[20 + 7 + 1 + 13 + 64 + 3 + 4];
+	struct net_pkt *pkt;
+	size_t off = 0;
+	u16_t chksum, hdr;
+	u32_t sum;
+
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = (u8_t)(i * 37 + 11);
+	}
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, 20);
+
+	for (size_t i = 0; i < ARRAY_SIZE(frag_len); i++) {
+		struct net_buf *frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+
+		zassert_not_null(frag, "Cannot allocate frag");
+
+		if (i & 1) {
+			net_buf_add(frag, 1);
+			net_buf_pull(frag, 1);
+		}
+
+		net_buf_add_mem(frag, data + off, frag_len[i]);
+		net_pkt_frag_add(pkt, frag);
+		off += frag_len[i];
+	}
+
+	/* IPv4 pseudo header: addresses, protocol and payload length */
+	sum = IPPROTO_UDP + sizeof(data) - 20;
+	sum = ref_chksum(data + 12, 8, sum);
+	sum = ref_chksum(data + 20, sizeof(data) - 20, sum);
+
+	chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+	zassert_equal(chksum, htons(~sum & 0xffff), "Wrong checksum %04x",
+		      chksum);
+
+	/* Incremental updates must match a full recomputation */
+	hdr = sys_get_be16(data + 24);
+	sys_put_be16(hdr ^ 0x5a5a, pkt->buffer->data + 24);
+	chksum = net_calc_chksum_update_16(chksum, hdr, hdr ^ 0x5a5a);
+	zassert_equal(chksum, net_calc_chksum(pkt, IPPROTO_UDP),
+		      "Wrong 16 bit incremental update");
+
+	sys_put_be32(0xdeadbeef, pkt->buffer->data + 12);
+	chksum = net_calc_chksum_update_32(chksum, sys_get_be32(data + 12),
+					   0xdeadbeef);
+	zassert_equal(chksum, net_calc_chksum(pkt, IPPROTO_UDP),
+		      "Wrong 32 bit incremental update");
+
+	net_pkt_unref(pkt);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_unit_test(test_net_addr),
 			 ztest_user_unit_test(test_net_addr),
-			 ztest_unit_test(test_addr_parse));
+			 ztest_unit_test(test_addr_parse),
+			 ztest_unit_test(test_chksum));
 
 	ztest_run_test_suite(test_utils_fn);
 }